@@ -2,9 +2,24 @@
 
 #pragma pack_matrix(column_major)
 
+// Permutation keywords (0/1, see Assets/ShaderPermutations.h); a plain compile gets everything on
+#ifndef LIGHTING
+#define LIGHTING 1
+#endif
+#ifndef SHADOWS
+#define SHADOWS 1
+#endif
+#ifndef AMBIENT
+#define AMBIENT 1
+#endif
+// Off for a plain compile: the per-draw path binds no instance stream
+#ifndef INSTANCED
+#define INSTANCED 0
+#endif
+
 cbuffer SceneCB : register(b0)
 {
-    float4x4 mvp; // M * (View * Proj)
+    float4x4 mvp; // M * (View * Proj); INSTANCED: View * Proj, M comes per instance
     float3 lightDir; // world dir FROM light TO scene
     float _pad0;
 
@@ -13,7 +28,7 @@ cbuffer SceneCB : register(b0)
     float thicknessPx;
     float _pad1;
 
-    float4x4 lightVP; // M * (LightView * LightProj) for shadow lookup
+    float4x4 lightVP; // M * (LightView * LightProj) for shadow lookup; INSTANCED: without M
 };
 
 Texture2D ShadowMap : register(t0);
@@ -25,6 +40,13 @@ struct VSIn
     float3 pos : POSITION;
     float3 normal : NORMAL;
     float3 color : COLOR0;
+#if INSTANCED
+    // Rows of the object-to-world matrix (row vectors, as on the CPU)
+    float4 world0 : WORLD0;
+    float4 world1 : WORLD1;
+    float4 world2 : WORLD2;
+    float4 world3 : WORLD3;
+#endif
 };
 
 struct PSIn
@@ -32,22 +54,35 @@ struct PSIn
     float4 pos : SV_POSITION;
     float3 n : NORMAL;
     float3 color : COLOR0;
+#if SHADOWS
     float4 lightPos : TEXCOORD0; // position in light clip space
+#endif
 };
 
 PSIn VSMainLit(VSIn i)
 {
     PSIn o;
     float4 wp = float4(i.pos, 1.0f);
+#if INSTANCED
+    float4x4 world = float4x4(i.world0, i.world1, i.world2, i.world3);
+    wp = mul(wp, world);
+#endif
     o.pos = mul(wp, mvp);
+#if SHADOWS
     o.lightPos = mul(wp, lightVP);
+#endif
 
     // For rigid transforms with uniform scale this is fine
+#if INSTANCED
+    o.n = normalize(mul(i.normal, (float3x3)world));
+#else
     o.n = normalize(i.normal);
+#endif
     o.color = i.color;
     return o;
 }
 
+#if SHADOWS
 float ShadowFactor(float4 lightPos)
 {
     // Project to NDC then to UV
@@ -73,23 +108,33 @@ float ShadowFactor(float4 lightPos)
         return (p.z > mapDepth + bias) ? 0.0f : 1.0f;
     }
 }
+#endif
 
 float4 PSMainLit(PSIn i) : SV_Target
 {
+    float3 litColor = float3(0.0f, 0.0f, 0.0f);
+#if LIGHTING
     // 1. Lambert lighting
     float3 L = normalize(-lightDir); // Direction TO light
     float3 N = normalize(i.n);
     float NdL = max(dot(N, L), 0.0f);
-    
+
     // 2. Shadow factor
+#if SHADOWS
     float shadow = ShadowFactor(i.lightPos);
-    
+#else
+    float shadow = 1.0f;
+#endif
+
     // 3. Combine color * light * shadow
-    float3 litColor = i.color * NdL * shadow;
-    
-    // Optional: add small ambient so shadows aren't pure black
+    litColor = i.color * NdL * shadow;
+#endif
+
+#if AMBIENT
+    // Small ambient so shadows aren't pure black
     float3 ambient = float3(0.05f, 0.05f, 0.05f);
     litColor = max(litColor, ambient * i.color);
-    
+#endif
+
     return float4(litColor, 1.0f);
-}
\ No newline at end of file
+}
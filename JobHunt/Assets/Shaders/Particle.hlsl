@@ -0,0 +1,48 @@
+// Particle.hlsl - Camera-facing particle quads, expanded and depth-sorted on the CPU (see Particles.h),
+// alpha-blended far to near over the opaque scene.
+#pragma pack_matrix(column_major)
+
+cbuffer SceneCB : register(b0)
+{
+    float4x4 mvp;      // view * projection
+    float3 lightDir;   // unused here
+    float _pad0;
+
+    float2 viewport;   // unused here
+    float thicknessPx; // unused here
+    float _pad1;
+
+    float4x4 lightVP;  // unused here
+};
+
+struct VSIn
+{
+    float3 pos : POSITION;     // corner, already offset along the camera's right / up
+    float4 color : COLOR0;
+    uint vid : SV_VertexID;
+};
+
+struct VSOut
+{
+    float4 pos : SV_POSITION;
+    float2 corner : TEXCOORD0; // -1..1 across the quad
+    float4 color : COLOR0;
+};
+
+VSOut VSParticle(VSIn i)
+{
+    // Four vertices per particle: 0 = top-left, 1 = top-right, 2 = bottom-left, 3 = bottom-right
+    uint c = i.vid & 3;
+    VSOut o;
+    o.pos = mul(float4(i.pos, 1.0f), mvp);
+    o.corner = float2(float(c & 1) * 2.0f - 1.0f, 1.0f - float(c >> 1) * 2.0f);
+    o.color = i.color;
+    return o;
+}
+
+float4 PSParticle(VSOut i) : SV_Target
+{
+    // Soft round sprite: coverage falls off to 0 at the quad's inscribed circle
+    float falloff = saturate(1.0f - dot(i.corner, i.corner));
+    return float4(i.color.rgb, i.color.a * falloff * falloff);
+}
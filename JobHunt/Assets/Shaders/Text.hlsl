@@ -0,0 +1,50 @@
+// Text.hlsl - Overlay text: one instanced quad per glyph, sampled from the glyph atlas (see Text.h).
+#pragma pack_matrix(column_major)
+
+cbuffer SceneCB : register(b0)
+{
+    float4x4 mvp;      // pixel-space ortho
+    float3 lightDir;   // unused here
+    float _pad0;
+
+    float2 viewport;
+    float thicknessPx;
+    float _pad1;
+
+    float4x4 lightVP;  // unused here
+};
+
+Texture2D<float> GlyphAtlas : register(t1);
+
+struct GlyphIn
+{
+    float4 rect : POSITION;    // x, y, w, h in pixels
+    uint4 atlasRect : TEXCOORD0; // u, v, w, h in texels
+    float4 color : COLOR0;
+    uint vid : SV_VertexID;
+};
+
+struct VSOut
+{
+    float4 pos : SV_POSITION;
+    float2 uv : TEXCOORD0;     // texels, not normalised
+    float4 color : COLOR0;
+};
+
+VSOut VSText(GlyphIn i)
+{
+    // Triangle strip: 0 = top-left, 1 = top-right, 2 = bottom-left, 3 = bottom-right
+    float2 corner = float2(i.vid & 1, i.vid >> 1);
+    VSOut o;
+    o.pos = mul(float4(i.rect.xy + corner * i.rect.zw, 0.0f, 1.0f), mvp);
+    o.uv = float2(i.atlasRect.xy) + corner * float2(i.atlasRect.zw);
+    o.color = i.color;
+    return o;
+}
+
+float4 PSText(VSOut i) : SV_Target
+{
+    // Pixel font: nearest texel, no filtering
+    float coverage = GlyphAtlas.Load(int3(int2(i.uv), 0));
+    return float4(i.color.rgb, i.color.a * coverage);
+}
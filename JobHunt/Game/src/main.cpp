@@ -3,8 +3,15 @@
 #include <string>
 #include <chrono>
 #include <thread>
+#include <cstdlib>
+#include <cwchar>
+#include <filesystem>
+#include <vector>
 #include "GraphicsEngine.h"
 #include "Renderer.h"
+#include "Core/Profiler.h"
+#include "Scene/EntityWorld.h"
+#include "Physics.h"
 
 using namespace GraphicsEngine;
 
@@ -38,11 +45,44 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow) {
         return -1;
     }
 
+    // --record <file> captures this session's input; --replay <file> [--fixed-dt <s>] plays one
+    // back from the same start state and exits at its end (frame_stats.* are written on shutdown)
+    std::wstring recordPath, replayPath;
+    float fixedDt = 0.0f;
+    for (int i = 1; i + 1 < __argc; i++) {
+        if (!wcscmp(__wargv[i], L"--record"))        recordPath = __wargv[++i];
+        else if (!wcscmp(__wargv[i], L"--replay"))   replayPath = __wargv[++i];
+        else if (!wcscmp(__wargv[i], L"--fixed-dt")) fixedDt = (float)_wtof(__wargv[++i]);
+    }
+    auto narrow = [](const std::wstring& w) { return std::filesystem::path(w).string(); };
+    if (!replayPath.empty() && !gRenderer->StartInputReplay(narrow(replayPath), fixedDt)) {
+        MessageBoxW(nullptr, (L"Cannot read input recording " + replayPath).c_str(), L"Error", MB_ICONERROR);
+        replayPath.clear();
+    }
+    else if (replayPath.empty() && !recordPath.empty()) {
+        gRenderer->StartInputRecording();
+    }
+
+    // Physics bodies live in the physics engine; scene entities with a PhysicsBody point at one
+    // and take its position after every step; their render proxies hear about it only when they move.
+    std::vector<PhysicsEngine::World> bodies(1);
+    bodies[0].x = 3.0f;
+    bodies[0].y = 5.0f;
+    EntityWorld& scene = gRenderer->GetScene();
+    RenderCommandQueue& renderQueue = gRenderer->GetRenderQueue();
+    {
+        const Transform t{ { 3.0f, 5.0f, 0.0f }, 0.0f, { 0.5f, 0.5f, 0.5f } };
+        RenderProxyDesc proxy;
+        proxy.world = TransformMatrix(t);
+        scene.Create(t, MeshInstance{}, PhysicsBody{ 0 }, RenderProxy{ renderQueue.Create(proxy) });
+    }
+
     auto prevUpdate = std::chrono::high_resolution_clock::now();
     MSG msg{};
     bool running = true;
 
     while (running) {
+        PROFILE_FRAME();
         while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
             if (msg.message == WM_QUIT) {
                 running = false;
@@ -58,12 +98,35 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow) {
         std::chrono::duration<double> dtUpdate = nowUpdate - prevUpdate;
         prevUpdate = nowUpdate;
 
+        {
+            // Replays step physics with the frame's recorded (or fixed) dt, like the renderer's Update
+            PROFILE_SCOPE("Physics::Step");
+            const float stepDt = gRenderer->InputFrameDt((float)dtUpdate.count());
+            for (PhysicsEngine::World& b : bodies) b.Step(stepDt);
+        }
+        {
+            PROFILE_SCOPE("Physics::Sync");
+            scene.ForEachChunk<Transform, const PhysicsBody, const RenderProxy>([&](uint32_t n, const Entity*, Transform* t, const PhysicsBody* pb, const RenderProxy* rp) {
+                for (uint32_t i = 0; i < n; i++) {
+                    const PhysicsEngine::World& b = bodies[pb[i].body];
+                    const float3 p{ b.x, b.y, b.z };
+                    if (p.x == t[i].position.x && p.y == t[i].position.y && p.z == t[i].position.z) continue;   // at rest
+                    t[i].position = p;
+                    renderQueue.SetTransform(rp[i].id, TransformMatrix(t[i]));
+                }
+            });
+        }
         gRenderer->Update((float)dtUpdate.count());
         gRenderer->Render();
 
+        if (!replayPath.empty() && gRenderer->InputReplayFinished()) break;
+
         std::this_thread::yield();
     }
 
+    if (replayPath.empty() && !recordPath.empty())
+        gRenderer->StopInputRecording(narrow(recordPath));
+
     gRenderer->Shutdown();
     DestroyRenderer(gRenderer);
     gRenderer = nullptr;
@@ -0,0 +1,82 @@
+#pragma once
+#include "Export.h"
+#include "Animation/Pose.h"
+#include <cstdint>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// Unit quaternion in 48 bits, "smallest three": the index of the largest component (2 bits, it is
+// rebuilt from the unit length and kept positive, since q and -q are the same rotation) and the
+// other three in [-1/sqrt2, 1/sqrt2] at 15 bits each. Worst case about 1e-4 rad.
+struct PackedQuat { uint16_t v[3]; };
+GRAPHICS_API PackedQuat PackQuat48(const quat& q);
+GRAPHICS_API quat       UnpackQuat48(const PackedQuat& p);
+
+// Source data, as imported: every joint at every frame, [frame * jointCount + joint]
+struct RawClip {
+    float                       sampleRate = 30.0f;
+    uint32_t                    frameCount = 0;
+    uint32_t                    jointCount = 0;
+    std::vector<JointTransform> samples;
+};
+
+// Per-track error bounds for Compress; the measured error includes quantization
+struct ClipCompression {
+    float rotationTolerance = 0.001f;      // radians
+    float translationTolerance = 0.0005f;  // model units
+};
+
+struct TrackError {
+    float    rotation = 0;       // max angle between the compressed and the source track, radians
+    float    translation = 0;    // max distance
+    uint32_t rotationKeys = 0;
+    uint32_t translationKeys = 0;
+};
+
+// A compressed clip: per joint, a rotation and a translation track, each reduced to the keys that
+// linear interpolation needs to stay inside the tolerance (constant tracks keep one) and quantized:
+// rotations to PackedQuat, translations to 16 bits per component over the track's range. Keys
+// stay on source frame numbers, so each track carries its own uint16 key times.
+class GRAPHICS_API AnimationClip {
+public:
+    static AnimationClip Compress(const RawClip& raw, const ClipCompression& settings = {},
+                                  std::vector<TrackError>* errors = nullptr);
+
+    // All joints at `time` (seconds), four at a time; looping wraps time into the clip, otherwise
+    // it clamps. Scale is not animated (see LocalToModel).
+    void           Sample(float time, Pose& out, bool loop = true) const;
+    // One joint, scalar: the reference for Sample, and enough for e.g. root motion
+    JointTransform SampleJoint(uint32_t joint, float time, bool loop = true) const;
+
+    uint32_t JointCount() const { return m_jointCount; }
+    uint32_t FrameCount() const { return m_frameCount; }
+    float    Duration() const { return m_frameCount > 1 ? float(m_frameCount - 1) / m_sampleRate : 0.0f; }
+    size_t   SizeBytes() const;
+
+private:
+    struct Track {
+        uint32_t firstKey = 0;
+        uint32_t keyCount = 0;
+    };
+    struct PackedVec3 { uint16_t v[3]; };
+    struct Range { float3 min, extent; };
+
+    static float3 UnpackTranslation(const Range& range, const PackedVec3& p);
+    float3 Translation(uint32_t joint, uint32_t key) const { return UnpackTranslation(m_transRanges[joint], m_transKeys[key]); }
+    float  FrameAt(float time, bool loop) const;
+
+    float                   m_sampleRate = 30.0f;
+    uint32_t                m_frameCount = 0;
+    uint32_t                m_jointCount = 0;
+
+    std::vector<Track>      m_rotTracks;
+    std::vector<uint16_t>   m_rotFrames;      // key times, per track contiguous
+    std::vector<PackedQuat> m_rotKeys;
+    std::vector<Track>      m_transTracks;
+    std::vector<uint16_t>   m_transFrames;
+    std::vector<PackedVec3> m_transKeys;
+    std::vector<Range>      m_transRanges;    // per track
+};
+
+}
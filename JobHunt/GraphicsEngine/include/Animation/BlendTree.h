@@ -0,0 +1,48 @@
+#pragma once
+#include "Export.h"
+#include "Animation/AnimationClip.h"
+#include "Animation/Pose.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// Flat blend tree: nodes are added children first and the last one is the root. Clip times and
+// blend weights are read from a per-character parameter array, so one tree (and one set of clips)
+// serves every character that uses it.
+class GRAPHICS_API BlendTree {
+public:
+    enum class NodeType : uint8_t { Clip, Blend };
+
+    struct Node {
+        NodeType type = NodeType::Clip;
+        uint32_t clip = 0;      // Clip: index into the clip set
+        uint32_t param = 0;     // Clip: playback time in seconds; Blend: weight of b
+        uint32_t a = 0, b = 0;  // Blend: children
+        uint32_t scratch = 0;   // scratch poses this subtree needs
+    };
+
+    // Both return the node index
+    uint32_t AddClip(uint32_t clip, uint32_t timeParam);
+    uint32_t AddBlend(uint32_t a, uint32_t b, uint32_t weightParam);
+
+    uint32_t NodeCount() const { return (uint32_t)m_nodes.size(); }
+    uint32_t ParamCount() const { return m_paramCount; }
+    const Node& GetNode(uint32_t i) const { return m_nodes[i]; }
+
+    // Intermediate poses; one per thread, reused across characters
+    struct Context { std::vector<Pose> scratch; };
+
+    // Blend weights at 0 or 1 evaluate only the side that counts
+    void Evaluate(std::span<const AnimationClip> clips, std::span<const float> params, Pose& out, Context& ctx) const;
+
+private:
+    void EvaluateNode(uint32_t node, std::span<const AnimationClip> clips, std::span<const float> params,
+                      Pose& out, Context& ctx, uint32_t depth) const;
+
+    std::vector<Node> m_nodes;
+    uint32_t          m_paramCount = 0;
+};
+
+}
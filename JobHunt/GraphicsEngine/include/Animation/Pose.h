@@ -0,0 +1,81 @@
+#pragma once
+#include "Export.h"
+#include "SolMath.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// Local (parent-relative) transform of one joint
+struct JointTransform {
+    quat   rotation;
+    float3 translation;
+    float3 scale{ 1, 1, 1 };
+};
+
+// Flattened hierarchy: joints are ordered so every parent comes before its children
+// (parents[i] < i, -1 for roots), which turns local-to-model into one forward pass.
+struct Skeleton {
+    std::vector<int16_t>        parents;
+    std::vector<JointTransform> bindPose;   // local; also the source of the (unanimated) scale
+
+    uint32_t JointCount() const { return (uint32_t)parents.size(); }
+    bool     IsFlattened() const
+    {
+        for (size_t i = 0; i < parents.size(); i++)
+            if (parents[i] >= int16_t(i)) return false;
+        return true;
+    }
+};
+
+// Four joints per block, component-major inside it, so sampling and blending handle four joints
+// per SIMD op. Rotation and translation only: clips do not animate scale.
+struct alignas(16) JointBlock {
+    float qx[4], qy[4], qz[4], qw[4];
+    float tx[4], ty[4], tz[4];
+};
+
+struct Pose {
+    std::vector<JointBlock> blocks;
+    uint32_t                jointCount = 0;
+
+    void Resize(uint32_t joints)
+    {
+        jointCount = joints;
+        blocks.resize((joints + 3) / 4);
+        // Padding lanes hold identity, so the SIMD paths never normalize a zero quaternion
+        for (uint32_t j = joints; j < uint32_t(blocks.size()) * 4; j++) Set(j, q_identity(), {});
+    }
+    void Set(uint32_t joint, const quat& r, const float3& t)
+    {
+        JointBlock& b = blocks[joint >> 2];
+        const uint32_t l = joint & 3;
+        b.qx[l] = r.x; b.qy[l] = r.y; b.qz[l] = r.z; b.qw[l] = r.w;
+        b.tx[l] = t.x; b.ty[l] = t.y; b.tz[l] = t.z;
+    }
+    quat Rotation(uint32_t joint) const
+    {
+        const JointBlock& b = blocks[joint >> 2];
+        const uint32_t l = joint & 3;
+        return { b.qx[l], b.qy[l], b.qz[l], b.qw[l] };
+    }
+    float3 Translation(uint32_t joint) const
+    {
+        const JointBlock& b = blocks[joint >> 2];
+        const uint32_t l = joint & 3;
+        return { b.tx[l], b.ty[l], b.tz[l] };
+    }
+};
+
+GRAPHICS_API void BindPose(const Skeleton& skeleton, Pose& out);
+
+// out = a..b by `weight` (q_nlerp on rotations, lerp on translations); out may alias a or b
+GRAPHICS_API void BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out);
+
+// Model-space joint matrices (row vectors: model[j] = local[j] * model[parent]), scale from the
+// bind pose. `root` places the whole skeleton; model must hold JointCount() matrices.
+GRAPHICS_API void LocalToModel(const Skeleton& skeleton, const Pose& pose, std::span<float4x4> model,
+                               const float4x4& root = m_identity());
+
+}
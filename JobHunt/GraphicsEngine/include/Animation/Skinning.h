@@ -0,0 +1,56 @@
+#pragma once
+#include "Export.h"
+#include "SolMath.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace GraphicsEngine {
+
+// Up to four joints per vertex; weights sum to 1, unused slots have weight 0 (any valid joint)
+struct SkinInfluence {
+    uint16_t joints[4];
+    float    weights[4];
+};
+
+// Bind-pose streams. Positions and normals are float3 at any stride, so they can be read out of an
+// interleaved vertex (VertexPNC) as well as a packed array; normals may be null.
+struct SkinSource {
+    const std::byte*     positions = nullptr;
+    uint32_t             positionStride = sizeof(float3);
+    const std::byte*     normals = nullptr;
+    uint32_t             normalStride = sizeof(float3);
+    const SkinInfluence* influences = nullptr;
+    uint32_t             vertexCount = 0;
+};
+
+// Where skinned vertices go, same rules: e.g. straight into an upload-ring allocation in the
+// renderer's vertex layout, or a packed position array for physics. Null normals are skipped.
+struct SkinTarget {
+    std::byte* positions = nullptr;
+    uint32_t   positionStride = sizeof(float3);
+    std::byte* normals = nullptr;
+    uint32_t   normalStride = sizeof(float3);
+};
+
+enum class SkinPath : uint8_t { Scalar, Avx2 };
+
+// Avx2 when this build and CPU support AVX2 + FMA, else Scalar
+GRAPHICS_API SkinPath BestSkinPath();
+
+// palette[j] = inverseBind[j] * model[j]: bind-pose model space to posed model space
+GRAPHICS_API void BuildSkinMatrices(std::span<const float4x4> model, std::span<const float4x4> inverseBind,
+                                    std::span<float4x4> palette);
+// The rigid part of each palette matrix, for SkinDualQuat (skinning joints are not scaled)
+GRAPHICS_API void BuildSkinDualQuats(std::span<const float4x4> palette, std::span<dualquat> out);
+
+// Vertices [first, first + count): linear blend of the palette matrices per vertex. Ranges are
+// independent, so callers split big meshes over the job system. Normals are renormalized.
+GRAPHICS_API void SkinLinear(const SkinSource& src, std::span<const float4x4> palette, const SkinTarget& dst,
+                             uint32_t first, uint32_t count, SkinPath path = BestSkinPath());
+// Same, blending dual quaternions (shortest path to the first influence, then normalized): no
+// candy-wrapper collapse on twisting joints, for a little more math per vertex
+GRAPHICS_API void SkinDualQuat(const SkinSource& src, std::span<const dualquat> palette, const SkinTarget& dst,
+                               uint32_t first, uint32_t count, SkinPath path = BestSkinPath());
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "Core/JobSystem.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GraphicsEngine {
+
+using StreamHandle = uint32_t;                  // 0 = invalid
+static constexpr StreamHandle kInvalidStream = 0;
+
+// Lower = sooner. Visible requests win over hidden ones at up to 4x the distance.
+inline float StreamPriority(float distance, bool visible) { return distance * (visible ? 1.0f : 4.0f); }
+
+enum class StreamState : uint8_t { Pending, Reading, Processing, Ready, Resident, Cancelled, Failed };
+
+struct StreamRequestDesc {
+    uint32_t file = 0;               // from AssetStreamer::OpenFile
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    float    priority = 0.0f;
+    // Optional CPU stage on the job system (decompression, transcoding); returns false on corrupt data.
+    std::function<bool(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& out)> process;
+    // Main-thread upload, called from PumpUploads within the frame budget.
+    std::function<void(const uint8_t* data, size_t size)> upload;
+};
+
+struct StreamerDesc {
+    uint32_t batchSize = 16;                 // requests taken per I/O batch
+    uint32_t coalesceGap = 64 * 1024;        // adjacent reads closer than this become one read
+    uint64_t maxInFlightBytes = 64u << 20;   // read + processed but not yet uploaded
+};
+
+struct StreamStats {
+    uint64_t requested = 0, resident = 0, cancelled = 0, failed = 0;
+    uint64_t bytesRead = 0, readCalls = 0;
+    double   ioBusySeconds = 0.0;            // time the I/O thread spent inside reads
+    double   latencyAvgMs = 0.0, latencyP95Ms = 0.0, latencyMaxMs = 0.0;   // request -> resident
+    double   MBps() const { return ioBusySeconds > 0.0 ? double(bytesRead) / 1048576.0 / ioBusySeconds : 0.0; }
+};
+
+// Asynchronous file streaming: one I/O thread reads the most urgent requests in batches
+// (sorted and coalesced by offset, positional reads), optional processing runs on the job
+// system, and the main thread pulls finished payloads through a per-frame byte budget.
+class AssetStreamer {
+public:
+    explicit AssetStreamer(JobSystem* jobs = nullptr, const StreamerDesc& desc = {});
+    ~AssetStreamer();
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+    uint32_t     OpenFile(const std::string& path);   // 0 on failure
+    StreamHandle Request(StreamRequestDesc desc);
+    void         SetPriority(StreamHandle h, float priority);
+    void         Cancel(StreamHandle h);              // payload is dropped wherever it is in the pipeline
+    StreamState  GetState(StreamHandle h) const;
+
+    // Runs upload callbacks for ready requests (most urgent first) until byteBudget is used;
+    // at least one request is uploaded per call so huge assets cannot starve. Returns bytes uploaded.
+    uint64_t PumpUploads(uint64_t byteBudget);
+
+    // Blocks until nothing is reading or processing and no pending request can start (tools, tests,
+    // loading screens). Requests held back by maxInFlightBytes wait for PumpUploads and do not
+    // count, so callers that queue more than that pump and wait again until everything is resident.
+    void WaitIdle();
+    StreamStats GetStats() const;
+
+private:
+    struct Entry;
+    struct File;
+
+    void IoLoop();
+    void ReadBatch(std::vector<Entry*>& batch);
+    void Finish(Entry* r, StreamState state);
+    Entry* Lookup(StreamHandle h) const;
+    bool   Idle() const;
+
+    JobSystem*                             m_jobs;
+    JobCounter                             m_jobCounter;  // processing jobs
+    StreamerDesc                           m_desc;
+    std::vector<std::unique_ptr<File>>     m_files;
+
+    mutable std::mutex                     m_mutex;
+    std::condition_variable                m_wake;        // I/O thread
+    std::condition_variable                m_idle;        // WaitIdle
+    std::vector<std::unique_ptr<Entry>>    m_requests;    // indexed by handle slot
+    std::vector<uint32_t>                  m_freeSlots;
+    std::vector<Entry*>                    m_pending;
+    std::vector<Entry*>                    m_ready;
+    uint32_t                               m_busy = 0;    // reading + processing
+    uint64_t                               m_inFlightBytes = 0;
+    bool                                   m_quit = false;
+
+    StreamStats                            m_stats;
+    std::vector<float>                     m_latencies;   // ms, last 4096
+    uint32_t                               m_latencyHead = 0;
+
+    std::thread                            m_io;
+};
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GraphicsEngine {
+
+class JobSystem;
+
+// ----------------------------------------------------------------------------
+// LZ4 block format (token / literals / 16-bit offset / match length), implemented in-tree.
+// Compression is greedy with a 64K-entry hash table; decompression is bounds-checked and
+// fails cleanly on corrupt input instead of reading or writing out of range.
+// ----------------------------------------------------------------------------
+size_t Lz4CompressBound(size_t srcSize);
+// Returns the compressed size, 0 if dst is too small.
+size_t Lz4Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+// dstSize must be the exact decompressed size.
+bool   Lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+// ----------------------------------------------------------------------------
+// Block stream: the input split into independent blocks so they decode in parallel or one
+// at a time straight into their destination (e.g. upload-ring memory).
+//   BlockStreamHeader | uint32 compressedBytes[blockCount] | block data
+// A block whose compressedBytes equals its raw size is stored uncompressed.
+// ----------------------------------------------------------------------------
+static constexpr uint32_t kCompressBlockSize = 256 * 1024;
+
+struct BlockStreamHeader {
+    char     magic[4] = { 'G','E','L','Z' };
+    uint32_t blockSize = kCompressBlockSize;
+    uint64_t rawBytes = 0;
+    uint32_t blockCount = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(BlockStreamHeader) == 24, "BlockStreamHeader layout is part of the file format");
+
+// Appends the block stream for src to out. Blocks are compressed in parallel when jobs is set.
+void CompressBlocks(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& out,
+                    JobSystem* jobs = nullptr, uint32_t blockSize = kCompressBlockSize);
+
+class BlockStreamReader {
+public:
+    // Validates the header and block table; the stream memory must outlive the reader.
+    bool Open(const uint8_t* stream, size_t size);
+
+    uint64_t RawSize() const    { return m_header ? m_header->rawBytes : 0; }
+    uint32_t BlockCount() const { return m_header ? m_header->blockCount : 0; }
+    uint32_t BlockSize() const  { return m_header ? m_header->blockSize : 0; }
+    size_t   BlockRawBytes(uint32_t block) const;
+
+    // dst must hold BlockRawBytes(block); block b lands at b * BlockSize() of the raw data.
+    bool DecodeBlock(uint32_t block, uint8_t* dst) const;
+    // dst must hold RawSize(); blocks are spread over the job system when set.
+    bool DecodeAll(uint8_t* dst, JobSystem* jobs = nullptr) const;
+
+private:
+    const BlockStreamHeader* m_header = nullptr;
+    const uint32_t*          m_sizes = nullptr;
+    std::vector<uint64_t>    m_offsets;    // block start, from the stream start
+};
+
+}
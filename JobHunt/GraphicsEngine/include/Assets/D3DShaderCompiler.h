@@ -0,0 +1,14 @@
+#pragma once
+#include "Assets/ShaderCache.h"
+
+namespace GraphicsEngine {
+
+// D3DCompile back end for the shader cache and the offline permutation build; includes resolve
+// relative to the source file. Windows only (links d3dcompiler).
+class D3DShaderCompiler final : public ShaderCompiler {
+public:
+    std::string Version() const override;
+    bool Compile(const ShaderDesc& desc, const std::string& source, std::vector<uint8_t>& bytecode, std::string& errors) override;
+};
+
+}
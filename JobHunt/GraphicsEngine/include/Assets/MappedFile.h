@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+
+// Read-only memory mapping of a whole file. Pages are faulted in on first touch,
+// so opening is O(1) and only the parts actually read count towards the working set.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& o) noexcept { *this = static_cast<MappedFile&&>(o); }
+    MappedFile& operator=(MappedFile&& o) noexcept;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool           IsOpen() const { return m_data != nullptr; }
+    const uint8_t* Data() const { return m_data; }
+    size_t         Size() const { return m_size; }
+
+private:
+#if defined(_WIN32)
+    void*          m_file = nullptr;       // HANDLE
+    void*          m_mapping = nullptr;    // HANDLE
+#else
+    int            m_fd = -1;
+#endif
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+};
+
+}
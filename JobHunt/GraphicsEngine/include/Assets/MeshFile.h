@@ -0,0 +1,130 @@
+#pragma once
+#include "SolMath.h"
+#include "Geometry.h"
+#include "Assets/MappedFile.h"
+#include "Assets/Compression.h"
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+
+class JobSystem;
+
+// ----------------------------------------------------------------------------
+// Binary mesh container (.gemesh), little endian:
+//   MeshFileHeader | MeshSectionEntry[sectionCount] | sections (each kMeshSectionAlign aligned)
+// Uncompressed sections hold the in-memory structs verbatim, so a mapped file is used in place with
+// no parsing. Compressed sections are LZ4 block streams (Assets/Compression.h) decoded on load.
+// ----------------------------------------------------------------------------
+static constexpr uint32_t kMeshFileVersion  = 2;
+static constexpr uint32_t kMeshSectionAlign = 64;
+
+enum class MeshSection : uint32_t {
+    Vertices = 1,          // VertexPNC
+    Indices,               // uint32_t, LOD 0 followed by coarser LODs
+    Lods,                  // MeshLod
+    Meshlets,              // Meshlet (LOD 0)
+    MeshletBounds,         // MeshletBounds
+    MeshletVertices,       // uint32_t
+    MeshletTriangles,      // uint8_t
+    MeshletIndices,        // uint32_t
+};
+
+enum class MeshCodec : uint32_t {
+    None = 0,
+    Lz4Blocks,             // BlockStreamHeader + independent LZ4 blocks
+};
+
+struct MeshFileHeader {
+    char     magic[4] = { 'G','E','M','S' };
+    uint32_t version = kMeshFileVersion;
+    uint32_t sectionCount = 0;
+    uint32_t headerBytes = 0;    // header + section table, sections start after this
+    AABB_t   bounds{};
+    uint32_t reserved[6] = {};
+};
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader layout is part of the file format");
+
+struct MeshSectionEntry {
+    MeshSection type;
+    uint32_t    stride;      // element size, checked against the reader's type
+    uint64_t    offset;      // from file start
+    uint64_t    bytes;       // stored bytes
+    uint64_t    rawBytes;    // decoded bytes (== bytes when uncompressed)
+    MeshCodec   codec;
+    uint32_t    reserved;
+};
+static_assert(sizeof(MeshSectionEntry) == 40, "MeshSectionEntry layout is part of the file format");
+
+// Index range of one LOD inside the Indices section; error = world-space simplification cell size.
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float    error = 0.0f;
+    uint32_t reserved = 0;
+};
+
+// Source data for WriteMeshFile (empty vectors are simply not emitted).
+struct MeshData {
+    std::vector<VertexPNC> vertices;
+    std::vector<uint32_t>  indices;
+    std::vector<MeshLod>   lods;
+    MeshletMesh            meshlets;
+    AABB_t                 bounds{};
+};
+
+struct MeshWriteOptions {
+    bool       compress = false;    // sections that do not shrink are still stored raw
+    JobSystem* jobs = nullptr;      // parallel block compression
+};
+
+bool WriteMeshFile(const std::string& path, const MeshData& mesh, const MeshWriteOptions& options = {});
+AABB_t ComputeMeshBounds(const std::vector<VertexPNC>& vertices);
+
+// Zero-copy reader: Open maps the file and validates the section table; the typed accessors
+// return views into the mapping, valid until Close (empty for compressed sections, which are
+// decoded with ReadSection or block by block through OpenBlockStream).
+class MeshFile {
+public:
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_header != nullptr; }
+
+    const MeshFileHeader& GetHeader() const { return *m_header; }
+    std::span<const uint8_t> GetSection(MeshSection type) const;   // stored bytes
+    uint64_t GetSectionRawSize(MeshSection type) const;
+    bool     IsCompressed(MeshSection type) const;
+
+    // Decodes (or copies) a whole section; dstSize must be GetSectionRawSize(type).
+    bool ReadSection(MeshSection type, void* dst, size_t dstSize, JobSystem* jobs = nullptr) const;
+    // Per-block access for streaming decode straight into upload memory; false if uncompressed.
+    bool OpenBlockStream(MeshSection type, BlockStreamReader& reader) const;
+
+    std::span<const VertexPNC>     Vertices() const         { return Typed<VertexPNC>(MeshSection::Vertices); }
+    std::span<const uint32_t>      Indices() const          { return Typed<uint32_t>(MeshSection::Indices); }
+    std::span<const MeshLod>       Lods() const             { return Typed<MeshLod>(MeshSection::Lods); }
+    std::span<const Meshlet>       Meshlets() const         { return Typed<Meshlet>(MeshSection::Meshlets); }
+    std::span<const MeshletBounds> MeshletBoundsData() const{ return Typed<MeshletBounds>(MeshSection::MeshletBounds); }
+    std::span<const uint32_t>      MeshletVertices() const  { return Typed<uint32_t>(MeshSection::MeshletVertices); }
+    std::span<const uint8_t>       MeshletTriangles() const { return Typed<uint8_t>(MeshSection::MeshletTriangles); }
+    std::span<const uint32_t>      MeshletIndices() const   { return Typed<uint32_t>(MeshSection::MeshletIndices); }
+
+private:
+    const MeshSectionEntry* Find(MeshSection type) const;
+
+    template<class T>
+    std::span<const T> Typed(MeshSection type) const
+    {
+        const MeshSectionEntry* e = Find(type);
+        if (!e || e->stride != sizeof(T) || e->codec != MeshCodec::None) return {};
+        return { reinterpret_cast<const T*>(m_map.Data() + e->offset), size_t(e->bytes / sizeof(T)) };
+    }
+
+    MappedFile              m_map;
+    const MeshFileHeader*   m_header = nullptr;
+    const MeshSectionEntry* m_table = nullptr;
+};
+
+}
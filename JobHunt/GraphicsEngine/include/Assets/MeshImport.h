@@ -0,0 +1,48 @@
+#pragma once
+#include "SolMath.h"
+#include "Geometry.h"
+#include "Memory/LinearArena.h"
+#include <string>
+#include <cstdint>
+
+namespace GraphicsEngine {
+
+class JobSystem;
+
+// Importer output. Both streams live in the caller's arena and stay valid until it is Reset.
+struct ImportedMesh {
+    VertexPNC* vertices = nullptr;
+    uint32_t*  indices = nullptr;
+    uint32_t   vertexCount = 0;
+    uint32_t   indexCount = 0;
+    AABB_t     bounds{};
+};
+
+struct ImportOptions {
+    bool   convertHandedness = true;     // OBJ / glTF are right-handed: mirror Z and flip winding for the LH engine
+    float  scale = 1.0f;
+    float3 defaultColor{ 0.8f, 0.8f, 0.8f };
+};
+
+struct ImportStats {
+    size_t   bytes = 0;          // text / JSON + binary bytes read
+    double   parseSeconds = 0.0; // tokenising + numeric conversion
+    double   totalSeconds = 0.0; // including vertex assembly
+    uint32_t threads = 1;
+};
+
+// Wavefront OBJ (v / vn / f, polygons fan-triangulated, negative indices). The mapped file is split
+// into line-aligned chunks that are counted, then parsed in parallel into preallocated arrays.
+bool ImportObj(const std::string& path, LinearArena& arena, ImportedMesh& out,
+               JobSystem* jobs = nullptr, const ImportOptions& options = {}, ImportStats* stats = nullptr);
+
+// glTF 2.0 (.gltf with external / data-URI buffers, or .glb). Triangle primitives of the default
+// scene are flattened into one world-space stream; accessors are converted in parallel ranges.
+bool ImportGltf(const std::string& path, LinearArena& arena, ImportedMesh& out,
+                JobSystem* jobs = nullptr, const ImportOptions& options = {}, ImportStats* stats = nullptr);
+
+// Dispatches on the file extension.
+bool ImportMesh(const std::string& path, LinearArena& arena, ImportedMesh& out,
+                JobSystem* jobs = nullptr, const ImportOptions& options = {}, ImportStats* stats = nullptr);
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "Core/Hash.h"
+#include "Assets/MappedFile.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GraphicsEngine {
+
+struct ShaderDefine { std::string name, value; };
+
+struct ShaderDesc {
+    std::string               path;      // source file; #include "..." resolves relative to it
+    std::string               entry;
+    std::string               target;    // e.g. "vs_5_0"
+    std::vector<ShaderDefine> defines;
+    uint32_t                  flags = 0; // compiler flags, part of the key
+};
+
+// Back end of the cache. The engine uses D3DCompile; tools and tests can plug in a stub.
+class ShaderCompiler {
+public:
+    virtual ~ShaderCompiler() = default;
+    // Changes whenever output for the same input may change (compiler DLL, options); part of every key.
+    virtual std::string Version() const = 0;
+    virtual bool ReadFile(const std::string& path, std::string& out);
+    virtual bool Compile(const ShaderDesc& desc, const std::string& source,
+                         std::vector<uint8_t>& bytecode, std::string& errors) = 0;
+};
+
+// Content key of one compile: source text, every file it includes (recursively), defines, entry,
+// target, flags and the compiler version; the path itself is not part of it. Returns false if the
+// main file cannot be read (a missing include only contributes its name; the compiler reports it).
+// Stateless, so offline builders can key permutations from several threads.
+bool ShaderSourceKey(const ShaderDesc& desc, ShaderCompiler& compiler, Hash128& key, std::string* source = nullptr);
+
+struct ShaderCacheStats {
+    uint32_t hits = 0, misses = 0, stored = 0;
+    double   openSeconds = 0.0;      // mapping + table validation
+    double   keySeconds = 0.0;       // reading sources / includes and hashing
+    double   compileSeconds = 0.0;   // misses only
+};
+
+// ----------------------------------------------------------------------------
+// Content-addressed blob cache (shader bytecode, PSO driver blobs) on disk:
+//   ShaderCacheHeader | ShaderCacheEntry[entryCount] (sorted by key) | blobs (16-byte aligned)
+// The file is memory-mapped and served in place; new blobs are kept in memory until Save,
+// which rewrites the file (temp + rename) with old and new entries merged.
+// ----------------------------------------------------------------------------
+struct ShaderCacheHeader {
+    char     magic[4] = { 'G','E','S','C' };
+    uint32_t version = 1;
+    uint32_t entryCount = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(ShaderCacheHeader) == 16, "ShaderCacheHeader layout is part of the file format");
+
+struct ShaderCacheEntry {
+    Hash128  key;
+    uint64_t offset;
+    uint64_t size;
+};
+static_assert(sizeof(ShaderCacheEntry) == 32, "ShaderCacheEntry layout is part of the file format");
+
+class ShaderCache {
+public:
+    // A missing or invalid file is an empty cache, not an error.
+    void Open(const std::string& path);
+    bool Save();
+    void Close();
+
+    std::span<const uint8_t> Find(const Hash128& key) const;
+    void Store(const Hash128& key, const void* data, size_t size);
+
+    // ShaderSourceKey, timed into the stats
+    bool ShaderKey(const ShaderDesc& desc, ShaderCompiler& compiler, Hash128& key, std::string* source = nullptr);
+
+    // Cached bytecode or a fresh compile (stored for the next Save). The span stays valid
+    // until Save / Close.
+    bool GetShader(const ShaderDesc& desc, ShaderCompiler& compiler, std::span<const uint8_t>& bytecode,
+                   std::string* errors = nullptr);
+
+    const ShaderCacheStats& GetStats() const { return m_stats; }
+
+private:
+    std::string                 m_path;
+    MappedFile                  m_map;
+    const ShaderCacheEntry*     m_table = nullptr;
+    uint32_t                    m_entryCount = 0;
+    std::unordered_map<Hash128, std::vector<uint8_t>, Hash128Hasher> m_added;
+    ShaderCacheStats            m_stats;
+};
+
+}
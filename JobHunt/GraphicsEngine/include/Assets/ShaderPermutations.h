@@ -0,0 +1,132 @@
+#pragma once
+#include "Assets/MappedFile.h"
+#include "Assets/ShaderCache.h"
+#include "Core/Hash.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace GraphicsEngine {
+
+class JobSystem;
+
+// ----------------------------------------------------------------------------
+// Keywords: one bit per shader feature. A permutation is the OR of its enabled keywords; each
+// keyword reaches HLSL as a 0/1 define of the same name, so shaders test them with #if.
+// ----------------------------------------------------------------------------
+enum ShaderKeyword : uint32_t {
+    kKeywordLighting = 1u << 0,   // directional Lambert term
+    kKeywordShadows  = 1u << 1,   // shadow-map lookup (needs kKeywordLighting to show)
+    kKeywordAmbient  = 1u << 2,   // constant ambient floor
+    kKeywordInstanced = 1u << 3,  // world matrix from a per-instance stream (slot 1), for indirect draws
+};
+static constexpr uint32_t kShaderKeywordCount = 4;
+
+const char* ShaderKeywordName(uint32_t bit);          // nullptr for an unknown / multi-bit value
+uint32_t    ShaderKeywordBit(std::string_view name);  // 0 if unknown
+// "SHADOWS AMBIENT", "SHADOWS|AMBIENT" or "SHADOWS,AMBIENT"; false if any name is unknown
+bool        ParseShaderKeywords(std::string_view list, uint32_t& mask);
+std::string ShaderKeywordString(uint32_t mask);       // "LIGHTING|SHADOWS", "" for none
+
+enum class ShaderStage : uint32_t { Vertex, Pixel, Count };
+static constexpr uint32_t kShaderStageCount = uint32_t(ShaderStage::Count);
+
+// One source file and its entry points. `keywords` lists the features it responds to; the
+// permutations of a program are the subsets of that mask (others are folded onto it).
+struct ShaderProgramDesc {
+    std::string           name;
+    std::string           path;                        // relative to the shader directory
+    std::string           entry[kShaderStageCount];    // empty = stage unused
+    std::string           target[kShaderStageCount];
+    uint32_t              keywords = 0;
+    std::vector<uint32_t> variants;                    // permutations to build; empty = every subset
+};
+
+// The engine's programs, indexed by EngineShaderProgram; the offline compiler and the renderer
+// share this table.
+enum EngineShaderProgram : uint32_t { kProgramBasic, kProgramBasicLit, kProgramText, kProgramParticle, kEngineProgramCount };
+std::span<const ShaderProgramDesc> EngineShaderPrograms();
+
+// Dense index of a permutation within its program: the program's keyword bits packed together
+// (a software pext), so a program with n keywords has exactly 2^n slots.
+uint32_t PermutationIndex(uint32_t keywords, uint32_t programKeywords);
+uint32_t PermutationCount(uint32_t programKeywords);
+// Every program keyword, defined to 0 or 1
+std::vector<ShaderDefine> PermutationDefines(uint32_t keywords, uint32_t programKeywords);
+// What the compiler sees for one stage of one permutation; offline and runtime builds go through
+// this, so their ShaderSourceKey match for the same flags.
+ShaderDesc PermutationShaderDesc(const ShaderProgramDesc& program, uint32_t keywords, ShaderStage stage,
+                                 const std::string& shaderDir, uint32_t flags);
+
+// ----------------------------------------------------------------------------
+// Precompiled permutations on disk:
+//   ShaderArchiveHeader | ShaderArchiveProgram[programCount] | ShaderArchiveSlot[slotCount] | blobs
+// Program p owns slots [firstSlot, firstSlot + 2^popcount(keywords) * kShaderStageCount); the slot of
+// (permutation, stage) is firstSlot + PermutationIndex * kShaderStageCount + stage, so a lookup is
+// two loads and no search. size 0 = not built.
+// ----------------------------------------------------------------------------
+struct ShaderArchiveHeader {
+    char     magic[4] = { 'G','E','S','A' };
+    uint32_t version = 1;
+    uint32_t programCount = 0;
+    uint32_t slotCount = 0;
+};
+static_assert(sizeof(ShaderArchiveHeader) == 16, "ShaderArchiveHeader layout is part of the file format");
+
+struct ShaderArchiveProgram {
+    char     name[24];         // zero-padded
+    uint32_t keywords;
+    uint32_t firstSlot;
+};
+static_assert(sizeof(ShaderArchiveProgram) == 32, "ShaderArchiveProgram layout is part of the file format");
+
+struct ShaderArchiveSlot {
+    Hash128  key;              // ShaderSourceKey of the compile, lets the loader spot stale entries
+    uint64_t offset;
+    uint64_t size;
+};
+static_assert(sizeof(ShaderArchiveSlot) == 32, "ShaderArchiveSlot layout is part of the file format");
+
+using ShaderProgramId = uint32_t;
+static constexpr ShaderProgramId kInvalidShaderProgram = UINT32_MAX;
+
+class ShaderArchive {
+public:
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_map.IsOpen(); }
+
+    ShaderProgramId FindProgram(std::string_view name) const;   // linear; resolve once at load
+    uint32_t        ProgramKeywords(ShaderProgramId program) const { return m_programs[program].keywords; }
+
+    // Keywords outside the program's set are ignored. Empty span = not in the archive.
+    std::span<const uint8_t> Find(ShaderProgramId program, uint32_t keywords, ShaderStage stage,
+                                  Hash128* key = nullptr) const;
+
+    uint32_t GetProgramCount() const { return m_programCount; }
+
+private:
+    MappedFile                  m_map;
+    const ShaderArchiveProgram* m_programs = nullptr;
+    const ShaderArchiveSlot*    m_slots = nullptr;
+    uint32_t                    m_programCount = 0;
+};
+
+struct ShaderArchiveBuildStats {
+    uint32_t compiled = 0, reused = 0, failed = 0;
+    uint64_t bytes = 0;
+    double   keySeconds = 0.0, compileSeconds = 0.0, writeSeconds = 0.0;
+};
+
+// Compiles every requested permutation of `programs` in parallel (jobs may be null) and writes the
+// archive. With a cache, unchanged permutations are taken from it and new bytecode is stored
+// into it (the caller saves). Compiler errors are collected into `errors`; nothing is written if
+// any permutation fails.
+bool BuildShaderArchive(const std::string& outPath, std::span<const ShaderProgramDesc> programs,
+                        const std::string& shaderDir, uint32_t flags, ShaderCompiler& compiler,
+                        JobSystem* jobs, ShaderCache* cache, std::string& errors,
+                        ShaderArchiveBuildStats* stats = nullptr);
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "Assets/AssetStreamer.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace GraphicsEngine {
+
+using TextureId = uint32_t;
+static constexpr TextureId kInvalidTexture = UINT32_MAX;
+
+// One streamable texture. Mips are stored finest first and contiguous at dataOffset, so the
+// small always-resident tail (mips up to tailSize) is a single read at the end.
+struct StreamedTextureDesc {
+    uint32_t width = 0, height = 0;
+    uint32_t mipCount = 1;
+    uint32_t blockDim = 4;           // 4 for BCn, 1 for uncompressed
+    uint32_t blockBytes = 16;        // bytes per block (BC1 = 8, BC7 = 16, RGBA8 = 4 with blockDim 1)
+    uint32_t file = 0;               // AssetStreamer::OpenFile
+    uint64_t dataOffset = 0;
+};
+
+struct TextureStreamerDesc {
+    uint64_t budgetBytes = 256ull << 20;   // resident + in flight
+    uint32_t tailSize = 64;                // mips with max(w,h) <= tailSize are never evicted
+    uint32_t maxRequestsPerFrame = 32;
+    float    mipBias = 0.0f;               // > 0 trades sharpness for memory
+};
+
+struct TextureStreamerStats {
+    uint64_t residentBytes = 0, inFlightBytes = 0, peakBytes = 0;
+    uint64_t requests = 0, cancels = 0, evictions = 0;
+    uint32_t visible = 0;                  // textures reported this frame
+    uint32_t missingMips = 0;              // sum over visible textures of (resident - desired) mips
+};
+
+// Screen-space heuristics for the culling pass: the on-screen diameter of a bounding sphere and
+// the mip whose resolution matches it (texture assumed to span the object once).
+float    ProjectedScreenSize(float radius, float distance, float fovY, float viewportHeight);
+uint32_t DesiredMip(uint32_t width, uint32_t height, uint32_t mipCount, float screenPixels, float bias = 0.0f);
+
+// Mip residency manager. The culling pass reports visible textures each frame; Update derives the
+// wanted mip per texture, evicts under budget pressure (least recently used first, then lowest
+// priority) and requests the next finer mip through the AssetStreamer, one mip at a time.
+// Main-thread only: the streamer's PumpUploads delivers the loaded mips.
+class TextureStreamer {
+public:
+    // GPU side: copy a loaded mip range into the texture, or drop mips finer than newResidentMip.
+    using UploadFn = std::function<void(TextureId id, uint32_t firstMip, uint32_t mipCount, const uint8_t* data, size_t size)>;
+    using EvictFn  = std::function<void(TextureId id, uint32_t newResidentMip)>;
+
+    explicit TextureStreamer(AssetStreamer& streamer, const TextureStreamerDesc& desc = {});
+    ~TextureStreamer();
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    void      SetCallbacks(UploadFn upload, EvictFn evict) { m_upload = std::move(upload); m_evict = std::move(evict); }
+    void      SetBudget(uint64_t bytes) { m_desc.budgetBytes = bytes; }
+    TextureId Register(const StreamedTextureDesc& desc);
+
+    // Culling-pass feedback for this frame; several reports for one texture keep the finest.
+    void ReportUsage(TextureId id, float screenPixels, float distance);
+    // Once per frame after the reports: cancels, evicts and issues requests.
+    void Update();
+
+    uint32_t GetResidentMip(TextureId id) const { return m_textures[id].resident; }   // mipCount = nothing yet
+    uint32_t GetDesiredMip(TextureId id) const  { return m_textures[id].desired; }
+    uint64_t MipBytes(TextureId id, uint32_t mip) const;
+    const TextureStreamerStats& GetStats() const { return m_stats; }
+
+private:
+    struct Texture {
+        StreamedTextureDesc desc;
+        uint32_t     tailMip = 0;
+        uint32_t     resident = 0;          // finest resident mip
+        uint32_t     desired = 0;
+        uint32_t     reported = 0;          // finest mip reported this frame
+        uint32_t     requestedMip = 0;
+        StreamHandle request = kInvalidStream;
+        uint64_t     requestBytes = 0;
+        uint64_t     lastUsed = 0;          // frame of the last report
+        float        distance = 0.0f;
+    };
+
+    uint64_t RangeBytes(const Texture& t, uint32_t firstMip, uint32_t endMip) const;
+    void     Request(TextureId id, uint32_t firstMip, uint32_t endMip);
+    void     OnLoaded(TextureId id, uint32_t firstMip, uint32_t endMip, const uint8_t* data, size_t size);
+    void     CancelRequest(Texture& t);
+
+    AssetStreamer&           m_streamer;
+    TextureStreamerDesc      m_desc;
+    UploadFn                 m_upload;
+    EvictFn                  m_evict;
+    std::vector<Texture>     m_textures;
+    uint64_t                 m_frame = 1;
+    TextureStreamerStats     m_stats;
+};
+
+}
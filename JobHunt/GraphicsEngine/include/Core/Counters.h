@@ -0,0 +1,63 @@
+#pragma once
+#include "Export.h"
+#include <cstdint>
+
+namespace GraphicsEngine {
+
+// Every counter the engine keeps: X(id, display name, unit). Adding one here is all it takes; the
+// HUD, the profiler trace and the stats export pick it up from this list.
+#define GE_COUNTER_LIST(X)                          \
+    X(BoxesTested, "Boxes tested", "")              \
+    X(BoxesCulled, "Boxes culled", "")              \
+    X(DrawCalls,   "Draw calls",   "")              \
+    X(PsoSwitches, "PSO switches", "")              \
+    X(CbBytes,     "CB bytes",     "B")             \
+    X(UploadBytes, "Upload bytes", "B")             \
+    X(ProxyUpdates, "Proxy updates", "")            \
+    X(Particles,   "Particles",    "")
+
+enum class Counter : uint32_t {
+#define GE_COUNTER_ENUM(id, name, unit) id,
+    GE_COUNTER_LIST(GE_COUNTER_ENUM)
+#undef GE_COUNTER_ENUM
+    Count
+};
+
+static constexpr uint32_t kCounterCount = uint32_t(Counter::Count);
+
+struct CounterInfo {
+    const char* name;
+    const char* unit;    // "" for plain counts
+};
+
+inline constexpr CounterInfo kCounterInfo[kCounterCount] = {
+#define GE_COUNTER_INFO(id, name, unit) { name, unit },
+    GE_COUNTER_LIST(GE_COUNTER_INFO)
+#undef GE_COUNTER_INFO
+};
+
+// One frame's worth of every counter
+struct CounterFrame {
+    uint64_t values[kCounterCount] = {};
+
+    uint64_t operator[](Counter c) const { return values[uint32_t(c)]; }
+};
+
+// Hot-path counters. Add goes to the calling thread's own block of relaxed atomics (a plain load
+// and store: only the owner writes, so there is no lock prefix and no shared cache line), and
+// EndFrame sums the blocks once per frame. Callers on hot loops should still count locally and Add
+// once per batch.
+class GRAPHICS_API Counters {
+public:
+    static void Add(Counter c, uint64_t n = 1);
+
+    // Main thread, once per frame after the work being counted: the totals since the previous call
+    static const CounterFrame& EndFrame();
+    static const CounterFrame& LastFrame();
+    // Everything counted since start-up, as of the last EndFrame
+    static const CounterFrame& Totals();
+};
+
+}
+
+#define COUNTER_ADD(id, n) ::GraphicsEngine::Counters::Add(::GraphicsEngine::Counter::id, (n))
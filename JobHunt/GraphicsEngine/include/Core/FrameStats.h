@@ -0,0 +1,146 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// Log-linear latency histogram in the style of HdrHistogram: values below 2^kSubBits ns are exact,
+// above that every power of two is split into 2^(kSubBits-1) buckets, so any recorded value is
+// off by less than 1/64 (1.6 %). Record is O(1) with no allocation; percentiles walk the buckets.
+class LatencyHistogram {
+public:
+    static constexpr uint32_t kSubBits = 7;
+    static constexpr uint32_t kMaxBits = 40;    // ~18 minutes in ns; larger values clamp
+
+    LatencyHistogram();
+
+    void Record(uint64_t ns);
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    uint64_t Count() const { return m_count; }
+    uint64_t Min() const { return m_count ? m_min : 0; }
+    uint64_t Max() const { return m_max; }
+    uint64_t Sum() const { return m_sum; }
+    double   Mean() const { return m_count ? double(m_sum) / double(m_count) : 0.0; }
+    // p in [0, 100]; the midpoint of the bucket holding that rank, clamped to [Min, Max]
+    uint64_t Percentile(double p) const;
+
+    // Non-empty buckets as (representative value, count), ascending
+    template <typename Fn> void ForEachBucket(Fn&& fn) const
+    {
+        for (uint32_t i = 0; i < (uint32_t)m_counts.size(); i++)
+            if (m_counts[i]) fn(BucketValue(i), m_counts[i]);
+    }
+
+private:
+    static uint32_t BucketIndex(uint64_t ns);
+    static uint64_t BucketValue(uint32_t index);
+
+    std::vector<uint64_t> m_counts;
+    uint64_t              m_count = 0, m_sum = 0;
+    uint64_t              m_min = UINT64_MAX, m_max = 0;
+};
+
+struct StageSummary {
+    uint64_t count = 0;
+    double   minMs = 0, meanMs = 0, maxMs = 0;
+    double   p50Ms = 0, p95Ms = 0, p99Ms = 0, p999Ms = 0;
+};
+
+// Per-frame distribution of a counter (draw calls, bytes...), in the counter's own unit
+struct CounterSummary {
+    uint64_t frames = 0;
+    uint64_t min = 0, max = 0, total = 0;
+    double   mean = 0;
+    uint64_t p50 = 0, p95 = 0, p99 = 0;
+};
+
+struct StutterEvent {
+    uint64_t frame;
+    double   timeSec;    // since the first frame
+    double   ms, medianMs;
+};
+
+// Per-stage timing statistics for a whole run plus a rolling window (for the title bar / HUD).
+// Stage 0 is the frame interval; callers register the rest (update, render, passes...) and time
+// them with Scope or Record. Counters are per-frame values (see Core/Counters.h) kept alongside
+// the stages so one export holds both. A frame counts as a stutter when it takes more than StutterFactor
+// times the median of the last kRecentFrames frames.
+class FrameStats {
+public:
+    static constexpr uint32_t kFrameStage = 0;
+    static constexpr uint32_t kRecentFrames = 128;
+    static constexpr size_t   kMaxStutters = 4096;
+
+    FrameStats();
+
+    uint32_t AddStage(const char* name);   // string literal; returns the stage id
+
+    // Once per frame with the frame interval; does stutter detection
+    void RecordFrame(double seconds);
+    void Record(uint32_t stage, double seconds);
+
+    uint32_t AddCounter(const char* name, const char* unit = "");   // literals; returns the counter id
+    // Once per frame per counter with that frame's value
+    void     RecordCounter(uint32_t counter, uint64_t value);
+
+    struct Scope {
+        FrameStats& stats;
+        uint32_t    stage;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        Scope(FrameStats& s, uint32_t st) : stats(s), stage(st) {}
+        ~Scope() { stats.Record(stage, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count()); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    void   SetStutterFactor(double factor) { m_stutterFactor = factor; }
+    double StutterFactor() const { return m_stutterFactor; }
+
+    uint64_t     Frames() const { return m_frames; }
+    uint64_t     StutterCount() const { return m_stutterCount; }
+    StageSummary Summary(uint32_t stage) const;            // whole run
+    StageSummary WindowSummary(uint32_t stage) const;      // since the last ResetWindow
+    uint64_t     WindowStutters() const { return m_windowStutters; }
+    void         ResetWindow();
+    uint32_t     StageCount() const { return (uint32_t)m_stages.size(); }
+    const char*  StageName(uint32_t stage) const { return m_stages[stage].name; }
+    uint32_t       CounterCount() const { return (uint32_t)m_counters.size(); }
+    const char*    CounterName(uint32_t counter) const { return m_counters[counter].name; }
+    CounterSummary CounterStats(uint32_t counter) const;    // whole run
+    // Last kRecentFrames frame times in ms, oldest first
+    std::vector<float> RecentFrames() const;
+
+    void Reset();
+
+    // One row per stage: count, min, mean, percentiles and max in ms, then the stutter count.
+    // Counters follow after a blank line as a second table with its own header.
+    bool WriteCsv(const std::string& path) const;
+    // Summary, histograms (non-empty buckets), counters and stutters
+    bool WriteJson(const std::string& path) const;
+
+private:
+    struct Stage {
+        const char*      name;
+        LatencyHistogram total, window;
+    };
+
+    struct CounterTrack {
+        const char*      name;
+        const char*      unit;
+        LatencyHistogram values;   // not nanoseconds here, just the same log-linear buckets
+    };
+
+    std::vector<Stage>        m_stages;
+    std::vector<CounterTrack> m_counters;
+    std::vector<StutterEvent> m_stutters;
+    float                     m_recent[kRecentFrames] = {};
+    uint64_t                  m_frames = 0, m_stutterCount = 0, m_windowStutters = 0;
+    double                    m_elapsed = 0.0;
+    double                    m_stutterFactor = 2.0;
+};
+
+}
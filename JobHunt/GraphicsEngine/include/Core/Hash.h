@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace GraphicsEngine {
+
+struct Hash128 {
+    uint64_t lo = 0, hi = 0;
+    bool operator==(const Hash128& o) const { return lo == o.lo && hi == o.hi; }
+    bool operator!=(const Hash128& o) const { return !(*this == o); }
+    bool operator<(const Hash128& o) const  { return hi != o.hi ? hi < o.hi : lo < o.lo; }
+};
+
+struct Hash128Hasher {
+    size_t operator()(const Hash128& h) const { return size_t(h.lo ^ (h.hi * 0x9E3779B97F4A7C15ull)); }
+};
+
+// MurmurHash3 x64/128 (public-domain algorithm, implemented here). Not cryptographic; used for
+// content keys where a collision only costs a wrong cache hit in the same build.
+Hash128 HashBytes128(const void* data, size_t size, uint64_t seed = 0);
+// Checks HashBytes128 against reference MurmurHash3 x64/128 digests. Keys built from it are
+// persisted (shader cache, archives), so tools that write them check it first.
+bool VerifyHashBytes128();
+
+// Incremental key builder: each piece is hashed with the running state as seed, and its size
+// takes part, so ("ab","c") and ("a","bc") differ.
+class Hasher128 {
+public:
+    void Add(const void* data, size_t size) { m_state = HashBytes128(data, size, m_state.lo ^ (m_state.hi << 1) ^ size); }
+    void Add(std::string_view s)            { Add(s.data(), s.size()); }
+    void Add(const Hash128& h)              { Add(&h, sizeof(h)); }
+
+    template<class T>
+    void AddPod(const T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "AddPod hashes the object representation");
+        Add(&v, sizeof(T));
+    }
+
+    Hash128 Get() const { return m_state; }
+
+private:
+    Hash128 m_state{};
+};
+
+}
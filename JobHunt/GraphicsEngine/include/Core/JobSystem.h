@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// Completion counter for a group of jobs; Wait() on it from the submitting thread.
+struct JobCounter {
+    std::atomic<uint32_t> pending{ 0 };
+    bool Done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Fixed pool of worker threads fed from one FIFO. Waiting threads run queued jobs instead of
+// sleeping, so nested ParallelFor calls cannot deadlock and a 0-worker pool still works
+// (everything then runs on the caller).
+class JobSystem {
+public:
+    // workerCount = UINT32_MAX picks hardware_concurrency - 1 (the caller is the extra thread)
+    explicit JobSystem(uint32_t workerCount = UINT32_MAX);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    uint32_t GetWorkerCount() const { return (uint32_t)m_workers.size(); }
+    uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }
+
+    void Submit(JobCounter& counter, std::function<void()> job);
+    void Wait(JobCounter& counter);
+
+    // fn(begin, end) over [0, count) in batches of at least `grain`; returns when all batches ran.
+    void ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& fn);
+
+private:
+    struct Job { std::function<void()> fn; JobCounter* counter; };
+
+    bool RunOne();                 // pops and runs one job; false if the queue was empty
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<Job>          m_queue;
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake;
+    bool                     m_quit = false;
+};
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "Export.h"
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  define GE_PROFILE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#  define GE_PROFILE_TSC 1
+#else
+#  include <chrono>
+#  define GE_PROFILE_TSC 0
+#endif
+
+// Set GE_PROFILE=0 (CMake option) to compile every PROFILE_* macro out.
+#ifndef GE_PROFILE
+#  define GE_PROFILE 1
+#endif
+
+namespace GraphicsEngine {
+
+// Raw timestamp: TSC ticks on x86, steady_clock nanoseconds elsewhere. Profiler::TicksPerSecond converts.
+inline uint64_t ProfileNow()
+{
+#if GE_PROFILE_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+struct ProfileEvent {
+    const char* name;   // string literal; only the pointer is stored
+    uint64_t    begin, end;
+};
+
+// CPU scope profiler. Every thread writes completed scopes into its own ring of the last
+// kEventsPerThread events (no locks, no allocation after the first event on a thread), and
+// BeginFrame marks frame boundaries, so an export can cut out the last N frames. Export reads the
+// rings concurrently with the writers and drops any entries that were overwritten while it copied.
+class GRAPHICS_API Profiler {
+public:
+    static constexpr uint32_t kEventsPerThread = 1u << 16;
+    static constexpr uint32_t kFrames = 1024;
+    static constexpr uint32_t kCounterSamples = 1u << 15;
+
+    static void Record(const char* name, uint64_t begin, uint64_t end);
+    // Main thread, once per frame, before anything else runs
+    static void BeginFrame();
+    // Sample of a counter track (drawn as a graph under the threads), stamped now; main thread,
+    // like BeginFrame. Keeps the last kCounterSamples samples.
+    static void RecordCounter(const char* name, double value);
+    // Shown as the thread's track name; defaults to "Thread <n>"
+    static void SetThreadName(const char* name);
+
+    static double TicksPerSecond();
+
+    // Chrome trace event JSON (chrome://tracing, ui.perfetto.dev) of the last `frames` frames
+    static bool ExportChromeTrace(const std::string& path, uint32_t frames = 300);
+};
+
+struct ProfileScope {
+    const char* name;
+    uint64_t    begin;
+    explicit ProfileScope(const char* n) : name(n), begin(ProfileNow()) {}
+    ~ProfileScope() { Profiler::Record(name, begin, ProfileNow()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+}
+
+#define GE_PROFILE_CONCAT2(a, b) a##b
+#define GE_PROFILE_CONCAT(a, b) GE_PROFILE_CONCAT2(a, b)
+
+#if GE_PROFILE
+#  define PROFILE_SCOPE(name) ::GraphicsEngine::ProfileScope GE_PROFILE_CONCAT(geProfileScope_, __LINE__)(name)
+#  define PROFILE_FRAME()     ::GraphicsEngine::Profiler::BeginFrame()
+#  define PROFILE_THREAD(name) ::GraphicsEngine::Profiler::SetThreadName(name)
+#  define PROFILE_COUNTER(name, value) ::GraphicsEngine::Profiler::RecordCounter(name, double(value))
+#else
+#  define PROFILE_SCOPE(name)  ((void)0)
+#  define PROFILE_FRAME()      ((void)0)
+#  define PROFILE_THREAD(name) ((void)0)
+#  define PROFILE_COUNTER(name, value) ((void)0)
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GraphicsEngine {
+
+class JobSystem;
+
+// A key and what it carries (an index, usually); interleaved, so a scatter writes one stream per
+// digit instead of two
+struct RadixItem {
+    uint32_t key;
+    uint32_t value;
+};
+
+// Stable LSD radix sort of 32-bit keys, ascending, 8 bits per pass over the low `keyBits` of the
+// keys (fewer bits, fewer passes). Each pass is parallel the same way as DrawCompactor:
+//   1. per-block digit histogram          parallel over key blocks
+//   2. exclusive scan to write cursors    per digit over blocks, then over the 256 digits
+//   3. stable scatter                     parallel over key blocks
+// A pass whose digit is the same for every key only costs its histogram. Scratch is kept between
+// calls, so a per-frame sort does not allocate once it has seen its largest input.
+class RadixSorter {
+public:
+    // keys.size() == values.size(); jobs = null runs everything on the caller
+    void Sort(std::span<const uint32_t> keys, std::span<const uint32_t> values, JobSystem* jobs = nullptr,
+              uint32_t keyBits = 32);
+
+    std::span<const RadixItem> Items() const { return { m_items[m_result].data(), m_count }; }
+
+private:
+    std::vector<RadixItem> m_items[2];               // ping-pong; m_result holds the sorted run
+    uint32_t               m_result = 0;
+    uint32_t               m_count = 0;
+    std::vector<uint32_t>  m_blockOffsets;           // [block * 256 + digit]: counts, then write cursors
+};
+
+}
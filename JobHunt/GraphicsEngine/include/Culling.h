@@ -0,0 +1,190 @@
+#pragma once
+#include "SolMath.h"
+#include "Geometry.h"
+#include <bit>
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GE_CULL_SSE 1
+#else
+#define GE_CULL_SSE 0
+#endif
+
+namespace GraphicsEngine {
+
+// Frustum planes in SolMath convention (dot(n,x) - d, normals point inside) plus the eye,
+// expressed in whatever space the tested bounds live in.
+struct CullView {
+    Plane_t planes[6];
+    float3  eye;
+};
+
+CullView MakeCullView(const TheFrustum_t& frustum, const float3& eye);
+// Perspective camera (cameraToWorld as from Camera::GetCameraToWorld) through frustum_build;
+// `corners` (SolMath Corners order) for callers that also draw it
+CullView MakeCullView(const float4x4& cameraToWorld, float fovY, float aspect, float zn, float zf,
+                      Points* corners = nullptr);
+// Planes of any world->clip matrix (D3D clip space, z in [0,w]), e.g. an orthographic light
+CullView MakeCullViewFromClip(const float4x4& worldToClip, const float3& eye);
+// World view -> object space of a mesh. Plane tests stay exact for any affine transform;
+// the cone test assumes rigid or uniformly scaled instances.
+CullView TransformCullView(const CullView& worldView, const float4x4& objectToWorld);
+
+// Conservative AABB vs view planes (SolMath classify convention: rejected only when fully behind a plane).
+inline bool AabbVisible(const CullView& view, const AABB_t& box)
+{
+    for (const Plane_t& p : view.planes)
+        if (classify_aabb_plane(box, p) == Classify::Back) return false;
+    return true;
+}
+
+// ============================================================================
+// Multi-view culling
+// ============================================================================
+static constexpr uint32_t kMaxCullViews = 32;
+
+// Up to kMaxCullViews views with their planes transposed, four views per SSE register, so one box
+// is tested against four views at the cost of one. View i is bit i in every view mask below.
+class CullViewSet {
+public:
+    void Set(std::span<const CullView> views);
+    uint32_t Count() const { return m_count; }
+    uint32_t AllViews() const { return m_count == 32 ? ~0u : (1u << m_count) - 1; }
+
+    // Of `views`, the ones the box is not wholly behind a plane of; `inside` (optional) gets the
+    // ones it is wholly in front of every plane of. Same rule as AabbVisible.
+    // Inline: BVH walks call it per node
+    uint32_t Classify(const float3& center, const float3& extents, uint32_t views, uint32_t* inside = nullptr) const;
+
+private:
+    struct alignas(16) Group {
+        float nx[6][4], ny[6][4], nz[6][4], d[6][4];
+        float ax[6][4], ay[6][4], az[6][4];   // |normal|, for the box radius
+    };
+
+    Group    m_groups[kMaxCullViews / 4]{};
+    uint32_t m_count = 0;
+};
+
+inline uint32_t CullViewSet::Classify(const float3& c, const float3& e, uint32_t views, uint32_t* inside) const
+{
+    uint32_t pass = 0, in = 0;
+#if GE_CULL_SSE
+    const __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+    const __m128 ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+    const __m128 zero = _mm_setzero_ps();
+    for (uint32_t g = 0; g < (m_count + 3) / 4; g++) {
+        const uint32_t lanes = (views >> (g * 4)) & 0xF;
+        if (!lanes) continue;
+        const Group& v = m_groups[g];
+        __m128 out = zero, front = _mm_cmpeq_ps(zero, zero);
+        for (int p = 0; p < 6; p++) {
+            // Same sums in the same order as classify_aabb_plane, so both agree to the bit
+            const __m128 s = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(v.nx[p]), cx), _mm_mul_ps(_mm_load_ps(v.ny[p]), cy)),
+                                                   _mm_mul_ps(_mm_load_ps(v.nz[p]), cz)), _mm_load_ps(v.d[p]));
+            const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(v.ax[p]), ex), _mm_mul_ps(_mm_load_ps(v.ay[p]), ey)),
+                                        _mm_mul_ps(_mm_load_ps(v.az[p]), ez));
+            out = _mm_or_ps(out, _mm_cmplt_ps(s, _mm_sub_ps(zero, r)));
+            front = _mm_and_ps(front, _mm_cmpgt_ps(s, r));
+            if (p == 2 && ((uint32_t)_mm_movemask_ps(out) & lanes) == lanes) break;   // every view rejects it already
+        }
+        const uint32_t o = (uint32_t)_mm_movemask_ps(out), f = (uint32_t)_mm_movemask_ps(front);
+        pass |= (lanes & ~o) << (g * 4);
+        in |= (lanes & ~o & f) << (g * 4);
+    }
+#else
+    for (uint32_t bits = views; bits; bits &= bits - 1) {
+        const uint32_t i = (uint32_t)std::countr_zero(bits);
+        const Group& v = m_groups[i / 4];
+        const uint32_t lane = i & 3;
+        bool out = false, front = true;
+        for (int p = 0; p < 6 && !out; p++) {
+            const float s = v.nx[p][lane] * c.x + v.ny[p][lane] * c.y + v.nz[p][lane] * c.z - v.d[p][lane];
+            const float r = v.ax[p][lane] * e.x + v.ay[p][lane] * e.y + v.az[p][lane] * e.z;
+            out = s < -r;
+            front &= s > r;
+        }
+        if (!out) pass |= 1u << i;
+        if (!out && front) in |= 1u << i;
+    }
+#endif
+    if (inside) *inside = in;
+    return pass;
+}
+
+// One bit per object id per view, as a multi-view cull leaves them. Word w of every view is stored
+// together ([w * views + view]): a cull sets an object's bits for all views at once, and those land
+// in one or two cache lines instead of one per view.
+class VisibilityMasks {
+public:
+    void Reset(uint32_t views, uint32_t objects)
+    {
+        m_views = views;
+        m_words = (objects + 63) / 64;
+        m_bits.assign(size_t(m_words) * views, 0);
+    }
+    void Set(uint32_t view, uint32_t id) { m_bits[size_t(id / 64) * m_views + view] |= uint64_t(1) << (id & 63); }
+    bool Test(uint32_t view, uint32_t id) const { return (m_bits[size_t(id / 64) * m_views + view] >> (id & 63)) & 1; }
+    // Bits of view v for ids [w * 64, w * 64 + 64)
+    uint64_t Word(uint32_t view, uint32_t w) const { return m_bits[size_t(w) * m_views + view]; }
+    uint32_t WordCount() const { return m_words; }
+
+    uint32_t Count(uint32_t view) const
+    {
+        uint32_t n = 0;
+        for (uint32_t w = 0; w < m_words; w++) n += (uint32_t)std::popcount(Word(view, w));
+        return n;
+    }
+    // fn(id) per set bit of `view`, ascending
+    template <typename Fn> void ForEach(uint32_t view, Fn&& fn) const
+    {
+        for (uint32_t w = 0; w < m_words; w++)
+            for (uint64_t bits = Word(view, w); bits; bits &= bits - 1) fn(w * 64 + (uint32_t)std::countr_zero(bits));
+    }
+
+private:
+    std::vector<uint64_t> m_bits;   // [id / 64 * m_views + view]
+    uint32_t              m_views = 0, m_words = 0;
+};
+
+// Optional occluder depth: conservative farthest depth per tile (standard Z, 1 = far).
+struct OcclusionBuffer {
+    const float* maxDepth = nullptr;
+    uint32_t     width = 0, height = 0;   // in tiles
+    float4x4     objectToClip = m_identity();
+};
+
+// SoA copy of MeshletBounds, padded to a multiple of 4 for the SIMD pass.
+struct MeshletCullData {
+    std::vector<float> cx, cy, cz, radius;
+    std::vector<float> ax, ay, az, cutoff;
+    uint32_t count = 0;
+
+    void Build(const MeshletMesh& mesh);
+};
+
+struct IndexRange { uint32_t firstIndex = 0; uint32_t indexCount = 0; };
+
+struct MeshletCullStats {
+    uint32_t tested = 0;
+    uint32_t frustumCulled = 0;
+    uint32_t coneCulled = 0;
+    uint32_t occlusionCulled = 0;
+    uint32_t visible = 0;
+    uint32_t ranges = 0;
+};
+
+// Frustum + backface-cone tests four meshlets per iteration (SSE), occlusion on the survivors.
+// Visible meshlets are emitted as index ranges into MeshletMesh::indices; neighbours are merged,
+// so a fully visible mesh collapses to a single DrawIndexed. Returns the number of visible meshlets.
+uint32_t CullMeshlets(const MeshletMesh& mesh, const MeshletCullData& soa, const CullView& view,
+                      std::vector<IndexRange>& outRanges,
+                      const OcclusionBuffer* occlusion = nullptr,
+                      MeshletCullStats* stats = nullptr);
+
+bool SphereOccluded(const OcclusionBuffer& occ, const float3& center, float radius);
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "Geometry.h"
+#include "SolMath.h"
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace GraphicsEngine {
+
+enum class DebugDepth : uint32_t {
+    Tested,     // hidden behind scene geometry
+    Overlay,    // always on top
+    Count
+};
+
+// World-space label; the renderer projects it and draws it with the overlay text.
+struct DebugLabel {
+    float3   pos;
+    uint32_t color;            // RGBA8 (PackRGBA8)
+    uint32_t offset, length;   // into DebugDrawFrame::chars
+};
+
+// One frame of debug geometry, merged from every thread: line-list vertices of both depth modes
+// back to back (tested first), so the lot is one upload and two draws.
+struct DebugDrawFrame {
+    std::vector<VertexPC>   lines;             // empty when Collect wrote to caller memory
+    uint32_t                lineStart[uint32_t(DebugDepth::Count)] = {};
+    uint32_t                lineCount[uint32_t(DebugDepth::Count)] = {};
+    std::vector<DebugLabel> labels;
+    std::vector<char>       chars;
+
+    std::string_view LabelText(const DebugLabel& l) const { return { chars.data() + l.offset, l.length }; }
+};
+
+struct DebugDrawStats {
+    uint32_t threads = 0;          // buffers merged by the last Collect
+    uint32_t lineVertices = 0;
+    uint32_t labels = 0;
+    uint32_t persistent = 0;       // timed segments + labels still alive
+};
+
+// Immediate-mode debug drawing, callable from any thread. Calls append to a buffer owned by the
+// calling thread (a per-thread lock that only Collect ever contends), so workers can draw without
+// funnelling through the render thread. `duration` 0 draws for the current frame only; a positive
+// duration keeps the item for that many seconds of Collect time.
+namespace DebugDraw {
+    void Line(const float3& a, const float3& b, const float3& color,
+              DebugDepth depth = DebugDepth::Tested, float duration = 0.0f);
+    // Pre-built line list (pairs of vertices)
+    void Lines(const VertexPC* vertices, uint32_t count, DebugDepth depth = DebugDepth::Tested, float duration = 0.0f);
+    void Box(const AABB_t& box, const float3& color, DebugDepth depth = DebugDepth::Tested, float duration = 0.0f);
+    // Oriented box: the [-1,1]^3 cube scaled by `extents` and transformed by `world`
+    void Box(const float4x4& world, const float3& extents, const float3& color,
+             DebugDepth depth = DebugDepth::Tested, float duration = 0.0f);
+    // Corners: near tl, tr, bl, br, then far tl, tr, bl, br
+    void Frustum(const float3 corners[8], const float3& color, DebugDepth depth = DebugDepth::Tested, float duration = 0.0f);
+    void Frustum(const float4x4& cameraToWorld, float fovY, float aspect, float zn, float zf, const float3& color,
+                 DebugDepth depth = DebugDepth::Tested, float duration = 0.0f);
+    // Three great circles
+    void Sphere(const float3& center, float radius, const float3& color, DebugDepth depth = DebugDepth::Tested,
+                float duration = 0.0f, uint32_t segments = 24);
+    // X/Y/Z of `world` in red/green/blue
+    void Axes(const float4x4& world, float size, DebugDepth depth = DebugDepth::Tested, float duration = 0.0f);
+    // Labels are always overlay
+    void Text(const float3& pos, std::string_view utf8, const float3& color, float duration = 0.0f);
+
+    // Render thread, once per frame: drains every thread's buffer into `out`, then ages timed
+    // items by dt. Calls racing with Collect land in this frame or the next, never half in both.
+    // `allocate`, if given, supplies the destination for the merged line vertices (upload memory,
+    // say) so they are copied exactly once; it is called once, and not at all for zero lines.
+    void Collect(float dt, DebugDrawFrame& out, const std::function<VertexPC*(uint32_t count)>& allocate = {});
+    // Drops everything, including timed items
+    void Clear();
+    DebugDrawStats GetStats();
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GraphicsEngine {
+
+class JobSystem;
+
+// Same layout as D3D12_DRAW_ARGUMENTS and VkDrawIndirectCommand
+struct DrawArgs {
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+};
+static_assert(sizeof(DrawArgs) == 16, "DrawArgs matches the API indirect draw layout");
+
+struct DrawMesh {
+    uint32_t vertexCount = 0;
+    uint32_t firstVertex = 0;
+};
+
+// One visible instance: which bucket (material / pipeline) and mesh it draws with, and what the
+// instance data is (e.g. a proxy id the caller turns into a matrix)
+struct DrawItem {
+    uint32_t bucket;
+    uint32_t mesh;
+    uint32_t instance;
+};
+
+// A bucket's contiguous run of args: one ExecuteIndirect with argCount draws
+struct DrawBucket {
+    uint32_t firstArg = 0;
+    uint32_t argCount = 0;
+    uint32_t instanceCount = 0;
+};
+
+// Turns a culled item list into indirect draw arguments: one DrawArgs per (bucket, mesh) that has
+// instances, bucket-major, and the instance payloads reordered so each draw's instances are
+// contiguous from its firstInstance. Built the way a GPU would do it, so the stages can move to a
+// compute pass later:
+//   1. per-block histogram of (bucket, mesh) slots        parallel over item blocks
+//   2. exclusive scan: slot totals, then block offsets    parallel over slots, serial over totals
+//   3. stable scatter of the payloads                     parallel over item blocks
+//   4. compaction of the non-empty slots into args        serial, over slots only
+// No graphics API involved; the renderer uploads Args() and Instances() and draws.
+class DrawCompactor {
+public:
+    void Configure(uint32_t bucketCount, std::span<const DrawMesh> meshes);
+
+    // jobs = null runs everything on the caller
+    void Build(std::span<const DrawItem> items, JobSystem* jobs = nullptr);
+
+    std::span<const DrawArgs>   Args() const { return { m_args.data(), m_argCount }; }
+    std::span<const uint32_t>   Instances() const { return m_instances; }
+    std::span<const DrawBucket> Buckets() const { return m_buckets; }
+    uint32_t                    SlotCount() const { return (uint32_t)m_slotTotal.size(); }
+
+private:
+    uint32_t Slot(const DrawItem& item) const { return item.bucket * m_meshCount + item.mesh; }
+
+    std::vector<DrawMesh>   m_meshes;
+    uint32_t                m_meshCount = 0;
+
+    uint32_t                m_blockCount = 0;
+    uint32_t                m_blockSize = 0;
+    std::vector<uint32_t>   m_blockOffsets;   // [block * slots + slot]: counts, then write cursors
+    std::vector<uint32_t>   m_slotTotal;
+    std::vector<uint32_t>   m_slotFirst;
+
+    std::vector<DrawArgs>   m_args;           // capacity kept; m_argCount valid
+    uint32_t                m_argCount = 0;
+    std::vector<uint32_t>   m_instances;
+    std::vector<DrawBucket> m_buckets;
+};
+
+}
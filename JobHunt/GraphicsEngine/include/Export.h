@@ -1,4 +1,8 @@
-#if defined(GRAPHICSENGINE_EXPORTS)
+#pragma once
+// GRAPHICSENGINE_STATIC: engine sources compiled straight into a tool instead of imported from the DLL
+#if !defined(_WIN32) || defined(GRAPHICSENGINE_STATIC)
+#  define GRAPHICS_API
+#elif defined(GRAPHICSENGINE_EXPORTS)
 #  define GRAPHICS_API __declspec(dllexport)
 #else
 #  define GRAPHICS_API __declspec(dllimport)
@@ -1,11 +1,55 @@
 #pragma once
 #include "SolMath.h"
 #include <vector>
+#include <cstddef>
 namespace GraphicsEngine{
 struct VertexPC { float3 pos; float3 color; };
 struct VertexPNC{ float3 pos; float3 normal; float3 color; };
+
+// Meshlet = small cluster of triangles (<= 64 verts / 124 tris) that is culled as a unit.
+// triangleOffset indexes both MeshletMesh::triangles (local ids) and MeshletMesh::indices (source ids),
+// so a visible meshlet maps directly to the index range [triangleOffset, triangleOffset + triangleCount*3).
+struct Meshlet {
+    uint32_t vertexOffset   = 0;  // into MeshletMesh::vertices
+    uint32_t triangleOffset = 0;  // first index (3 per triangle)
+    uint32_t vertexCount    = 0;
+    uint32_t triangleCount  = 0;
+};
+// Bounding sphere + normal cone. Backface test: dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius.
+// coneCutoff == 1 means the cone is too wide and the meshlet is never cone-culled.
+struct MeshletBounds {
+    float3 center;   float radius = 0.0f;
+    float3 coneAxis; float coneCutoff = 1.0f;
+};
+struct MeshletMesh {
+    std::vector<Meshlet>       meshlets;
+    std::vector<MeshletBounds> bounds;     // one per meshlet
+    std::vector<uint32_t>      vertices;   // meshlet-local vertex -> source vertex
+    std::vector<uint8_t>       triangles;  // meshlet-local vertex ids, 3 per triangle
+    std::vector<uint32_t>      indices;    // source vertex ids in meshlet order (index buffer ready)
+};
+
 namespace Geom{
+    static constexpr uint32_t kMeshletMaxVertices  = 64;
+    static constexpr uint32_t kMeshletMaxTriangles = 124;
+
     void BuildGridXZ (float halfExtent, float spacing, float3 color, std::vector<VertexPC>& outLines);
     void BuildAxes   (float axisLength,                    std::vector<VertexPC>& outLines);
-    void BuildSolidCubePNC(float half,                     std::vector<VertexPNC>& outTris);}
+    void BuildSolidCubePNC(float half,                     std::vector<VertexPNC>& outTris);
+
+    // Greedy locality-driven clustering: grows each meshlet from the triangles adjacent to its current
+    // vertices (fewest new vertices first), so meshlets stay spatially compact and cone bounds stay tight.
+    // positions is strided (bytes) so interleaved vertex streams can be passed without copying.
+    // Returns false, with out left empty, if an index is not below vertexCount (corrupt input).
+    bool BuildMeshlets(const float3* positions, size_t positionStride, size_t vertexCount,
+                       const uint32_t* indices, size_t indexCount, MeshletMesh& out,
+                       uint32_t maxVertices = kMeshletMaxVertices, uint32_t maxTriangles = kMeshletMaxTriangles);
+    bool BuildMeshlets(const std::vector<VertexPNC>& verts, const std::vector<uint32_t>& indices, MeshletMesh& out,
+                       uint32_t maxVertices = kMeshletMaxVertices, uint32_t maxTriangles = kMeshletMaxTriangles);
+
+    // Vertex-clustering LOD: snaps vertices to a cellSize grid, keeps the first vertex per cell as its
+    // representative and drops collapsed triangles. Output indexes the original vertex buffer, so a LOD
+    // chain is just extra index ranges.
+    void BuildClusterLod(const float3* positions, size_t positionStride, size_t vertexCount,
+                         const uint32_t* indices, size_t indexCount, float cellSize, std::vector<uint32_t>& outIndices);}
 }
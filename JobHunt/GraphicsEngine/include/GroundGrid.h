@@ -0,0 +1,62 @@
+#pragma once
+#include "SolMath.h"
+#include "Geometry.h"
+#include "Culling.h"
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+
+// One square world chunk selected around the camera.
+struct GridChunk {
+    int32_t  x = 0, z = 0;   // chunk coordinates (world origin = x * chunkSize)
+    uint32_t lod = 0;        // 0 = finest
+    AABB_t   bounds;
+};
+
+struct ChunkRingDesc {
+    float    chunkSize   = 16.0f;   // world units per chunk edge
+    int32_t  radius      = 8;       // chunks kept around the camera chunk
+    float    lodDistance = 16.0f;   // LOD 1 starts here, each further level doubles the distance
+    uint32_t maxLod      = 3;
+    float    minY = 0.0f, maxY = 0.0f;
+};
+
+// Camera-centred chunk ring: circular radius, distance-based LOD, frustum culled per chunk.
+// Shared by the grid/ground and by anything else that streams fixed-size world tiles.
+void SelectChunks(const ChunkRingDesc& desc, const float3& eye, const CullView* view, std::vector<GridChunk>& out);
+uint32_t ChunkLod(const ChunkRingDesc& desc, const float3& eye, const AABB_t& bounds);
+
+// Infinite XZ grid + ground built from the visible chunk set every frame.
+// Line density halves per LOD; vertices are written straight into caller memory (frame upload ring),
+// so nothing is cached or allocated per frame.
+class GroundGrid {
+public:
+    void SetDesc(const ChunkRingDesc& desc) { m_desc = desc; }
+    const ChunkRingDesc& GetDesc() const { return m_desc; }
+
+    void SetSpacing(float spacing) { m_spacing = spacing; }
+    void SetColors(const float3& line, const float3& ground) { m_lineColor = line; m_groundColor = ground; }
+
+    void Update(const float3& eye, const CullView* view);
+
+    const std::vector<GridChunk>& GetVisibleChunks() const { return m_visible; }
+
+    uint32_t GetLineVertexCount() const { return m_lineVertexCount; }
+    void     WriteLines(VertexPC* dst) const;
+
+    uint32_t GetGroundVertexCount() const { return (uint32_t)m_visible.size() * 6; }
+    void     WriteGround(VertexPNC* dst) const;
+
+private:
+    uint32_t LinesPerChunk(uint32_t lod) const;
+
+    ChunkRingDesc          m_desc;
+    float                  m_spacing = 1.0f;
+    float3                 m_lineColor{ 0.25f, 0.25f, 0.25f };
+    float3                 m_groundColor{ 0.5f, 0.5f, 0.5f };
+    std::vector<GridChunk> m_visible;
+    uint32_t               m_lineVertexCount = 0;
+};
+
+}
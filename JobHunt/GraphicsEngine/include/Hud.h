@@ -0,0 +1,91 @@
+#pragma once
+#include "Geometry.h"
+#include "SolMath.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// Pixel-space HUD primitives (y down), appended as VertexPC triangles.
+class HudBuilder {
+public:
+    explicit HudBuilder(std::vector<VertexPC>& out) : m_out(out) {}
+
+    void Rect(float x0, float y0, float x1, float y1, const float3& c);
+    void HBar(float x, float y, float w, float t, const float3& c) { Rect(x, y, x + w, y + t, c); }
+    void VBar(float x, float y, float t, float h, const float3& c) { Rect(x, y, x + t, y + h, c); }
+
+private:
+    std::vector<VertexPC>& m_out;
+};
+
+enum class HudLayer : uint32_t { Static, Dynamic, Count };
+
+struct HudStats {
+    uint32_t rebuilt = 0;        // elements regenerated since the last ResetStats
+    uint32_t packs = 0;          // layer re-packs
+};
+
+// Retained-mode HUD. Each element keeps the vertices it built last time together with a caller
+// chosen key (what it shows: the toggle states, the viewport size); Update re-runs the
+// builder only when that key changes. Elements are packed per layer - static ones (resize, toggles)
+// first, per-frame ones after - and each layer carries a version, so the GPU copy is refreshed
+// only for the layer that actually changed.
+class RetainedHud {
+public:
+    using ElementId = uint32_t;
+
+    ElementId Add(HudLayer layer);
+
+    template<class Fn>
+    void Update(ElementId id, uint64_t key, Fn&& build)
+    {
+        Element& e = m_elements[id];
+        if (e.built && e.key == key) return;
+        e.vertices.clear();
+        HudBuilder b(e.vertices);
+        build(b);
+        e.key = key;
+        e.built = true;
+        m_dirty[uint32_t(e.layer)] = true;
+        m_stats.rebuilt++;
+    }
+
+    // Forces every element to rebuild on its next Update.
+    void Invalidate();
+    // Re-packs dirty layers into Vertices(); cheap when nothing changed.
+    void Pack();
+
+    std::span<const VertexPC> Vertices() const { return m_packed; }
+    uint32_t LayerStart(HudLayer layer) const { return layer == HudLayer::Static ? 0 : m_staticCount; }
+    uint32_t LayerCount(HudLayer layer) const
+    {
+        return layer == HudLayer::Static ? m_staticCount : uint32_t(m_packed.size()) - m_staticCount;
+    }
+    // Bumped by Pack whenever the layer's vertices changed (a static change moves the dynamic
+    // range too, so it bumps both).
+    uint64_t LayerVersion(HudLayer layer) const { return m_version[uint32_t(layer)]; }
+
+    const HudStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = {}; }
+
+private:
+    struct Element {
+        HudLayer              layer = HudLayer::Static;
+        uint64_t              key = 0;
+        bool                  built = false;
+        std::vector<VertexPC> vertices;
+    };
+
+    void Append(HudLayer layer);
+
+    std::vector<Element>  m_elements;
+    std::vector<VertexPC> m_packed;
+    uint32_t              m_staticCount = 0;
+    bool                  m_dirty[uint32_t(HudLayer::Count)] = {};
+    uint64_t              m_version[uint32_t(HudLayer::Count)] = { 1, 1 };
+    HudStats              m_stats;
+};
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// ----------------------------------------------------------------------------
+// Input as a stream of events grouped into frames. Window messages are queued and handed to the
+// game at the start of the next Update, together with that frame's dt, so the same recording fed
+// back in gives the same simulation: key state, mouse deltas and toggles all come from the events,
+// never from polling the OS. Key codes are Windows virtual-key codes on every platform.
+// ----------------------------------------------------------------------------
+enum class InputEventType : uint8_t {
+    KeyDown,
+    KeyUp,
+    MouseMove,     // x, y = client position; buttons = InputButton bits
+    MouseWheel,    // x = wheel delta
+};
+
+enum InputButton : uint8_t {
+    kInputLeft  = 1,
+    kInputRight = 2,
+};
+
+struct InputEvent {
+    InputEventType type;
+    uint8_t        buttons = 0;
+    uint16_t       key = 0;
+    int32_t        x = 0, y = 0;
+};
+static_assert(sizeof(InputEvent) == 12, "InputEvent layout is part of the recording format");
+
+struct InputFrame {
+    float    dt;                       // seconds, as measured when recorded
+    uint32_t firstEvent, eventCount;   // into InputRecording::events
+};
+static_assert(sizeof(InputFrame) == 12, "InputFrame layout is part of the recording format");
+
+// Binary recording (.gerec), little endian: InputRecordingHeader | InputFrame[] | InputEvent[]
+static constexpr uint32_t kInputRecordingVersion = 1;
+
+struct InputRecordingHeader {
+    char     magic[4] = { 'G','E','I','R' };
+    uint32_t version = kInputRecordingVersion;
+    uint32_t frameCount = 0;
+    uint32_t eventCount = 0;
+};
+
+struct InputRecording {
+    std::vector<InputFrame> frames;
+    std::vector<InputEvent> events;
+
+    std::span<const InputEvent> FrameEvents(size_t frame) const
+    {
+        return { events.data() + frames[frame].firstEvent, frames[frame].eventCount };
+    }
+    double Duration() const;
+
+    bool Save(const std::string& path) const;
+    // false on a missing, truncated or inconsistent file
+    bool Load(const std::string& path);
+};
+
+// Key and mouse state rebuilt from events; what Update reads instead of GetAsyncKeyState.
+struct InputState {
+    bool     keys[256] = {};
+    int32_t  mouseX = 0, mouseY = 0;
+    uint8_t  buttons = 0;
+
+    void Apply(const InputEvent& e);
+    bool Down(uint32_t key) const { return key < 256 && keys[key]; }
+};
+
+// The per-frame event source. Live: queued window events, optionally recorded. Replay: the frames
+// of a recording in order (live events are dropped), with the recorded dt or a fixed one.
+class InputStream {
+public:
+    enum class Mode { Live, Recording, Replay };
+
+    void Push(const InputEvent& e);
+
+    // Start of a frame: the events to apply now. Returns the dt to simulate with, which is
+    // `measuredDt` unless replaying.
+    float BeginFrame(float measuredDt, std::span<const InputEvent>& events);
+    // The dt the next BeginFrame will return, for systems stepped before it (physics)
+    float PeekDt(float measuredDt) const;
+
+    void StartRecording();
+    InputRecording StopRecording();            // back to Live
+
+    // fixedDt <= 0 replays each frame's recorded dt
+    void StartReplay(InputRecording recording, float fixedDt = 0.0f);
+    void StopReplay();
+    // Replay mode with every recorded frame consumed
+    bool ReplayFinished() const { return m_mode == Mode::Replay && m_replayFrame >= m_replay.frames.size(); }
+
+    Mode   GetMode() const { return m_mode; }
+    size_t ReplayFrame() const { return m_replayFrame; }
+    size_t ReplayFrameCount() const { return m_replay.frames.size(); }
+
+private:
+    Mode                    m_mode = Mode::Live;
+    std::vector<InputEvent> m_queue, m_frameEvents;
+    InputRecording          m_recording;
+    InputRecording          m_replay;
+    size_t                  m_replayFrame = 0;
+    float                   m_fixedDt = 0.0f;
+};
+
+}
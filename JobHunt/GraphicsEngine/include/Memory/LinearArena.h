@@ -1,30 +1,53 @@
 #pragma once
 #include <vector>
+#include <memory>
 #include <cstdint>
+#include <cstddef>
 
 namespace GraphicsEngine {
 
+// Bump allocator. Overflow chains a new block instead of reallocating, so pointers handed out
+// stay valid until Reset; Reset folds the chain into one block sized for the previous peak.
 class LinearArena {
-    std::vector<uint8_t> buffer;
-    size_t cursor = 0;
+    struct Block { std::unique_ptr<uint8_t[]> data; size_t size = 0; };
+    std::vector<Block> blocks;
+    size_t cursor = 0;      // in blocks.back()
+    size_t used = 0;
+
+    void AddBlock(size_t size) {
+        blocks.push_back({ std::unique_ptr<uint8_t[]>(new uint8_t[size]), size });
+        cursor = 0;
+    }
 
 public:
     explicit LinearArena(size_t capacity = 0) {
-        buffer.resize(capacity);
+        if (capacity) AddBlock(capacity);
     }
 
     void Reset() {
+        if (blocks.size() > 1) {
+            const size_t total = GetCapacity();
+            blocks.clear();
+            AddBlock(total);
+        }
         cursor = 0;
+        used = 0;
     }
 
     void* Alloc(size_t size, size_t alignment = 16) {
-        size_t aligned = (cursor + (alignment - 1)) & ~(alignment - 1);
-        if (aligned + size > buffer.size()) {
-            buffer.resize(aligned + size);
+        for (;;) {
+            if (!blocks.empty()) {
+                const uintptr_t base = reinterpret_cast<uintptr_t>(blocks.back().data.get());
+                const size_t aligned = ((base + cursor + (alignment - 1)) & ~uintptr_t(alignment - 1)) - base;
+                if (aligned + size <= blocks.back().size) {
+                    cursor = aligned + size;
+                    used += size;
+                    return blocks.back().data.get() + aligned;
+                }
+            }
+            const size_t grow = blocks.empty() ? 4096 : blocks.back().size * 2;
+            AddBlock(grow > size + alignment ? grow : size + alignment);
         }
-        void* ptr = buffer.data() + aligned;
-        cursor = aligned + size;
-        return ptr;
     }
 
     template<typename T>
@@ -34,8 +57,18 @@ public:
         return ptr;
     }
 
-    size_t GetUsed() const { return cursor; }
-    size_t GetCapacity() const { return buffer.size(); }
+    // Uninitialised storage for n trivially copyable elements
+    template<typename T>
+    T* AllocArray(size_t n, size_t alignment = alignof(T)) {
+        return n ? (T*)Alloc(n * sizeof(T), alignment < alignof(T) ? alignof(T) : alignment) : nullptr;
+    }
+
+    size_t GetUsed() const { return used; }
+    size_t GetCapacity() const {
+        size_t total = 0;
+        for (const Block& b : blocks) total += b.size;
+        return total;
+    }
 };
 
 }
@@ -0,0 +1,79 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+namespace GraphicsEngine {
+
+// Frame-partitioned bump allocator over memory someone else owns: the mapped upload heap in
+// UploadAlloc, plain host memory in the headless tools. Each of frameCount frames gets a fixed
+// slice; BeginFrame rewinds to the slice of a frame the GPU has finished with.
+class UploadRing {
+public:
+    struct Allocation {
+        uint8_t* cpuPtr = nullptr;
+        uint64_t gpuAddress = 0;
+        size_t   size = 0;
+
+        bool IsValid() const { return cpuPtr != nullptr; }
+    };
+
+    void Init(uint8_t* cpuBase, uint64_t gpuBase, size_t totalSize, uint32_t frameCount) {
+        m_cpuBase = cpuBase;
+        m_gpuBase = gpuBase;
+        m_totalSize = totalSize;
+        m_frameCount = frameCount;
+        m_perFrameSize = (totalSize / frameCount / 65536) * 65536;   // 64KB aligned
+        m_currentFrame = 0;
+        m_head = 0;
+    }
+
+    void Reset() { *this = UploadRing{}; }
+
+    void BeginFrame(uint32_t frameIndex) {
+        m_currentFrame = frameIndex;
+        m_head = frameIndex * m_perFrameSize;
+    }
+
+    Allocation Allocate(size_t size, size_t alignment = 256) {
+        if (size == 0) return Allocation{};
+
+        const size_t frameEnd = (m_currentFrame + 1) * m_perFrameSize;
+        const size_t aligned = (m_head + (alignment - 1)) & ~(alignment - 1);
+        const size_t newHead = aligned + size;
+
+        if (newHead > frameEnd) {
+            // Out of upload memory for this frame: raise the total size given to Init
+            assert(false && "UploadRing: frame out of memory. Increase totalSize.");
+            return Allocation{};
+        }
+
+        m_head = newHead;
+        return { m_cpuBase + aligned, m_gpuBase + aligned, size };
+    }
+
+    template<typename T>
+    Allocation AllocateVertices(const T* data, size_t count) {
+        const size_t size = sizeof(T) * count;
+        Allocation alloc = Allocate(size, alignof(T));
+        if (alloc.IsValid() && data) memcpy(alloc.cpuPtr, data, size);
+        return alloc;
+    }
+
+    size_t GetUsedThisFrame() const { return m_head - m_currentFrame * m_perFrameSize; }
+    size_t GetAvailableThisFrame() const { return (m_currentFrame + 1) * m_perFrameSize - m_head; }
+    size_t GetPerFrameSize() const { return m_perFrameSize; }
+    size_t GetTotalSize() const { return m_totalSize; }
+
+private:
+    uint8_t* m_cpuBase = nullptr;
+    uint64_t m_gpuBase = 0;
+    size_t   m_totalSize = 0;
+    size_t   m_perFrameSize = 0;
+    uint32_t m_frameCount = 0;
+    uint32_t m_currentFrame = 0;
+    size_t   m_head = 0;
+};
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "SolMath.h"
+#include "Core/RadixSort.h"
+#include <cstdint>
+#include <vector>
+
+namespace GraphicsEngine {
+
+class JobSystem;
+
+// One billboard corner as Particle.hlsl reads it; four per particle, in the order top-left,
+// top-right, bottom-left, bottom-right (the shader takes the corner from SV_VertexID & 3)
+struct ParticleVertex {
+    float3   pos;
+    uint32_t color;            // RGBA8 (PackRGBA8), alpha already faded by age
+};
+static_assert(sizeof(ParticleVertex) == 16, "ParticleVertex is the vertex layout of Particle.hlsl");
+
+struct ParticleEmitterDesc {
+    float3   position{ 0, 0, 0 };
+    float3   velocity{ 0, 4, 0 };   // mean launch velocity
+    float    spread = 1.0f;          // +- random velocity per axis
+    float    lifetime = 3.0f;        // seconds
+    float    size = 0.05f;           // billboard half-extent
+    uint32_t color = 0xFFFFFFFF;     // RGBA8
+};
+
+// CPU particles in SoA arrays, drawn as alpha-blended camera-facing quads. Per frame:
+//   Simulate   integrate, fade, drop the expired ones
+//   Sort       view-depth key per particle, radix sorted far to near; the arrays are then permuted
+//              into that order, so the visible particles are [0, VisibleCount()) and Expand streams.
+//              Particles move little between frames, so after the first frame the permute does too.
+//   Expand     four corners per visible particle from the camera's right / up rows, written straight
+//              into caller memory (the frame upload ring)
+// Sort and Expand are parallel over the job system.
+class ParticleSystem {
+public:
+    void SetCapacity(uint32_t capacity);
+    uint32_t GetCapacity() const { return m_capacity; }
+
+    // Spawns up to `count` particles (fewer when full); returns how many were spawned
+    uint32_t Emit(const ParticleEmitterDesc& e, uint32_t count);
+    void Simulate(float dt, const float3& gravity = { 0, -9.81f, 0 });
+    void Clear() { m_count = 0; m_visible = 0; }
+
+    // cameraToWorld as from Camera::GetCameraToWorld (rows: right, up, forward, position)
+    void Sort(const float4x4& cameraToWorld, float nearZ, JobSystem* jobs = nullptr);
+    // Writes VisibleCount() * 4 vertices to `out`, far to near; between Sort and the next Simulate
+    void Expand(const float4x4& cameraToWorld, ParticleVertex* out, JobSystem* jobs = nullptr) const;
+
+    uint32_t GetCount() const { return m_count; }
+    // In front of the near plane as of the last Sort; they are the first ones, far to near
+    uint32_t VisibleCount() const { return m_visible; }
+    float3 Position(uint32_t i) const { return { m_px[i], m_py[i], m_pz[i] }; }
+    float Size(uint32_t i) const { return m_size[i]; }
+
+private:
+    uint32_t Random();
+
+    uint32_t              m_capacity = 0;
+    uint32_t              m_count = 0;
+    uint32_t              m_visible = 0;
+    uint32_t              m_seed = 0x9E3779B9u;
+    std::vector<float>    m_px, m_py, m_pz, m_vx, m_vy, m_vz;
+    std::vector<float>    m_age, m_life, m_size;
+    std::vector<uint32_t> m_color;
+
+    // Sort scratch: keys and identity indices go in, the sorted indices gather every array into
+    // m_gatherF / m_gatherU, which are then swapped in
+    std::vector<uint32_t> m_keys, m_indices;
+    RadixSorter           m_sorter;
+    std::vector<float>    m_gatherF;
+    std::vector<uint32_t> m_gatherU;
+};
+
+}
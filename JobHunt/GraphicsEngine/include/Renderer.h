@@ -2,13 +2,30 @@
 #include "Export.h"
 #include "Camera.h"
 #include "Geometry.h"
+#include "GroundGrid.h"
+#include "Hud.h"
+#include "Input.h"
+#include "Particles.h"
+#include "Terrain.h"
+#include "Text.h"
 #include "D3D12Helpers.h"
+#include "DebugDraw.h"
+#include "DrawCompaction.h"
 #include "SolMath.h"
 #include "Memory/UploadAlloc.h"
+#include "Core/FrameStats.h"
+#include "Core/JobSystem.h"
+#include "Assets/AssetStreamer.h"
+#include "Assets/ShaderCache.h"
+#include "Assets/ShaderPermutations.h"
+#include "Scene/EntityWorld.h"
+#include "Scene/RenderScene.h"
 
 #include <Windows.h>
 #include <vector>
 #include <array>
+#include <span>
+#include <string>
 #include <cstdint>
 
 struct ID3D12Device;
@@ -21,6 +38,7 @@ struct ID3D12RootSignature;
 struct ID3D12PipelineState;
 struct ID3D12Resource;
 struct ID3D12Fence;
+struct ID3D12CommandSignature;
 
 namespace GraphicsEngine
 {
@@ -43,33 +61,83 @@ namespace GraphicsEngine
         void OnMouseMove(int x, int y, bool lmb, bool rmb);
         void OnMouseWheel(int delta);
 
+        // Input recording / replay (see Input.h). Start both before the first Update so the run
+        // begins from the initial scene state; fixedDt <= 0 replays the recorded frame times.
+        void StartInputRecording();
+        bool StopInputRecording(const std::string& path);
+        bool StartInputReplay(const std::string& path, float fixedDt = 0.0f);
+        bool InputReplayFinished() const { return m_input.ReplayFinished(); }
+        // The dt the next Update simulates with: the recorded (or fixed) one while replaying
+        float InputFrameDt(float measuredDt) const { return m_input.PeekDt(measuredDt); }
+
         void ToggleFrustum() { m_showPlayerFrustum = !m_showPlayerFrustum; }
         void ToggleGrid() { m_showGrid = !m_showGrid; }
+        void ToggleParticles() { m_showParticles = !m_showParticles; }
 
         void MovePlayer(float dx, float dy, float dz);
 
+        // Scene content (boxes, meshes, the player); the game adds its own entities, e.g. physics
+        // bodies it syncs after stepping
+        EntityWorld& GetScene() { return m_scene; }
+        // What the renderer draws: entities with a RenderProxy push their changes here before Update,
+        // which submits them; Render applies them to the render scene
+        RenderCommandQueue& GetRenderQueue() { return m_renderQueue; }
+
+        // Streams a CDLOD heightmap (see Terrain.h); replaces the flat chunk ground while open.
+        bool LoadTerrain(const std::string& path);
+
     private:
         bool CreateDevice();
         bool CreateSwapchainAndRTVs(HWND hwnd, uint32_t width, uint32_t height);
         bool CreateDepth(uint32_t width, uint32_t height);
         bool CreateRootAndPSO();
+        // Render states a pipeline can be built for; the shader permutation is the keyword mask
+        enum class Pass : uint32_t { Lit, Lines, LinesDepth, Overlay, Shadow, Text, Particles, Count };
+        std::span<const uint8_t> LoadShader(uint32_t program, uint32_t keywords, ShaderStage stage);
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC PipelineDesc(Pass pass, uint32_t keywords);
+        void CreatePipeline(D3D12_GRAPHICS_PIPELINE_STATE_DESC desc, ComPtr<ID3D12PipelineState>& out);
+        ID3D12PipelineState* GetPipeline(Pass pass, uint32_t keywords = 0);
+        uint32_t LitKeywords() const;
+        // SetPipelineState unless `pso` is already bound on this frame's list; counts the switches
+        void BindPipeline(ID3D12GraphicsCommandList* cmd, ID3D12PipelineState* pso);
+        // Copies `bytes` into the constant ring at the next 256-byte boundary; returns the offset
+        UINT WriteConstants(const void* data, UINT bytes);
+        void EndFrameCounters();
         bool CreateCommandObjects();
         bool CreateGeometry();
 
+        // This frame's views (main camera, player frustum, light) culled against the render scene in
+        // one walk; the passes read their proxies from m_visibility
+        void CullViews();
         bool CreateShadowMap(uint32_t size);
         void RenderShadowPass(ID3D12GraphicsCommandList* cmd);
+        bool CreateTextResources();
 
         void WaitForGPU();
         void MoveToNextFrame();
 
         void RecordDrawCalls(ID3D12GraphicsCommandList* cmd);
+        // Uploads m_drawCompactor's instances and args; one ExecuteIndirect per non-empty bucket
+        void DrawCompacted(ID3D12GraphicsCommandList* cmd, std::span<ID3D12PipelineState* const> bucketPsos);
+        // Sorts the particles far to near, expands them into the upload ring and draws them blended
+        void RenderParticles(ID3D12GraphicsCommandList* cmd);
+        void RenderDebugDraw(ID3D12GraphicsCommandList* cmd);
+        void UpdateHud();
         void RenderHUD(ID3D12GraphicsCommandList* cmd);
+        void RenderText(ID3D12GraphicsCommandList* cmd);
 
         void UpdateTitleFPS(HWND hwnd);
+
+        // One queued input event, applied at the start of Update
+        void ApplyInput(const InputEvent& e);
+        void HandleKeyDown(uint32_t key);
+        void HandleMouseMove(int x, int y, bool rmb);
+        void HandleMouseWheel(int delta);
         void RecreateOnResize(uint32_t width, uint32_t height);
 
         void UpdateLight(float dt);
         float3 ComputeLightDir() const;
+        float3 PlayerPosition() const;
 
     private:
         static constexpr UINT kFrameCount = 3;
@@ -92,9 +160,14 @@ namespace GraphicsEngine
         HANDLE                              m_fenceEvent = nullptr;
 
         ComPtr<ID3D12RootSignature>         m_rootSig;
-        ComPtr<ID3D12PipelineState>         m_pso;
-        ComPtr<ID3D12PipelineState>         m_psoLines;
-        ComPtr<ID3D12PipelineState>         m_psoNoDepth;
+        Hash128                             m_rootSigKey;
+        ShaderCache                         m_shaderCache;   // bytecode + PSO blobs, ShaderCache.bin
+        ShaderArchive                       m_shaderArchive; // precompiled permutations, Shaders\Shaders.gesa
+        ShaderProgramId                     m_archivePrograms[kEngineProgramCount] = {};
+        UINT                                m_shaderFlags = 0;
+        struct StartupStats { double pipelineMs = 0.0; uint32_t psoHits = 0, psoMisses = 0, archiveHits = 0; } m_startup;
+        // Indexed by (pass, keyword mask); built on first use, the common ones at startup
+        ComPtr<ID3D12PipelineState>         m_pipelines[uint32_t(Pass::Count)][1u << kShaderKeywordCount];
 
         D3D12_VIEWPORT                      m_viewport{};
         D3D12_RECT                          m_scissor{};
@@ -105,44 +178,65 @@ namespace GraphicsEngine
         uint8_t* m_cbMapped = nullptr;
         UINT64                              m_cbSizeBytes = 256ULL * 1024ULL;
         UINT64                              m_cbHead = 0;
+        ID3D12PipelineState*                m_boundPso = nullptr;   // reset with the command list
 
-        ComPtr<ID3D12Resource>              m_vbLines;
-        D3D12_VERTEX_BUFFER_VIEW            m_vbLinesView{};
-        UINT                                m_vertexCountLines = 0;
+        // Draw-args-only signature: instances differ by their stream data, not by root arguments
+        ComPtr<ID3D12CommandSignature>      m_drawSignature;
+        static constexpr uint32_t           kMaterialCount = 1;   // draw buckets; every proxy is lit-opaque so far
+        DrawCompactor                       m_drawCompactor;
+        std::vector<DrawItem>               m_drawItems;
 
         ComPtr<ID3D12Resource>              m_vbTris;
         D3D12_VERTEX_BUFFER_VIEW            m_vbTrisView{};
         UINT                                m_vertexCountTris = 0;
 
-        std::vector<VertexPC>               m_lines;
         std::vector<VertexPNC>              m_trisLit;
 
-        struct LineRanges {
-            UINT gridStart = 0, gridCount = 0;
-            UINT axesStart = 0, axesCount = 0;            
-        };
-        LineRanges                           m_lineRanges;
-
-        struct Box { AABB_t aabb; float3 color; };
-        std::vector<Box>                     m_debugBoxes;
-
         float3 m_frustumOffset{ 0.0f, 0.0f, 0.0f };
         float  m_frustumStep = 0.25f;
 
         UploadAlloc                          m_dynamicUpload;
 
-        std::vector<VertexPC>                m_hudVertices;
-        std::vector<VertexPC>                m_boxLineVertices;
-        std::vector<VertexPC>                m_frustumVertices;
+        GroundGrid                           m_ground;      // camera-centred chunked grid + ground
+        JobSystem                            m_jobs;
+        AssetStreamer                        m_streamer{ &m_jobs };   // declared before its clients
+        Terrain                              m_terrain;     // streamed heightmap, drawn instead of the flat ground when open
+
+        RetainedHud                          m_hud;
+        struct HudIds { RetainedHud::ElementId crosshair, toggles; } m_hudIds{};
+        // Persistent HUD vertices, one slice per frame in flight; a slice is rewritten only for the
+        // layers whose version it has not seen
+        ComPtr<ID3D12Resource>               m_hudBuffer;
+        uint8_t*                             m_hudMapped = nullptr;
+        UINT                                 m_hudCapacity = 0;   // vertices per slice
+        struct HudSlice { uint64_t staticVersion = 0, dynamicVersion = 0; } m_hudSlices[kFrameCount];
+        float3                               m_hudLastPos{ 0,0,0 };
+        bool                                 m_hudPosValid = false;
+        // Overlay text: everything drawn through m_text during a frame goes out in one instanced draw
+        GlyphAtlas                           m_glyphAtlas;
+        TextBatch                            m_text{ m_glyphAtlas };
+        ComPtr<ID3D12Resource>               m_glyphTex;   // R8, SRV in m_srvHeap slot 1 (t1)
+        DebugDrawFrame                       m_debugFrame;   // merged DebugDraw output, capacity kept
+        ParticleSystem                       m_particles;
+        ParticleEmitterDesc                  m_fountain;     // the demo emitter
+        float                                m_particleSpawn = 0.0f;   // fractional particles owed
+        float                                m_debugDt = 0.0f;   // Update time since the last Collect
 
         Camera                               m_camera;
         Camera                               m_playerCam;
-        struct Player { float3 pos{ 0,0.5f,0 }; float yaw = 0.0f; } m_player;
-
-        bool                                 m_keys[256] = { false };
-        bool                                 m_rmb = false;
-        int                                  m_lastMouseX = 0;
-        int                                  m_lastMouseY = 0;
+        EntityWorld                          m_scene;
+        Entity                               m_player;      // Transform + Player
+        Entity                               m_testCube;    // Transform + MeshInstance; the shadow frustum follows it
+        RenderCommandQueue                   m_renderQueue;
+        RenderScene                          m_renderScene; // proxies with persistent matrices, bounds and BVH
+        enum CullViewIndex : uint32_t { kViewMain, kViewPlayer, kViewLight, kViewCount };
+        CullView                             m_views[kViewCount]{};
+        CullViewSet                          m_viewSet;
+        VisibilityMasks                      m_visibility;    // per view, by proxy id
+        Points                               m_playerFrustumPts{};
+
+        InputStream                          m_input;
+        InputState                           m_inputState;
 
         bool                                 m_showPlayerFrustum = true;
         bool                                 m_showGrid = true;
@@ -150,8 +244,6 @@ namespace GraphicsEngine
         HWND                                 m_hwnd = nullptr;
         uint32_t                             m_width = 1280, m_height = 720;
         float                                m_timeSinceTitle = 0.0f;
-        float                                m_fpsAccum = 0.0f;
-        int                                  m_fpsFrames = 0;
         float                                m_lastFPS = 0.0f;
 
         bool                                 m_vsync = true;
@@ -165,12 +257,17 @@ namespace GraphicsEngine
         float                                m_orbitDist = 6.0f;
         float3                               m_orbitFocus{ 0,0,0 };
 
-        float                                m_lastFrameMs = 0.0f;
-        std::array<float, 160>               m_frameTimes{};
-        int                                  m_ftHead = 0;
+        // Frame interval plus per-stage CPU times; written to frame_stats.csv/.json at Shutdown
+        FrameStats                           m_frameStats;
+        struct {
+            uint32_t update = 0, render = 0, waitForFrame = 0, cull = 0, shadow = 0, scene = 0;
+            uint32_t particles = 0, debugDraw = 0, hud = 0, text = 0, present = 0;
+        }                                    m_stage;
+        bool                                 m_showCounters = true;   // HUD counter readouts ('P')
 
         static constexpr float kBaseMoveSpeed = 5.0f;
         static constexpr float kSprintMul = 2.0f;
+        static constexpr uint64_t kStreamUploadBudget = 4u << 20;   // bytes installed per frame
 
         bool  m_useCullOverride = true;
         float m_cullNear = 0.1f;
@@ -184,10 +281,11 @@ namespace GraphicsEngine
 
         bool   m_showRandomCubes = true;
         bool   m_showTestCube = true;
+        bool   m_showParticles = true;
 
-        float3 m_testCubePos{ 9.4f, 0.9f, 0.0f };
-        float3 m_testCubeScale{ 1.0f, 11.0f, 1.0f };
-        float  m_testCubeYaw = 0.0f;
+        static constexpr uint32_t kParticleCapacity = 65536;
+        static constexpr float    kParticleRate = 6000.0f;     // spawned per second
+        static constexpr uint32_t kParticleBatch = 16384;      // quads per draw: 16-bit indices, 4 vertices each
 
         bool   m_shadowsEnabled = true;
         static constexpr UINT kShadowMapSize = 2048;
@@ -204,9 +302,8 @@ namespace GraphicsEngine
         D3D12_VIEWPORT                      m_shadowViewport{};
         D3D12_RECT                          m_shadowScissor{};
 
-        ComPtr<ID3D12PipelineState>         m_psoShadow;
-
         float4x4                            m_lightView = m_identity();
         float4x4                            m_lightProj = m_identity();
+        float3                              m_lightPos{ 0, 0, 0 };   // eye of m_lightView
     };
 }
@@ -0,0 +1,107 @@
+#pragma once
+#include "SolMath.h"
+#include <cstdint>
+#include <type_traits>
+
+namespace GraphicsEngine {
+
+// ----------------------------------------------------------------------------
+// Scene components. Plain data, trivially copyable: chunks move them with memcpy. Each one is
+// listed once in GE_COMPONENT_LIST, which fixes its id at compile time, so the engine DLL and the
+// game agree on ids without any registration step.
+// ----------------------------------------------------------------------------
+struct Transform {
+    float3 position{ 0, 0, 0 };
+    float  yaw = 0.0f;              // radians about +Y
+    float3 scale{ 1, 1, 1 };
+};
+
+struct Velocity {
+    float3 value{ 0, 0, 0 };
+};
+
+// World-space bounds, what culling tests
+struct Bounds {
+    AABB_t aabb{ { 0, 0, 0 }, { 0.5f, 0.5f, 0.5f } };
+};
+
+struct Color {
+    float3 rgb{ 1, 1, 1 };
+};
+
+// Drawn lit and into the shadow map with the renderer's cube mesh (the only mesh so far)
+struct MeshInstance {
+    uint32_t mesh = 0;
+};
+
+// The frustum-carrying player the arrow keys move
+struct Player {
+    float yaw = 0.0f;
+};
+
+// Driven by the game's physics: body indexes the game's body array, the transform is synced from it
+struct PhysicsBody {
+    uint32_t body = 0;
+};
+
+// The entity's proxy in the renderer's RenderScene; whoever changes what it draws from pushes the
+// change through the RenderCommandQueue
+struct RenderProxy {
+    uint32_t id = UINT32_MAX;
+};
+
+#define GE_COMPONENT_LIST(X) \
+    X(Transform)             \
+    X(Velocity)              \
+    X(Bounds)                \
+    X(Color)                 \
+    X(MeshInstance)          \
+    X(Player)                \
+    X(PhysicsBody)           \
+    X(RenderProxy)
+
+enum class ComponentType : uint32_t {
+#define GE_COMPONENT_ENUM(T) T,
+    GE_COMPONENT_LIST(GE_COMPONENT_ENUM)
+#undef GE_COMPONENT_ENUM
+    Count
+};
+
+static constexpr uint32_t kComponentTypeCount = uint32_t(ComponentType::Count);
+using ComponentMask = uint64_t;
+static_assert(kComponentTypeCount <= 64, "ComponentMask holds one bit per component type");
+
+template <typename T> struct ComponentTraits;   // only the listed components have an id
+
+#define GE_COMPONENT_TRAITS(T)                                                          \
+    static_assert(std::is_trivially_copyable_v<T>, #T " must be trivially copyable");   \
+    template <> struct ComponentTraits<T> { static constexpr uint32_t id = uint32_t(ComponentType::T); };
+GE_COMPONENT_LIST(GE_COMPONENT_TRAITS)
+#undef GE_COMPONENT_TRAITS
+
+template <typename T> concept SceneComponent = requires { ComponentTraits<std::remove_const_t<T>>::id; };
+
+template <typename T> inline constexpr uint32_t ComponentId = ComponentTraits<std::remove_const_t<T>>::id;
+template <typename... Ts> inline constexpr ComponentMask ComponentMaskOf = ((ComponentMask(1) << ComponentId<Ts>) | ... | ComponentMask(0));
+
+// What type-erased storage needs: size, alignment and the default-constructed value
+template <typename T> inline const T kComponentDefault{};
+
+struct ComponentInfo {
+    const char* name;
+    uint32_t    size, align;
+    const void* defaultValue;
+};
+
+inline const ComponentInfo kComponentInfo[kComponentTypeCount] = {
+#define GE_COMPONENT_INFO(T) { #T, uint32_t(sizeof(T)), uint32_t(alignof(T)), &kComponentDefault<T> },
+    GE_COMPONENT_LIST(GE_COMPONENT_INFO)
+#undef GE_COMPONENT_INFO
+};
+
+inline float4x4 TransformMatrix(const Transform& t)
+{
+    return m_trs(t.position, q_from_axis_angle(float3{ 0, 1, 0 }, t.yaw), t.scale);
+}
+
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "Export.h"
+#include "Culling.h"
+#include "SolMath.h"
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// Persistent AABB tree over objects that mostly stay put. Leaves hold a box fattened by a margin,
+// so an object moving inside it costs nothing; only one that leaves it is removed and reinserted
+// (surface-area heuristic for the sibling, height-balancing rotations on the way up). Frame cost
+// follows the objects that moved, not the tree size.
+class GRAPHICS_API DynamicBvh {
+public:
+    static constexpr uint32_t kNull = UINT32_MAX;
+    static constexpr uint32_t kMaxDepth = 96;
+
+    explicit DynamicBvh(float margin = 0.1f) : m_margin(margin) {}
+
+    // `mask` is ORed up the tree, so a query can skip subtrees without what it wants. Returns the leaf.
+    uint32_t Insert(const AABB_t& bounds, uint32_t data, uint32_t mask = 1);
+    void     Remove(uint32_t leaf);
+    // New exact bounds for a leaf; reinserts only if they left the fat box. Returns true if it did.
+    bool     Move(uint32_t leaf, const AABB_t& bounds);
+    void     Clear();
+
+    uint32_t LeafCount() const { return m_leaves; }
+    uint32_t Height() const { return m_root == kNull ? 0 : m_nodes[m_root].height; }
+
+    // fn(data, inside) per leaf whose fat box passes the view and whose mask shares a bit with
+    // `mask`; inside = the whole fat box is in front of every plane, so callers can skip their exact
+    // test. Planes a node is fully inside are not tested again below it. Returns nodes tested.
+    template <typename Fn> uint32_t Query(const CullView& view, uint32_t mask, Fn&& fn) const
+    {
+        if (m_root == kNull || !(m_nodes[m_root].mask & mask)) return 0;
+        struct Item { uint32_t node, planes; };
+        Item stack[kMaxDepth];
+        uint32_t top = 0, tested = 0;
+        stack[top++] = { m_root, 0x3Fu };
+
+        while (top) {
+            const Item it = stack[--top];
+            const Node& n = m_nodes[it.node];
+            uint32_t planes = it.planes;
+            if (planes) {
+                tested++;
+                const float3 c = (n.min + n.max) * 0.5f, e = (n.max - n.min) * 0.5f;
+                bool outside = false;
+                for (uint32_t p = 0; p < 6 && !outside; p++) {
+                    if (!(planes & (1u << p))) continue;
+                    const Plane_t& pl = view.planes[p];
+                    const float r = std::fabs(pl.normal.x) * e.x + std::fabs(pl.normal.y) * e.y + std::fabs(pl.normal.z) * e.z;
+                    const float s = plane_signed_distance(pl, c);
+                    if (s < -r) outside = true;
+                    else if (s > r) planes &= ~(1u << p);
+                }
+                if (outside) continue;
+            }
+            if (n.IsLeaf()) { fn(n.data, planes == 0); continue; }
+            assert(top + 2 <= kMaxDepth);
+            for (uint32_t ch : n.child)
+                if (m_nodes[ch].mask & mask) stack[top++] = { ch, planes };
+        }
+        return tested;
+    }
+
+    // Query for several views in one walk. masks[v] is view v's `mask`. fn(data, partial, inside)
+    // per leaf some view may see: `inside` = the views an ancestor was wholly in front of the planes
+    // of, `partial` = the views still undecided, which the caller settles with its exact bounds (the
+    // leaf's fat box is not tested, that would only repeat it). Each node is loaded once and
+    // classified against every view still testing it, four per SSE op; a view stops testing a
+    // subtree once it rejects or contains it. Returns boxes tested, a leaf's exact test included.
+    template <typename Fn> uint32_t QueryViews(const CullViewSet& views, std::span<const uint32_t> masks, Fn&& fn) const
+    {
+        assert(masks.size() == views.Count());
+        // Views wanting each mask bit, so a node's wanting views are an OR over its (few) bits
+        uint32_t wantBit[32] = {};
+        uint32_t anyMask = 0;
+        for (uint32_t v = 0; v < views.Count(); v++) {
+            anyMask |= masks[v];
+            for (uint32_t bits = masks[v]; bits; bits &= bits - 1) wantBit[std::countr_zero(bits)] |= 1u << v;
+        }
+        auto wanting = [&](uint32_t mask) {
+            uint32_t w = 0;
+            for (mask &= anyMask; mask; mask &= mask - 1) w |= wantBit[std::countr_zero(mask)];
+            return w;
+        };
+
+        if (m_root == kNull || !(m_nodes[m_root].mask & anyMask)) return 0;
+        struct Item { uint32_t node, testing, inside; };
+        Item stack[kMaxDepth];
+        uint32_t top = 0, tested = 0;
+        stack[top++] = { m_root, views.AllViews(), 0 };
+
+        while (top) {
+            const Item it = stack[--top];
+            const Node& n = m_nodes[it.node];
+            const uint32_t want = wanting(n.mask);
+            uint32_t testing = it.testing & want, inside = it.inside & want;
+            // A leaf's fat box would only repeat the caller's exact test
+            if (n.IsLeaf()) {
+                tested += testing != 0;
+                if (testing || inside) fn(n.data, testing, inside);
+                continue;
+            }
+            if (testing) {
+                tested++;
+                uint32_t contained = 0;
+                testing = views.Classify((n.min + n.max) * 0.5f, (n.max - n.min) * 0.5f, testing, &contained);
+                inside |= contained;
+                testing &= ~contained;
+            }
+            if (!testing && !inside) continue;
+            assert(top + 2 <= kMaxDepth);
+            for (uint32_t ch : n.child)
+                if (m_nodes[ch].mask & anyMask) stack[top++] = { ch, testing, inside };
+        }
+        return tested;
+    }
+
+private:
+    struct Node {
+        float3   min, max;
+        uint32_t parent = kNull;      // next free node while on the free list
+        uint32_t child[2] = { kNull, kNull };
+        uint32_t height = 0;          // leaves are 0
+        uint32_t mask = 0;
+        uint32_t data = 0;
+
+        bool IsLeaf() const { return child[0] == kNull; }
+    };
+
+    uint32_t AllocateNode();
+    void     FreeNode(uint32_t i);
+    void     InsertLeaf(uint32_t leaf);
+    void     RemoveLeaf(uint32_t leaf);
+    // Re-derives bounds, height and mask from the children, from `i` to the root, rotating as it goes
+    void     Refit(uint32_t i);
+    uint32_t Balance(uint32_t a);
+    void     Combine(uint32_t i);
+
+    std::vector<Node> m_nodes;
+    uint32_t          m_root = kNull;
+    uint32_t          m_free = kNull;
+    uint32_t          m_leaves = 0;
+    float             m_margin;
+};
+
+}
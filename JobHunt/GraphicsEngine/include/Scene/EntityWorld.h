@@ -0,0 +1,249 @@
+#pragma once
+#include "Export.h"
+#include "Core/JobSystem.h"
+#include "Scene/Components.h"
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GraphicsEngine {
+
+struct Entity {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != UINT32_MAX; }
+    bool operator==(const Entity&) const = default;
+};
+
+// kChunkBytes of rows for one archetype: the entity ids, then one array per component
+struct ArchetypeChunk {
+    std::byte* data = nullptr;
+    uint32_t   count = 0;
+};
+
+// Every entity with exactly one set of components lives in one archetype, packed into chunks
+// (rows stay dense: removal moves the last row into the hole, so only the last chunk is partial).
+class Archetype {
+public:
+    static constexpr uint32_t kChunkBytes = 16 * 1024;
+    static constexpr uint32_t kAbsent = UINT32_MAX;
+
+    explicit Archetype(ComponentMask mask);
+    ~Archetype();
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    ComponentMask         Mask() const { return m_mask; }
+    uint32_t              Capacity() const { return m_capacity; }    // rows per chunk
+    uint32_t              Count() const { return m_count; }
+    uint32_t              ChunkCount() const { return (uint32_t)m_chunks.size(); }
+    const ArchetypeChunk& Chunk(uint32_t i) const { return m_chunks[i]; }
+    // Byte offset of a component's array in every chunk, kAbsent if this archetype lacks it
+    uint32_t              ColumnOffset(uint32_t component) const { return m_offsets[component]; }
+
+    std::byte* Row(uint32_t row, uint32_t component) const
+    {
+        return m_chunks[row / m_capacity].data + m_offsets[component] + size_t(row % m_capacity) * kComponentInfo[component].size;
+    }
+    Entity& RowEntity(uint32_t row) const
+    {
+        return reinterpret_cast<Entity*>(m_chunks[row / m_capacity].data)[row % m_capacity];
+    }
+
+private:
+    friend class EntityWorld;
+
+    uint32_t PushRow(Entity e);
+    // Swap-remove; returns the entity that moved into `row` (invalid if `row` was the last)
+    Entity   RemoveRow(uint32_t row);
+
+    ComponentMask               m_mask;
+    uint32_t                    m_capacity = 0;
+    uint32_t                    m_count = 0;
+    uint32_t                    m_offsets[kComponentTypeCount];
+    uint32_t                    m_edges[kComponentTypeCount];   // archetype with that bit flipped, once looked up
+    std::vector<ArchetypeChunk> m_chunks;
+    std::byte*                  m_spare = nullptr;              // last freed chunk, so add/remove churn does not hit the heap
+};
+
+// Structural changes recorded for later: what jobs iterating chunks use instead of touching the
+// world. Played back in recording order by EntityWorld::Playback.
+class EntityCommandBuffer {
+public:
+    // No handle comes back; the entity exists after playback
+    template <typename... Ts> void Create(const Ts&... components)
+    {
+        Put(Op::Create);
+        Put(uint32_t(sizeof...(Ts)));
+        (PutComponent(components), ...);
+    }
+    void Destroy(Entity e) { Put(Op::Destroy); Put(e); }
+    template <typename T> void Add(Entity e, const T& value) { Put(Op::Add); Put(e); PutComponent(value); }
+    template <typename T> void Remove(Entity e) { Put(Op::Remove); Put(e); Put(ComponentId<T>); }
+
+    bool Empty() const { return m_data.empty(); }
+    void Clear() { m_data.clear(); }
+
+private:
+    friend class EntityWorld;
+    enum class Op : uint8_t { Create, Destroy, Add, Remove };
+
+    template <typename T> void Put(const T& v)
+    {
+        const size_t at = m_data.size();
+        m_data.resize(at + sizeof(T));
+        std::memcpy(m_data.data() + at, &v, sizeof(T));
+    }
+    template <typename T> void PutComponent(const T& v) { Put(ComponentId<T>); Put(v); }
+
+    std::vector<std::byte> m_data;
+};
+
+// Archetype ECS. Entities are generation-checked handles; components are the plain structs of
+// Scene/Components.h, stored per archetype in 16 KB SoA chunks. Queries name a component set and
+// get the chunks of every archetype that has it, as raw arrays. Structural changes (create,
+// destroy, add, remove) are not allowed while iterating; record them in an EntityCommandBuffer.
+class GRAPHICS_API EntityWorld {
+public:
+    EntityWorld();
+    ~EntityWorld();
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    // values[id] per component in mask (indexed by component id); null entries are defaults
+    Entity Create(ComponentMask mask, const void* const* values = nullptr);
+    template <SceneComponent... Ts> Entity Create(const Ts&... components)
+    {
+        const void* values[kComponentTypeCount] = {};
+        ((values[ComponentId<Ts>] = &components), ...);
+        return Create(ComponentMaskOf<Ts...>, values);
+    }
+    void     Destroy(Entity e);
+    bool     IsAlive(Entity e) const;
+    uint32_t EntityCount() const { return m_alive; }
+
+    // value null = default; sets the value if the component is already there
+    void          AddComponent(Entity e, uint32_t component, const void* value);
+    void          RemoveComponent(Entity e, uint32_t component);
+    void*         GetComponent(Entity e, uint32_t component) const;   // null if dead or missing
+    ComponentMask GetMask(Entity e) const;
+
+    template <typename T> void     Add(Entity e, const T& value) { AddComponent(e, ComponentId<T>, &value); }
+    template <typename T> void     Remove(Entity e) { RemoveComponent(e, ComponentId<T>); }
+    template <typename T> T*       Get(Entity e) { return static_cast<T*>(GetComponent(e, ComponentId<T>)); }
+    template <typename T> const T* Get(Entity e) const { return static_cast<const T*>(GetComponent(e, ComponentId<T>)); }
+    template <typename T> bool     Has(Entity e) const { return (GetMask(e) >> ComponentId<T>) & 1; }
+
+    // Archetypes with every component of `all` and none of `none`. Cached per (all, none) and
+    // extended with archetypes created since the last call, so a repeated query is a lookup.
+    const std::vector<Archetype*>& Match(ComponentMask all, ComponentMask none = 0);
+    uint32_t                       ArchetypeCount() const { return (uint32_t)m_archetypes.size(); }
+
+    // fn(count, const Entity*, Ts*...) per chunk holding all of Ts (const Ts for read-only access)
+    template <typename... Ts, typename Fn> void ForEachChunk(Fn&& fn)
+    {
+        static_assert(sizeof...(Ts) > 0, "name at least one component");
+        IterationScope scope(*this);
+        for (Archetype* a : Match(ComponentMaskOf<Ts...>)) {
+            const uint32_t offsets[] = { a->ColumnOffset(ComponentId<Ts>)... };
+            for (const ArchetypeChunk& c : a->m_chunks)
+                CallChunk<Ts...>(fn, c, offsets, std::index_sequence_for<Ts...>{});
+        }
+    }
+
+    // fn(Entity, Ts&...) per entity
+    template <typename... Ts, typename Fn> void ForEach(Fn&& fn)
+    {
+        ForEachChunk<Ts...>([&](uint32_t count, const Entity* entities, Ts*... columns) {
+            for (uint32_t i = 0; i < count; i++) fn(entities[i], columns[i]...);
+        });
+    }
+
+    // ForEachChunk with chunks spread over the job system. If fn also takes an EntityCommandBuffer&
+    // first, each chunk records into its own buffer and they are played back in chunk order after
+    // the join, so the result does not depend on scheduling.
+    template <typename... Ts, typename Fn> void ParallelForEachChunk(JobSystem& jobs, Fn&& fn, uint32_t grain = 1)
+    {
+        static_assert(sizeof...(Ts) > 0, "name at least one component");
+        constexpr bool deferred = std::is_invocable_v<Fn&, EntityCommandBuffer&, uint32_t, const Entity*, Ts*...>;
+
+        m_parallelChunks.clear();
+        for (Archetype* a : Match(ComponentMaskOf<Ts...>))
+            for (const ArchetypeChunk& c : a->m_chunks) m_parallelChunks.push_back({ a, &c });
+        const uint32_t count = (uint32_t)m_parallelChunks.size();
+        if constexpr (deferred)
+            if (m_chunkCommands.size() < count) m_chunkCommands.resize(count);
+
+        {
+            IterationScope scope(*this);
+            jobs.ParallelFor(count, grain, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    const ChunkRef& r = m_parallelChunks[i];
+                    const uint32_t offsets[] = { r.archetype->ColumnOffset(ComponentId<Ts>)... };
+                    if constexpr (deferred) {
+                        EntityCommandBuffer& cmds = m_chunkCommands[i];
+                        CallChunk<Ts...>([&](auto... args) { fn(cmds, args...); }, *r.chunk, offsets, std::index_sequence_for<Ts...>{});
+                    } else {
+                        CallChunk<Ts...>(fn, *r.chunk, offsets, std::index_sequence_for<Ts...>{});
+                    }
+                }
+            });
+        }
+        if constexpr (deferred)
+            for (uint32_t i = 0; i < count; i++) Playback(m_chunkCommands[i]);
+    }
+
+    // Applies the recorded changes in order, then clears the buffer. Commands on entities that
+    // died in the meantime are skipped.
+    void Playback(EntityCommandBuffer& cmds);
+
+private:
+    struct EntityRecord {
+        uint32_t generation = 0;
+        uint32_t archetype = UINT32_MAX;   // UINT32_MAX: free slot
+        uint32_t row = 0;
+    };
+    struct QueryCache {
+        ComponentMask           all, none;
+        std::vector<Archetype*> archetypes;
+        size_t                  seen = 0;    // archetypes already tested
+    };
+    struct ChunkRef {
+        Archetype*            archetype;
+        const ArchetypeChunk* chunk;
+    };
+    struct IterationScope {
+        EntityWorld& world;
+        explicit IterationScope(EntityWorld& w) : world(w) { world.m_iterating++; }
+        ~IterationScope() { world.m_iterating--; }
+    };
+
+    template <typename... Ts, typename Fn, size_t... I>
+    static void CallChunk(Fn&& fn, const ArchetypeChunk& c, const uint32_t* offsets, std::index_sequence<I...>)
+    {
+        fn(c.count, reinterpret_cast<const Entity*>(c.data), reinterpret_cast<Ts*>(c.data + offsets[I])...);
+    }
+
+    uint32_t GetArchetype(ComponentMask mask);
+    uint32_t ArchetypeWithToggled(uint32_t archetype, uint32_t component);
+    void     MoveEntity(Entity e, uint32_t toArchetype);
+    const EntityRecord* Find(Entity e) const;
+
+    std::vector<EntityRecord>                 m_records;
+    std::vector<uint32_t>                     m_freeSlots;
+    uint32_t                                  m_alive = 0;
+    std::vector<std::unique_ptr<Archetype>>   m_archetypes;
+    std::unordered_map<ComponentMask, uint32_t> m_archetypeByMask;
+    std::vector<std::unique_ptr<QueryCache>>  m_queries;
+    uint32_t                                  m_iterating = 0;
+    std::vector<ChunkRef>                     m_parallelChunks;
+    std::vector<EntityCommandBuffer>          m_chunkCommands;
+};
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "Export.h"
+#include "Culling.h"
+#include "SolMath.h"
+#include "Scene/DynamicBvh.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace GraphicsEngine {
+
+using RenderProxyId = uint32_t;
+static constexpr RenderProxyId kInvalidProxy = UINT32_MAX;
+
+// What a proxy is drawn as; also the BVH mask, so a query for one kind skips subtrees of the other
+enum RenderProxyKind : uint32_t {
+    kProxyMesh     = 1u << 0,   // lit + shadow pass, the renderer's cube mesh
+    kProxyDebugBox = 1u << 1,   // DebugDraw::Box of the world bounds
+};
+
+struct RenderProxyDesc {
+    float4x4 world = m_identity();
+    AABB_t   localBounds{ { 0, 0, 0 }, { 0.5f, 0.5f, 0.5f } };
+    float3   color{ 1, 1, 1 };
+    uint32_t mesh = 0;
+    uint32_t material = 0;    // draw bucket: proxies sharing one are submitted with one indirect call
+    uint32_t kind = kProxyMesh;
+    bool     visible = true;
+};
+
+// The game side of the render scene: records proxy changes and hands them over in batches.
+// Recording is single-producer (the thread that runs the game update); Submit is the only point
+// that synchronises with the render side. Ids are allocated here, so they are usable at once.
+class GRAPHICS_API RenderCommandQueue {
+public:
+    RenderProxyId Create(const RenderProxyDesc& desc);
+    void          Destroy(RenderProxyId id);
+    void          SetTransform(RenderProxyId id, const float4x4& world);
+    void          SetBounds(RenderProxyId id, const AABB_t& localBounds);
+    void          SetVisible(RenderProxyId id, bool visible);
+
+    // Publishes everything recorded since the last Submit
+    void Submit();
+
+private:
+    friend class RenderScene;
+    enum class Op : uint8_t { Create, Destroy, SetTransform, SetBounds, SetVisible };
+
+    template <typename T> void Put(const T& v)
+    {
+        const size_t at = m_recording.size();
+        m_recording.resize(at + sizeof(T));
+        std::memcpy(m_recording.data() + at, &v, sizeof(T));
+    }
+
+    std::vector<std::byte>     m_recording;
+    std::vector<RenderProxyId> m_freeIds;
+    RenderProxyId              m_nextId = 0;
+
+    std::mutex                 m_lock;
+    std::vector<std::byte>     m_submitted;   // guarded by m_lock
+};
+
+// The render side: proxies with persistent world matrices, world bounds and BVH leaves. Nothing
+// is recomputed per frame; ApplyUpdates touches only the proxies the commands named, and culling
+// walks the BVH.
+class GRAPHICS_API RenderScene {
+public:
+    struct UpdateStats {
+        uint32_t commands = 0;
+        uint32_t dirty = 0;        // proxies whose bounds were recomputed
+        uint32_t reinserted = 0;   // of those, the ones that left their fat BVH box
+    };
+
+    // Render thread, once per frame before culling
+    UpdateStats ApplyUpdates(RenderCommandQueue& queue);
+
+    // fn(id, inside) per visible proxy of `kinds` whose world bounds pass `view`; inside = the
+    // proxy is wholly in front of every plane. Returns the number of BVH nodes tested.
+    template <typename Fn> uint32_t Cull(const CullView& view, uint32_t kinds, Fn&& fn) const
+    {
+        return m_bvh.Query(view, kinds, [&](uint32_t id, bool inside) {
+            if (inside) fn(id, true);
+            else if (AabbVisible(view, m_worldBounds[id])) fn(id, false);
+        });
+    }
+    // Every view at once: one BVH walk leaves view v's visible proxies of kinds[v] as bits in
+    // out.View(v), with the same result Cull would give per view. Returns the number of BVH nodes tested.
+    uint32_t CullViews(const CullViewSet& views, std::span<const uint32_t> kinds, VisibilityMasks& out) const;
+    // fn(id) per visible proxy of `kinds`, unculled
+    template <typename Fn> void ForEach(uint32_t kinds, Fn&& fn) const
+    {
+        for (RenderProxyId id = 0; id < (RenderProxyId)m_state.size(); id++)
+            if (m_state[id].alive && m_state[id].visible && (m_state[id].kind & kinds)) fn(id);
+    }
+
+    const float4x4& World(RenderProxyId id) const { return m_world[id]; }
+    const AABB_t&   WorldBounds(RenderProxyId id) const { return m_worldBounds[id]; }
+    const float3&   Color(RenderProxyId id) const { return m_state[id].color; }
+    uint32_t        Mesh(RenderProxyId id) const { return m_state[id].mesh; }
+    uint32_t        Material(RenderProxyId id) const { return m_state[id].material; }
+    uint32_t        ProxyCount() const { return m_alive; }
+    // Live proxies of any of `kinds`, visible or not
+    uint32_t        ProxyCount(uint32_t kinds) const;
+    const DynamicBvh& Bvh() const { return m_bvh; }
+
+private:
+    struct ProxyState {
+        AABB_t   localBounds;
+        float3   color;
+        uint32_t mesh = 0;
+        uint32_t material = 0;
+        uint32_t kind = 0;
+        uint32_t leaf = DynamicBvh::kNull;
+        bool     alive = false;
+        bool     visible = false;
+        bool     dirty = false;
+    };
+
+    void MarkDirty(RenderProxyId id);
+    void CountKind(uint32_t kind, int delta);
+
+    // Hot data apart from the rest: culling reads bounds, drawing reads matrices
+    std::vector<float4x4>      m_world;
+    std::vector<AABB_t>        m_worldBounds;
+    std::vector<ProxyState>    m_state;
+    std::vector<RenderProxyId> m_dirty;
+    std::vector<std::byte>     m_applying;    // swapped with the queue's submitted batch
+    DynamicBvh                 m_bvh;
+    uint32_t                   m_alive = 0;
+    uint32_t                   m_kindCount[32] = {};   // per RenderProxyKind bit
+};
+
+}
@@ -86,7 +86,12 @@ struct float3 {
 inline float3 operator*(float s, const float3& v){ return v*s; }
 
 struct float4 {
+#if defined(_MSC_VER)
     union { struct { float x,y,z,w; }; float3 xyz; struct { float2 xy, zw; }; };
+#else
+    // GCC/Clang reject non-trivial members inside anonymous structs; xy/zw are MSVC-only.
+    union { struct { float x,y,z,w; }; float3 xyz; };
+#endif
     float4() : x(0),y(0),z(0),w(0) {}
     float4(float X,float Y,float Z,float W):x(X),y(Y),z(Z),w(W){}
     float& operator[](int i)       { return (&x)[i]; }
@@ -151,8 +156,8 @@ struct quat {
 inline quat q_identity(){ return {}; }
 inline quat q_from_axis_angle(const float3& axis, float radians){
     float3 a = normalize_safe(axis, {0,0,1});
-    float s = std::sinf(radians*0.5f);
-    float c = std::cosf(radians*0.5f);
+    float s = std::sin(radians*0.5f);
+    float c = std::cos(radians*0.5f);
     return { a.x*s, a.y*s, a.z*s, c };
 }
 inline quat q_mul(const quat& a, const quat& b){
@@ -195,13 +200,20 @@ inline quat q_slerp(const quat& a, const quat& b, float t){
     if (dotp > 0.9995f) {
         return q_normalize({ lerp(q1.x,q2.x,t), lerp(q1.y,q2.y,t), lerp(q1.z,q2.z,t), lerp(q1.w,q2.w,t) });
     }
-    float theta0 = std::acosf(dotp);
+    float theta0 = std::acos(dotp);
     float theta  = theta0 * t;
-    float s0 = std::sinf(theta0 - theta);
-    float s1 = std::sinf(theta);
-    float inv = 1.0f/std::sinf(theta0);
+    float s0 = std::sin(theta0 - theta);
+    float s1 = std::sin(theta);
+    float inv = 1.0f/std::sin(theta0);
     return { (q1.x*s0 + q2.x*s1)*inv, (q1.y*s0 + q2.y*s1)*inv, (q1.z*s0 + q2.z*s1)*inv, (q1.w*s0 + q2.w*s1)*inv };
 }
+inline float q_dot(const quat& a, const quat& b){ return a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w; }
+// Normalized lerp along the shorter arc: not constant speed like q_slerp, but no trig, and close
+// enough between keyframes or for blend weights (the usual choice for animation)
+inline quat q_nlerp(const quat& a, const quat& b, float t){
+    float ta = 1.0f - t, tb = (q_dot(a,b) < 0.0f) ? -t : t;
+    return q_normalize({ a.x*ta + b.x*tb, a.y*ta + b.y*tb, a.z*ta + b.z*tb, a.w*ta + b.w*tb });
+}
 
 // --- Add: OBB type used by obb_intersects_obb -------------------------------
 struct OBB {
@@ -312,7 +324,7 @@ inline float4x4 m_scale(const float3& s){
 }
 inline float4x4 m_rotation_axis(const float3& axis, float radians){
     float3 a = normalize_safe(axis, {0,0,1});
-    float  c = std::cosf(radians), s = std::sinf(radians), t = 1.0f - c;
+    float  c = std::cos(radians), s = std::sin(radians), t = 1.0f - c;
     float x=a.x, y=a.y, z=a.z;
     return {
         float4{ t*x*x + c,   t*x*y + s*z, t*x*z - s*y, 0 },
@@ -367,7 +379,7 @@ inline float4x4 m_inverse_affine(const float4x4& m){
 // Projection and view (row-major, row vectors). LH/RH based on SOL_MATH_LH.
 // -----------------------------------------------------------------------------
 inline float4x4 perspective_fov(float fovY, float aspect, float zn, float zf){
-    float y = 1.0f / std::tanf(fovY*0.5f);
+    float y = 1.0f / std::tan(fovY*0.5f);
     float x = y / aspect;
 #if SOL_MATH_LH
     return { float4{ x,0,0,0 }, float4{ 0,y,0,0 }, float4{ 0,0, zf/(zf-zn), 1 },
@@ -459,8 +471,8 @@ inline void frustum_build(TheFrustum_t& fr, Points& pt, const float4x4& viewCW,
     const float3 pos   = viewCW[3].xyz;
     const float3 nc = pos + fwd*zn;
     const float3 fc = pos + fwd*zf;
-    const float halfHn = std::tanf(fovY*0.5f)*zn;
-    const float halfHf = std::tanf(fovY*0.5f)*zf;
+    const float halfHn = std::tan(fovY*0.5f)*zn;
+    const float halfHf = std::tan(fovY*0.5f)*zf;
     const float halfWn = halfHn*aspect;
     const float halfWf = halfHf*aspect;
 
@@ -477,8 +489,8 @@ inline void frustum_build(TheFrustum_t& fr, Points& pt, const float4x4& viewCW,
     fr[F_FAR] = plane_from_points(pt[FAR_TopLeft], pt[FAR_TopRight], pt[FAR_BottomRight]);
     fr[F_LEFT] = plane_from_points(pt[NEAR_TopLeft], pt[FAR_TopLeft], pt[FAR_BottomLeft]);
     fr[F_RIGHT] = plane_from_points(pt[FAR_TopRight], pt[NEAR_TopRight], pt[NEAR_BottomRight]);
-    fr[F_TOP] = plane_from_points(pt[FAR_TopLeft], pt[FAR_TopRight], pt[NEAR_TopRight]);
-    fr[F_BOTTOM] = plane_from_points(pt[FAR_BottomRight], pt[FAR_BottomLeft], pt[NEAR_BottomLeft]);
+    fr[F_TOP] = plane_from_points(pt[FAR_TopRight], pt[FAR_TopLeft], pt[NEAR_TopRight]);
+    fr[F_BOTTOM] = plane_from_points(pt[FAR_BottomLeft], pt[FAR_BottomRight], pt[NEAR_BottomLeft]);
 
 }
 inline bool aabb_in_frustum(const AABB_t& b, const TheFrustum_t& fr){
@@ -654,6 +666,56 @@ inline DecomposeTRS decompose_trs_with_shear(const float4x4& m) {
     return out;
 }
 
+// -----------------------------------------------------------------------------
+// Dual quaternion: a rigid transform (rotation, then translation) as real + eps*dual,
+// dual = 0.5 * (t,0) * real. Weighted sums of them stay rigid after dq_normalize, which
+// is why skinning blends these instead of matrices (no collapsing joints).
+// -----------------------------------------------------------------------------
+struct dualquat {
+    quat real;
+    quat dual{0,0,0,0};
+};
+
+inline dualquat dq_identity(){ return {}; }
+inline dualquat dq_from_rotation_translation(const quat& r, const float3& t){
+    quat d = q_mul(quat{t.x, t.y, t.z, 0.0f}, r);
+    return { r, quat{ 0.5f*d.x, 0.5f*d.y, 0.5f*d.z, 0.5f*d.w } };
+}
+// Rigid part of an affine row-vector matrix (scale and shear are dropped)
+inline dualquat dq_from_matrix(const float4x4& m){
+    DecomposeTRS d = decompose_trs_with_shear(m);
+    if (!d.success) return dq_from_rotation_translation(q_identity(), { m[3].x, m[3].y, m[3].z });
+    // decompose hands q_from_matrix3_rows the transposed basis; for row vectors that is the inverse
+    return dq_from_rotation_translation(q_conjugate(d.rotation), d.translation);
+}
+inline float3 dq_translation(const dualquat& q){
+    quat t = q_mul(q.dual, q_conjugate(q.real));
+    return { 2.0f*t.x, 2.0f*t.y, 2.0f*t.z };
+}
+inline dualquat dq_normalize(const dualquat& q){
+    float len = std::sqrt(q_dot(q.real, q.real));
+    if (len < SOL_MATH_EPS) return dq_identity();
+    float inv = 1.0f/len;
+    return { quat{ q.real.x*inv, q.real.y*inv, q.real.z*inv, q.real.w*inv },
+             quat{ q.dual.x*inv, q.dual.y*inv, q.dual.z*inv, q.dual.w*inv } };
+}
+// Unit dual quaternion applied to a point / a direction
+inline float3 dq_transform_dir(const dualquat& q, const float3& v){
+    float3 r{ q.real.x, q.real.y, q.real.z };
+    return v + 2.0f * cross(r, cross(r, v) + q.real.w * v);
+}
+inline float3 dq_transform_point(const dualquat& q, const float3& p){
+    float3 r{ q.real.x, q.real.y, q.real.z }, d{ q.dual.x, q.dual.y, q.dual.z };
+    float3 t = 2.0f * (q.real.w * d - q.dual.w * r + cross(r, d));
+    return dq_transform_dir(q, p) + t;
+}
+inline float4x4 m_from_dualquat(const dualquat& q){
+    float4x4 m = m_from_quat(q.real);
+    float3 t = dq_translation(q);
+    m[3] = float4{ t.x, t.y, t.z, 1.0f };
+    return m;
+}
+
 // -----------------------------------------------------------------------------
 // OBB-OBB intersection (Separating Axis Theorem)
 // Precise test across 15 candidate axes: A's 3, B's 3, and 9 cross products.
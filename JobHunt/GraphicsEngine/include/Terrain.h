@@ -0,0 +1,146 @@
+#pragma once
+#include "SolMath.h"
+#include "Geometry.h"
+#include "Culling.h"
+#include "Assets/AssetStreamer.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+
+namespace GraphicsEngine {
+
+// ----------------------------------------------------------------------------
+// On-disk layout (little endian):
+//   TerrainFileHeader | tiles (row-major, (tileSize+1)^2 uint16 each, border shared with neighbour)
+//   | min/max pyramid (uint16 pairs, level 0 = leaves first) | base map (baseSize+1)^2 uint16
+// Tiles are read individually at runtime; the pyramid and base map stay resident.
+// ----------------------------------------------------------------------------
+struct TerrainFileHeader {
+    char     magic[4] = { 'G','E','T','R' };
+    uint32_t version = 1;
+    uint32_t size = 0;          // quads per side (samples per side = size + 1)
+    uint32_t tileSize = 0;      // quads per tile side
+    uint32_t leafSize = 0;      // quads per quadtree leaf side
+    uint32_t levels = 0;        // quadtree levels (root = leafSize << (levels-1))
+    uint32_t baseSize = 0;      // quads per side of the always-resident low-res map
+    float    sampleSpacing = 1.0f;
+    float    heightScale = 1.0f;
+    float    heightOffset = 0.0f;
+    uint64_t tilesOffset = 0;
+    uint64_t pyramidOffset = 0;
+    uint64_t baseOffset = 0;
+};
+static_assert(sizeof(TerrainFileHeader) == 64, "TerrainFileHeader layout is part of the file format");
+
+struct TerrainBuildDesc {
+    uint32_t size = 16384;
+    uint32_t tileSize = 256;
+    uint32_t leafSize = 32;
+    uint32_t baseSize = 512;
+    float    sampleSpacing = 1.0f;
+    float    heightScale = 100.0f;
+    float    heightOffset = 0.0f;
+};
+// Fills w*h samples starting at (x0,z0); coordinates may reach size (inclusive), the callee clamps.
+using TerrainSampleFn = std::function<void(uint32_t x0, uint32_t z0, uint32_t w, uint32_t h, uint16_t* out)>;
+
+// Offline: streams the source tile by tile, so a 16k x 16k map never has to be resident.
+bool BuildTerrainFile(const std::string& path, const TerrainBuildDesc& desc, const TerrainSampleFn& source);
+
+// One selected quadtree area, drawn with a shared (quads+1)^2 patch whose odd vertices morph
+// toward the next coarser level as the camera moves away.
+struct TerrainNode {
+    uint32_t x = 0, z = 0;      // origin in quads
+    uint32_t level = 0;
+    uint32_t quads = 0;         // gridDim (full node) or gridDim/2 (quadrant rendered at this level)
+    uint32_t firstVertex = 0;   // into the vertex stream written by WriteVertices
+};
+
+struct TerrainMemoryStats {
+    size_t pyramidBytes = 0;
+    size_t baseBytes = 0;
+    size_t tileBytes = 0;
+    uint32_t residentTiles = 0;
+    uint32_t totalTiles = 0;
+};
+
+class Terrain {
+public:
+    ~Terrain() { Close(); }
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    void SetOrigin(const float3& origin) { m_origin = origin; }
+    // gridDim quads per node patch, lodDistance = visibility range of level 0 (world units, doubles per level)
+    void SetLod(uint32_t gridDim, float lodDistance, float morphStartRatio = 0.66f);
+    void SetTileBudget(uint32_t maxResidentTiles) { m_tileBudget = maxResidentTiles; }
+    // Tiles are read asynchronously through the streamer (installed from its PumpUploads);
+    // without one StreamTiles reads them synchronously. The streamer must outlive the terrain.
+    void SetStreamer(AssetStreamer* streamer);
+
+    // CDLOD quadtree selection (frustum culled, distance ranges per level)
+    void Select(const float3& eye, const CullView* view);
+    // Loads (or requests) missing tiles for the current selection, closest first, and evicts LRU
+    // tiles over budget. Streamed tiles no longer needed are cancelled. Returns tiles loaded / requested.
+    uint32_t StreamTiles(const float3& eye, uint32_t maxLoads);
+
+    const std::vector<TerrainNode>& GetNodes() const { return m_nodes; }
+    uint32_t GetVertexCount() const { return m_vertexCount; }
+    void     WriteVertices(VertexPNC* dst, const float3& eye) const;
+
+    // Shared patch topology (uint16 triangle list), full or quadrant patch
+    const std::vector<uint16_t>& GetPatchIndices(bool quadrant) const { return quadrant ? m_patchHalf : m_patchFull; }
+
+    float SampleHeight(float sx, float sz) const;   // in samples, bilinear
+    float GetHeightAt(float worldX, float worldZ) const;
+    TerrainMemoryStats GetMemoryStats() const;
+    const TerrainFileHeader& GetHeader() const { return m_hdr; }
+
+private:
+    struct Tile { int32_t index = -1; uint64_t lastUsed = 0; std::vector<uint16_t> samples; };
+
+    uint32_t NodesPerSide(uint32_t level) const { return (m_hdr.size / m_hdr.leafSize) >> level; }
+    void     NodeMinMax(uint32_t level, uint32_t nx, uint32_t nz, float& mn, float& mx) const;
+    AABB_t   NodeBounds(uint32_t level, uint32_t nx, uint32_t nz) const;
+    bool     SelectNode(const float3& eye, const CullView* view, uint32_t level, uint32_t nx, uint32_t nz);
+    void     AddNode(uint32_t x, uint32_t z, uint32_t level, uint32_t quads);
+    float    RawSample(uint32_t x, uint32_t z) const;   // 0..65535, tile if resident else base map
+    void     BuildPatch(uint32_t quads, std::vector<uint16_t>& out) const;
+    bool     LoadTile(int32_t tileIndex, Tile& slot);
+    int32_t  AcquireSlot();                       // free or LRU slot not used this frame, -1 if none
+    void     InstallTile(int32_t tileIndex, const uint8_t* data, size_t size);
+    void     CancelStreaming();
+
+    std::ifstream           m_file;
+    std::string             m_path;
+    AssetStreamer*          m_streamer = nullptr;
+    uint32_t                m_streamFile = 0;
+    std::vector<StreamHandle> m_tileStream;     // tile -> in-flight request
+    std::vector<int32_t>    m_streaming;        // tiles with a request in flight
+    TerrainFileHeader       m_hdr;
+    std::vector<size_t>     m_levelOffset;      // into m_minMax, in nodes
+    std::vector<uint16_t>   m_minMax;           // 2 per node
+    std::vector<uint16_t>   m_base;
+    std::vector<int32_t>    m_tileSlot;         // tile -> m_tiles index or -1
+    std::vector<Tile>       m_tiles;
+    std::vector<uint64_t>   m_tileRequested;    // frame stamp, dedups requests
+    uint32_t                m_tilesPerSide = 0, m_tileShift = 0, m_baseShift = 0;
+    uint32_t                m_tileBudget = 64;
+    uint64_t                m_frame = 0;
+
+    float3                  m_origin{ 0,0,0 };
+    uint32_t                m_gridDim = 16;
+    std::vector<float>      m_ranges, m_morphStart, m_morphEnd;
+    float                   m_lodDistance = 128.0f;
+    float                   m_morphRatio = 0.66f;
+
+    std::vector<TerrainNode> m_nodes;
+    uint32_t                m_vertexCount = 0;
+    std::vector<uint16_t>   m_patchFull, m_patchHalf;
+};
+
+}
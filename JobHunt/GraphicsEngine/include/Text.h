@@ -0,0 +1,103 @@
+#pragma once
+#include "Core/Hash.h"
+#include "SolMath.h"
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace GraphicsEngine {
+
+// One glyph on screen: a single instanced quad, expanded from a 4-vertex strip in the vertex shader.
+struct GlyphInstance {
+    float    x, y, w, h;       // pixels, y down
+    uint16_t u, v, uw, vh;     // atlas texels
+    uint32_t color;            // RGBA8, R in the low byte
+};
+static_assert(sizeof(GlyphInstance) == 28, "GlyphInstance is the per-instance vertex layout of Text.hlsl");
+
+struct Glyph {
+    uint16_t u = 0, v = 0, w = 0, h = 0;   // atlas rect
+    int16_t  xoff = 0, yoff = 0;           // pen position -> top-left of the rect
+    uint16_t advance = 0;
+};
+
+// Single-channel (R8) glyph atlas baked from the built-in 5x7 pixel font: printable ASCII plus
+// a few symbols the overlays use (degree, plus-minus, micro). Other code points draw a box.
+class GlyphAtlas {
+public:
+    void BakeBuiltin();
+
+    uint32_t                    Width() const { return m_width; }
+    uint32_t                    Height() const { return m_height; }
+    const std::vector<uint8_t>& Pixels() const { return m_pixels; }
+    uint32_t                    LineHeight() const { return m_lineHeight; }
+
+    // O(1) for ASCII, a short search otherwise
+    const Glyph& Find(uint32_t codepoint) const;
+
+private:
+    std::vector<uint8_t>                    m_pixels;
+    uint32_t                                m_width = 0, m_height = 0;
+    uint32_t                                m_lineHeight = 0;
+    Glyph                                   m_ascii[128];
+    Glyph                                   m_replacement;
+    std::vector<std::pair<uint32_t, Glyph>> m_extra;     // sorted by code point
+};
+
+// Next code point of a UTF-8 string; malformed or truncated sequences yield U+FFFD and skip one byte.
+uint32_t DecodeUtf8(std::string_view s, size_t& pos);
+
+// Glyph positions of a laid-out string in unscaled atlas pixels; '\n' starts a new line, '\t'
+// advances to the next multiple of four cells.
+struct ShapedGlyph { float x, y; uint16_t u, v, w, h; };
+struct ShapedText {
+    std::vector<ShapedGlyph> glyphs;
+    float                    width = 0.0f, height = 0.0f;
+    uint64_t                 lastUsed = 0;
+};
+void ShapeText(const GlyphAtlas& atlas, std::string_view utf8, ShapedText& out);
+
+inline uint32_t PackRGBA8(const float3& c, float a = 1.0f)
+{
+    auto q = [](float v) { return uint32_t(SOL_MIN(SOL_MAX(v, 0.0f), 1.0f) * 255.0f + 0.5f); };
+    return q(c.x) | (q(c.y) << 8) | (q(c.z) << 16) | (q(a) << 24);
+}
+
+struct TextExtent { float width = 0.0f, height = 0.0f; };
+
+struct TextStats {
+    uint32_t glyphs = 0, strings = 0;          // this frame
+    uint32_t cacheHits = 0, cacheMisses = 0;   // this frame
+    uint32_t cached = 0;                       // shaped strings held
+};
+
+// All overlay text of a frame in one instance array, drawn with a single instanced draw. Shaped
+// strings are cached by content, so a label that does not change is laid out once; strings not
+// drawn for kEvictFrames frames are dropped, and past kMaxCached only last frame's are kept.
+class TextBatch {
+public:
+    static constexpr uint64_t kEvictFrames = 120;
+    static constexpr size_t   kMaxCached = 4096;
+
+    explicit TextBatch(const GlyphAtlas& atlas) : m_atlas(&atlas) {}
+
+    void Begin();   // new frame: clears the instances
+    TextExtent Draw(std::string_view utf8, float x, float y, float scale, uint32_t color);
+    TextExtent Measure(std::string_view utf8, float scale);
+
+    std::span<const GlyphInstance> Instances() const { return m_instances; }
+    const TextStats& GetStats() const { return m_stats; }
+
+private:
+    const ShapedText& Shape(std::string_view utf8);
+
+    const GlyphAtlas*                                         m_atlas;
+    std::unordered_map<Hash128, ShapedText, Hash128Hasher>    m_cache;
+    std::vector<GlyphInstance>                                m_instances;
+    uint64_t                                                  m_frame = 0;
+    TextStats                                                 m_stats;
+};
+
+}
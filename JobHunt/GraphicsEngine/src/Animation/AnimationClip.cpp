@@ -0,0 +1,316 @@
+#include "Animation/AnimationClip.h"
+#include "PoseSimd.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace GraphicsEngine;
+using namespace GraphicsEngine::AnimDetail;
+
+namespace {
+
+constexpr float kQuatRange = 0.70710678f;   // |any but the largest component| <= 1/sqrt2
+constexpr float kQuatStep = 2.0f * kQuatRange / 32767.0f;
+
+// Angle of the rotation between a and b; atan2 of the relative quaternion stays precise for the
+// tiny angles compression cares about, where acos(dot) is not
+float RotationError(const quat& a, const quat& b)
+{
+    const quat d = q_mul(q_conjugate(a), b);
+    return 2.0f * std::atan2(std::sqrt(d.x*d.x + d.y*d.y + d.z*d.z), std::fabs(d.w));
+}
+
+// Greedy key reduction over frames [0, frames): each segment is extended while interpolating its
+// (already quantized) end keys stays within `tolerance` at every frame it skips. A track that
+// never leaves the tolerance around its first key keeps just that key.
+template <typename Decode, typename Interp, typename Error>
+void FitKeys(uint32_t frames, float tolerance, Decode&& decode, Interp&& interp, Error&& error, std::vector<uint16_t>& keys)
+{
+    const auto first = decode(0u);
+    bool constant = true;
+    for (uint32_t f = 1; f < frames && constant; f++) constant = error(first, f) <= tolerance;
+    keys.push_back(0);
+    if (constant) return;
+
+    uint32_t k = 0;
+    auto a = first;
+    while (k + 1 < frames) {
+        uint32_t end = k + 1;
+        auto b = decode(end);
+        for (uint32_t j = k + 2; j < frames; j++) {
+            const auto candidate = decode(j);
+            bool fits = true;
+            for (uint32_t f = k + 1; f < j && fits; f++)
+                fits = error(interp(a, candidate, float(f - k) / float(j - k)), f) <= tolerance;
+            if (!fits) break;
+            end = j;
+            b = candidate;
+        }
+        keys.push_back(uint16_t(end));
+        k = end;
+        a = b;
+    }
+}
+
+// Last key at or before `frame`, the next one, and the blend between them
+struct KeySpan { uint32_t k0, k1; float t; };
+KeySpan FindKeys(const uint16_t* frames, uint32_t count, float frame)
+{
+    // Branchless binary search for the last key <= floor(frame); key 0 is always frame 0. Tracks
+    // hold few keys and clips are shared between threads, so this beats keeping cursors.
+    const uint32_t whole = uint32_t(frame);
+    const uint16_t* base = frames;
+    for (uint32_t n = count; n > 1; n -= n / 2)
+        base = (base[n / 2] <= whole) ? base + n / 2 : base;
+    const uint32_t k0 = uint32_t(base - frames);
+    const uint32_t k1 = std::min(k0 + 1, count - 1);
+    const float t = k1 != k0 ? (frame - float(frames[k0])) / float(frames[k1] - frames[k0]) : 0.0f;
+    return { k0, k1, t };
+}
+
+// UnpackQuat48 for four keys at once, into lanes of x / y / z / w
+void UnpackQuat48x4(const PackedQuat* const keys[4], float* x, float* y, float* z, float* w)
+{
+#if GE_ANIM_SSE
+    alignas(16) int32_t ia[4], ib[4], ic[4], largest[4];
+    for (uint32_t l = 0; l < 4; l++) {
+        const PackedQuat& p = *keys[l];
+        const uint64_t bits = uint64_t(p.v[0]) | (uint64_t(p.v[1]) << 16) | (uint64_t(p.v[2]) << 32);
+        largest[l] = int32_t(bits & 3);
+        ia[l] = int32_t((bits >> 2) & 0x7FFF);
+        ib[l] = int32_t((bits >> 17) & 0x7FFF);
+        ic[l] = int32_t((bits >> 32) & 0x7FFF);
+    }
+    const __m128 step = _mm_set1_ps(kQuatStep), range = _mm_set1_ps(kQuatRange);
+    auto component = [&](const int32_t* v) {
+        return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(v))), step), range);
+    };
+    const __m128 a = component(ia), b = component(ib), c = component(ic);
+    const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+    const __m128 d = _mm_sqrt_ps(_mm_max_ps(_mm_setzero_ps(), _mm_sub_ps(_mm_set1_ps(1.0f), sum)));
+
+    const __m128i index = _mm_load_si128(reinterpret_cast<const __m128i*>(largest));
+    auto is = [&](int i) { return _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(i))); };
+    auto select = [](__m128 mask, __m128 yes, __m128 no) { return _mm_or_ps(_mm_and_ps(mask, yes), _mm_andnot_ps(mask, no)); };
+    const __m128 is0 = is(0), is1 = is(1), is2 = is(2), is3 = is(3);
+    // Same placement as UnpackQuat48: d goes where the largest was, a / b / c fill the rest in order
+    _mm_store_ps(x, select(is0, d, a));
+    _mm_store_ps(y, select(is0, a, select(is1, d, b)));
+    _mm_store_ps(z, select(is2, d, select(is3, c, b)));
+    _mm_store_ps(w, select(is3, d, c));
+#else
+    for (uint32_t l = 0; l < 4; l++) {
+        const quat q = UnpackQuat48(*keys[l]);
+        x[l] = q.x; y[l] = q.y; z[l] = q.z; w[l] = q.w;
+    }
+#endif
+}
+
+}
+
+// ============================================================================
+// 48-bit quaternions
+// ============================================================================
+PackedQuat GraphicsEngine::PackQuat48(const quat& q)
+{
+    const float c[4] = { q.x, q.y, q.z, q.w };
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; i++)
+        if (std::fabs(c[i]) > std::fabs(c[largest])) largest = i;
+    const float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint64_t bits = largest;
+    uint32_t shift = 2;
+    for (uint32_t i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        const float v = std::clamp(c[i] * sign, -kQuatRange, kQuatRange);
+        bits |= uint64_t(std::lround((v + kQuatRange) / kQuatStep)) << shift;
+        shift += 15;
+    }
+    return { { uint16_t(bits), uint16_t(bits >> 16), uint16_t(bits >> 32) } };
+}
+
+quat GraphicsEngine::UnpackQuat48(const PackedQuat& p)
+{
+    const uint64_t bits = uint64_t(p.v[0]) | (uint64_t(p.v[1]) << 16) | (uint64_t(p.v[2]) << 32);
+    const float a = float((bits >> 2) & 0x7FFF) * kQuatStep - kQuatRange;
+    const float b = float((bits >> 17) & 0x7FFF) * kQuatStep - kQuatRange;
+    const float c = float((bits >> 32) & 0x7FFF) * kQuatStep - kQuatRange;
+    const float d = std::sqrt(std::max(0.0f, 1.0f - a*a - b*b - c*c));
+    switch (bits & 3) {
+    case 0:  return { d, a, b, c };
+    case 1:  return { a, d, b, c };
+    case 2:  return { a, b, d, c };
+    default: return { a, b, c, d };
+    }
+}
+
+// ============================================================================
+// Compression
+// ============================================================================
+AnimationClip AnimationClip::Compress(const RawClip& raw, const ClipCompression& settings, std::vector<TrackError>* errors)
+{
+    const uint32_t F = raw.frameCount, J = raw.jointCount;
+    assert(F >= 1 && F <= 65536 && raw.samples.size() == size_t(F) * J);
+
+    AnimationClip clip;
+    clip.m_sampleRate = raw.sampleRate;
+    clip.m_frameCount = F;
+    clip.m_jointCount = J;
+    clip.m_rotTracks.resize(J);
+    clip.m_transTracks.resize(J);
+    clip.m_transRanges.resize(J);
+    if (errors) errors->assign(J, TrackError{});
+
+    std::vector<quat> rot(F);
+    std::vector<float3> trans(F);
+    std::vector<uint16_t> keys;
+    for (uint32_t j = 0; j < J; j++) {
+        // Source made hemisphere-continuous, so keys interpolate along the arc the data took
+        for (uint32_t f = 0; f < F; f++) {
+            const JointTransform& s = raw.samples[size_t(f) * J + j];
+            rot[f] = q_normalize(s.rotation);
+            if (f && q_dot(rot[f], rot[f - 1]) < 0.0f) rot[f] = { -rot[f].x, -rot[f].y, -rot[f].z, -rot[f].w };
+            trans[f] = s.translation;
+        }
+
+        // Rotation track
+        keys.clear();
+        FitKeys(F, settings.rotationTolerance,
+                [&](uint32_t f) { return UnpackQuat48(PackQuat48(rot[f])); },
+                [](const quat& a, const quat& b, float t) { return q_nlerp(a, b, t); },
+                [&](const quat& q, uint32_t f) { return RotationError(q, rot[f]); },
+                keys);
+        clip.m_rotTracks[j] = { (uint32_t)clip.m_rotFrames.size(), (uint32_t)keys.size() };
+        for (uint16_t k : keys) {
+            clip.m_rotFrames.push_back(k);
+            clip.m_rotKeys.push_back(PackQuat48(rot[k]));
+        }
+
+        // Translation track, quantized over its own range
+        float3 mn = trans[0], mx = trans[0];
+        for (const float3& t : trans) {
+            mn = { SOL_MIN(mn.x, t.x), SOL_MIN(mn.y, t.y), SOL_MIN(mn.z, t.z) };
+            mx = { SOL_MAX(mx.x, t.x), SOL_MAX(mx.y, t.y), SOL_MAX(mx.z, t.z) };
+        }
+        const Range range{ mn, mx - mn };
+        clip.m_transRanges[j] = range;
+        auto pack = [&](const float3& t) {
+            PackedVec3 p;
+            for (int c = 0; c < 3; c++)
+                p.v[c] = range.extent[c] > 0.0f ? uint16_t(std::lround((t[c] - range.min[c]) / range.extent[c] * 65535.0f)) : 0;
+            return p;
+        };
+        auto unpack = [&](const PackedVec3& p) { return UnpackTranslation(range, p); };
+        keys.clear();
+        FitKeys(F, settings.translationTolerance,
+                [&](uint32_t f) { return unpack(pack(trans[f])); },
+                [](const float3& a, const float3& b, float t) { return lerp(a, b, t); },
+                [&](const float3& t, uint32_t f) { return length(t - trans[f]); },
+                keys);
+        clip.m_transTracks[j] = { (uint32_t)clip.m_transFrames.size(), (uint32_t)keys.size() };
+        for (uint16_t k : keys) {
+            clip.m_transFrames.push_back(k);
+            clip.m_transKeys.push_back(pack(trans[k]));
+        }
+
+        // Measured bounds: what the runtime will actually sample, at every source frame
+        if (errors) {
+            TrackError& e = (*errors)[j];
+            e.rotationKeys = clip.m_rotTracks[j].keyCount;
+            e.translationKeys = clip.m_transTracks[j].keyCount;
+            for (uint32_t f = 0; f < F; f++) {
+                const JointTransform s = clip.SampleJoint(j, float(f) / raw.sampleRate, false);
+                e.rotation = std::max(e.rotation, RotationError(s.rotation, rot[f]));
+                e.translation = std::max(e.translation, length(s.translation - trans[f]));
+            }
+        }
+    }
+    return clip;
+}
+
+size_t AnimationClip::SizeBytes() const
+{
+    return sizeof(*this) +
+           m_rotTracks.size() * sizeof(Track) + m_rotFrames.size() * sizeof(uint16_t) + m_rotKeys.size() * sizeof(PackedQuat) +
+           m_transTracks.size() * sizeof(Track) + m_transFrames.size() * sizeof(uint16_t) + m_transKeys.size() * sizeof(PackedVec3) +
+           m_transRanges.size() * sizeof(Range);
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+float3 AnimationClip::UnpackTranslation(const Range& range, const PackedVec3& p)
+{
+    return { range.min.x + float(p.v[0]) * (range.extent.x / 65535.0f),
+             range.min.y + float(p.v[1]) * (range.extent.y / 65535.0f),
+             range.min.z + float(p.v[2]) * (range.extent.z / 65535.0f) };
+}
+
+float AnimationClip::FrameAt(float time, bool loop) const
+{
+    const float last = float(m_frameCount - 1);
+    float frame = time * m_sampleRate;
+    if (loop && last > 0.0f) {
+        frame = std::fmod(frame, last);
+        if (frame < 0.0f) frame += last;
+    }
+    return std::clamp(frame, 0.0f, last);
+}
+
+JointTransform AnimationClip::SampleJoint(uint32_t joint, float time, bool loop) const
+{
+    const float frame = FrameAt(time, loop);
+    JointTransform out;
+
+    const Track& rt = m_rotTracks[joint];
+    const KeySpan r = FindKeys(&m_rotFrames[rt.firstKey], rt.keyCount, frame);
+    out.rotation = q_nlerp(UnpackQuat48(m_rotKeys[rt.firstKey + r.k0]), UnpackQuat48(m_rotKeys[rt.firstKey + r.k1]), r.t);
+
+    const Track& tt = m_transTracks[joint];
+    const KeySpan t = FindKeys(&m_transFrames[tt.firstKey], tt.keyCount, frame);
+    out.translation = lerp(Translation(joint, tt.firstKey + t.k0), Translation(joint, tt.firstKey + t.k1), t.t);
+    return out;
+}
+
+void AnimationClip::Sample(float time, Pose& out, bool loop) const
+{
+    out.Resize(m_jointCount);
+    const float frame = FrameAt(time, loop);
+
+    // Per block: find each lane's keys (scalar, the key times differ per joint), then decode the
+    // rotations and interpolate four lanes at once
+    static const PackedQuat identity = PackQuat48(q_identity());
+    JointBlock a, b;
+    float rt[4], tt[4];
+    const PackedQuat* r0[4];
+    const PackedQuat* r1[4];
+    for (uint32_t block = 0; block < (uint32_t)out.blocks.size(); block++) {
+        for (uint32_t l = 0; l < 4; l++) {
+            const uint32_t j = block * 4 + l;
+            if (j >= m_jointCount) {
+                r0[l] = r1[l] = &identity;
+                a.tx[l] = a.ty[l] = a.tz[l] = b.tx[l] = b.ty[l] = b.tz[l] = 0.0f;
+                rt[l] = tt[l] = 0.0f;
+                continue;
+            }
+
+            const Track& rTrack = m_rotTracks[j];
+            const KeySpan r = FindKeys(&m_rotFrames[rTrack.firstKey], rTrack.keyCount, frame);
+            r0[l] = &m_rotKeys[rTrack.firstKey + r.k0];
+            r1[l] = &m_rotKeys[rTrack.firstKey + r.k1];
+            rt[l] = r.t;
+
+            const Track& tTrack = m_transTracks[j];
+            const KeySpan t = FindKeys(&m_transFrames[tTrack.firstKey], tTrack.keyCount, frame);
+            const float3 t0 = Translation(j, tTrack.firstKey + t.k0);
+            const float3 t1 = Translation(j, tTrack.firstKey + t.k1);
+            a.tx[l] = t0.x; a.ty[l] = t0.y; a.tz[l] = t0.z;
+            b.tx[l] = t1.x; b.ty[l] = t1.y; b.tz[l] = t1.z;
+            tt[l] = t.t;
+        }
+        UnpackQuat48x4(r0, a.qx, a.qy, a.qz, a.qw);
+        UnpackQuat48x4(r1, b.qx, b.qy, b.qz, b.qw);
+        BlendBlock(a, b, rt, tt, out.blocks[block]);
+    }
+}
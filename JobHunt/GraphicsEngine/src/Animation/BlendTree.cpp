@@ -0,0 +1,58 @@
+#include "Animation/BlendTree.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace GraphicsEngine;
+
+uint32_t BlendTree::AddClip(uint32_t clip, uint32_t timeParam)
+{
+    Node n;
+    n.type = NodeType::Clip;
+    n.clip = clip;
+    n.param = timeParam;
+    m_nodes.push_back(n);
+    m_paramCount = std::max(m_paramCount, timeParam + 1);
+    return (uint32_t)m_nodes.size() - 1;
+}
+
+uint32_t BlendTree::AddBlend(uint32_t a, uint32_t b, uint32_t weightParam)
+{
+    assert(a < m_nodes.size() && b < m_nodes.size());
+    Node n;
+    n.type = NodeType::Blend;
+    n.a = a;
+    n.b = b;
+    n.param = weightParam;
+    // `a` is evaluated into the output, `b` into a scratch pose one level down
+    n.scratch = std::max({ 1u, m_nodes[a].scratch, m_nodes[b].scratch + 1 });
+    m_nodes.push_back(n);
+    m_paramCount = std::max(m_paramCount, weightParam + 1);
+    return (uint32_t)m_nodes.size() - 1;
+}
+
+void BlendTree::Evaluate(std::span<const AnimationClip> clips, std::span<const float> params, Pose& out, Context& ctx) const
+{
+    assert(!m_nodes.empty() && params.size() >= m_paramCount);
+    // Sized up front: EvaluateNode holds references into it while recursing
+    if (ctx.scratch.size() < m_nodes.back().scratch) ctx.scratch.resize(m_nodes.back().scratch);
+    EvaluateNode((uint32_t)m_nodes.size() - 1, clips, params, out, ctx, 0);
+}
+
+void BlendTree::EvaluateNode(uint32_t index, std::span<const AnimationClip> clips, std::span<const float> params,
+                             Pose& out, Context& ctx, uint32_t depth) const
+{
+    const Node& node = m_nodes[index];
+    if (node.type == NodeType::Clip) {
+        clips[node.clip].Sample(params[node.param], out);
+        return;
+    }
+
+    const float w = saturate(params[node.param]);
+    if (w <= 0.0f) return EvaluateNode(node.a, clips, params, out, ctx, depth);
+    if (w >= 1.0f) return EvaluateNode(node.b, clips, params, out, ctx, depth);
+
+    Pose& other = ctx.scratch[depth];
+    EvaluateNode(node.a, clips, params, out, ctx, depth);
+    EvaluateNode(node.b, clips, params, other, ctx, depth + 1);
+    BlendPoses(out, other, w, out);
+}
@@ -0,0 +1,58 @@
+#include "Animation/Pose.h"
+#include "PoseSimd.h"
+#include <cassert>
+
+using namespace GraphicsEngine;
+using namespace GraphicsEngine::AnimDetail;
+
+void GraphicsEngine::BindPose(const Skeleton& skeleton, Pose& out)
+{
+    out.Resize(skeleton.JointCount());
+    for (uint32_t j = 0; j < skeleton.JointCount(); j++)
+        out.Set(j, skeleton.bindPose[j].rotation, skeleton.bindPose[j].translation);
+}
+
+void GraphicsEngine::BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out)
+{
+    assert(a.jointCount == b.jointCount);
+    if (&out != &a && &out != &b) out.Resize(a.jointCount);
+    const float w[4] = { weight, weight, weight, weight };
+    for (size_t i = 0; i < a.blocks.size(); i++) BlendBlock(a.blocks[i], b.blocks[i], w, w, out.blocks[i]);
+}
+
+void GraphicsEngine::LocalToModel(const Skeleton& skeleton, const Pose& pose, std::span<float4x4> model, const float4x4& root)
+{
+    assert(skeleton.IsFlattened() && pose.jointCount == skeleton.JointCount() && model.size() >= pose.jointCount);
+    for (uint32_t j = 0; j < pose.jointCount; j++) {
+        const JointBlock& b = pose.blocks[j >> 2];
+        const uint32_t l = j & 3;
+        const float3& s = skeleton.bindPose[j].scale;
+
+        // Local rows as in m_trs (scale, rotate, translate); the quaternion is unit already
+        const float x = b.qx[l], y = b.qy[l], z = b.qz[l], w = b.qw[l];
+        const float xx = x*x, yy = y*y, zz = z*z, xy = x*y, xz = x*z, yz = y*z, wx = w*x, wy = w*y, wz = w*z;
+        const float L[4][3] = {
+            { (1 - 2*(yy + zz)) * s.x, 2*(xy + wz) * s.x,       2*(xz - wy) * s.x },
+            { 2*(xy - wz) * s.y,       (1 - 2*(xx + zz)) * s.y, 2*(yz + wx) * s.y },
+            { 2*(xz + wy) * s.z,       2*(yz - wx) * s.z,       (1 - 2*(xx + yy)) * s.z },
+            { b.tx[l],                 b.ty[l],                 b.tz[l] },
+        };
+
+        // model[j] = local * model[parent]; parents come first, so theirs is final already
+        const int16_t parent = skeleton.parents[j];
+        const float4x4& P = parent < 0 ? root : model[parent];
+        float4x4& M = model[j];
+#if GE_ANIM_SSE
+        const __m128 p0 = _mm_loadu_ps(&P[0].x), p1 = _mm_loadu_ps(&P[1].x), p2 = _mm_loadu_ps(&P[2].x), p3 = _mm_loadu_ps(&P[3].x);
+        for (int r = 0; r < 4; r++) {
+            __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(L[r][0]), p0), _mm_mul_ps(_mm_set1_ps(L[r][1]), p1)),
+                                  _mm_mul_ps(_mm_set1_ps(L[r][2]), p2));
+            if (r == 3) v = _mm_add_ps(v, p3);
+            _mm_storeu_ps(&M[r].x, v);
+        }
+#else
+        for (int r = 0; r < 4; r++)
+            M[r] = P[0] * L[r][0] + P[1] * L[r][1] + P[2] * L[r][2] + (r == 3 ? P[3] : float4{ 0, 0, 0, 0 });
+#endif
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+// Four-joint SIMD helpers shared by clip sampling and pose blending (not part of the public API).
+// Each lane is one joint; the math is q_nlerp / lerp from SolMath.
+#include "Animation/Pose.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GE_ANIM_SSE 1
+#else
+#define GE_ANIM_SSE 0
+#endif
+
+namespace GraphicsEngine::AnimDetail {
+
+// out = nlerp(a, b, t) and lerp of the translations, per lane; ta / tt are per-lane weights for
+// rotation and translation (they come from different key pairs when sampling)
+inline void BlendBlock(const JointBlock& a, const JointBlock& b, const float ta[4], const float tt[4], JointBlock& out)
+{
+#if GE_ANIM_SSE
+    const __m128 ax = _mm_load_ps(a.qx), ay = _mm_load_ps(a.qy), az = _mm_load_ps(a.qz), aw = _mm_load_ps(a.qw);
+    const __m128 bx = _mm_load_ps(b.qx), by = _mm_load_ps(b.qy), bz = _mm_load_ps(b.qz), bw = _mm_load_ps(b.qw);
+    const __m128 t = _mm_loadu_ps(ta);
+
+    // Shorter arc: negate t where dot(a, b) < 0 (sign bit of the dot moved onto t)
+    const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000u)));
+    const __m128 tb = _mm_xor_ps(t, _mm_and_ps(d, signMask));
+    const __m128 wa = _mm_sub_ps(_mm_set1_ps(1.0f), t);
+
+    __m128 x = _mm_add_ps(_mm_mul_ps(ax, wa), _mm_mul_ps(bx, tb));
+    __m128 y = _mm_add_ps(_mm_mul_ps(ay, wa), _mm_mul_ps(by, tb));
+    __m128 z = _mm_add_ps(_mm_mul_ps(az, wa), _mm_mul_ps(bz, tb));
+    __m128 w = _mm_add_ps(_mm_mul_ps(aw, wa), _mm_mul_ps(bw, tb));
+    const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+    // After the flip dot >= 0, so len2 >= (1-t)^2 + t^2 >= 0.5 for unit inputs: no zero guard
+    const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(len2));
+    _mm_store_ps(out.qx, _mm_mul_ps(x, inv));
+    _mm_store_ps(out.qy, _mm_mul_ps(y, inv));
+    _mm_store_ps(out.qz, _mm_mul_ps(z, inv));
+    _mm_store_ps(out.qw, _mm_mul_ps(w, inv));
+
+    const __m128 u = _mm_loadu_ps(tt);
+    auto lerp4 = [&](const float* pa, const float* pb, float* po) {
+        const __m128 va = _mm_load_ps(pa);
+        _mm_store_ps(po, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(pb), va), u)));
+    };
+    lerp4(a.tx, b.tx, out.tx);
+    lerp4(a.ty, b.ty, out.ty);
+    lerp4(a.tz, b.tz, out.tz);
+#else
+    for (uint32_t l = 0; l < 4; l++) {
+        const quat q = q_nlerp({ a.qx[l], a.qy[l], a.qz[l], a.qw[l] }, { b.qx[l], b.qy[l], b.qz[l], b.qw[l] }, ta[l]);
+        out.qx[l] = q.x; out.qy[l] = q.y; out.qz[l] = q.z; out.qw[l] = q.w;
+        out.tx[l] = lerp(a.tx[l], b.tx[l], tt[l]);
+        out.ty[l] = lerp(a.ty[l], b.ty[l], tt[l]);
+        out.tz[l] = lerp(a.tz[l], b.tz[l], tt[l]);
+    }
+#endif
+}
+
+}
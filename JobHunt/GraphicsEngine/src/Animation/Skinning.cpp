@@ -0,0 +1,297 @@
+#include "Animation/Skinning.h"
+#include <cassert>
+#include <cstring>
+
+// AVX2 kernels are compiled for x64 whatever the baseline and picked at runtime
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+#define GE_SKIN_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GE_TARGET_AVX2
+#else
+#define GE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#else
+#define GE_SKIN_AVX2 0
+#endif
+
+using namespace GraphicsEngine;
+
+namespace {
+
+float3 Load3(const std::byte* p)
+{
+    float3 v;
+    std::memcpy(&v, p, sizeof(float3));
+    return v;
+}
+void Store3(std::byte* p, const float3& v) { std::memcpy(p, &v, sizeof(float3)); }
+
+// ============================================================================
+// Scalar
+// ============================================================================
+void SkinLinearScalar(const SkinSource& src, const float4x4* palette, const SkinTarget& dst, uint32_t first, uint32_t end)
+{
+    for (uint32_t v = first; v < end; v++) {
+        const SkinInfluence& inf = src.influences[v];
+        float4 r0{}, r1{}, r2{}, r3{};
+        for (int i = 0; i < 4; i++) {
+            const float4x4& m = palette[inf.joints[i]];
+            const float w = inf.weights[i];
+            r0 += m[0] * w; r1 += m[1] * w; r2 += m[2] * w; r3 += m[3] * w;
+        }
+        const float3 p = Load3(src.positions + size_t(v) * src.positionStride);
+        const float4 o = r0 * p.x + r1 * p.y + r2 * p.z + r3;
+        Store3(dst.positions + size_t(v) * dst.positionStride, o.xyz);
+        if (src.normals && dst.normals) {
+            const float3 n = Load3(src.normals + size_t(v) * src.normalStride);
+            const float4 on = r0 * n.x + r1 * n.y + r2 * n.z;
+            Store3(dst.normals + size_t(v) * dst.normalStride, normalize_safe(on.xyz, n));
+        }
+    }
+}
+
+dualquat BlendDualQuats(const SkinInfluence& inf, const dualquat* palette)
+{
+    const quat& pivot = palette[inf.joints[0]].real;
+    dualquat b{ quat{ 0, 0, 0, 0 }, quat{ 0, 0, 0, 0 } };
+    for (int i = 0; i < 4; i++) {
+        const dualquat& q = palette[inf.joints[i]];
+        const float w = q_dot(q.real, pivot) < 0.0f ? -inf.weights[i] : inf.weights[i];
+        b.real.x += q.real.x * w; b.real.y += q.real.y * w; b.real.z += q.real.z * w; b.real.w += q.real.w * w;
+        b.dual.x += q.dual.x * w; b.dual.y += q.dual.y * w; b.dual.z += q.dual.z * w; b.dual.w += q.dual.w * w;
+    }
+    return dq_normalize(b);
+}
+
+void SkinDualQuatScalar(const SkinSource& src, const dualquat* palette, const SkinTarget& dst, uint32_t first, uint32_t end)
+{
+    for (uint32_t v = first; v < end; v++) {
+        const dualquat q = BlendDualQuats(src.influences[v], palette);
+        Store3(dst.positions + size_t(v) * dst.positionStride, dq_transform_point(q, Load3(src.positions + size_t(v) * src.positionStride)));
+        if (src.normals && dst.normals)
+            Store3(dst.normals + size_t(v) * dst.normalStride, dq_transform_dir(q, Load3(src.normals + size_t(v) * src.normalStride)));
+    }
+}
+
+#if GE_SKIN_AVX2
+// ============================================================================
+// AVX2
+// ============================================================================
+// One vertex per iteration: a float4x4 is two ymm (rows 0-1, rows 2-3) and a dual quaternion one,
+// so blending four influences is a handful of FMAs with no transposes or gathers.
+
+bool CpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0, osxsave = (info[2] & (1 << 27)) != 0;
+    if (!fma || !osxsave || (_xgetbv(0) & 6) != 6) return false;   // the OS must save ymm state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+GE_TARGET_AVX2 void Store3(std::byte* p, __m128 v)
+{
+    alignas(16) float f[4];
+    _mm_store_ps(f, v);
+    std::memcpy(p, f, sizeof(float3));
+}
+
+GE_TARGET_AVX2 __m128 Load3Ps(const std::byte* p)
+{
+    float f[4] = { 0, 0, 0, 0 };
+    std::memcpy(f, p, sizeof(float3));
+    return _mm_loadu_ps(f);
+}
+
+GE_TARGET_AVX2 __m128 Normalize3(__m128 v, __m128 fallback)
+{
+    const __m128 len2 = _mm_dp_ps(v, v, 0x7F);
+    const __m128 valid = _mm_cmpgt_ps(len2, _mm_set1_ps(SOL_MATH_EPS * SOL_MATH_EPS));
+    return _mm_blendv_ps(fallback, _mm_div_ps(v, _mm_sqrt_ps(len2)), valid);
+}
+
+GE_TARGET_AVX2 void SkinLinearAvx2(const SkinSource& src, const float4x4* palette, const SkinTarget& dst, uint32_t first, uint32_t end)
+{
+    const bool normals = src.normals && dst.normals;
+    for (uint32_t v = first; v < end; v++) {
+        const SkinInfluence& inf = src.influences[v];
+        __m256 m01 = _mm256_setzero_ps(), m23 = _mm256_setzero_ps();
+        for (int i = 0; i < 4; i++) {
+            const float* m = &palette[inf.joints[i]][0].x;
+            const __m256 w = _mm256_set1_ps(inf.weights[i]);
+            m01 = _mm256_fmadd_ps(w, _mm256_loadu_ps(m), m01);
+            m23 = _mm256_fmadd_ps(w, _mm256_loadu_ps(m + 8), m23);
+        }
+
+        // (x*r0 | y*r1) + (z*r2 | 1*r3), then the two halves added
+        const float3 p = Load3(src.positions + size_t(v) * src.positionStride);
+        __m256 s = _mm256_mul_ps(_mm256_set_m128(_mm_set1_ps(p.y), _mm_set1_ps(p.x)), m01);
+        s = _mm256_fmadd_ps(_mm256_set_m128(_mm_set1_ps(1.0f), _mm_set1_ps(p.z)), m23, s);
+        Store3(dst.positions + size_t(v) * dst.positionStride, _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1)));
+
+        if (normals) {
+            const std::byte* np = src.normals + size_t(v) * src.normalStride;
+            const float3 n = Load3(np);
+            __m256 t = _mm256_mul_ps(_mm256_set_m128(_mm_set1_ps(n.y), _mm_set1_ps(n.x)), m01);
+            t = _mm256_fmadd_ps(_mm256_set_m128(_mm_setzero_ps(), _mm_set1_ps(n.z)), m23, t);
+            const __m128 on = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+            Store3(dst.normals + size_t(v) * dst.normalStride, Normalize3(on, Load3Ps(np)));
+        }
+    }
+}
+
+// Lanes of eight vertices: float3 at `stride` bytes from base (a multiple of 4)
+GE_TARGET_AVX2 void Gather3(const float* base, uint32_t stride, __m256i vertex, __m256 out[3])
+{
+    const __m256i at = _mm256_mullo_epi32(vertex, _mm256_set1_epi32(int(stride / 4)));
+    for (int c = 0; c < 3; c++) out[c] = _mm256_i32gather_ps(base, _mm256_add_epi32(at, _mm256_set1_epi32(c)), 4);
+}
+
+GE_TARGET_AVX2 void Store3x8(std::byte* base, uint32_t stride, uint32_t first, const __m256 in[3])
+{
+    alignas(32) float f[3][8];
+    for (int c = 0; c < 3; c++) _mm256_store_ps(f[c], in[c]);
+    for (uint32_t l = 0; l < 8; l++) {
+        const float3 o{ f[0][l], f[1][l], f[2][l] };
+        std::memcpy(base + size_t(first + l) * stride, &o, sizeof(float3));
+    }
+}
+
+// v + 2 cross(r, cross(r, v) + w v) per lane, as dq_transform_dir; r = real x, y, z, w
+GE_TARGET_AVX2 void Rotate8(const __m256 r[4], const __m256 in[3], __m256 out[3])
+{
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 cx = _mm256_fmadd_ps(r[3], in[0], _mm256_fmsub_ps(r[1], in[2], _mm256_mul_ps(r[2], in[1])));
+    const __m256 cy = _mm256_fmadd_ps(r[3], in[1], _mm256_fmsub_ps(r[2], in[0], _mm256_mul_ps(r[0], in[2])));
+    const __m256 cz = _mm256_fmadd_ps(r[3], in[2], _mm256_fmsub_ps(r[0], in[1], _mm256_mul_ps(r[1], in[0])));
+    out[0] = _mm256_fmadd_ps(two, _mm256_fmsub_ps(r[1], cz, _mm256_mul_ps(r[2], cy)), in[0]);
+    out[1] = _mm256_fmadd_ps(two, _mm256_fmsub_ps(r[2], cx, _mm256_mul_ps(r[0], cz)), in[1]);
+    out[2] = _mm256_fmadd_ps(two, _mm256_fmsub_ps(r[0], cy, _mm256_mul_ps(r[1], cx)), in[2]);
+}
+
+// Influence i of eight vertices (inf = their SkinInfluence offsets in ints): weight and the eight
+// dual quaternion components of its joint
+GE_TARGET_AVX2 void GatherInfluence(const int* influences, const float* palette, __m256i inf, int i, __m256& w, __m256 q[8])
+{
+    const __m256i pair = _mm256_i32gather_epi32(influences, _mm256_add_epi32(inf, _mm256_set1_epi32(i / 2)), 4);
+    const __m256i joint = (i & 1) ? _mm256_srli_epi32(pair, 16) : _mm256_and_si256(pair, _mm256_set1_epi32(0xFFFF));
+    const __m256i base = _mm256_slli_epi32(joint, 3);
+    w = _mm256_i32gather_ps(reinterpret_cast<const float*>(influences), _mm256_add_epi32(inf, _mm256_set1_epi32(2 + i)), 4);
+    for (int c = 0; c < 8; c++) q[c] = _mm256_i32gather_ps(palette, _mm256_add_epi32(base, _mm256_set1_epi32(c)), 4);
+}
+
+// Eight vertices per iteration in SoA form: the dual quaternion blend needs a per-influence dot
+// product (hemisphere sign) and the transform three cross products, which as horizontal ops on one
+// vertex are all shuffle latency. Gathered into lanes they are plain vertical FMAs.
+GE_TARGET_AVX2 void SkinDualQuatAvx2(const SkinSource& src, const dualquat* palette, const SkinTarget& dst, uint32_t first, uint32_t end)
+{
+    static_assert(sizeof(dualquat) == 32 && sizeof(SkinInfluence) == 24, "gather offsets below");
+    const bool normals = src.normals && dst.normals;
+    const float* pal = &palette[0].real.x;
+    const int* infl = reinterpret_cast<const int*>(src.influences);
+    const float* pos = reinterpret_cast<const float*>(src.positions);
+    const float* nrm = reinterpret_cast<const float*>(src.normals);
+    assert(src.positionStride % 4 == 0 && (!normals || src.normalStride % 4 == 0));
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 signMask = _mm256_set1_ps(-0.0f), two = _mm256_set1_ps(2.0f);
+
+    uint32_t v = first;
+    for (; v + 8 <= end; v += 8) {
+        const __m256i vi = _mm256_add_epi32(_mm256_set1_epi32(int(v)), lane);
+        const __m256i inf = _mm256_mullo_epi32(vi, _mm256_set1_epi32(6));   // SkinInfluence = 6 ints
+
+        // b = sum of sign * weight * dq, sign from dot(real, real of influence 0)
+        __m256 b[8], q[8], w;
+        GatherInfluence(infl, pal, inf, 0, w, q);
+        const __m256 pivot[4] = { q[0], q[1], q[2], q[3] };
+        for (int c = 0; c < 8; c++) b[c] = _mm256_mul_ps(w, q[c]);
+        for (int i = 1; i < 4; i++) {
+            GatherInfluence(infl, pal, inf, i, w, q);
+            const __m256 d = _mm256_fmadd_ps(q[0], pivot[0], _mm256_fmadd_ps(q[1], pivot[1], _mm256_fmadd_ps(q[2], pivot[2], _mm256_mul_ps(q[3], pivot[3]))));
+            w = _mm256_xor_ps(w, _mm256_and_ps(d, signMask));
+            for (int c = 0; c < 8; c++) b[c] = _mm256_fmadd_ps(w, q[c], b[c]);
+        }
+
+        // Normalize by |real|
+        const __m256 len2 = _mm256_fmadd_ps(b[0], b[0], _mm256_fmadd_ps(b[1], b[1], _mm256_fmadd_ps(b[2], b[2], _mm256_mul_ps(b[3], b[3]))));
+        const __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(len2));
+        for (int c = 0; c < 8; c++) b[c] = _mm256_mul_ps(b[c], inv);
+        const __m256 rx = b[0], ry = b[1], rz = b[2], rw = b[3], dx = b[4], dy = b[5], dz = b[6], dw = b[7];
+
+        // Point: rotated, plus t = 2 (w d - dw r + cross(r, d))
+        __m256 p[3], o[3];
+        Gather3(pos, src.positionStride, vi, p);
+        Rotate8(b, p, o);
+        o[0] = _mm256_add_ps(o[0], _mm256_mul_ps(two, _mm256_add_ps(_mm256_fmsub_ps(rw, dx, _mm256_mul_ps(dw, rx)), _mm256_fmsub_ps(ry, dz, _mm256_mul_ps(rz, dy)))));
+        o[1] = _mm256_add_ps(o[1], _mm256_mul_ps(two, _mm256_add_ps(_mm256_fmsub_ps(rw, dy, _mm256_mul_ps(dw, ry)), _mm256_fmsub_ps(rz, dx, _mm256_mul_ps(rx, dz)))));
+        o[2] = _mm256_add_ps(o[2], _mm256_mul_ps(two, _mm256_add_ps(_mm256_fmsub_ps(rw, dz, _mm256_mul_ps(dw, rz)), _mm256_fmsub_ps(rx, dy, _mm256_mul_ps(ry, dx)))));
+        Store3x8(dst.positions, dst.positionStride, v, o);
+
+        if (normals) {
+            Gather3(nrm, src.normalStride, vi, p);
+            Rotate8(b, p, o);
+            Store3x8(dst.normals, dst.normalStride, v, o);
+        }
+    }
+    // Tail
+    if (v < end) SkinDualQuatScalar(src, palette, dst, v, end);
+}
+#endif
+
+}
+
+// ============================================================================
+// API
+// ============================================================================
+SkinPath GraphicsEngine::BestSkinPath()
+{
+#if GE_SKIN_AVX2
+    static const SkinPath best = CpuHasAvx2() ? SkinPath::Avx2 : SkinPath::Scalar;
+    return best;
+#else
+    return SkinPath::Scalar;
+#endif
+}
+
+void GraphicsEngine::BuildSkinMatrices(std::span<const float4x4> model, std::span<const float4x4> inverseBind, std::span<float4x4> palette)
+{
+    assert(inverseBind.size() >= model.size() && palette.size() >= model.size());
+    for (size_t j = 0; j < model.size(); j++) palette[j] = m_mul(inverseBind[j], model[j]);
+}
+
+void GraphicsEngine::BuildSkinDualQuats(std::span<const float4x4> palette, std::span<dualquat> out)
+{
+    assert(out.size() >= palette.size());
+    for (size_t j = 0; j < palette.size(); j++) out[j] = dq_from_matrix(palette[j]);
+}
+
+void GraphicsEngine::SkinLinear(const SkinSource& src, std::span<const float4x4> palette, const SkinTarget& dst,
+                                uint32_t first, uint32_t count, SkinPath path)
+{
+    assert(first + count <= src.vertexCount && src.positions && dst.positions && src.influences);
+#if GE_SKIN_AVX2
+    if (path == SkinPath::Avx2 && BestSkinPath() == SkinPath::Avx2)
+        return SkinLinearAvx2(src, palette.data(), dst, first, first + count);
+#endif
+    (void)path;
+    SkinLinearScalar(src, palette.data(), dst, first, first + count);
+}
+
+void GraphicsEngine::SkinDualQuat(const SkinSource& src, std::span<const dualquat> palette, const SkinTarget& dst,
+                                  uint32_t first, uint32_t count, SkinPath path)
+{
+    assert(first + count <= src.vertexCount && src.positions && dst.positions && src.influences);
+#if GE_SKIN_AVX2
+    if (path == SkinPath::Avx2 && BestSkinPath() == SkinPath::Avx2)
+        return SkinDualQuatAvx2(src, palette.data(), dst, first, first + count);
+#endif
+    (void)path;
+    SkinDualQuatScalar(src, palette.data(), dst, first, first + count);
+}
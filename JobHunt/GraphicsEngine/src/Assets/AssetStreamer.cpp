@@ -0,0 +1,392 @@
+#include "Assets/AssetStreamer.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <Windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+using namespace GraphicsEngine;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t kSlotBits = 20;
+    constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+    constexpr uint32_t kLatencySamples = 4096;
+}
+
+struct AssetStreamer::File {
+#if defined(_WIN32)
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    ~File() { if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle); }
+
+    bool Open(const std::string& path)
+    {
+        handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        return handle != INVALID_HANDLE_VALUE;
+    }
+
+    // Positional read on a synchronous handle (OVERLAPPED only carries the offset)
+    bool ReadAt(uint64_t offset, uint8_t* dst, size_t size) const
+    {
+        while (size) {
+            OVERLAPPED ov{};
+            ov.Offset = DWORD(offset);
+            ov.OffsetHigh = DWORD(offset >> 32);
+            const DWORD chunk = DWORD(std::min<size_t>(size, 1u << 30));
+            DWORD read = 0;
+            if (!ReadFile(handle, dst, chunk, &read, &ov) || read == 0) return false;
+            offset += read; dst += read; size -= read;
+        }
+        return true;
+    }
+#else
+    int fd = -1;
+    ~File() { if (fd >= 0) ::close(fd); }
+
+    bool Open(const std::string& path)
+    {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+#if defined(POSIX_FADV_RANDOM)
+        posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);   // batches are sorted, readahead only wastes bandwidth
+#endif
+        return true;
+    }
+
+    bool ReadAt(uint64_t offset, uint8_t* dst, size_t size) const
+    {
+        while (size) {
+            const ssize_t n = pread(fd, dst, size, off_t(offset));
+            if (n <= 0) return false;
+            offset += uint64_t(n); dst += n; size -= size_t(n);
+        }
+        return true;
+    }
+#endif
+};
+
+struct AssetStreamer::Entry {
+    StreamHandle               handle = kInvalidStream;
+    StreamRequestDesc          desc;
+    StreamState                state = StreamState::Pending;   // guarded by m_mutex
+    std::atomic<bool>          cancelled{ false };
+    std::vector<uint8_t>       data;
+    Clock::time_point          requested;
+    const File*                file = nullptr;
+};
+
+// ============================================================================
+// Construction
+// ============================================================================
+AssetStreamer::AssetStreamer(JobSystem* jobs, const StreamerDesc& desc)
+    : m_jobs(jobs), m_desc(desc)
+{
+    m_files.emplace_back();   // file id 0 = invalid
+    m_latencies.reserve(kLatencySamples);
+    m_io = std::thread([this] { IoLoop(); });
+}
+
+AssetStreamer::~AssetStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+        for (Entry* r : m_pending) r->cancelled = true;
+    }
+    m_wake.notify_all();
+    m_io.join();
+    if (m_jobs) m_jobs->Wait(m_jobCounter);
+}
+
+uint32_t AssetStreamer::OpenFile(const std::string& path)
+{
+    auto file = std::make_unique<File>();
+    if (!file->Open(path)) return 0;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.push_back(std::move(file));
+    return uint32_t(m_files.size() - 1);
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+AssetStreamer::Entry* AssetStreamer::Lookup(StreamHandle h) const
+{
+    const uint32_t slot = (h & kSlotMask);
+    if (slot == 0 || slot > m_requests.size()) return nullptr;
+    Entry* r = m_requests[slot - 1].get();
+    return (r && r->handle == h) ? r : nullptr;
+}
+
+StreamHandle AssetStreamer::Request(StreamRequestDesc desc)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (desc.file == 0 || desc.file >= m_files.size() || desc.size == 0) return kInvalidStream;
+
+    uint32_t slot;
+    if (!m_freeSlots.empty()) { slot = m_freeSlots.back(); m_freeSlots.pop_back(); }
+    else { m_requests.emplace_back(std::make_unique<AssetStreamer::Entry>()); slot = uint32_t(m_requests.size()); }
+
+    // Generation in the high bits so stale handles never alias a recycled slot
+    AssetStreamer::Entry* r = m_requests[slot - 1].get();
+    const uint32_t generation = ((r->handle >> kSlotBits) + 1) & (0xFFFFFFFFu >> kSlotBits);
+    r->handle = (generation << kSlotBits) | slot;
+    r->desc = std::move(desc);
+    r->state = StreamState::Pending;
+    r->cancelled = false;
+    r->data.clear();
+    r->requested = Clock::now();
+    r->file = m_files[r->desc.file].get();
+
+    m_pending.push_back(r);
+    m_stats.requested++;
+    m_wake.notify_one();
+    return r->handle;
+}
+
+void AssetStreamer::SetPriority(StreamHandle h, float priority)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (AssetStreamer::Entry* r = Lookup(h)) r->desc.priority = priority;
+}
+
+void AssetStreamer::Cancel(StreamHandle h)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    AssetStreamer::Entry* r = Lookup(h);
+    if (!r) return;
+    r->cancelled = true;
+    // Queued work is dropped now; reads, jobs and uploads in flight notice the flag when they finish
+    std::vector<Entry*>* queue = r->state == StreamState::Pending ? &m_pending
+                               : r->state == StreamState::Ready   ? &m_ready : nullptr;
+    if (queue) {
+        auto it = std::find(queue->begin(), queue->end(), r);
+        if (it != queue->end()) {   // not found = PumpUploads already took it
+            queue->erase(it);
+            Finish(r, StreamState::Cancelled);
+        }
+    }
+}
+
+StreamState AssetStreamer::GetState(StreamHandle h) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const AssetStreamer::Entry* r = Lookup(h);
+    return r ? r->state : StreamState::Cancelled;   // finished requests are recycled
+}
+
+// Called with m_mutex held
+void AssetStreamer::Finish(AssetStreamer::Entry* r, StreamState state)
+{
+    const bool counted = r->state != StreamState::Pending;   // bytes are charged when the read starts
+    r->state = state;
+    if (state == StreamState::Cancelled) m_stats.cancelled++;
+    else if (state == StreamState::Failed) m_stats.failed++;
+    else if (state == StreamState::Resident) {
+        m_stats.resident++;
+        const float ms = std::chrono::duration<float, std::milli>(Clock::now() - r->requested).count();
+        if (m_latencies.size() < kLatencySamples) m_latencies.push_back(ms);
+        else m_latencies[m_latencyHead++ % kLatencySamples] = ms;
+    }
+    if (counted) m_inFlightBytes -= std::min<uint64_t>(m_inFlightBytes, r->desc.size);
+    std::vector<uint8_t>().swap(r->data);
+    r->desc.process = nullptr;
+    r->desc.upload = nullptr;
+    m_freeSlots.push_back(r->handle & kSlotMask);
+    m_wake.notify_one();
+    // A cancel can empty the pending queue with nothing in flight: that is idle too
+    if (Idle()) m_idle.notify_all();
+}
+
+// ============================================================================
+// I/O thread
+// ============================================================================
+void AssetStreamer::IoLoop()
+{
+    std::vector<AssetStreamer::Entry*> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] {
+                return m_quit || (!m_pending.empty() && m_inFlightBytes < m_desc.maxInFlightBytes);
+            });
+            if (m_quit) return;
+
+            // Most urgent first; priorities may have changed since the last batch
+            const size_t take = std::min<size_t>(m_desc.batchSize, m_pending.size());
+            std::partial_sort(m_pending.begin(), m_pending.begin() + take, m_pending.end(),
+                              [](const AssetStreamer::Entry* a, const AssetStreamer::Entry* b) { return a->desc.priority < b->desc.priority; });
+            batch.assign(m_pending.begin(), m_pending.begin() + take);
+            m_pending.erase(m_pending.begin(), m_pending.begin() + take);
+            for (AssetStreamer::Entry* r : batch) {
+                r->state = StreamState::Reading;
+                m_inFlightBytes += r->desc.size;
+            }
+            m_busy += uint32_t(batch.size());
+        }
+        ReadBatch(batch);
+    }
+}
+
+void AssetStreamer::ReadBatch(std::vector<AssetStreamer::Entry*>& batch)
+{
+    // File order, then offset: neighbouring requests are merged into one read
+    std::sort(batch.begin(), batch.end(), [](const AssetStreamer::Entry* a, const AssetStreamer::Entry* b) {
+        return a->file != b->file ? a->file < b->file : a->desc.offset < b->desc.offset;
+    });
+
+    uint64_t bytes = 0, calls = 0;
+    const auto t0 = Clock::now();
+    std::vector<uint8_t> span;
+    std::vector<bool> ok(batch.size(), false);
+    for (size_t i = 0; i < batch.size();) {
+        size_t j = i + 1;
+        uint64_t end = batch[i]->desc.offset + batch[i]->desc.size;
+        while (j < batch.size() && batch[j]->file == batch[i]->file &&
+               batch[j]->desc.offset <= end + m_desc.coalesceGap) {
+            end = std::max(end, batch[j]->desc.offset + batch[j]->desc.size);
+            j++;
+        }
+
+        if (j == i + 1) {
+            AssetStreamer::Entry* r = batch[i];
+            if (!r->cancelled) {
+                r->data.resize(r->desc.size);
+                ok[i] = r->file->ReadAt(r->desc.offset, r->data.data(), r->desc.size);
+                bytes += r->desc.size; calls++;
+            }
+        } else {
+            const uint64_t begin = batch[i]->desc.offset;
+            span.resize(size_t(end - begin));
+            const bool read = batch[i]->file->ReadAt(begin, span.data(), span.size());
+            bytes += span.size(); calls++;
+            for (size_t k = i; k < j; k++) {
+                AssetStreamer::Entry* r = batch[k];
+                if (!read || r->cancelled) continue;
+                r->data.assign(span.begin() + ptrdiff_t(r->desc.offset - begin),
+                               span.begin() + ptrdiff_t(r->desc.offset - begin + r->desc.size));
+                ok[k] = true;
+            }
+        }
+        i = j;
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::vector<std::function<void()>> inlineJobs;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stats.bytesRead += bytes;
+    m_stats.readCalls += calls;
+    m_stats.ioBusySeconds += seconds;
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        AssetStreamer::Entry* r = batch[i];
+        if (r->cancelled || !ok[i]) {
+            m_busy--;
+            Finish(r, r->cancelled ? StreamState::Cancelled : StreamState::Failed);
+            continue;
+        }
+        if (!r->desc.process) {
+            m_busy--;
+            r->state = StreamState::Ready;
+            m_ready.push_back(r);
+            continue;
+        }
+
+        r->state = StreamState::Processing;
+        auto job = [this, r] {
+            std::vector<uint8_t> out;
+            const bool done = !r->cancelled && r->desc.process(r->data.data(), r->data.size(), out);
+            std::lock_guard<std::mutex> jobLock(m_mutex);
+            m_busy--;
+            if (r->cancelled || !done) {
+                Finish(r, r->cancelled ? StreamState::Cancelled : StreamState::Failed);
+            } else {
+                r->data.swap(out);
+                r->state = StreamState::Ready;
+                m_ready.push_back(r);
+            }
+            m_idle.notify_all();
+        };
+        if (m_jobs && m_jobs->GetWorkerCount() > 0) m_jobs->Submit(m_jobCounter, std::move(job));
+        else inlineJobs.push_back(std::move(job));
+    }
+    m_idle.notify_all();
+
+    // Without a job system the processing stage runs here, outside the lock
+    lock.unlock();
+    for (auto& job : inlineJobs) job();
+}
+
+// ============================================================================
+// Main thread
+// ============================================================================
+uint64_t AssetStreamer::PumpUploads(uint64_t byteBudget)
+{
+    std::vector<AssetStreamer::Entry*> uploads;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::sort(m_ready.begin(), m_ready.end(), [](const AssetStreamer::Entry* a, const AssetStreamer::Entry* b) {
+            return a->desc.priority < b->desc.priority;
+        });
+        uint64_t used = 0;
+        size_t n = 0;
+        for (; n < m_ready.size(); n++) {
+            const uint64_t size = m_ready[n]->data.size();
+            if (n > 0 && used + size > byteBudget) break;
+            used += size;
+        }
+        uploads.assign(m_ready.begin(), m_ready.begin() + n);
+        m_ready.erase(m_ready.begin(), m_ready.begin() + n);
+    }
+
+    // Callbacks run unlocked so they can issue new requests
+    uint64_t uploaded = 0;
+    for (AssetStreamer::Entry* r : uploads) {
+        if (r->cancelled) continue;
+        if (r->desc.upload) r->desc.upload(r->data.data(), r->data.size());
+        uploaded += r->data.size();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (AssetStreamer::Entry* r : uploads)
+        Finish(r, r->cancelled ? StreamState::Cancelled : StreamState::Resident);
+    return uploaded;
+}
+
+void AssetStreamer::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return Idle(); });
+}
+
+// Called with m_mutex held. Pending work behind the in-flight cap only starts once PumpUploads
+// frees bytes, so it does not count: waiting for it without pumping would never return.
+bool AssetStreamer::Idle() const
+{
+    return m_busy == 0 && (m_pending.empty() || m_inFlightBytes >= m_desc.maxInFlightBytes);
+}
+
+StreamStats AssetStreamer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    StreamStats s = m_stats;
+    if (!m_latencies.empty()) {
+        std::vector<float> sorted(m_latencies);
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (float v : sorted) sum += v;
+        s.latencyAvgMs = sum / double(sorted.size());
+        s.latencyP95Ms = sorted[std::min(sorted.size() - 1, size_t(double(sorted.size()) * 0.95))];
+        s.latencyMaxMs = sorted.back();
+    }
+    return s;
+}
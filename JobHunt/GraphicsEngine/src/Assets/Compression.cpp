@@ -0,0 +1,275 @@
+#include "Assets/Compression.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace GraphicsEngine;
+
+namespace {
+    constexpr uint32_t kMinMatch = 4;
+    constexpr size_t   kLastLiterals = 5;     // the format ends with at least 5 literals
+    constexpr size_t   kMatchSafety = 12;     // no match may start closer than this to the end
+    constexpr uint32_t kMaxOffset = 65535;
+    constexpr uint32_t kHashBits = 16;
+
+    inline uint32_t Read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+    inline uint64_t Read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+    inline uint32_t Hash(uint32_t v) { return (v * 2654435761u) >> (32 - kHashBits); }
+
+    inline uint32_t TrailingZeros(uint64_t v)
+    {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, v);
+        return uint32_t(i);
+#else
+        return uint32_t(__builtin_ctzll(v));
+#endif
+    }
+
+    // Bytes equal from a and b, stopping at limit (for a)
+    inline size_t MatchLength(const uint8_t* a, const uint8_t* b, const uint8_t* limit)
+    {
+        const uint8_t* start = a;
+        while (a + 8 <= limit) {
+            const uint64_t diff = Read64(a) ^ Read64(b);
+            if (diff) return size_t(a - start) + (TrailingZeros(diff) >> 3);
+            a += 8; b += 8;
+        }
+        while (a < limit && *a == *b) { a++; b++; }
+        return size_t(a - start);
+    }
+
+    inline uint8_t* WriteLength(uint8_t* op, size_t len)
+    {
+        for (; len >= 255; len -= 255) *op++ = 255;
+        *op++ = uint8_t(len);
+        return op;
+    }
+}
+
+// ============================================================================
+// LZ4 block
+// ============================================================================
+size_t GraphicsEngine::Lz4CompressBound(size_t srcSize)
+{
+    return srcSize + srcSize / 255 + 16;
+}
+
+size_t GraphicsEngine::Lz4Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+{
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* const end = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* const opEnd = dst + dstCapacity;
+
+    if (srcSize > kMatchSafety) {
+        const uint8_t* const mfLimit = end - kMatchSafety;
+        const uint8_t* const matchLimit = end - kLastLiterals;
+        std::unique_ptr<uint32_t[]> table(new uint32_t[size_t(1) << kHashBits]());
+
+        ip++;
+        while (ip < mfLimit) {
+            const uint32_t seq = Read32(ip);
+            const uint32_t h = Hash(seq);
+            const uint8_t* ref = src + table[h];
+            table[h] = uint32_t(ip - src);
+            if (ref >= ip || size_t(ip - ref) > kMaxOffset || Read32(ref) != seq) {
+                ip += 1 + (size_t(ip - anchor) >> 6);   // skip faster through incompressible runs
+                continue;
+            }
+
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) { ip--; ref--; }
+            const size_t literals = size_t(ip - anchor);
+            const size_t match = kMinMatch + MatchLength(ip + kMinMatch, ref + kMinMatch, matchLimit);
+
+            // token + literal run + offset + match run, worst case
+            if (size_t(opEnd - op) < 1 + literals / 255 + 1 + literals + 2 + match / 255 + 1) return 0;
+            uint8_t* token = op++;
+            const size_t litCode = std::min<size_t>(literals, 15);
+            const size_t matchCode = std::min<size_t>(match - kMinMatch, 15);
+            *token = uint8_t((litCode << 4) | matchCode);
+            if (litCode == 15) op = WriteLength(op, literals - 15);
+            std::memcpy(op, anchor, literals);
+            op += literals;
+            const uint32_t offset = uint32_t(ip - ref);
+            *op++ = uint8_t(offset);
+            *op++ = uint8_t(offset >> 8);
+            if (matchCode == 15) op = WriteLength(op, match - kMinMatch - 15);
+
+            ip += match;
+            anchor = ip;
+            if (ip < mfLimit) table[Hash(Read32(ip - 2))] = uint32_t(ip - 2 - src);
+        }
+    }
+
+    // Trailing literals
+    const size_t literals = size_t(end - anchor);
+    if (size_t(opEnd - op) < 1 + literals / 255 + 1 + literals) return 0;
+    uint8_t* token = op++;
+    *token = uint8_t(std::min<size_t>(literals, 15) << 4);
+    if (literals >= 15) op = WriteLength(op, literals - 15);
+    if (literals) std::memcpy(op, anchor, literals);   // src may be null when srcSize is 0
+    op += literals;
+    return size_t(op - dst);
+}
+
+bool GraphicsEngine::Lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    const uint8_t* ip = src;
+    const uint8_t* const ipEnd = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* const opEnd = dst + dstSize;
+
+    auto readLength = [&](size_t& len) {
+        uint8_t b;
+        do {
+            if (ip >= ipEnd) return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < ipEnd) {
+        const uint8_t token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(literals)) return false;
+        if (literals > size_t(ipEnd - ip) || literals > size_t(opEnd - op)) return false;
+        if (size_t(ipEnd - ip) >= literals + 16 && size_t(opEnd - op) >= literals + 16) {
+            // Fixed 16-byte steps instead of a variable-length copy; the overshoot stays in bounds
+            const uint8_t* s = ip;
+            uint8_t* d = op;
+            do { std::memcpy(d, s, 16); d += 16; s += 16; } while (d < op + literals);
+        } else if (literals) {
+            std::memcpy(op, ip, literals);   // dst may be null when dstSize is 0
+        }
+        ip += literals;
+        op += literals;
+        if (ip == ipEnd) break;   // last sequence has no match
+
+        if (ipEnd - ip < 2) return false;
+        const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > size_t(op - dst)) return false;
+        size_t match = token & 15;
+        if (match == 15 && !readLength(match)) return false;
+        match += kMinMatch;
+        if (match > size_t(opEnd - op)) return false;
+
+        const uint8_t* ref = op - offset;
+        if (offset >= 8 && size_t(opEnd - op) >= match + 8) {
+            // 8-byte steps; may write up to 7 bytes past the match, still inside dst
+            uint8_t* const matchEnd = op + match;
+            do { std::memcpy(op, ref, 8); op += 8; ref += 8; } while (op < matchEnd);
+            op = matchEnd;
+        } else {
+            while (match--) *op++ = *ref++;   // short offsets repeat a pattern byte by byte
+        }
+    }
+    return op == opEnd;
+}
+
+// ============================================================================
+// Block stream
+// ============================================================================
+void GraphicsEngine::CompressBlocks(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& out,
+                                    JobSystem* jobs, uint32_t blockSize)
+{
+    BlockStreamHeader hdr;
+    hdr.blockSize = blockSize;
+    hdr.rawBytes = srcSize;
+    hdr.blockCount = uint32_t((srcSize + blockSize - 1) / blockSize);
+
+    // Each block compresses into its own worst-case slot, then the slots are packed
+    const size_t bound = Lz4CompressBound(blockSize);
+    std::vector<uint8_t> scratch(size_t(hdr.blockCount) * bound);
+    std::vector<uint32_t> sizes(hdr.blockCount);
+    auto compress = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; b++) {
+            const size_t offset = size_t(b) * blockSize;
+            const size_t raw = std::min<size_t>(blockSize, srcSize - offset);
+            uint8_t* slot = scratch.data() + size_t(b) * bound;
+            const size_t packed = Lz4Compress(src + offset, raw, slot, raw - 1);
+            if (packed == 0) std::memcpy(slot, src + offset, raw);   // stored: did not shrink
+            sizes[b] = uint32_t(packed ? packed : raw);
+        }
+    };
+    if (jobs) jobs->ParallelFor(hdr.blockCount, 1, compress);
+    else compress(0, hdr.blockCount);
+
+    const size_t base = out.size();
+    size_t total = sizeof(hdr) + sizes.size() * sizeof(uint32_t);
+    for (uint32_t s : sizes) total += s;
+    out.resize(base + total);
+    uint8_t* p = out.data() + base;
+    std::memcpy(p, &hdr, sizeof(hdr));
+    p += sizeof(hdr);
+    std::memcpy(p, sizes.data(), sizes.size() * sizeof(uint32_t));
+    p += sizes.size() * sizeof(uint32_t);
+    for (uint32_t b = 0; b < hdr.blockCount; b++) {
+        std::memcpy(p, scratch.data() + size_t(b) * bound, sizes[b]);
+        p += sizes[b];
+    }
+}
+
+bool BlockStreamReader::Open(const uint8_t* stream, size_t size)
+{
+    m_header = nullptr;
+    m_sizes = nullptr;
+    m_offsets.clear();
+
+    const BlockStreamHeader* hdr = reinterpret_cast<const BlockStreamHeader*>(stream);
+    if (size < sizeof(BlockStreamHeader) || std::memcmp(hdr->magic, "GELZ", 4) != 0 || hdr->blockSize == 0 ||
+        uint64_t(hdr->blockCount) != (hdr->rawBytes + hdr->blockSize - 1) / hdr->blockSize ||
+        (size - sizeof(BlockStreamHeader)) / sizeof(uint32_t) < hdr->blockCount)
+        return false;
+
+    const uint32_t* sizes = reinterpret_cast<const uint32_t*>(stream + sizeof(BlockStreamHeader));
+    uint64_t offset = sizeof(BlockStreamHeader) + uint64_t(hdr->blockCount) * sizeof(uint32_t);
+    m_offsets.resize(hdr->blockCount);
+    for (uint32_t b = 0; b < hdr->blockCount; b++) {
+        m_offsets[b] = offset;
+        offset += sizes[b];
+    }
+    if (offset > size) { m_offsets.clear(); return false; }
+
+    m_header = hdr;
+    m_sizes = sizes;
+    return true;
+}
+
+size_t BlockStreamReader::BlockRawBytes(uint32_t block) const
+{
+    if (!m_header || block >= m_header->blockCount) return 0;
+    const uint64_t offset = uint64_t(block) * m_header->blockSize;
+    return size_t(std::min<uint64_t>(m_header->blockSize, m_header->rawBytes - offset));
+}
+
+bool BlockStreamReader::DecodeBlock(uint32_t block, uint8_t* dst) const
+{
+    const size_t raw = BlockRawBytes(block);
+    if (raw == 0) return false;
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(m_header) + m_offsets[block];
+    if (m_sizes[block] == raw) { std::memcpy(dst, src, raw); return true; }
+    return Lz4Decompress(src, m_sizes[block], dst, raw);
+}
+
+bool BlockStreamReader::DecodeAll(uint8_t* dst, JobSystem* jobs) const
+{
+    if (!m_header) return false;
+    std::atomic<bool> ok{ true };
+    auto decode = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; b++)
+            if (!DecodeBlock(b, dst + size_t(b) * m_header->blockSize)) ok = false;
+    };
+    if (jobs) jobs->ParallelFor(BlockCount(), 1, decode);
+    else decode(0, BlockCount());
+    return ok;
+}
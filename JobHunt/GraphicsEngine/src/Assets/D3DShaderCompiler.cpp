@@ -0,0 +1,31 @@
+#include "Assets/D3DShaderCompiler.h"
+#include <Windows.h>
+#include <d3dcompiler.h>
+#include <wrl.h>
+
+using namespace GraphicsEngine;
+using Microsoft::WRL::ComPtr;
+
+std::string D3DShaderCompiler::Version() const
+{
+    return "d3dcompiler_" + std::to_string(D3D_COMPILER_VERSION);
+}
+
+bool D3DShaderCompiler::Compile(const ShaderDesc& desc, const std::string& source, std::vector<uint8_t>& bytecode, std::string& errors)
+{
+    std::vector<D3D_SHADER_MACRO> macros;
+    for (const ShaderDefine& d : desc.defines) macros.push_back({ d.name.c_str(), d.value.c_str() });
+    macros.push_back({ nullptr, nullptr });
+
+    ComPtr<ID3DBlob> code, errs;
+    HRESULT hr = D3DCompile(source.data(), source.size(), desc.path.c_str(), macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                            desc.entry.c_str(), desc.target.c_str(), desc.flags, 0, &code, &errs);
+    if (errs) {
+        OutputDebugStringA((const char*)errs->GetBufferPointer());
+        errors.assign((const char*)errs->GetBufferPointer(), errs->GetBufferSize());
+    }
+    if (FAILED(hr)) return false;
+    const uint8_t* p = (const uint8_t*)code->GetBufferPointer();
+    bytecode.assign(p, p + code->GetBufferSize());
+    return true;
+}
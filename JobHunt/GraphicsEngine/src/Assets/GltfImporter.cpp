@@ -0,0 +1,483 @@
+#include "Assets/MeshImport.h"
+#include "Assets/MappedFile.h"
+#include "ImportCommon.h"
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace GraphicsEngine::ImportDetail;
+
+// ============================================================================
+// Minimal JSON DOM (values live in an arena, strings are views into the source)
+// ============================================================================
+namespace {
+    struct JsonValue {
+        enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+        Type             type = Type::Null;
+        uint32_t         count = 0;          // children (Array / Object)
+        double           number = 0.0;       // Number, Bool (0/1)
+        std::string_view key;                // member name when inside an object
+        std::string_view str;                // String, raw (escapes are not expanded)
+        const JsonValue* items = nullptr;
+
+        const JsonValue* Find(std::string_view k) const
+        {
+            if (type != Type::Object) return nullptr;
+            for (uint32_t i = 0; i < count; i++) if (items[i].key == k) return &items[i];
+            return nullptr;
+        }
+        const JsonValue* At(uint32_t i) const { return (type == Type::Array && i < count) ? &items[i] : nullptr; }
+        double Num(std::string_view k, double def) const
+        {
+            const JsonValue* v = Find(k);
+            return (v && v->type == Type::Number) ? v->number : def;
+        }
+        std::string_view Str(std::string_view k) const
+        {
+            const JsonValue* v = Find(k);
+            return (v && v->type == Type::String) ? v->str : std::string_view();
+        }
+    };
+
+    // Recursive descent; children are collected on one shared stack and copied into the arena
+    // when their container closes, so parsing allocates nothing per token.
+    class JsonParser {
+    public:
+        JsonParser(const char* begin, const char* end, LinearArena& arena) : m_p(begin), m_e(end), m_arena(arena) {}
+
+        bool Parse(JsonValue& root)
+        {
+            if (!Value(root, 0)) return false;
+            Skip();
+            return m_p == m_e;
+        }
+
+    private:
+        void Skip() { while (m_p < m_e && (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r')) ++m_p; }
+
+        bool Literal(const char* lit, size_t n)
+        {
+            if (size_t(m_e - m_p) < n || std::memcmp(m_p, lit, n) != 0) return false;
+            m_p += n;
+            return true;
+        }
+
+        bool String(std::string_view& out)
+        {
+            const char* s = ++m_p;   // past the opening quote
+            while (m_p < m_e && *m_p != '"') m_p += (*m_p == '\\') ? 2 : 1;
+            if (m_p >= m_e) return false;
+            out = std::string_view(s, size_t(m_p - s));
+            ++m_p;
+            return true;
+        }
+
+        bool Container(JsonValue& v, uint32_t depth, bool object)
+        {
+            const char close = object ? '}' : ']';
+            v.type = object ? JsonValue::Type::Object : JsonValue::Type::Array;
+            const size_t mark = m_stack.size();
+            ++m_p;
+            Skip();
+            if (m_p < m_e && *m_p == close) { ++m_p; return true; }
+            for (;;) {
+                JsonValue child;
+                Skip();
+                if (object) {
+                    if (m_p >= m_e || *m_p != '"' || !String(child.key)) return false;
+                    Skip();
+                    if (m_p >= m_e || *m_p != ':') return false;
+                    ++m_p;
+                }
+                if (!Value(child, depth + 1)) return false;
+                m_stack.push_back(child);
+                Skip();
+                if (m_p < m_e && *m_p == ',') { ++m_p; continue; }
+                if (m_p < m_e && *m_p == close) { ++m_p; break; }
+                return false;
+            }
+            v.count = uint32_t(m_stack.size() - mark);
+            JsonValue* items = m_arena.AllocArray<JsonValue>(v.count);
+            std::memcpy(static_cast<void*>(items), &m_stack[mark], v.count * sizeof(JsonValue));
+            v.items = items;
+            m_stack.resize(mark);
+            return true;
+        }
+
+        bool Value(JsonValue& v, uint32_t depth)
+        {
+            Skip();
+            if (m_p >= m_e || depth > 64) return false;
+            switch (*m_p) {
+            case '{': return Container(v, depth, true);
+            case '[': return Container(v, depth, false);
+            case '"': v.type = JsonValue::Type::String; return String(v.str);
+            case 't': v.type = JsonValue::Type::Bool; v.number = 1.0; return Literal("true", 4);
+            case 'f': v.type = JsonValue::Type::Bool; v.number = 0.0; return Literal("false", 5);
+            case 'n': v.type = JsonValue::Type::Null; return Literal("null", 4);
+            default: {
+                v.type = JsonValue::Type::Number;
+                auto r = std::from_chars(m_p, m_e, v.number);
+                if (r.ec != std::errc()) return false;
+                m_p = r.ptr;
+                return true;
+            }
+            }
+        }
+
+        const char*            m_p;
+        const char*            m_e;
+        LinearArena&           m_arena;
+        std::vector<JsonValue> m_stack;
+    };
+}
+
+// ============================================================================
+// glTF buffers / accessors
+// ============================================================================
+namespace {
+    constexpr uint32_t kGlbMagic = 0x46546C67;   // "glTF"
+    constexpr uint32_t kGlbJson = 0x4E4F534A;    // "JSON"
+    constexpr uint32_t kGlbBin = 0x004E4942;     // "BIN\0"
+
+    struct BufferData { const uint8_t* data = nullptr; size_t size = 0; };
+
+    struct Accessor {
+        const uint8_t* data = nullptr;
+        uint32_t count = 0, stride = 0, components = 0, componentType = 0;
+        bool     normalized = false;
+    };
+
+    uint32_t ComponentSize(uint32_t type)
+    {
+        switch (type) {
+        case 5120: case 5121: return 1;
+        case 5122: case 5123: return 2;
+        case 5125: case 5126: return 4;
+        default: return 0;
+        }
+    }
+
+    uint32_t ComponentCount(std::string_view type)
+    {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4") return 4;
+        return 0;
+    }
+
+    bool ResolveAccessor(const JsonValue& doc, const std::vector<BufferData>& buffers, int index, Accessor& out)
+    {
+        const JsonValue* accessors = doc.Find("accessors");
+        const JsonValue* acc = (accessors && index >= 0) ? accessors->At(uint32_t(index)) : nullptr;
+        if (!acc) return false;
+        const JsonValue* views = doc.Find("bufferViews");
+        const double viewIndex = acc->Num("bufferView", -1);
+        const JsonValue* view = (views && viewIndex >= 0) ? views->At(uint32_t(viewIndex)) : nullptr;
+        if (!view) return false;   // sparse / zero-filled accessors are not supported
+        const double buffer = view->Num("buffer", -1);
+        if (buffer < 0 || buffer >= double(buffers.size())) return false;
+
+        out.componentType = uint32_t(acc->Num("componentType", 0));
+        out.components = ComponentCount(acc->Str("type"));
+        out.count = uint32_t(acc->Num("count", 0));
+        out.normalized = acc->Find("normalized") && acc->Find("normalized")->number != 0.0;
+        const uint32_t elem = ComponentSize(out.componentType) * out.components;
+        if (!elem) return false;
+        out.stride = uint32_t(view->Num("byteStride", 0));
+        if (!out.stride) out.stride = elem;
+
+        const size_t viewOffset = size_t(view->Num("byteOffset", 0)), viewLength = size_t(view->Num("byteLength", 0));
+        const size_t accOffset = size_t(acc->Num("byteOffset", 0));
+        if (viewOffset + viewLength > buffers[size_t(buffer)].size) return false;
+        if (out.count && accOffset + size_t(out.count - 1) * out.stride + elem > viewLength) return false;
+        out.data = buffers[size_t(buffer)].data + viewOffset + accOffset;
+        return true;
+    }
+
+    inline float ReadComponent(const Accessor& a, const uint8_t* p)
+    {
+        switch (a.componentType) {
+        case 5126: { float f; std::memcpy(&f, p, 4); return f; }
+        case 5121: return a.normalized ? float(*p) / 255.0f : float(*p);
+        case 5123: { uint16_t v; std::memcpy(&v, p, 2); return a.normalized ? float(v) / 65535.0f : float(v); }
+        case 5120: { int8_t v; std::memcpy(&v, p, 1); return a.normalized ? SOL_MAX(float(v) / 127.0f, -1.0f) : float(v); }
+        case 5122: { int16_t v; std::memcpy(&v, p, 2); return a.normalized ? SOL_MAX(float(v) / 32767.0f, -1.0f) : float(v); }
+        default: return 0.0f;
+        }
+    }
+
+    inline float3 ReadFloat3(const Accessor& a, uint32_t i)
+    {
+        const uint8_t* p = a.data + size_t(i) * a.stride;
+        const uint32_t cs = ComponentSize(a.componentType);
+        return { ReadComponent(a, p), ReadComponent(a, p + cs), a.components > 2 ? ReadComponent(a, p + 2 * cs) : 0.0f };
+    }
+
+    inline uint32_t ReadIndex(const Accessor& a, uint32_t i)
+    {
+        const uint8_t* p = a.data + size_t(i) * a.stride;
+        switch (a.componentType) {
+        case 5121: return *p;
+        case 5123: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+        case 5125: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        default: return 0;
+        }
+    }
+
+    int Base64Value(char c)
+    {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+    }
+
+    BufferData DecodeBase64(std::string_view s, LinearArena& arena)
+    {
+        uint8_t* out = arena.AllocArray<uint8_t>(s.size() / 4 * 3 + 3);
+        size_t n = 0;
+        uint32_t acc = 0, bits = 0;
+        for (char c : s) {
+            const int v = Base64Value(c);
+            if (v < 0) continue;    // padding / whitespace
+            acc = (acc << 6) | uint32_t(v);
+            bits += 6;
+            if (bits >= 8) { bits -= 8; out[n++] = uint8_t(acc >> bits); }
+        }
+        return { out, n };
+    }
+
+    std::string DecodeUri(std::string_view uri)
+    {
+        std::string s;
+        s.reserve(uri.size());
+        for (size_t i = 0; i < uri.size(); i++) {
+            if (uri[i] == '%' && i + 2 < uri.size()) {
+                int v = 0;
+                std::from_chars(uri.data() + i + 1, uri.data() + i + 3, v, 16);
+                s.push_back(char(v));
+                i += 2;
+            } else {
+                s.push_back(uri[i]);
+            }
+        }
+        return s;
+    }
+
+    // One triangle primitive instance in world space
+    struct DrawItem {
+        Accessor position, normal, color, index;
+        bool     hasNormal = false, hasColor = false, hasIndex = false;
+        float4x4 world = m_identity();
+        float4x4 normalMatrix = m_identity();
+        uint32_t vertexBase = 0, indexBase = 0, vertexCount = 0, indexCount = 0;
+    };
+
+    float4x4 NodeLocal(const JsonValue& node)
+    {
+        if (const JsonValue* m = node.Find("matrix"); m && m->count == 16) {
+            // Column-major column-vector matrix == row-major row-vector matrix
+            float v[16];
+            for (uint32_t i = 0; i < 16; i++) v[i] = float(m->items[i].number);
+            return load_row_major(v);
+        }
+        float3 t{ 0,0,0 }, s{ 1,1,1 };
+        quat r;
+        if (const JsonValue* a = node.Find("translation"); a && a->count == 3) t = { float(a->items[0].number), float(a->items[1].number), float(a->items[2].number) };
+        if (const JsonValue* a = node.Find("scale"); a && a->count == 3)       s = { float(a->items[0].number), float(a->items[1].number), float(a->items[2].number) };
+        if (const JsonValue* a = node.Find("rotation"); a && a->count == 4)
+            r = quat(float(a->items[0].number), float(a->items[1].number), float(a->items[2].number), float(a->items[3].number));
+        return m_trs(t, r, s);
+    }
+
+    bool CollectMesh(const JsonValue& doc, const std::vector<BufferData>& buffers, uint32_t meshIndex,
+                     const float4x4& world, std::vector<DrawItem>& items)
+    {
+        const JsonValue* meshes = doc.Find("meshes");
+        const JsonValue* mesh = meshes ? meshes->At(meshIndex) : nullptr;
+        const JsonValue* prims = mesh ? mesh->Find("primitives") : nullptr;
+        if (!prims) return false;
+        for (uint32_t p = 0; p < prims->count; p++) {
+            const JsonValue& prim = prims->items[p];
+            if (prim.Num("mode", 4) != 4) continue;   // triangles only
+            const JsonValue* attr = prim.Find("attributes");
+            if (!attr) continue;
+
+            DrawItem item;
+            item.world = world;
+            item.normalMatrix = m_transpose(m_inverse_affine(world));
+            if (!ResolveAccessor(doc, buffers, int(attr->Num("POSITION", -1)), item.position)) return false;
+            item.hasNormal = ResolveAccessor(doc, buffers, int(attr->Num("NORMAL", -1)), item.normal) && item.normal.count == item.position.count;
+            item.hasColor = ResolveAccessor(doc, buffers, int(attr->Num("COLOR_0", -1)), item.color) && item.color.count == item.position.count;
+            item.hasIndex = ResolveAccessor(doc, buffers, int(prim.Num("indices", -1)), item.index);
+            item.vertexCount = item.position.count;
+            item.indexCount = (item.hasIndex ? item.index.count : item.vertexCount) / 3 * 3;
+            items.push_back(item);
+        }
+        return true;
+    }
+
+    bool CollectNode(const JsonValue& doc, const std::vector<BufferData>& buffers, uint32_t nodeIndex,
+                     const float4x4& parent, std::vector<DrawItem>& items, uint32_t depth)
+    {
+        const JsonValue* nodes = doc.Find("nodes");
+        const JsonValue* node = nodes ? nodes->At(nodeIndex) : nullptr;
+        if (!node || depth > 64) return false;
+        const float4x4 world = m_mul(NodeLocal(*node), parent);
+        if (node->Find("mesh") && !CollectMesh(doc, buffers, uint32_t(node->Num("mesh", 0)), world, items)) return false;
+        if (const JsonValue* children = node->Find("children"))
+            for (uint32_t c = 0; c < children->count; c++)
+                if (!CollectNode(doc, buffers, uint32_t(children->items[c].number), world, items, depth + 1)) return false;
+        return true;
+    }
+}
+
+// ============================================================================
+// Import
+// ============================================================================
+bool GraphicsEngine::ImportGltf(const std::string& path, LinearArena& arena, ImportedMesh& out,
+                                JobSystem* jobs, const ImportOptions& options, ImportStats* stats)
+{
+    const auto t0 = Clock::now();
+    out = ImportedMesh{};
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    // ---- Container: .glb (JSON chunk + BIN chunk) or plain JSON
+    const uint8_t* bytes = file.Data();
+    std::string_view json(reinterpret_cast<const char*>(bytes), file.Size());
+    BufferData glbBin;
+    uint32_t magic = 0;
+    if (file.Size() >= 12) std::memcpy(&magic, bytes, 4);
+    if (magic == kGlbMagic) {
+        json = {};
+        for (size_t off = 12; off + 8 <= file.Size();) {
+            uint32_t len, type;
+            std::memcpy(&len, bytes + off, 4);
+            std::memcpy(&type, bytes + off + 4, 4);
+            if (off + 8 + len > file.Size()) return false;
+            if (type == kGlbJson) json = std::string_view(reinterpret_cast<const char*>(bytes + off + 8), len);
+            else if (type == kGlbBin && !glbBin.data) glbBin = { bytes + off + 8, len };
+            off += 8 + ((size_t(len) + 3) & ~size_t(3));
+        }
+        if (json.empty()) return false;
+    }
+
+    LinearArena scratch(json.size() + 4096);
+    JsonValue doc;
+    if (!JsonParser(json.data(), json.data() + json.size(), scratch).Parse(doc) || doc.type != JsonValue::Type::Object)
+        return false;
+
+    // ---- Buffers: GLB BIN, data URIs or files next to the .gltf
+    const size_t slash = path.find_last_of("/\\");
+    const std::string dir = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    std::vector<BufferData> buffers;
+    std::vector<MappedFile> external;
+    size_t totalBytes = file.Size();
+    if (const JsonValue* bufs = doc.Find("buffers")) {
+        external.reserve(bufs->count);
+        for (uint32_t i = 0; i < bufs->count; i++) {
+            const std::string_view uri = bufs->items[i].Str("uri");
+            if (uri.empty()) { buffers.push_back(glbBin); continue; }
+            if (uri.substr(0, 5) == "data:") {
+                const size_t comma = uri.find(',');
+                if (comma == std::string_view::npos) return false;
+                buffers.push_back(DecodeBase64(uri.substr(comma + 1), scratch));
+                continue;
+            }
+            external.emplace_back();
+            if (!external.back().Open(dir + DecodeUri(uri))) return false;
+            buffers.push_back({ external.back().Data(), external.back().Size() });
+            totalBytes += external.back().Size();
+        }
+    }
+
+    // ---- Flatten the default scene (or every mesh when there is no scene graph)
+    const float4x4 root = options.convertHandedness ? m_scale({ 1, 1, -1 }) : m_identity();
+    const float4x4 rootScaled = m_mul(m_scale({ options.scale, options.scale, options.scale }), root);
+    std::vector<DrawItem> items;
+    const JsonValue* scenes = doc.Find("scenes");
+    const JsonValue* scene = scenes ? scenes->At(uint32_t(doc.Num("scene", 0))) : nullptr;
+    if (const JsonValue* sceneNodes = scene ? scene->Find("nodes") : nullptr) {
+        for (uint32_t n = 0; n < sceneNodes->count; n++)
+            if (!CollectNode(doc, buffers, uint32_t(sceneNodes->items[n].number), rootScaled, items, 0)) return false;
+    } else if (const JsonValue* meshes = doc.Find("meshes")) {
+        for (uint32_t m = 0; m < meshes->count; m++)
+            if (!CollectMesh(doc, buffers, m, rootScaled, items)) return false;
+    }
+    if (items.empty()) return false;
+    const auto t1 = Clock::now();
+
+    // ---- Output layout, then convert in parallel ranges
+    uint64_t vertexTotal = 0, indexTotal = 0;
+    for (DrawItem& it : items) {
+        it.vertexBase = uint32_t(vertexTotal); vertexTotal += it.vertexCount;
+        it.indexBase = uint32_t(indexTotal);   indexTotal += it.indexCount;
+    }
+    if (vertexTotal == 0 || indexTotal == 0 || vertexTotal > UINT32_MAX || indexTotal > UINT32_MAX) return false;
+    out.vertexCount = uint32_t(vertexTotal);
+    out.indexCount = uint32_t(indexTotal);
+    out.vertices = arena.AllocArray<VertexPNC>(out.vertexCount);
+    out.indices = arena.AllocArray<uint32_t>(out.indexCount);
+
+    struct Range { uint32_t item, begin, end; bool indices; };
+    constexpr uint32_t kRange = 65536;
+    std::vector<Range> ranges;
+    for (uint32_t i = 0; i < items.size(); i++) {
+        for (uint32_t b = 0; b < items[i].vertexCount; b += kRange) ranges.push_back({ i, b, SOL_MIN(b + kRange, items[i].vertexCount), false });
+        for (uint32_t b = 0; b < items[i].indexCount; b += kRange * 3) ranges.push_back({ i, b, SOL_MIN(b + kRange * 3, items[i].indexCount), true });
+    }
+
+    // A mirrored transform flips triangle orientation; D3D wants clockwise front faces
+    std::atomic<bool> valid{ true };
+    ForRange(jobs, uint32_t(ranges.size()), 1, [&](uint32_t rb, uint32_t re) {
+        for (uint32_t r = rb; r < re; r++) {
+            const Range& range = ranges[r];
+            const DrawItem& it = items[range.item];
+            if (!range.indices) {
+                for (uint32_t v = range.begin; v < range.end; v++) {
+                    VertexPNC& o = out.vertices[it.vertexBase + v];
+                    o.pos = transform_point(ReadFloat3(it.position, v), it.world);
+                    o.normal = it.hasNormal ? normalize_safe(transform_dir(ReadFloat3(it.normal, v), it.normalMatrix), { 0,1,0 }) : float3{ 0,0,0 };
+                    o.color = it.hasColor ? ReadFloat3(it.color, v) : options.defaultColor;
+                }
+            } else {
+                const float3 r0 = it.world[0].xyz, r1 = it.world[1].xyz, r2 = it.world[2].xyz;
+                // glTF fronts are CCW seen in a right-handed view. Seen in the LH view they turn CW
+                // (D3D front) unless the world transform mirrors, which the handedness root always does.
+                const bool flip = dot(cross(r0, r1), r2) < 0.0f;
+                for (uint32_t i = range.begin; i < range.end; i += 3) {
+                    uint32_t a = it.hasIndex ? ReadIndex(it.index, i) : i;
+                    uint32_t b = it.hasIndex ? ReadIndex(it.index, i + 1) : i + 1;
+                    uint32_t c = it.hasIndex ? ReadIndex(it.index, i + 2) : i + 2;
+                    if (a >= it.vertexCount || b >= it.vertexCount || c >= it.vertexCount) { valid = false; a = b = c = 0; }
+                    if (flip) std::swap(b, c);
+                    uint32_t* o = out.indices + it.indexBase + i;
+                    o[0] = it.vertexBase + a; o[1] = it.vertexBase + b; o[2] = it.vertexBase + c;
+                }
+            }
+        }
+    });
+    if (!valid) return false;
+
+    // Primitives without NORMAL get area-weighted normals from their own triangles
+    for (const DrawItem& it : items)
+        if (!it.hasNormal)
+            ComputeNormals(jobs, out.vertices + it.vertexBase, it.vertexCount, out.indices + it.indexBase, it.indexCount, it.vertexBase);
+    out.bounds = ComputeBounds(out.vertices, out.vertexCount);
+
+    if (stats) {
+        stats->bytes = totalBytes;
+        stats->parseSeconds = Seconds(t0, t1);
+        stats->totalSeconds = Seconds(t0, Clock::now());
+        stats->threads = jobs ? jobs->GetThreadCount() : 1;
+    }
+    return true;
+}
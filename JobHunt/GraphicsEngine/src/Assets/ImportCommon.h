@@ -0,0 +1,52 @@
+#pragma once
+// Shared helpers for the mesh importers (not part of the public API).
+#include "Assets/MeshImport.h"
+#include "Core/JobSystem.h"
+#include <chrono>
+#include <functional>
+
+namespace GraphicsEngine::ImportDetail {
+
+using Clock = std::chrono::steady_clock;
+inline double Seconds(Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double>(b - a).count(); }
+
+// ParallelFor when a job system is given, a single inline call otherwise
+inline void ForRange(JobSystem* jobs, uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& fn)
+{
+    if (jobs) jobs->ParallelFor(count, grain, fn);
+    else if (count) fn(0, count);
+}
+
+inline AABB_t ComputeBounds(const VertexPNC* v, uint32_t n)
+{
+    if (n == 0) return AABB_t{};
+    float3 mn = v[0].pos, mx = v[0].pos;
+    for (uint32_t i = 1; i < n; i++) {
+        const float3& p = v[i].pos;
+        mn = { SOL_MIN(mn.x, p.x), SOL_MIN(mn.y, p.y), SOL_MIN(mn.z, p.z) };
+        mx = { SOL_MAX(mx.x, p.x), SOL_MAX(mx.y, p.y), SOL_MAX(mx.z, p.z) };
+    }
+    AABB_t b;
+    b.center = (mn + mx) * 0.5f;
+    b.extents = (mx - mn) * 0.5f;
+    return b;
+}
+
+// Area-weighted vertex normals for already converted (clockwise, LH) triangles; indices are
+// relative to v after subtracting indexBias. Serial accumulation (shared vertices would race),
+// parallel normalisation.
+inline void ComputeNormals(JobSystem* jobs, VertexPNC* v, uint32_t vertexCount, const uint32_t* idx, size_t indexCount,
+                           uint32_t indexBias = 0)
+{
+    for (uint32_t i = 0; i < vertexCount; i++) v[i].normal = { 0,0,0 };
+    for (size_t t = 0; t + 2 < indexCount; t += 3) {
+        VertexPNC& a = v[idx[t] - indexBias]; VertexPNC& b = v[idx[t + 1] - indexBias]; VertexPNC& c = v[idx[t + 2] - indexBias];
+        const float3 n = cross(b.pos - a.pos, c.pos - a.pos);
+        a.normal = a.normal + n; b.normal = b.normal + n; c.normal = c.normal + n;
+    }
+    ForRange(jobs, vertexCount, 16384, [v](uint32_t b, uint32_t e) {
+        for (uint32_t i = b; i < e; i++) v[i].normal = normalize_safe(v[i].normal, { 0,1,0 });
+    });
+}
+
+}
@@ -0,0 +1,92 @@
+#include "Assets/MappedFile.h"
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <Windows.h>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+using namespace GraphicsEngine;
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept
+{
+    if (this == &o) return *this;
+    Close();
+#if defined(_WIN32)
+    m_file = o.m_file;       o.m_file = nullptr;
+    m_mapping = o.m_mapping; o.m_mapping = nullptr;
+#else
+    m_fd = o.m_fd;           o.m_fd = -1;
+#endif
+    m_data = o.m_data;       o.m_data = nullptr;
+    m_size = o.m_size;       o.m_size = 0;
+    return *this;
+}
+
+#if defined(_WIN32)
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return false; }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return false; }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size_t(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_file = m_mapping = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+}
+#else
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+
+    void* view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) { ::close(fd); return false; }
+
+    m_fd = fd;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size_t(st.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
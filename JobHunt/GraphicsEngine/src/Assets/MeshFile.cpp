@@ -0,0 +1,176 @@
+#include "Assets/MeshFile.h"
+#include <fstream>
+#include <cstring>
+
+using namespace GraphicsEngine;
+
+namespace {
+    struct PendingSection { MeshSection type; uint32_t stride; const void* data; uint64_t bytes; };
+
+    template<class T>
+    void AddSection(std::vector<PendingSection>& out, MeshSection type, const std::vector<T>& v)
+    {
+        if (!v.empty()) out.push_back({ type, uint32_t(sizeof(T)), v.data(), uint64_t(v.size() * sizeof(T)) });
+    }
+
+    uint64_t AlignUp(uint64_t v) { return (v + kMeshSectionAlign - 1) & ~uint64_t(kMeshSectionAlign - 1); }
+}
+
+// ============================================================================
+// Writer
+// ============================================================================
+AABB_t GraphicsEngine::ComputeMeshBounds(const std::vector<VertexPNC>& vertices)
+{
+    if (vertices.empty()) return AABB_t{};
+    float3 mn = vertices[0].pos, mx = vertices[0].pos;
+    for (const VertexPNC& v : vertices) {
+        mn = { SOL_MIN(mn.x, v.pos.x), SOL_MIN(mn.y, v.pos.y), SOL_MIN(mn.z, v.pos.z) };
+        mx = { SOL_MAX(mx.x, v.pos.x), SOL_MAX(mx.y, v.pos.y), SOL_MAX(mx.z, v.pos.z) };
+    }
+    AABB_t b;
+    b.center = (mn + mx) * 0.5f;
+    b.extents = (mx - mn) * 0.5f;
+    return b;
+}
+
+bool GraphicsEngine::WriteMeshFile(const std::string& path, const MeshData& mesh, const MeshWriteOptions& options)
+{
+    std::vector<PendingSection> sections;
+    AddSection(sections, MeshSection::Vertices, mesh.vertices);
+    AddSection(sections, MeshSection::Indices, mesh.indices);
+    AddSection(sections, MeshSection::Lods, mesh.lods);
+    AddSection(sections, MeshSection::Meshlets, mesh.meshlets.meshlets);
+    AddSection(sections, MeshSection::MeshletBounds, mesh.meshlets.bounds);
+    AddSection(sections, MeshSection::MeshletVertices, mesh.meshlets.vertices);
+    AddSection(sections, MeshSection::MeshletTriangles, mesh.meshlets.triangles);
+    AddSection(sections, MeshSection::MeshletIndices, mesh.meshlets.indices);
+
+    MeshFileHeader hdr;
+    hdr.sectionCount = uint32_t(sections.size());
+    hdr.headerBytes = uint32_t(sizeof(MeshFileHeader) + sections.size() * sizeof(MeshSectionEntry));
+    hdr.bounds = mesh.bounds;
+
+    // Compressed payloads replace the section data; keep them only where they save space
+    std::vector<std::vector<uint8_t>> packed(sections.size());
+    std::vector<MeshSectionEntry> table(sections.size());
+    uint64_t offset = AlignUp(hdr.headerBytes);
+    for (size_t i = 0; i < sections.size(); i++) {
+        PendingSection& s = sections[i];
+        const uint64_t rawBytes = s.bytes;
+        MeshCodec codec = MeshCodec::None;
+        if (options.compress) {
+            CompressBlocks(static_cast<const uint8_t*>(s.data), size_t(s.bytes), packed[i], options.jobs);
+            if (packed[i].size() < s.bytes) {
+                s.data = packed[i].data();
+                s.bytes = packed[i].size();
+                codec = MeshCodec::Lz4Blocks;
+            }
+        }
+        table[i] = { s.type, s.stride, offset, s.bytes, rawBytes, codec, 0 };
+        offset = AlignUp(offset + s.bytes);
+    }
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    f.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(MeshSectionEntry));
+
+    static const char zeros[kMeshSectionAlign] = {};
+    uint64_t written = hdr.headerBytes;
+    for (size_t i = 0; i < sections.size(); i++) {
+        f.write(zeros, std::streamsize(table[i].offset - written));
+        f.write(static_cast<const char*>(sections[i].data), std::streamsize(sections[i].bytes));
+        written = table[i].offset + sections[i].bytes;
+    }
+    f.write(zeros, std::streamsize(AlignUp(written) - written));   // keep the file size a multiple of the alignment
+    return bool(f);
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+bool MeshFile::Open(const std::string& path)
+{
+    Close();
+    if (!m_map.Open(path)) return false;
+
+    const uint8_t* data = m_map.Data();
+    const size_t size = m_map.Size();
+    const MeshFileHeader* hdr = reinterpret_cast<const MeshFileHeader*>(data);
+    if (size < sizeof(MeshFileHeader) || std::memcmp(hdr->magic, "GEMS", 4) != 0 ||
+        hdr->version != kMeshFileVersion ||
+        hdr->headerBytes != sizeof(MeshFileHeader) + uint64_t(hdr->sectionCount) * sizeof(MeshSectionEntry) ||
+        hdr->headerBytes > size) {
+        Close();
+        return false;
+    }
+
+    // Validate once so accessors can hand out raw views
+    const MeshSectionEntry* table = reinterpret_cast<const MeshSectionEntry*>(data + sizeof(MeshFileHeader));
+    for (uint32_t i = 0; i < hdr->sectionCount; i++) {
+        const MeshSectionEntry& e = table[i];
+        const bool codecOk = e.codec == MeshCodec::None ? e.rawBytes == e.bytes : e.codec == MeshCodec::Lz4Blocks;
+        if (e.offset % kMeshSectionAlign || e.offset < hdr->headerBytes || e.offset > size ||
+            e.bytes > size - e.offset || e.stride == 0 || e.rawBytes % e.stride || !codecOk) {
+            Close();
+            return false;
+        }
+    }
+
+    m_header = hdr;
+    m_table = table;
+    return true;
+}
+
+void MeshFile::Close()
+{
+    m_map.Close();
+    m_header = nullptr;
+    m_table = nullptr;
+}
+
+const MeshSectionEntry* MeshFile::Find(MeshSection type) const
+{
+    if (!m_header) return nullptr;
+    for (uint32_t i = 0; i < m_header->sectionCount; i++)
+        if (m_table[i].type == type) return &m_table[i];
+    return nullptr;
+}
+
+std::span<const uint8_t> MeshFile::GetSection(MeshSection type) const
+{
+    const MeshSectionEntry* e = Find(type);
+    if (!e) return {};
+    return { m_map.Data() + e->offset, size_t(e->bytes) };
+}
+
+uint64_t MeshFile::GetSectionRawSize(MeshSection type) const
+{
+    const MeshSectionEntry* e = Find(type);
+    return e ? e->rawBytes : 0;
+}
+
+bool MeshFile::IsCompressed(MeshSection type) const
+{
+    const MeshSectionEntry* e = Find(type);
+    return e && e->codec != MeshCodec::None;
+}
+
+bool MeshFile::OpenBlockStream(MeshSection type, BlockStreamReader& reader) const
+{
+    const MeshSectionEntry* e = Find(type);
+    if (!e || e->codec != MeshCodec::Lz4Blocks) return false;
+    return reader.Open(m_map.Data() + e->offset, size_t(e->bytes)) && reader.RawSize() == e->rawBytes;
+}
+
+bool MeshFile::ReadSection(MeshSection type, void* dst, size_t dstSize, JobSystem* jobs) const
+{
+    const MeshSectionEntry* e = Find(type);
+    if (!e || dstSize != e->rawBytes) return false;
+    if (e->codec == MeshCodec::None) {
+        std::memcpy(dst, m_map.Data() + e->offset, dstSize);
+        return true;
+    }
+    BlockStreamReader reader;
+    return OpenBlockStream(type, reader) && reader.DecodeAll(static_cast<uint8_t*>(dst), jobs);
+}
@@ -0,0 +1,314 @@
+#include "Assets/MeshImport.h"
+#include "Assets/MappedFile.h"
+#include "ImportCommon.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace GraphicsEngine::ImportDetail;
+
+namespace {
+    constexpr uint32_t kNoIndex = UINT32_MAX;
+
+    // Line-aligned slice of the file. Counts come from the first pass, bases from their prefix sums.
+    struct ObjChunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        uint32_t positions = 0, normals = 0, triangles = 0;
+        uint32_t positionBase = 0, normalBase = 0, triangleBase = 0;
+        bool     sharedIndices = true;    // every corner has normal index == position index (or none)
+        bool     ok = true;
+    };
+
+    // Parsed corners of all triangles, filled in place by the chunks
+    struct ObjArrays {
+        float3*   positions = nullptr;
+        float3*   normals = nullptr;
+        uint32_t* cornerPos = nullptr;    // 3 per triangle, 0-based
+        uint32_t* cornerNrm = nullptr;    // kNoIndex when the corner has no normal
+        uint32_t  positionCount = 0, normalCount = 0;
+    };
+
+    inline bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+    inline bool IsLineEnd(char c) { return c == '\n' || c == '\r' || c == '#'; }
+
+    inline const char* SkipSpace(const char* p, const char* e)
+    {
+        while (p < e && IsSpace(*p)) ++p;
+        return p;
+    }
+
+    inline const char* NextLine(const char* p, const char* e)
+    {
+        const char* n = static_cast<const char*>(std::memchr(p, '\n', size_t(e - p)));
+        return n ? n + 1 : e;
+    }
+
+    inline const char* ParseFloat(const char* p, const char* e, float& v)
+    {
+        p = SkipSpace(p, e);
+        if (p < e && *p == '+') ++p;     // from_chars rejects an explicit plus sign
+        auto r = std::from_chars(p, e, v);
+        if (r.ec != std::errc()) { v = 0.0f; return nullptr; }
+        return r.ptr;
+    }
+
+    // Counts corner tokens on an "f" line
+    uint32_t CountCorners(const char* p, const char* e)
+    {
+        uint32_t n = 0;
+        for (;;) {
+            p = SkipSpace(p, e);
+            if (p >= e || IsLineEnd(*p)) return n;
+            ++n;
+            while (p < e && !IsSpace(*p) && !IsLineEnd(*p)) ++p;
+        }
+    }
+
+    void CountChunk(ObjChunk& c)
+    {
+        for (const char* p = c.begin; p < c.end; p = NextLine(p, c.end)) {
+            const char* e = c.end;
+            if (p + 1 >= e) break;
+            if (p[0] == 'v') {
+                if (IsSpace(p[1])) c.positions++;
+                else if (p[1] == 'n' && p + 2 < e && IsSpace(p[2])) c.normals++;
+            } else if (p[0] == 'f' && IsSpace(p[1])) {
+                const uint32_t corners = CountCorners(p + 2, e);
+                if (corners >= 3) c.triangles += corners - 2;
+            }
+        }
+    }
+
+    // OBJ index: 1-based, or negative = relative to the number of elements defined so far
+    inline bool ResolveIndex(int32_t raw, uint32_t definedSoFar, uint32_t total, uint32_t& out)
+    {
+        int64_t i = raw > 0 ? int64_t(raw) - 1 : int64_t(definedSoFar) + raw;
+        if (raw == 0 || i < 0 || i >= int64_t(total)) return false;
+        out = uint32_t(i);
+        return true;
+    }
+
+    // Parses "v", "v/vt", "v//vn" or "v/vt/vn"
+    const char* ParseCorner(const char* p, const char* e, const ObjArrays& a,
+                            uint32_t posSoFar, uint32_t nrmSoFar, uint32_t& vi, uint32_t& ni)
+    {
+        int32_t raw = 0;
+        auto r = std::from_chars(p, e, raw);
+        if (r.ec != std::errc() || !ResolveIndex(raw, posSoFar, a.positionCount, vi)) return nullptr;
+        p = r.ptr;
+        ni = kNoIndex;
+        if (p < e && *p == '/') {
+            ++p;
+            if (p < e && *p != '/') {                 // texcoord index, unused
+                r = std::from_chars(p, e, raw);
+                if (r.ec != std::errc()) return nullptr;
+                p = r.ptr;
+            }
+            if (p < e && *p == '/') {
+                ++p;
+                r = std::from_chars(p, e, raw);
+                if (r.ec != std::errc() || !ResolveIndex(raw, nrmSoFar, a.normalCount, ni)) return nullptr;
+                p = r.ptr;
+            }
+        }
+        return p;
+    }
+
+    void ParseChunk(ObjChunk& c, const ObjArrays& a, bool flipWinding)
+    {
+        uint32_t v = c.positionBase, n = c.normalBase, t = c.triangleBase;
+        for (const char* p = c.begin; p < c.end; p = NextLine(p, c.end)) {
+            const char* e = c.end;
+            if (p + 1 >= e) break;
+            if (p[0] == 'v' && IsSpace(p[1])) {
+                float3& out = a.positions[v++];
+                const char* q = ParseFloat(p + 2, e, out.x);
+                q = q ? ParseFloat(q, e, out.y) : nullptr;
+                q = q ? ParseFloat(q, e, out.z) : nullptr;
+                if (!q) { c.ok = false; return; }
+            } else if (p[0] == 'v' && p[1] == 'n' && p + 2 < e && IsSpace(p[2])) {
+                float3& out = a.normals[n++];
+                const char* q = ParseFloat(p + 3, e, out.x);
+                q = q ? ParseFloat(q, e, out.y) : nullptr;
+                q = q ? ParseFloat(q, e, out.z) : nullptr;
+                if (!q) { c.ok = false; return; }
+            } else if (p[0] == 'f' && IsSpace(p[1])) {
+                // Fan triangulation without buffering the polygon: keep the first and previous corner
+                uint32_t firstV = 0, firstN = 0, prevV = 0, prevN = 0, corner = 0;
+                const char* q = p + 2;
+                for (;;) {
+                    q = SkipSpace(q, e);
+                    if (q >= e || IsLineEnd(*q)) break;
+                    uint32_t vi, ni;
+                    q = ParseCorner(q, e, a, v, n, vi, ni);
+                    if (!q) { c.ok = false; return; }
+                    if (ni != kNoIndex && ni != vi) c.sharedIndices = false;
+
+                    if (corner == 0) { firstV = vi; firstN = ni; }
+                    else if (corner >= 2) {
+                        uint32_t* cp = &a.cornerPos[size_t(t) * 3];
+                        uint32_t* cn = &a.cornerNrm[size_t(t) * 3];
+                        const int i1 = flipWinding ? 2 : 1, i2 = flipWinding ? 1 : 2;
+                        cp[0] = firstV; cp[i1] = prevV; cp[i2] = vi;
+                        cn[0] = firstN; cn[i1] = prevN; cn[i2] = ni;
+                        t++;
+                    }
+                    prevV = vi; prevN = ni;
+                    corner++;
+                }
+            }
+        }
+    }
+
+    inline float3 ConvertPoint(const float3& p, const ImportOptions& o)
+    {
+        return { p.x * o.scale, p.y * o.scale, (o.convertHandedness ? -p.z : p.z) * o.scale };
+    }
+    inline float3 ConvertNormal(const float3& n, const ImportOptions& o)
+    {
+        return normalize_safe(float3{ n.x, n.y, o.convertHandedness ? -n.z : n.z }, { 0,1,0 });
+    }
+
+    // Open addressing (vi, ni) -> output vertex; only used when normals are indexed separately
+    uint32_t DedupCorners(const ObjArrays& a, size_t cornerCount, LinearArena& scratch,
+                          uint32_t* indices, uint64_t*& uniqueKeys)
+    {
+        size_t cap = 1;
+        while (cap < cornerCount * 2) cap <<= 1;
+        uint64_t* keys = scratch.AllocArray<uint64_t>(cap);
+        uint32_t* values = scratch.AllocArray<uint32_t>(cap);
+        std::fill(keys, keys + cap, UINT64_MAX);
+        uniqueKeys = scratch.AllocArray<uint64_t>(cornerCount);
+
+        uint32_t unique = 0;
+        for (size_t i = 0; i < cornerCount; i++) {
+            const uint64_t key = (uint64_t(a.cornerPos[i]) << 32) | a.cornerNrm[i];
+            size_t h = size_t((key * 0x9E3779B97F4A7C15ull) >> 17) & (cap - 1);
+            while (keys[h] != UINT64_MAX && keys[h] != key) h = (h + 1) & (cap - 1);
+            if (keys[h] == UINT64_MAX) {
+                keys[h] = key;
+                values[h] = unique;
+                uniqueKeys[unique++] = key;
+            }
+            indices[i] = values[h];
+        }
+        return unique;
+    }
+}
+
+bool GraphicsEngine::ImportObj(const std::string& path, LinearArena& arena, ImportedMesh& out,
+                               JobSystem* jobs, const ImportOptions& options, ImportStats* stats)
+{
+    const auto t0 = Clock::now();
+    out = ImportedMesh{};
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    const char* data = reinterpret_cast<const char*>(file.Data());
+    const char* end = data + file.Size();
+
+    // ---- Split into line-aligned chunks (several per thread, at least 1 MB each)
+    const uint32_t threads = jobs ? jobs->GetThreadCount() : 1;
+    const size_t minChunk = size_t(1) << 20;
+    const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(size_t(threads) * 8, file.Size() / minChunk));
+    std::vector<ObjChunk> chunks(chunkCount);
+    const char* p = data;
+    for (size_t i = 0; i < chunkCount; i++) {
+        chunks[i].begin = p;
+        const char* target = (i + 1 == chunkCount) ? end : data + file.Size() * (i + 1) / chunkCount;
+        p = target < p ? p : (target >= end ? end : NextLine(target, end));
+        chunks[i].end = p;
+    }
+
+    // ---- Pass 1: count
+    ForRange(jobs, uint32_t(chunkCount), 1, [&](uint32_t b, uint32_t e) {
+        for (uint32_t i = b; i < e; i++) CountChunk(chunks[i]);
+    });
+
+    ObjArrays a;
+    uint32_t triangles = 0;
+    for (ObjChunk& c : chunks) {
+        c.positionBase = a.positionCount; a.positionCount += c.positions;
+        c.normalBase = a.normalCount;     a.normalCount += c.normals;
+        c.triangleBase = triangles;       triangles += c.triangles;
+    }
+    if (a.positionCount == 0 || triangles == 0) return false;
+
+    // ---- Pass 2: parse straight into the preallocated arrays
+    LinearArena scratch(size_t(a.positionCount + a.normalCount) * sizeof(float3) + size_t(triangles) * 24 + 4096);
+    a.positions = scratch.AllocArray<float3>(a.positionCount);
+    a.normals = scratch.AllocArray<float3>(a.normalCount);
+    a.cornerPos = scratch.AllocArray<uint32_t>(size_t(triangles) * 3);
+    a.cornerNrm = scratch.AllocArray<uint32_t>(size_t(triangles) * 3);
+
+    ForRange(jobs, uint32_t(chunkCount), 1, [&](uint32_t b, uint32_t e) {
+        for (uint32_t i = b; i < e; i++) ParseChunk(chunks[i], a, options.convertHandedness);
+    });
+    bool shared = true;
+    for (const ObjChunk& c : chunks) {
+        if (!c.ok) return false;
+        shared &= c.sharedIndices;
+    }
+    const auto t1 = Clock::now();
+
+    // ---- Assemble VertexPNC + indices in the caller's arena
+    const size_t cornerCount = size_t(triangles) * 3;
+    const bool hasNormals = a.normalCount > 0;
+    out.indexCount = uint32_t(cornerCount);
+    out.indices = arena.AllocArray<uint32_t>(cornerCount);
+
+    if (!hasNormals || (shared && a.normalCount == a.positionCount)) {
+        // Fast path: one output vertex per position, indices copied as is
+        out.vertexCount = a.positionCount;
+        out.vertices = arena.AllocArray<VertexPNC>(out.vertexCount);
+        ForRange(jobs, out.vertexCount, 16384, [&](uint32_t b, uint32_t e) {
+            for (uint32_t i = b; i < e; i++) {
+                VertexPNC& v = out.vertices[i];
+                v.pos = ConvertPoint(a.positions[i], options);
+                v.normal = hasNormals ? ConvertNormal(a.normals[i], options) : float3{ 0,0,0 };
+                v.color = options.defaultColor;
+            }
+        });
+        ForRange(jobs, uint32_t(cornerCount), 65536, [&](uint32_t b, uint32_t e) {
+            std::memcpy(out.indices + b, a.cornerPos + b, size_t(e - b) * sizeof(uint32_t));
+        });
+    } else {
+        uint64_t* keys = nullptr;
+        out.vertexCount = DedupCorners(a, cornerCount, scratch, out.indices, keys);
+        out.vertices = arena.AllocArray<VertexPNC>(out.vertexCount);
+        ForRange(jobs, out.vertexCount, 16384, [&](uint32_t b, uint32_t e) {
+            for (uint32_t i = b; i < e; i++) {
+                const uint32_t vi = uint32_t(keys[i] >> 32), ni = uint32_t(keys[i]);
+                VertexPNC& v = out.vertices[i];
+                v.pos = ConvertPoint(a.positions[vi], options);
+                v.normal = ni != kNoIndex ? ConvertNormal(a.normals[ni], options) : float3{ 0,1,0 };
+                v.color = options.defaultColor;
+            }
+        });
+    }
+    if (!hasNormals) ComputeNormals(jobs, out.vertices, out.vertexCount, out.indices, out.indexCount);
+    out.bounds = ComputeBounds(out.vertices, out.vertexCount);
+
+    if (stats) {
+        stats->bytes = file.Size();
+        stats->parseSeconds = Seconds(t0, t1);
+        stats->totalSeconds = Seconds(t0, Clock::now());
+        stats->threads = threads;
+    }
+    return true;
+}
+
+bool GraphicsEngine::ImportMesh(const std::string& path, LinearArena& arena, ImportedMesh& out,
+                                JobSystem* jobs, const ImportOptions& options, ImportStats* stats)
+{
+    const size_t dot = path.find_last_of('.');
+    std::string ext = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+    for (char& ch : ext) ch = char(std::tolower((unsigned char)ch));
+    if (ext == "obj") return ImportObj(path, arena, out, jobs, options, stats);
+    if (ext == "gltf" || ext == "glb") return ImportGltf(path, arena, out, jobs, options, stats);
+    return false;
+}
@@ -0,0 +1,271 @@
+#include "Assets/ShaderCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace GraphicsEngine;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    double Seconds(Clock::time_point a) { return std::chrono::duration<double>(Clock::now() - a).count(); }
+
+    constexpr uint32_t kMaxIncludeDepth = 32;
+    constexpr uint64_t kBlobAlign = 16;
+
+    std::string DirectoryOf(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    // Names from #include "x" / #include <x> directives, in order. Comments and string literals are
+    // skipped, so an include that is commented out takes no part in the key.
+    void ScanIncludes(const std::string& text, std::vector<std::string>& out)
+    {
+        const size_t n = text.size();
+        auto blank = [&](size_t p) { while (p < n && (text[p] == ' ' || text[p] == '\t')) p++; return p; };
+        bool lineStart = true;   // nothing but whitespace and comments since the last newline
+        size_t pos = 0;
+        while (pos < n) {
+            const char c = text[pos];
+            if (c == '/' && pos + 1 < n && text[pos + 1] == '/') {
+                pos = text.find('\n', pos);
+                if (pos == std::string::npos) break;
+            } else if (c == '/' && pos + 1 < n && text[pos + 1] == '*') {
+                const size_t end = text.find("*/", pos + 2);
+                if (end == std::string::npos) break;
+                pos = end + 2;
+            } else if (c == '"') {
+                for (pos++; pos < n && text[pos] != '"' && text[pos] != '\n'; pos++)
+                    if (text[pos] == '\\') pos++;
+                pos++;
+                lineStart = false;
+            } else if (c == '#' && lineStart) {
+                lineStart = false;
+                pos = blank(pos + 1);
+                if (text.compare(pos, 7, "include") != 0) continue;
+                pos = blank(pos + 7);
+                if (pos >= n || (text[pos] != '"' && text[pos] != '<')) continue;
+                const char close = text[pos] == '"' ? '"' : '>';
+                const size_t end = text.find(close, pos + 1);
+                if (end == std::string::npos || text.find('\n', pos) < end) continue;
+                out.push_back(text.substr(pos + 1, end - pos - 1));
+                pos = end + 1;
+            } else {
+                if (c == '\n') lineStart = true;
+                else if (c != ' ' && c != '\t' && c != '\r') lineStart = false;
+                pos++;
+            }
+        }
+    }
+
+    bool HashFile(const std::string& path, ShaderCompiler& compiler, Hasher128& hasher,
+                  std::vector<std::string>& visited, std::string* text, uint32_t depth)
+    {
+        std::string source;
+        if (!compiler.ReadFile(path, source)) return false;
+        hasher.Add(source);
+        visited.push_back(path);
+
+        std::vector<std::string> includes;
+        ScanIncludes(source, includes);
+        const std::string dir = DirectoryOf(path);
+        for (const std::string& name : includes) {
+            hasher.Add(name);
+            const std::string child = dir + name;
+            if (depth >= kMaxIncludeDepth || std::find(visited.begin(), visited.end(), child) != visited.end()) continue;
+            // A missing include is left to the compiler to report; its name is already in the key
+            HashFile(child, compiler, hasher, visited, nullptr, depth + 1);
+        }
+        if (text) *text = std::move(source);
+        return true;
+    }
+}
+
+bool ShaderCompiler::ReadFile(const std::string& path, std::string& out)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    std::ostringstream ss;
+    ss << f.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+// ============================================================================
+// File
+// ============================================================================
+void ShaderCache::Open(const std::string& path)
+{
+    Close();
+    m_path = path;
+    const auto t0 = Clock::now();
+    if (!m_map.Open(path)) return;
+
+    const uint8_t* data = m_map.Data();
+    const size_t size = m_map.Size();
+    const ShaderCacheHeader* hdr = reinterpret_cast<const ShaderCacheHeader*>(data);
+    bool ok = size >= sizeof(ShaderCacheHeader) && std::memcmp(hdr->magic, "GESC", 4) == 0 && hdr->version == 1 &&
+              (size - sizeof(ShaderCacheHeader)) / sizeof(ShaderCacheEntry) >= hdr->entryCount;
+    const ShaderCacheEntry* table = reinterpret_cast<const ShaderCacheEntry*>(data + sizeof(ShaderCacheHeader));
+    for (uint32_t i = 0; ok && i < hdr->entryCount; i++) {
+        const ShaderCacheEntry& e = table[i];
+        ok = e.offset <= size && e.size <= size - e.offset && (i == 0 || table[i - 1].key < e.key);
+    }
+    if (ok) {
+        m_table = table;
+        m_entryCount = hdr->entryCount;
+    } else {
+        m_map.Close();   // stale format or torn write: start over
+    }
+    m_stats.openSeconds += Seconds(t0);
+}
+
+bool ShaderCache::Save()
+{
+    if (m_added.empty() || m_path.empty()) return true;
+
+    // Merge mapped and new entries, sorted by key
+    struct Item { Hash128 key; const uint8_t* data; uint64_t size; };
+    std::vector<Item> items;
+    items.reserve(m_entryCount + m_added.size());
+    for (uint32_t i = 0; i < m_entryCount; i++)
+        if (!m_added.count(m_table[i].key))
+            items.push_back({ m_table[i].key, m_map.Data() + m_table[i].offset, m_table[i].size });
+    for (const auto& [key, blob] : m_added) items.push_back({ key, blob.data(), blob.size() });
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+
+    ShaderCacheHeader hdr;
+    hdr.entryCount = uint32_t(items.size());
+    std::vector<ShaderCacheEntry> table(items.size());
+    uint64_t offset = sizeof(ShaderCacheHeader) + table.size() * sizeof(ShaderCacheEntry);
+    for (size_t i = 0; i < items.size(); i++) {
+        offset = (offset + kBlobAlign - 1) & ~(kBlobAlign - 1);
+        table[i] = { items[i].key, offset, items[i].size };
+        offset += items[i].size;
+    }
+
+    const std::string tmp = m_path + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f) return false;
+        f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        f.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(ShaderCacheEntry)));
+        static const char zeros[kBlobAlign] = {};
+        uint64_t written = sizeof(ShaderCacheHeader) + table.size() * sizeof(ShaderCacheEntry);
+        for (size_t i = 0; i < items.size(); i++) {
+            f.write(zeros, std::streamsize(table[i].offset - written));
+            f.write(reinterpret_cast<const char*>(items[i].data), std::streamsize(items[i].size));
+            written = table[i].offset + items[i].size;
+        }
+        f.close();
+        if (!f) {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    // The mapping must go before the rename (Windows refuses to replace a mapped file). If the
+    // rename fails the old file is untouched: it is mapped again and the new blobs stay in memory
+    // for the next Save.
+    const std::string path = m_path;
+    m_map.Close();
+    m_table = nullptr;
+    m_entryCount = 0;
+    std::filesystem::rename(tmp, path, ec);
+    const bool renamed = !ec;
+    auto added = std::move(m_added);
+    if (renamed) added.clear();
+    else std::filesystem::remove(tmp, ec);
+    Open(path);
+    m_added = std::move(added);
+    return renamed;
+}
+
+void ShaderCache::Close()
+{
+    m_map.Close();
+    m_table = nullptr;
+    m_entryCount = 0;
+    m_added.clear();
+    m_path.clear();
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+std::span<const uint8_t> ShaderCache::Find(const Hash128& key) const
+{
+    auto added = m_added.find(key);
+    if (added != m_added.end()) return { added->second.data(), added->second.size() };
+
+    const ShaderCacheEntry* end = m_table + m_entryCount;
+    const ShaderCacheEntry* e = std::lower_bound(m_table, end, key,
+        [](const ShaderCacheEntry& a, const Hash128& k) { return a.key < k; });
+    if (e == end || e->key != key) return {};
+    return { m_map.Data() + e->offset, size_t(e->size) };
+}
+
+void ShaderCache::Store(const Hash128& key, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_added[key].assign(bytes, bytes + size);
+    m_stats.stored++;
+}
+
+// ============================================================================
+// Shaders
+// ============================================================================
+bool GraphicsEngine::ShaderSourceKey(const ShaderDesc& desc, ShaderCompiler& compiler, Hash128& key, std::string* source)
+{
+    Hasher128 hasher;
+    hasher.Add(compiler.Version());
+    hasher.Add(desc.entry);
+    hasher.Add(desc.target);
+    hasher.AddPod(desc.flags);
+    for (const ShaderDefine& d : desc.defines) { hasher.Add(d.name); hasher.Add(d.value); }
+
+    std::vector<std::string> visited;
+    const bool ok = HashFile(desc.path, compiler, hasher, visited, source, 0);
+    key = hasher.Get();
+    return ok;
+}
+
+bool ShaderCache::ShaderKey(const ShaderDesc& desc, ShaderCompiler& compiler, Hash128& key, std::string* source)
+{
+    const auto t0 = Clock::now();
+    const bool ok = ShaderSourceKey(desc, compiler, key, source);
+    m_stats.keySeconds += Seconds(t0);
+    return ok;
+}
+
+bool ShaderCache::GetShader(const ShaderDesc& desc, ShaderCompiler& compiler, std::span<const uint8_t>& bytecode,
+                            std::string* errors)
+{
+    Hash128 key;
+    std::string source;
+    if (!ShaderKey(desc, compiler, key, &source)) {
+        if (errors) *errors = "cannot read " + desc.path;
+        return false;
+    }
+
+    bytecode = Find(key);
+    if (!bytecode.empty()) { m_stats.hits++; return true; }
+
+    m_stats.misses++;
+    const auto t0 = Clock::now();
+    std::vector<uint8_t> blob;
+    std::string log;
+    const bool ok = compiler.Compile(desc, source, blob, log);
+    m_stats.compileSeconds += Seconds(t0);
+    if (errors) *errors = std::move(log);
+    if (!ok) return false;
+
+    Store(key, blob.data(), blob.size());
+    bytecode = Find(key);
+    return true;
+}
@@ -0,0 +1,332 @@
+#include "Assets/ShaderPermutations.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace GraphicsEngine;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    double Seconds(Clock::time_point a) { return std::chrono::duration<double>(Clock::now() - a).count(); }
+
+    constexpr uint64_t kBlobAlign = 16;
+
+    struct KeywordInfo { uint32_t bit; const char* name; };
+    constexpr KeywordInfo kKeywords[kShaderKeywordCount] = {
+        { kKeywordLighting, "LIGHTING" },
+        { kKeywordShadows,  "SHADOWS" },
+        { kKeywordAmbient,  "AMBIENT" },
+        { kKeywordInstanced, "INSTANCED" },
+    };
+
+    uint32_t PopCount(uint32_t v)
+    {
+        uint32_t n = 0;
+        for (; v; v &= v - 1) n++;
+        return n;
+    }
+}
+
+// ============================================================================
+// Keywords
+// ============================================================================
+const char* GraphicsEngine::ShaderKeywordName(uint32_t bit)
+{
+    for (const KeywordInfo& k : kKeywords)
+        if (k.bit == bit) return k.name;
+    return nullptr;
+}
+
+uint32_t GraphicsEngine::ShaderKeywordBit(std::string_view name)
+{
+    for (const KeywordInfo& k : kKeywords)
+        if (name == k.name) return k.bit;
+    return 0;
+}
+
+bool GraphicsEngine::ParseShaderKeywords(std::string_view list, uint32_t& mask)
+{
+    mask = 0;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        const size_t end = std::min(list.find_first_of(" |,\t", pos), list.size());
+        if (end > pos) {
+            const uint32_t bit = ShaderKeywordBit(list.substr(pos, end - pos));
+            if (!bit) return false;
+            mask |= bit;
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+std::string GraphicsEngine::ShaderKeywordString(uint32_t mask)
+{
+    std::string s;
+    for (const KeywordInfo& k : kKeywords) {
+        if (!(mask & k.bit)) continue;
+        if (!s.empty()) s += '|';
+        s += k.name;
+    }
+    return s;
+}
+
+// ============================================================================
+// Programs
+// ============================================================================
+std::span<const ShaderProgramDesc> GraphicsEngine::EngineShaderPrograms()
+{
+    static const ShaderProgramDesc programs[kEngineProgramCount] = {
+        // Unlit position + colour: lines, HUD
+        { "Basic", "Basic.hlsl", { "VSMain", "PSMain" }, { "vs_5_0", "ps_5_0" }, 0, {} },
+        // Lit triangles; also the depth-only shadow pass (vertex stage of the empty permutation)
+        { "BasicLit", "BasicLit.hlsl", { "VSMainLit", "PSMainLit" }, { "vs_5_0", "ps_5_0" },
+          kKeywordLighting | kKeywordShadows | kKeywordAmbient | kKeywordInstanced, {} },
+        // Instanced glyph quads sampling the text atlas (Text.h)
+        { "Text", "Text.hlsl", { "VSText", "PSText" }, { "vs_5_0", "ps_5_0" }, 0, {} },
+        // Camera-facing particle quads, alpha-blended (Particles.h)
+        { "Particle", "Particle.hlsl", { "VSParticle", "PSParticle" }, { "vs_5_0", "ps_5_0" }, 0, {} },
+    };
+    return programs;
+}
+
+uint32_t GraphicsEngine::PermutationIndex(uint32_t keywords, uint32_t programKeywords)
+{
+    uint32_t index = 0, out = 1;
+    for (uint32_t m = programKeywords; m; m &= m - 1, out <<= 1)
+        if (keywords & m & (~m + 1)) index |= out;   // lowest remaining program bit
+    return index;
+}
+
+uint32_t GraphicsEngine::PermutationCount(uint32_t programKeywords)
+{
+    return 1u << PopCount(programKeywords);
+}
+
+std::vector<ShaderDefine> GraphicsEngine::PermutationDefines(uint32_t keywords, uint32_t programKeywords)
+{
+    std::vector<ShaderDefine> defines;
+    for (const KeywordInfo& k : kKeywords)
+        if (programKeywords & k.bit) defines.push_back({ k.name, (keywords & k.bit) ? "1" : "0" });
+    return defines;
+}
+
+ShaderDesc GraphicsEngine::PermutationShaderDesc(const ShaderProgramDesc& program, uint32_t keywords, ShaderStage stage,
+                                                 const std::string& shaderDir, uint32_t flags)
+{
+    ShaderDesc desc;
+    desc.path = shaderDir;
+    if (!desc.path.empty() && desc.path.back() != '/' && desc.path.back() != '\\') desc.path += '/';
+    desc.path += program.path;
+    desc.entry = program.entry[uint32_t(stage)];
+    desc.target = program.target[uint32_t(stage)];
+    desc.defines = PermutationDefines(keywords, program.keywords);
+    desc.flags = flags;
+    return desc;
+}
+
+// ============================================================================
+// Archive
+// ============================================================================
+bool ShaderArchive::Open(const std::string& path)
+{
+    Close();
+    if (!m_map.Open(path)) return false;
+
+    const uint8_t* data = m_map.Data();
+    const size_t size = m_map.Size();
+    const ShaderArchiveHeader* hdr = reinterpret_cast<const ShaderArchiveHeader*>(data);
+    bool ok = size >= sizeof(ShaderArchiveHeader) && std::memcmp(hdr->magic, "GESA", 4) == 0 && hdr->version == 1 &&
+              (size - sizeof(ShaderArchiveHeader)) / sizeof(ShaderArchiveProgram) >= hdr->programCount;
+    const ShaderArchiveProgram* programs = reinterpret_cast<const ShaderArchiveProgram*>(data + sizeof(ShaderArchiveHeader));
+    const size_t slotStart = sizeof(ShaderArchiveHeader) + size_t(ok ? hdr->programCount : 0) * sizeof(ShaderArchiveProgram);
+    ok = ok && (size - slotStart) / sizeof(ShaderArchiveSlot) >= hdr->slotCount;
+    const ShaderArchiveSlot* slots = reinterpret_cast<const ShaderArchiveSlot*>(data + slotStart);
+
+    // Validate once so Find can index without checks
+    for (uint32_t p = 0; ok && p < hdr->programCount; p++) {
+        const ShaderArchiveProgram& prog = programs[p];
+        ok = prog.firstSlot <= hdr->slotCount &&
+             uint64_t(PermutationCount(prog.keywords)) * kShaderStageCount <= hdr->slotCount - prog.firstSlot &&
+             prog.name[sizeof(prog.name) - 1] == 0;
+    }
+    for (uint32_t i = 0; ok && i < hdr->slotCount; i++)
+        ok = slots[i].offset <= size && slots[i].size <= size - slots[i].offset;
+
+    if (!ok) {
+        m_map.Close();
+        return false;
+    }
+    m_programs = programs;
+    m_slots = slots;
+    m_programCount = hdr->programCount;
+    return true;
+}
+
+void ShaderArchive::Close()
+{
+    m_map.Close();
+    m_programs = nullptr;
+    m_slots = nullptr;
+    m_programCount = 0;
+}
+
+ShaderProgramId ShaderArchive::FindProgram(std::string_view name) const
+{
+    for (uint32_t p = 0; p < m_programCount; p++)
+        if (name == m_programs[p].name) return p;
+    return kInvalidShaderProgram;
+}
+
+std::span<const uint8_t> ShaderArchive::Find(ShaderProgramId program, uint32_t keywords, ShaderStage stage, Hash128* key) const
+{
+    if (program >= m_programCount) return {};
+    const ShaderArchiveProgram& prog = m_programs[program];
+    const ShaderArchiveSlot& slot =
+        m_slots[prog.firstSlot + PermutationIndex(keywords, prog.keywords) * kShaderStageCount + uint32_t(stage)];
+    if (key) *key = slot.key;
+    if (!slot.size) return {};
+    return { m_map.Data() + slot.offset, size_t(slot.size) };
+}
+
+// ============================================================================
+// Offline build
+// ============================================================================
+bool GraphicsEngine::BuildShaderArchive(const std::string& outPath, std::span<const ShaderProgramDesc> programs,
+                                        const std::string& shaderDir, uint32_t flags, ShaderCompiler& compiler,
+                                        JobSystem* jobs, ShaderCache* cache, std::string& errors,
+                                        ShaderArchiveBuildStats* stats)
+{
+    ShaderArchiveBuildStats local;
+    ShaderArchiveBuildStats& st = stats ? *stats : local;
+
+    // Program table and the work list: one task per (permutation, stage) actually requested
+    struct Task {
+        uint32_t                 slot;
+        uint32_t                 keywords;
+        ShaderDesc               desc;
+        Hash128                  key;
+        std::string              source;
+        std::span<const uint8_t> cached;
+        std::vector<uint8_t>     bytecode;
+        std::string              log;
+        bool                     readable = false;
+        bool                     ok = false;
+    };
+    std::vector<ShaderArchiveProgram> table(programs.size());
+    std::vector<Task> tasks;
+    uint32_t slotCount = 0;
+    for (size_t p = 0; p < programs.size(); p++) {
+        const ShaderProgramDesc& prog = programs[p];
+        ShaderArchiveProgram& entry = table[p];
+        std::memset(&entry, 0, sizeof(entry));
+        if (prog.name.size() >= sizeof(entry.name)) {
+            errors += "program name too long: " + prog.name + "\n";
+            return false;
+        }
+        std::memcpy(entry.name, prog.name.data(), prog.name.size());
+        entry.keywords = prog.keywords;
+        entry.firstSlot = slotCount;
+
+        std::vector<uint32_t> variants = prog.variants;
+        if (variants.empty())
+            for (uint32_t m = prog.keywords;; m = (m - 1) & prog.keywords) {   // every subset
+                variants.push_back(m);
+                if (!m) break;
+            }
+        std::vector<bool> seen(PermutationCount(prog.keywords), false);
+        for (uint32_t v : variants) {
+            const uint32_t index = PermutationIndex(v, prog.keywords);
+            if (seen[index]) continue;
+            seen[index] = true;
+            for (uint32_t s = 0; s < kShaderStageCount; s++) {
+                if (prog.entry[s].empty()) continue;
+                Task t;
+                t.slot = slotCount + index * kShaderStageCount + s;
+                t.keywords = v & prog.keywords;
+                t.desc = PermutationShaderDesc(prog, v & prog.keywords, ShaderStage(s), shaderDir, flags);
+                tasks.push_back(std::move(t));
+            }
+        }
+        slotCount += PermutationCount(prog.keywords) * kShaderStageCount;
+    }
+
+    // Key everything first (cheap, parallel), then compile the misses
+    auto t0 = Clock::now();
+    auto run = [&](auto&& fn) {
+        if (jobs) jobs->ParallelFor(uint32_t(tasks.size()), 1, [&](uint32_t b, uint32_t e) { for (uint32_t i = b; i < e; i++) fn(tasks[i]); });
+        else      for (Task& t : tasks) fn(t);
+    };
+    run([&](Task& t) {
+        t.readable = ShaderSourceKey(t.desc, compiler, t.key, &t.source);
+        if (!t.readable) { t.log = "cannot read " + t.desc.path; return; }
+        if (cache) t.cached = cache->Find(t.key);   // read-only while the jobs run
+        t.ok = !t.cached.empty();
+    });
+    st.keySeconds += Seconds(t0);
+
+    t0 = Clock::now();
+    run([&](Task& t) {
+        if (t.ok || !t.readable) return;
+        t.ok = compiler.Compile(t.desc, t.source, t.bytecode, t.log);
+        std::string().swap(t.source);
+    });
+    st.compileSeconds += Seconds(t0);
+
+    for (Task& t : tasks) {
+        if (!t.ok) {
+            st.failed++;
+            errors += t.desc.path + " " + t.desc.entry + " [" + ShaderKeywordString(t.keywords) + "]: " + t.log + "\n";
+            continue;
+        }
+        if (!t.cached.empty()) st.reused++;
+        else {
+            st.compiled++;
+            if (cache) cache->Store(t.key, t.bytecode.data(), t.bytecode.size());
+        }
+    }
+    if (st.failed) return false;
+
+    // Layout: header, programs, slots, then blobs in slot order
+    t0 = Clock::now();
+    std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.slot < b.slot; });
+    ShaderArchiveHeader hdr;
+    hdr.programCount = uint32_t(table.size());
+    hdr.slotCount = slotCount;
+    std::vector<ShaderArchiveSlot> slots(slotCount, ShaderArchiveSlot{ Hash128{}, 0, 0 });
+    uint64_t offset = sizeof(hdr) + table.size() * sizeof(ShaderArchiveProgram) + slots.size() * sizeof(ShaderArchiveSlot);
+    for (const Task& t : tasks) {
+        const size_t size = t.cached.empty() ? t.bytecode.size() : t.cached.size();
+        offset = (offset + kBlobAlign - 1) & ~(kBlobAlign - 1);
+        slots[t.slot] = { t.key, offset, size };
+        offset += size;
+    }
+
+    const std::string tmp = outPath + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f) { errors += "cannot write " + tmp + "\n"; return false; }
+        f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        f.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(ShaderArchiveProgram)));
+        f.write(reinterpret_cast<const char*>(slots.data()), std::streamsize(slots.size() * sizeof(ShaderArchiveSlot)));
+        static const char zeros[kBlobAlign] = {};
+        uint64_t written = sizeof(hdr) + table.size() * sizeof(ShaderArchiveProgram) + slots.size() * sizeof(ShaderArchiveSlot);
+        for (const Task& t : tasks) {
+            const ShaderArchiveSlot& s = slots[t.slot];
+            const uint8_t* data = t.cached.empty() ? t.bytecode.data() : t.cached.data();
+            f.write(zeros, std::streamsize(s.offset - written));
+            f.write(reinterpret_cast<const char*>(data), std::streamsize(s.size));
+            written = s.offset + s.size;
+        }
+        st.bytes = written;
+        if (!f) { errors += "cannot write " + tmp + "\n"; return false; }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, outPath, ec);
+    st.writeSeconds += Seconds(t0);
+    if (ec) errors += "cannot replace " + outPath + "\n";
+    return !ec;
+}
@@ -0,0 +1,201 @@
+#include "Assets/TextureStreamer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace GraphicsEngine;
+
+// ============================================================================
+// Heuristics
+// ============================================================================
+float GraphicsEngine::ProjectedScreenSize(float radius, float distance, float fovY, float viewportHeight)
+{
+    // Diameter over the frustum height at that distance; inside the sphere it fills the screen
+    if (distance <= radius) return viewportHeight;
+    return radius / (distance * std::tan(fovY * 0.5f)) * viewportHeight;
+}
+
+uint32_t GraphicsEngine::DesiredMip(uint32_t width, uint32_t height, uint32_t mipCount, float screenPixels, float bias)
+{
+    if (screenPixels <= 0.0f) return mipCount - 1;
+    const float texels = float(std::max(width, height));
+    const float mip = std::floor(std::log2(texels / screenPixels) + bias);
+    if (mip <= 0.0f) return 0;
+    return std::min(uint32_t(mip), mipCount - 1);
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+TextureStreamer::TextureStreamer(AssetStreamer& streamer, const TextureStreamerDesc& desc)
+    : m_streamer(streamer), m_desc(desc)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    for (Texture& t : m_textures) CancelRequest(t);
+}
+
+TextureId TextureStreamer::Register(const StreamedTextureDesc& desc)
+{
+    Texture t;
+    t.desc = desc;
+    t.desc.mipCount = std::max(desc.mipCount, 1u);
+    t.tailMip = t.desc.mipCount - 1;
+    for (uint32_t m = 0; m < t.desc.mipCount; m++) {
+        if (std::max(std::max(desc.width >> m, 1u), std::max(desc.height >> m, 1u)) <= m_desc.tailSize) { t.tailMip = m; break; }
+    }
+    t.resident = t.desc.mipCount;
+    t.desired = t.reported = t.tailMip;
+    m_textures.push_back(t);
+    return TextureId(m_textures.size() - 1);
+}
+
+uint64_t TextureStreamer::MipBytes(TextureId id, uint32_t mip) const
+{
+    return RangeBytes(m_textures[id], mip, mip + 1);
+}
+
+uint64_t TextureStreamer::RangeBytes(const Texture& t, uint32_t firstMip, uint32_t endMip) const
+{
+    const uint32_t d = t.desc.blockDim;
+    uint64_t bytes = 0;
+    for (uint32_t m = firstMip; m < endMip; m++) {
+        const uint32_t w = std::max(t.desc.width >> m, 1u), h = std::max(t.desc.height >> m, 1u);
+        bytes += uint64_t((w + d - 1) / d) * ((h + d - 1) / d) * t.desc.blockBytes;
+    }
+    return bytes;
+}
+
+// ============================================================================
+// Per frame
+// ============================================================================
+void TextureStreamer::ReportUsage(TextureId id, float screenPixels, float distance)
+{
+    Texture& t = m_textures[id];
+    const uint32_t mip = std::min(DesiredMip(t.desc.width, t.desc.height, t.desc.mipCount, screenPixels, m_desc.mipBias), t.tailMip);
+    if (t.lastUsed != m_frame) {
+        t.lastUsed = m_frame;
+        t.reported = mip;
+        t.distance = distance;
+    } else {
+        t.reported = std::min(t.reported, mip);
+        t.distance = std::min(t.distance, distance);
+    }
+}
+
+void TextureStreamer::Update()
+{
+    m_stats.visible = 0;
+    m_stats.missingMips = 0;
+
+    std::vector<TextureId> wanted;
+    std::vector<TextureId> victims;
+    for (TextureId id = 0; id < m_textures.size(); id++) {
+        Texture& t = m_textures[id];
+        const bool used = t.lastUsed == m_frame;
+        t.desired = used ? t.reported : t.tailMip;
+        if (used) {
+            m_stats.visible++;
+            if (t.resident > t.desired) m_stats.missingMips += std::min(t.resident, t.tailMip) - t.desired;
+        }
+
+        if (t.request != kInvalidStream) {
+            const StreamState state = m_streamer.GetState(t.request);
+            if (state == StreamState::Failed || state == StreamState::Cancelled) {
+                m_stats.inFlightBytes -= t.requestBytes;   // failed read: retried below
+                t.request = kInvalidStream;
+            } else if (t.requestedMip < t.desired) {
+                CancelRequest(t);                          // no longer worth the bandwidth
+            }
+        }
+        if (t.request == kInvalidStream && t.resident > t.desired) wanted.push_back(id);
+        // Mips finer than needed (or above the tail when unused) can be given back
+        if (t.resident < t.desired) victims.push_back(id);
+    }
+
+    // Missing tails first, then by distance; visible textures win over prefetch
+    std::sort(wanted.begin(), wanted.end(), [this](TextureId a, TextureId b) {
+        const Texture& ta = m_textures[a];
+        const Texture& tb = m_textures[b];
+        const bool tailA = ta.resident == ta.desc.mipCount, tailB = tb.resident == tb.desc.mipCount;
+        if (tailA != tailB) return tailA;
+        return StreamPriority(ta.distance, ta.lastUsed == m_frame) < StreamPriority(tb.distance, tb.lastUsed == m_frame);
+    });
+    // Least recently used first, then the farthest
+    std::sort(victims.begin(), victims.end(), [this](TextureId a, TextureId b) {
+        const Texture& ta = m_textures[a];
+        const Texture& tb = m_textures[b];
+        if (ta.lastUsed != tb.lastUsed) return ta.lastUsed < tb.lastUsed;
+        return ta.distance > tb.distance;
+    });
+
+    size_t victim = 0;
+    uint32_t issued = 0;
+    for (TextureId id : wanted) {
+        if (issued >= m_desc.maxRequestsPerFrame) break;
+        Texture& t = m_textures[id];
+        const bool tail = t.resident == t.desc.mipCount;
+        const uint32_t first = tail ? t.tailMip : t.resident - 1;
+        const uint64_t bytes = RangeBytes(t, first, tail ? t.desc.mipCount : t.resident);
+
+        // Evict one mip at a time until the request fits
+        while (m_stats.residentBytes + m_stats.inFlightBytes + bytes > m_desc.budgetBytes && victim < victims.size()) {
+            Texture& v = m_textures[victims[victim]];
+            if (v.resident >= v.desired) { victim++; continue; }
+            m_stats.residentBytes -= RangeBytes(v, v.resident, v.resident + 1);
+            v.resident++;
+            m_stats.evictions++;
+            if (m_evict) m_evict(victims[victim], v.resident);
+        }
+        if (m_stats.residentBytes + m_stats.inFlightBytes + bytes > m_desc.budgetBytes) break;   // budget full
+
+        Request(id, first, tail ? t.desc.mipCount : t.resident);
+        issued++;
+    }
+
+    m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.residentBytes + m_stats.inFlightBytes);
+    m_frame++;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+void TextureStreamer::Request(TextureId id, uint32_t firstMip, uint32_t endMip)
+{
+    Texture& t = m_textures[id];
+    StreamRequestDesc req;
+    req.file = t.desc.file;
+    req.offset = t.desc.dataOffset + RangeBytes(t, 0, firstMip);
+    req.size = uint32_t(RangeBytes(t, firstMip, endMip));
+    req.priority = StreamPriority(t.distance, t.lastUsed == m_frame);
+    req.upload = [this, id, firstMip, endMip](const uint8_t* data, size_t size) { OnLoaded(id, firstMip, endMip, data, size); };
+
+    t.request = m_streamer.Request(std::move(req));
+    if (t.request == kInvalidStream) return;
+    t.requestedMip = firstMip;
+    t.requestBytes = RangeBytes(t, firstMip, endMip);
+    m_stats.inFlightBytes += t.requestBytes;
+    m_stats.requests++;
+}
+
+void TextureStreamer::OnLoaded(TextureId id, uint32_t firstMip, uint32_t endMip, const uint8_t* data, size_t size)
+{
+    Texture& t = m_textures[id];
+    t.request = kInvalidStream;
+    m_stats.inFlightBytes -= t.requestBytes;
+    if (endMip != t.resident) return;   // stale: the texture changed while the read was in flight
+
+    m_stats.residentBytes += t.requestBytes;
+    t.resident = firstMip;
+    if (m_upload) m_upload(id, firstMip, endMip - firstMip, data, size);
+}
+
+void TextureStreamer::CancelRequest(Texture& t)
+{
+    if (t.request == kInvalidStream) return;
+    m_streamer.Cancel(t.request);
+    t.request = kInvalidStream;
+    m_stats.inFlightBytes -= t.requestBytes;
+    m_stats.cancels++;
+}
@@ -9,7 +9,7 @@ void Camera::YawPitch(float dyaw, float dpitch){
     if(m_pitch>limit) m_pitch=limit; if(m_pitch<-limit) m_pitch=-limit; UpdateBasis();
 }
 void Camera::UpdateBasis(){
-    float cy=std::cosf(m_yaw), sy=std::sinf(m_yaw), cp=std::cosf(m_pitch), sp=std::sinf(m_pitch);
+    float cy=std::cos(m_yaw), sy=std::sin(m_yaw), cp=std::cos(m_pitch), sp=std::sin(m_pitch);
     m_forward = normalize_safe(float3{ sy*cp, sp, cy*cp });
     m_right   = normalize_safe(cross(float3{0,1,0}, m_forward), float3{1,0,0});
     m_up      = cross(m_forward, m_right);
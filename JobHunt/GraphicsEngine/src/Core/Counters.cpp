@@ -0,0 +1,65 @@
+#include "Core/Counters.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace GraphicsEngine;
+
+namespace {
+
+struct alignas(64) CounterBlock {
+    std::atomic<uint64_t> values[kCounterCount] = {};
+};
+
+struct Registry {
+    std::mutex                                 lock;
+    std::vector<std::unique_ptr<CounterBlock>> blocks;   // never shrinks: totals outlive their threads
+    CounterFrame                               totals, lastFrame;
+};
+
+Registry& GetRegistry()
+{
+    static Registry r;
+    return r;
+}
+
+thread_local CounterBlock* t_block = nullptr;
+
+CounterBlock* RegisterThread()
+{
+    Registry& r = GetRegistry();
+    std::lock_guard<std::mutex> lock(r.lock);
+    r.blocks.push_back(std::make_unique<CounterBlock>());
+    return r.blocks.back().get();
+}
+
+}
+
+void Counters::Add(Counter c, uint64_t n)
+{
+    CounterBlock* block = t_block;
+    if (!block) block = t_block = RegisterThread();
+
+    std::atomic<uint64_t>& v = block->values[uint32_t(c)];
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+const CounterFrame& Counters::EndFrame()
+{
+    Registry& r = GetRegistry();
+    std::lock_guard<std::mutex> lock(r.lock);
+
+    CounterFrame sum;
+    for (const auto& b : r.blocks)
+        for (uint32_t i = 0; i < kCounterCount; i++)
+            sum.values[i] += b->values[i].load(std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < kCounterCount; i++)
+        r.lastFrame.values[i] = sum.values[i] - r.totals.values[i];
+    r.totals = sum;
+    return r.lastFrame;
+}
+
+const CounterFrame& Counters::LastFrame() { return GetRegistry().lastFrame; }
+const CounterFrame& Counters::Totals() { return GetRegistry().totals; }
@@ -0,0 +1,273 @@
+#include "Core/FrameStats.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+using namespace GraphicsEngine;
+
+namespace {
+
+constexpr uint32_t kHalf = 1u << (LatencyHistogram::kSubBits - 1);
+
+double Ms(uint64_t ns) { return double(ns) * 1e-6; }
+
+StageSummary Summarize(const LatencyHistogram& h)
+{
+    StageSummary s;
+    s.count = h.Count();
+    s.minMs = Ms(h.Min());
+    s.meanMs = h.Mean() * 1e-6;
+    s.maxMs = Ms(h.Max());
+    s.p50Ms = Ms(h.Percentile(50.0));
+    s.p95Ms = Ms(h.Percentile(95.0));
+    s.p99Ms = Ms(h.Percentile(99.0));
+    s.p999Ms = Ms(h.Percentile(99.9));
+    return s;
+}
+
+bool WriteFile(const std::string& path, const std::string& text)
+{
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    f.write(text.data(), (std::streamsize)text.size());
+    return bool(f);
+}
+
+}
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+LatencyHistogram::LatencyHistogram()
+    : m_counts(size_t(kMaxBits - kSubBits + 2) * kHalf, 0)
+{
+}
+
+uint32_t LatencyHistogram::BucketIndex(uint64_t ns)
+{
+    ns = std::min<uint64_t>(ns, (uint64_t(1) << kMaxBits) - 1);
+    if (ns < (uint64_t(1) << kSubBits)) return uint32_t(ns);
+    // Keep the top kSubBits bits: the mantissa lands in [kHalf, 2*kHalf)
+    const uint32_t shift = uint32_t(std::bit_width(ns)) - kSubBits;
+    return shift * kHalf + uint32_t(ns >> shift);
+}
+
+uint64_t LatencyHistogram::BucketValue(uint32_t index)
+{
+    if (index < (1u << kSubBits)) return index;
+    const uint32_t shift = index / kHalf - 1;
+    const uint64_t mantissa = index - shift * kHalf;
+    return (mantissa << shift) + ((uint64_t(1) << shift) >> 1);
+}
+
+void LatencyHistogram::Record(uint64_t ns)
+{
+    m_counts[BucketIndex(ns)]++;
+    m_count++;
+    m_sum += ns;
+    m_min = std::min(m_min, ns);
+    m_max = std::max(m_max, ns);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < m_counts.size(); i++) m_counts[i] += other.m_counts[i];
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::Reset()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = m_sum = 0;
+    m_min = UINT64_MAX;
+    m_max = 0;
+}
+
+uint64_t LatencyHistogram::Percentile(double p) const
+{
+    if (!m_count) return 0;
+    // Nearest rank; the epsilon keeps 99.9 % of 100000 at rank 99900 rather than 99901
+    const double   exact = std::clamp(p, 0.0, 100.0) / 100.0 * double(m_count);
+    const uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(exact - 1e-9));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < (uint32_t)m_counts.size(); i++) {
+        seen += m_counts[i];
+        if (seen >= rank) return std::clamp(BucketValue(i), m_min, m_max);
+    }
+    return m_max;
+}
+
+// ============================================================================
+// FrameStats
+// ============================================================================
+FrameStats::FrameStats()
+{
+    m_stages.push_back({ "Frame", {}, {} });
+}
+
+uint32_t FrameStats::AddStage(const char* name)
+{
+    m_stages.push_back({ name, {}, {} });
+    return (uint32_t)m_stages.size() - 1;
+}
+
+void FrameStats::Record(uint32_t stage, double seconds)
+{
+    const uint64_t ns = (uint64_t)std::max(0.0, seconds * 1e9);
+    m_stages[stage].total.Record(ns);
+    m_stages[stage].window.Record(ns);
+}
+
+void FrameStats::RecordFrame(double seconds)
+{
+    const float ms = float(seconds * 1000.0);
+
+    // Median of the frames before this one; needs a full window so start-up hitches do not count
+    if (m_frames >= kRecentFrames) {
+        float sorted[kRecentFrames];
+        std::copy(std::begin(m_recent), std::end(m_recent), sorted);
+        std::nth_element(sorted, sorted + kRecentFrames / 2, sorted + kRecentFrames);
+        const float median = sorted[kRecentFrames / 2];
+        if (ms > median * m_stutterFactor) {
+            m_stutterCount++;
+            m_windowStutters++;
+            if (m_stutters.size() < kMaxStutters)
+                m_stutters.push_back({ m_frames, m_elapsed, ms, median });
+        }
+    }
+
+    m_recent[m_frames % kRecentFrames] = ms;
+    m_frames++;
+    m_elapsed += seconds;
+    Record(kFrameStage, seconds);
+}
+
+uint32_t FrameStats::AddCounter(const char* name, const char* unit)
+{
+    m_counters.push_back({ name, unit, {} });
+    return (uint32_t)m_counters.size() - 1;
+}
+
+void FrameStats::RecordCounter(uint32_t counter, uint64_t value)
+{
+    m_counters[counter].values.Record(value);
+}
+
+CounterSummary FrameStats::CounterStats(uint32_t counter) const
+{
+    const LatencyHistogram& h = m_counters[counter].values;
+    CounterSummary s;
+    s.frames = h.Count();
+    s.min = h.Min();
+    s.max = h.Max();
+    s.total = h.Sum();
+    s.mean = h.Mean();
+    s.p50 = h.Percentile(50.0);
+    s.p95 = h.Percentile(95.0);
+    s.p99 = h.Percentile(99.0);
+    return s;
+}
+
+StageSummary FrameStats::Summary(uint32_t stage) const { return Summarize(m_stages[stage].total); }
+StageSummary FrameStats::WindowSummary(uint32_t stage) const { return Summarize(m_stages[stage].window); }
+
+void FrameStats::ResetWindow()
+{
+    for (Stage& s : m_stages) s.window.Reset();
+    m_windowStutters = 0;
+}
+
+std::vector<float> FrameStats::RecentFrames() const
+{
+    const uint32_t n = (uint32_t)std::min<uint64_t>(m_frames, kRecentFrames);
+    std::vector<float> out;
+    out.reserve(n);
+    for (uint64_t f = m_frames - n; f < m_frames; f++) out.push_back(m_recent[f % kRecentFrames]);
+    return out;
+}
+
+void FrameStats::Reset()
+{
+    for (Stage& s : m_stages) { s.total.Reset(); s.window.Reset(); }
+    for (CounterTrack& c : m_counters) c.values.Reset();
+    m_stutters.clear();
+    std::fill(std::begin(m_recent), std::end(m_recent), 0.0f);
+    m_frames = m_stutterCount = m_windowStutters = 0;
+    m_elapsed = 0.0;
+}
+
+bool FrameStats::WriteCsv(const std::string& path) const
+{
+    std::string out = "stage,count,min_ms,mean_ms,p50_ms,p95_ms,p99_ms,p99.9_ms,max_ms,stutters\n";
+    char buf[320];
+    for (uint32_t i = 0; i < StageCount(); i++) {
+        const StageSummary s = Summary(i);
+        std::snprintf(buf, sizeof(buf), "%s,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%llu\n",
+                      m_stages[i].name, (unsigned long long)s.count, s.minMs, s.meanMs,
+                      s.p50Ms, s.p95Ms, s.p99Ms, s.p999Ms, s.maxMs,
+                      (unsigned long long)(i == kFrameStage ? m_stutterCount : 0));
+        out += buf;
+    }
+    if (!m_counters.empty()) {
+        out += "\ncounter,unit,frames,min,mean,p50,p95,p99,max,total\n";
+        for (uint32_t i = 0; i < CounterCount(); i++) {
+            const CounterSummary c = CounterStats(i);
+            std::snprintf(buf, sizeof(buf), "%s,%s,%llu,%llu,%.2f,%llu,%llu,%llu,%llu,%llu\n",
+                          m_counters[i].name, m_counters[i].unit, (unsigned long long)c.frames, (unsigned long long)c.min,
+                          c.mean, (unsigned long long)c.p50, (unsigned long long)c.p95, (unsigned long long)c.p99,
+                          (unsigned long long)c.max, (unsigned long long)c.total);
+            out += buf;
+        }
+    }
+    return WriteFile(path, out);
+}
+
+bool FrameStats::WriteJson(const std::string& path) const
+{
+    std::string out;
+    char buf[320];
+    std::snprintf(buf, sizeof(buf), "{\n  \"frames\": %llu,\n  \"seconds\": %.3f,\n  \"stutterFactor\": %.2f,\n  \"stutterCount\": %llu,\n  \"stages\": {",
+                  (unsigned long long)m_frames, m_elapsed, m_stutterFactor, (unsigned long long)m_stutterCount);
+    out += buf;
+    for (uint32_t i = 0; i < StageCount(); i++) {
+        const StageSummary s = Summary(i);
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    \"%s\": { \"count\": %llu, \"minMs\": %.4f, \"meanMs\": %.4f, \"p50Ms\": %.4f, \"p95Ms\": %.4f, "
+                      "\"p99Ms\": %.4f, \"p999Ms\": %.4f, \"maxMs\": %.4f,\n      \"histogramMs\": [",
+                      i ? "," : "", m_stages[i].name, (unsigned long long)s.count, s.minMs, s.meanMs,
+                      s.p50Ms, s.p95Ms, s.p99Ms, s.p999Ms, s.maxMs);
+        out += buf;
+        bool first = true;
+        m_stages[i].total.ForEachBucket([&](uint64_t ns, uint64_t count) {
+            std::snprintf(buf, sizeof(buf), "%s[%.4f,%llu]", first ? "" : ",", Ms(ns), (unsigned long long)count);
+            out += buf;
+            first = false;
+        });
+        out += "] }";
+    }
+    out += "\n  },\n  \"counters\": {";
+    for (uint32_t i = 0; i < CounterCount(); i++) {
+        const CounterSummary c = CounterStats(i);
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    \"%s\": { \"unit\": \"%s\", \"frames\": %llu, \"min\": %llu, \"mean\": %.2f, \"p50\": %llu, "
+                      "\"p95\": %llu, \"p99\": %llu, \"max\": %llu, \"total\": %llu }",
+                      i ? "," : "", m_counters[i].name, m_counters[i].unit, (unsigned long long)c.frames,
+                      (unsigned long long)c.min, c.mean, (unsigned long long)c.p50, (unsigned long long)c.p95,
+                      (unsigned long long)c.p99, (unsigned long long)c.max, (unsigned long long)c.total);
+        out += buf;
+    }
+    out += m_counters.empty() ? "},\n  \"stutters\": [" : "\n  },\n  \"stutters\": [";
+    for (size_t i = 0; i < m_stutters.size(); i++) {
+        const StutterEvent& e = m_stutters[i];
+        std::snprintf(buf, sizeof(buf), "%s\n    { \"frame\": %llu, \"timeSec\": %.3f, \"ms\": %.3f, \"medianMs\": %.3f }",
+                      i ? "," : "", (unsigned long long)e.frame, e.timeSec, e.ms, e.medianMs);
+        out += buf;
+    }
+    out += m_stutters.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return WriteFile(path, out);
+}
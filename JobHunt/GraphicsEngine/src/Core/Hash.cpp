@@ -0,0 +1,94 @@
+#include "Core/Hash.h"
+#include <cstring>
+
+using namespace GraphicsEngine;
+
+namespace {
+    inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    inline uint64_t Mix(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDull;
+        k ^= k >> 33;
+        k *= 0xC4CEB9FE1A85EC53ull;
+        k ^= k >> 33;
+        return k;
+    }
+
+    // Reference digests from the canonical implementation (Python mmh3 5.3.1, hash128 with
+    // x64arch=True, unsigned; lo = its low 64 bits) of prefixes of kVectorText: every tail length,
+    // one and two full blocks, and a second seed.
+    constexpr char kVectorText[] = "The quick brown fox jumps over the lazy dog";
+    struct HashVector { uint32_t length, seed; uint64_t lo, hi; };
+    constexpr HashVector kVectors[] = {
+        {  0, 0x00000000u, 0x0000000000000000ull, 0x0000000000000000ull },
+        {  0, 0x9747B28Cu, 0x392B208A1DAABBB3ull, 0x93B0608FE302957Aull },
+        {  1, 0x00000000u, 0x8C03777E9184689Aull, 0x3AB5D6B4BA293E79ull },
+        {  2, 0x00000000u, 0xD7DD0BEAEE68E3B9ull, 0xA56FB69099026B97ull },
+        {  3, 0x00000000u, 0x304F2652DCD66D9Aull, 0xEF385E5D15EABF42ull },
+        {  4, 0x00000000u, 0xBD4301BEABA07D9Cull, 0xDFAE3C4B8026DD1Cull },
+        {  5, 0x00000000u, 0x6F7AAC75205270FEull, 0x76F5EBD390DAC61Full },
+        {  5, 0x9747B28Cu, 0x55BBF08960180758ull, 0xA4D25059A638F51Full },
+        {  6, 0x00000000u, 0x796E1100F3F66746ull, 0xB2A07E0B1665AB1Full },
+        {  7, 0x00000000u, 0xF0D3843A5ABCD5C9ull, 0x9394B7F9C86D6073ull },
+        {  8, 0x00000000u, 0x644BAAE4AD5B71CDull, 0x8EEEF997E2881CDFull },
+        {  9, 0x00000000u, 0x37A06404B2A8F155ull, 0xADBCC8FF3D6ECCC0ull },
+        { 10, 0x00000000u, 0x420E44DF457484B8ull, 0x9CABADD477515FE9ull },
+        { 11, 0x00000000u, 0x87C320550739A882ull, 0xFA91E8A5D66E7B9Full },
+        { 12, 0x00000000u, 0x61D6A1372F90F9CBull, 0xB66353EA7C002529ull },
+        { 13, 0x00000000u, 0x3C600C93F99BFD3Bull, 0xC3E13319056F26F4ull },
+        { 14, 0x00000000u, 0xDCD216A95D6E6007ull, 0x84C1EEB85C46C838ull },
+        { 15, 0x00000000u, 0x48137CB864E39216ull, 0xFD7BAF64397AD64Bull },
+        { 16, 0x00000000u, 0x9D1244F4AF9B32C4ull, 0x3D153C8B2C2A3AA6ull },
+        { 16, 0x9747B28Cu, 0x26D68787CD1DAC29ull, 0x00D3833029BB7D23ull },
+        { 17, 0x00000000u, 0x91F96376E757E9AEull, 0x9B44E58DAE83EB0Cull },
+        { 17, 0x9747B28Cu, 0x41E6AC8E209E3DB1ull, 0x6FB5CD54F806E5E2ull },
+        { 31, 0x00000000u, 0x9B28B5DDD9C4C509ull, 0x0D3C1CB80FE2F964ull },
+        { 32, 0x00000000u, 0xDF6AF91BB29BDACFull, 0x91A341C58DF1F3A6ull },
+        { 33, 0x00000000u, 0x68D135CDAB7BB3DDull, 0xE617F8470728BB01ull },
+        { 43, 0x00000000u, 0xE34BBC7BBC071B6Cull, 0x7A433CA9C49A9347ull },
+        { 43, 0x9747B28Cu, 0x738A7F3BD2633121ull, 0xF94573727EC016E5ull },
+    };
+}
+
+Hash128 GraphicsEngine::HashBytes128(const void* data, size_t size, uint64_t seed)
+{
+    constexpr uint64_t c1 = 0x87C37B91114253D5ull;
+    constexpr uint64_t c2 = 0x4CF5AD432745937Full;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t h1 = seed, h2 = seed;
+
+    const size_t blocks = size / 16;
+    for (size_t i = 0; i < blocks; i++, p += 16) {
+        uint64_t k1, k2;
+        std::memcpy(&k1, p, 8);
+        std::memcpy(&k2, p + 8, 8);
+
+        k1 *= c1; k1 = Rotl(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = Rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52DCE729;
+        k2 *= c2; k2 = Rotl(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = Rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495AB5;
+    }
+
+    // Tail: up to 15 bytes, little-endian into k1 (bytes 0-7) and k2 (bytes 8-14)
+    uint64_t k1 = 0, k2 = 0;
+    const size_t tail = size & 15;
+    for (size_t i = tail; i > 8; i--) k2 |= uint64_t(p[i - 1]) << ((i - 9) * 8);
+    for (size_t i = tail < 8 ? tail : 8; i > 0; i--) k1 |= uint64_t(p[i - 1]) << ((i - 1) * 8);
+    if (tail > 8) { k2 *= c2; k2 = Rotl(k2, 33); k2 *= c1; h2 ^= k2; }
+    if (tail > 0) { k1 *= c1; k1 = Rotl(k1, 31); k1 *= c2; h1 ^= k1; }
+
+    h1 ^= uint64_t(size); h2 ^= uint64_t(size);
+    h1 += h2; h2 += h1;
+    h1 = Mix(h1); h2 = Mix(h2);
+    h1 += h2; h2 += h1;
+    return { h1, h2 };
+}
+
+bool GraphicsEngine::VerifyHashBytes128()
+{
+    for (const HashVector& v : kVectors)
+        if (HashBytes128(kVectorText, v.length, v.seed) != Hash128{ v.lo, v.hi }) return false;
+    return true;
+}
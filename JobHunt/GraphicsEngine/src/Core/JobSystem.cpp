@@ -0,0 +1,89 @@
+#include "Core/JobSystem.h"
+#include <algorithm>
+
+using namespace GraphicsEngine;
+
+JobSystem::JobSystem(uint32_t workerCount)
+{
+    if (workerCount == UINT32_MAX) {
+        const uint32_t hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 0;
+    }
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++)
+        m_workers.emplace_back([this] { WorkerLoop(); });
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_workers) t.join();
+}
+
+void JobSystem::Submit(JobCounter& counter, std::function<void()> job)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back({ std::move(job), &counter });
+    }
+    m_wake.notify_one();
+}
+
+bool JobSystem::RunOne()
+{
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) return false;
+        job = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+    job.fn();
+    job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    while (!counter.Done())
+        if (!RunOne()) std::this_thread::yield();   // remaining jobs are running on workers
+}
+
+void JobSystem::WorkerLoop()
+{
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+            if (m_quit && m_queue.empty()) return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        job.fn();
+        job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t, uint32_t)>& fn)
+{
+    if (count == 0) return;
+    grain = std::max(grain, 1u);
+    // A few batches per thread keeps workers busy when batch costs are uneven
+    const uint32_t batches = std::min((count + grain - 1) / grain, GetThreadCount() * 4);
+    if (batches <= 1) { fn(0, count); return; }
+
+    const uint32_t per = (count + batches - 1) / batches;
+    JobCounter counter;
+    for (uint32_t b = 1; b < batches; b++) {
+        const uint32_t begin = b * per, end = std::min(count, begin + per);
+        if (begin < end) Submit(counter, [&fn, begin, end] { fn(begin, end); });
+    }
+    fn(0, std::min(count, per));
+    Wait(counter);
+}
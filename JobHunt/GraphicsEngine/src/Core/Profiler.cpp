@@ -0,0 +1,254 @@
+#include "Core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace GraphicsEngine;
+
+namespace {
+
+// Slots are relaxed atomics so the exporter may read them while the owner writes; on x86 and ARM64
+// those are plain loads and stores.
+struct EventSlot {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t>    begin{ 0 }, end{ 0 };
+};
+
+struct CounterSlot {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t>    time{ 0 };
+    std::atomic<double>      value{ 0.0 };
+};
+
+struct ThreadLog {
+    EventSlot             events[Profiler::kEventsPerThread];
+    std::atomic<uint64_t> head{ 0 };    // events ever written; release-published after each slot
+    uint32_t              id = 0;
+    std::string           name;         // under Registry::lock
+};
+
+struct Registry {
+    std::mutex                              lock;
+    std::vector<std::unique_ptr<ThreadLog>> threads;   // never shrinks: logs outlive their threads
+
+    std::atomic<uint64_t>                   frameStarts[Profiler::kFrames];
+    std::atomic<uint64_t>                   frameCount{ 0 };
+
+    CounterSlot                             counters[Profiler::kCounterSamples];
+    std::atomic<uint64_t>                   counterCount{ 0 };
+
+    const uint64_t                          anchorTicks = ProfileNow();
+    const std::chrono::steady_clock::time_point anchorTime = std::chrono::steady_clock::now();
+};
+
+Registry& GetRegistry()
+{
+    static Registry r;
+    return r;
+}
+
+thread_local ThreadLog* t_log = nullptr;
+
+ThreadLog* RegisterThread()
+{
+    Registry& r = GetRegistry();
+    auto log = std::make_unique<ThreadLog>();
+    std::lock_guard<std::mutex> lock(r.lock);
+    log->id = (uint32_t)r.threads.size() + 1;   // tid 0 is the frame track
+    log->name = "Thread " + std::to_string(log->id);
+    r.threads.push_back(std::move(log));
+    return r.threads.back().get();
+}
+
+void AppendEscaped(std::string& out, const char* s)
+{
+    for (; *s; ++s) {
+        const char c = *s;
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if ((unsigned char)c < 0x20) out += ' ';
+        else out += c;
+    }
+}
+
+}
+
+void Profiler::Record(const char* name, uint64_t begin, uint64_t end)
+{
+    ThreadLog* log = t_log;
+    if (!log) log = t_log = RegisterThread();
+
+    const uint64_t h = log->head.load(std::memory_order_relaxed);
+    // Pairs with the export's fence: an export that reads any store below also sees head >= h
+    std::atomic_thread_fence(std::memory_order_release);
+    EventSlot& e = log->events[h & (kEventsPerThread - 1)];
+    e.name.store(name, std::memory_order_relaxed);
+    e.begin.store(begin, std::memory_order_relaxed);
+    e.end.store(end, std::memory_order_relaxed);
+    log->head.store(h + 1, std::memory_order_release);
+}
+
+void Profiler::BeginFrame()
+{
+    Registry& r = GetRegistry();
+    const uint64_t n = r.frameCount.load(std::memory_order_relaxed);
+    r.frameStarts[n % kFrames].store(ProfileNow(), std::memory_order_relaxed);
+    r.frameCount.store(n + 1, std::memory_order_release);
+}
+
+void Profiler::RecordCounter(const char* name, double value)
+{
+    Registry& r = GetRegistry();
+    const uint64_t n = r.counterCount.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);   // as in Record
+    CounterSlot& c = r.counters[n & (kCounterSamples - 1)];
+    c.name.store(name, std::memory_order_relaxed);
+    c.time.store(ProfileNow(), std::memory_order_relaxed);
+    c.value.store(value, std::memory_order_relaxed);
+    r.counterCount.store(n + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    ThreadLog* log = t_log;
+    if (!log) log = t_log = RegisterThread();
+    std::lock_guard<std::mutex> lock(GetRegistry().lock);
+    log->name = name;
+}
+
+double Profiler::TicksPerSecond()
+{
+#if GE_PROFILE_TSC
+    // Calibrated against steady_clock since the first profiler use; the longer the run, the better
+    Registry& r = GetRegistry();
+    auto elapsed = std::chrono::steady_clock::now() - r.anchorTime;
+    if (elapsed < std::chrono::milliseconds(20)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20) - elapsed);
+        elapsed = std::chrono::steady_clock::now() - r.anchorTime;
+    }
+    const uint64_t ticks = ProfileNow() - r.anchorTicks;
+    return double(ticks) / std::chrono::duration<double>(elapsed).count();
+#else
+    return double(std::chrono::steady_clock::period::den) / double(std::chrono::steady_clock::period::num);
+#endif
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path, uint32_t frames)
+{
+    Registry& r = GetRegistry();
+    const double usPerTick = 1e6 / TicksPerSecond();
+
+    // Frame boundaries: the export window starts at the oldest requested frame still in the ring
+    const uint64_t frameCount = r.frameCount.load(std::memory_order_acquire);
+    const uint64_t keep = std::min<uint64_t>({ (uint64_t)frames, frameCount, (uint64_t)kFrames - 1 });
+    std::vector<uint64_t> starts;
+    starts.reserve(keep);
+    for (uint64_t f = frameCount - keep; f < frameCount; f++)
+        starts.push_back(r.frameStarts[f % kFrames].load(std::memory_order_relaxed));
+    const uint64_t windowBegin = starts.empty() ? 0 : starts.front();
+    auto us = [&](uint64_t t) { return double(int64_t(t - windowBegin)) * usPerTick; };
+
+    struct ThreadCopy { uint32_t id; std::string name; std::vector<ProfileEvent> events; };
+    std::vector<ThreadCopy> copies;
+    {
+        std::lock_guard<std::mutex> lock(r.lock);
+        copies.reserve(r.threads.size());
+        for (const auto& log : r.threads) {
+            ThreadCopy c{ log->id, log->name, {} };
+            const uint64_t head = log->head.load(std::memory_order_acquire);
+            const uint64_t first = head > kEventsPerThread ? head - kEventsPerThread : 0;
+            c.events.reserve(size_t(head - first));
+            for (uint64_t i = first; i < head; i++) {
+                const EventSlot& e = log->events[i & (kEventsPerThread - 1)];
+                c.events.push_back({ e.name.load(std::memory_order_relaxed),
+                                     e.begin.load(std::memory_order_relaxed),
+                                     e.end.load(std::memory_order_relaxed) });
+            }
+            // The owner kept writing while we copied; whatever it wrapped over is torn, so drop it.
+            // That includes slot `after`, which it may be writing right now. The fence keeps the
+            // re-read of head after the slot reads, so it covers every write they may have seen.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after = log->head.load(std::memory_order_acquire);
+            const uint64_t overwritten = after + 1 > kEventsPerThread ? after + 1 - kEventsPerThread : 0;
+            if (overwritten > first)
+                c.events.erase(c.events.begin(), c.events.begin() + ptrdiff_t(std::min(overwritten - first, head - first)));
+            copies.push_back(std::move(c));
+        }
+    }
+
+    // Counter samples, same torn-entry rule as the thread rings
+    struct CounterCopy { const char* name; uint64_t time; double value; };
+    std::vector<CounterCopy> counters;
+    {
+        const uint64_t head = r.counterCount.load(std::memory_order_acquire);
+        const uint64_t first = head > kCounterSamples ? head - kCounterSamples : 0;
+        counters.reserve(size_t(head - first));
+        for (uint64_t i = first; i < head; i++) {
+            const CounterSlot& c = r.counters[i & (kCounterSamples - 1)];
+            counters.push_back({ c.name.load(std::memory_order_relaxed), c.time.load(std::memory_order_relaxed),
+                                 c.value.load(std::memory_order_relaxed) });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = r.counterCount.load(std::memory_order_acquire);
+        const uint64_t overwritten = after + 1 > kCounterSamples ? after + 1 - kCounterSamples : 0;
+        if (overwritten > first)
+            counters.erase(counters.begin(), counters.begin() + ptrdiff_t(std::min(overwritten - first, head - first)));
+    }
+
+    std::string json;
+    json.reserve(1 << 20);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char buf[256];
+    bool firstEvent = true;
+    auto sep = [&] { if (!firstEvent) json += ",\n"; firstEvent = false; };
+
+    sep();
+    json += "{\"ph\":\"M\",\"pid\":0,\"tid\":0,\"name\":\"thread_name\",\"args\":{\"name\":\"Frames\"}}";
+    for (size_t f = 0; f + 1 < starts.size(); f++) {
+        sep();
+        std::snprintf(buf, sizeof(buf), "{\"ph\":\"X\",\"pid\":0,\"tid\":0,\"name\":\"Frame %llu\",\"ts\":%.3f,\"dur\":%.3f}",
+                      (unsigned long long)(frameCount - keep + f), us(starts[f]), us(starts[f + 1]) - us(starts[f]));
+        json += buf;
+    }
+
+    for (const ThreadCopy& c : copies) {
+        sep();
+        std::snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"", c.id);
+        json += buf;
+        AppendEscaped(json, c.name.c_str());
+        json += "\"}}";
+        std::snprintf(buf, sizeof(buf), ",\n{\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%u}}",
+                      c.id, c.id);
+        json += buf;
+
+        for (const ProfileEvent& e : c.events) {
+            if (!e.name || e.end < windowBegin) continue;
+            sep();
+            json += "{\"ph\":\"X\",\"pid\":0,\"tid\":";
+            json += std::to_string(c.id);
+            json += ",\"name\":\"";
+            AppendEscaped(json, e.name);
+            std::snprintf(buf, sizeof(buf), "\",\"ts\":%.3f,\"dur\":%.3f}", us(e.begin), double(e.end - e.begin) * usPerTick);
+            json += buf;
+        }
+    }
+    for (const CounterCopy& c : counters) {
+        if (!c.name || c.time < windowBegin) continue;
+        sep();
+        json += "{\"ph\":\"C\",\"pid\":0,\"name\":\"";
+        AppendEscaped(json, c.name);
+        std::snprintf(buf, sizeof(buf), "\",\"ts\":%.3f,\"args\":{\"value\":%.17g}}", us(c.time), c.value);
+        json += buf;
+    }
+    json += "\n]}\n";
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    f.write(json.data(), (std::streamsize)json.size());
+    return bool(f);
+}
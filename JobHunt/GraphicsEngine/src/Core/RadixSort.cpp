@@ -0,0 +1,95 @@
+#include "Core/RadixSort.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace GraphicsEngine;
+
+namespace {
+
+constexpr uint32_t kDigitBits = 8;
+constexpr uint32_t kDigits = 1u << kDigitBits;
+constexpr uint32_t kMinBlockKeys = 16384;     // below this a block is not worth a job
+constexpr uint32_t kBlocksPerThread = 4;
+
+template <typename Fn> void Dispatch(JobSystem* jobs, uint32_t count, uint32_t grain, Fn&& fn)
+{
+    if (jobs && count > grain) jobs->ParallelFor(count, grain, fn);
+    else if (count) fn(0u, count);
+}
+
+}
+
+void RadixSorter::Sort(std::span<const uint32_t> keys, std::span<const uint32_t> values, JobSystem* jobs, uint32_t keyBits)
+{
+    assert(keys.size() == values.size() && keyBits >= 1 && keyBits <= 32);
+    const uint32_t n = (uint32_t)keys.size();
+    const uint32_t threads = jobs ? jobs->GetThreadCount() : 1;
+    const uint32_t passes = (keyBits + kDigitBits - 1) / kDigitBits;
+    m_count = n;
+    m_result = 0;
+    for (std::vector<RadixItem>& items : m_items)
+        if (items.size() < n) items.resize(n);
+
+    const uint32_t blockCount = std::clamp((n + kMinBlockKeys - 1) / kMinBlockKeys, 1u, threads * kBlocksPerThread);
+    const uint32_t blockSize = (n + blockCount - 1) / blockCount;
+    m_blockOffsets.resize(size_t(blockCount) * kDigits);
+
+    // Interleave once; every pass then reads and writes items
+    Dispatch(jobs, blockCount, 1, [&](uint32_t b0, uint32_t b1) {
+        RadixItem* out = m_items[0].data();
+        const uint32_t end = std::min(n, b1 * blockSize);
+        for (uint32_t i = b0 * blockSize; i < end; i++) out[i] = { keys[i], values[i] };
+    });
+
+    for (uint32_t pass = 0; pass < passes; pass++) {
+        const uint32_t shift = pass * kDigitBits;
+        const RadixItem* src = m_items[m_result].data();
+        RadixItem* dst = m_items[m_result ^ 1].data();
+
+        // 1. Histogram per block
+        Dispatch(jobs, blockCount, 1, [&](uint32_t b0, uint32_t b1) {
+            for (uint32_t b = b0; b < b1; b++) {
+                uint32_t* counts = &m_blockOffsets[size_t(b) * kDigits];
+                std::fill(counts, counts + kDigits, 0u);
+                const uint32_t end = std::min(n, (b + 1) * blockSize);
+                for (uint32_t i = b * blockSize; i < end; i++) counts[(src[i].key >> shift) & (kDigits - 1)]++;
+            }
+        });
+
+        // 2. Digit totals and each block's offset within its digit; a digit holding every key means
+        // this pass would not move anything
+        uint32_t totals[kDigits];
+        bool skip = false;
+        for (uint32_t d = 0; d < kDigits; d++) {
+            uint32_t sum = 0;
+            for (uint32_t b = 0; b < blockCount; b++) {
+                uint32_t& c = m_blockOffsets[size_t(b) * kDigits + d];
+                const uint32_t count = c;
+                c = sum;
+                sum += count;
+            }
+            totals[d] = sum;
+            skip |= sum == n;
+        }
+        if (skip) continue;
+        uint32_t running = 0;
+        for (uint32_t d = 0; d < kDigits; d++) {
+            for (uint32_t b = 0; b < blockCount; b++) m_blockOffsets[size_t(b) * kDigits + d] += running;
+            running += totals[d];
+        }
+
+        // 3. Scatter; blocks write disjoint ranges and keep their order within a digit
+        Dispatch(jobs, blockCount, 1, [&](uint32_t b0, uint32_t b1) {
+            for (uint32_t b = b0; b < b1; b++) {
+                uint32_t* cursor = &m_blockOffsets[size_t(b) * kDigits];
+                const uint32_t end = std::min(n, (b + 1) * blockSize);
+                for (uint32_t i = b * blockSize; i < end; i++) {
+                    const RadixItem item = src[i];
+                    dst[cursor[(item.key >> shift) & (kDigits - 1)]++] = item;
+                }
+            }
+        });
+        m_result ^= 1;
+    }
+}
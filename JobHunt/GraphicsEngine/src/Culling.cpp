@@ -0,0 +1,220 @@
+#include "Culling.h"
+#include <cassert>
+
+using namespace GraphicsEngine;
+
+// ============================================================================
+// Views
+// ============================================================================
+CullView GraphicsEngine::MakeCullView(const TheFrustum_t& frustum, const float3& eye)
+{
+    CullView v{};
+    for (int i = 0; i < 6; i++) v.planes[i] = frustum[i];
+    v.eye = eye;
+    return v;
+}
+
+CullView GraphicsEngine::MakeCullView(const float4x4& cameraToWorld, float fovY, float aspect, float zn, float zf,
+                                      Points* corners)
+{
+    TheFrustum_t fr;
+    Points pts;
+    frustum_build(fr, pts, cameraToWorld, fovY, aspect, zn, zf);
+    if (corners) *corners = pts;
+    return MakeCullView(fr, cameraToWorld[3].xyz);
+}
+
+CullView GraphicsEngine::MakeCullViewFromClip(const float4x4& worldToClip, const float3& eye)
+{
+    // Row vectors: clip = x * M, so each clip coordinate is a column of M and each bound of the
+    // clip volume (-w <= x <= w, -w <= y <= w, 0 <= z <= w) is a sum of columns
+    const float4x4& M = worldToClip;
+    const float4 cx{ M[0].x, M[1].x, M[2].x, M[3].x };
+    const float4 cy{ M[0].y, M[1].y, M[2].y, M[3].y };
+    const float4 cz{ M[0].z, M[1].z, M[2].z, M[3].z };
+    const float4 cw{ M[0].w, M[1].w, M[2].w, M[3].w };
+    float4 eq[6];
+    eq[F_NEAR] = cz;       eq[F_FAR] = cw - cz;
+    eq[F_LEFT] = cw + cx;  eq[F_RIGHT] = cw - cx;
+    eq[F_BOTTOM] = cw + cy; eq[F_TOP] = cw - cy;
+
+    CullView v{};
+    for (int i = 0; i < 6; i++) {
+        // n.x + w >= 0  ->  dot(n, x) - (-w) >= 0
+        const float3 n = eq[i].xyz;
+        const float L = length(n);
+        const float inv = (L > SOL_MATH_EPS) ? 1.0f / L : 0.0f;
+        v.planes[i] = { n * inv, -eq[i].w * inv };
+    }
+    v.eye = eye;
+    return v;
+}
+
+CullView GraphicsEngine::TransformCullView(const CullView& worldView, const float4x4& objectToWorld)
+{
+    // Row vectors: x_w = x_o * M, so plane_o = M * (n, -d)^T
+    const float4x4& M = objectToWorld;
+    CullView v{};
+    for (int i = 0; i < 6; i++) {
+        const Plane_t& p = worldView.planes[i];
+        float4 pw{ p.normal.x, p.normal.y, p.normal.z, -p.offset };
+        float3 n{ dot(M[0], pw), dot(M[1], pw), dot(M[2], pw) };
+        float  w = dot(M[3], pw);
+        float  L = length(n);
+        float  inv = (L > SOL_MATH_EPS) ? 1.0f / L : 0.0f;
+        v.planes[i] = { n * inv, -w * inv };
+    }
+    v.eye = transform_point(worldView.eye, m_inverse_affine(objectToWorld));
+    return v;
+}
+
+// ============================================================================
+// Multi-view
+// ============================================================================
+void CullViewSet::Set(std::span<const CullView> views)
+{
+    assert(views.size() <= kMaxCullViews);
+    m_count = (uint32_t)views.size();
+    // Lanes past the last view stay zero: never outside, never inside, and masked off anyway
+    for (Group& g : m_groups) g = Group{};
+    for (uint32_t i = 0; i < m_count; i++) {
+        Group& g = m_groups[i / 4];
+        const uint32_t lane = i & 3;
+        for (int p = 0; p < 6; p++) {
+            const Plane_t& pl = views[i].planes[p];
+            g.nx[p][lane] = pl.normal.x; g.ny[p][lane] = pl.normal.y; g.nz[p][lane] = pl.normal.z;
+            g.d[p][lane] = pl.offset;
+            g.ax[p][lane] = std::fabs(pl.normal.x); g.ay[p][lane] = std::fabs(pl.normal.y); g.az[p][lane] = std::fabs(pl.normal.z);
+        }
+    }
+}
+
+// ============================================================================
+// SoA bounds
+// ============================================================================
+void MeshletCullData::Build(const MeshletMesh& mesh)
+{
+    count = (uint32_t)mesh.bounds.size();
+    const size_t padded = (size_t(count) + 3) & ~size_t(3);
+    std::vector<float>* lanes[8] = { &cx, &cy, &cz, &radius, &ax, &ay, &az, &cutoff };
+    for (auto* l : lanes) l->assign(padded, 0.0f);
+    for (uint32_t i = 0; i < count; i++) {
+        const MeshletBounds& b = mesh.bounds[i];
+        cx[i] = b.center.x; cy[i] = b.center.y; cz[i] = b.center.z; radius[i] = b.radius;
+        ax[i] = b.coneAxis.x; ay[i] = b.coneAxis.y; az[i] = b.coneAxis.z; cutoff[i] = b.coneCutoff;
+    }
+    // Padding lanes never pass the frustum test
+    for (size_t i = count; i < padded; i++) { radius[i] = -FLT_MAX; cutoff[i] = 1.0f; }
+}
+
+// ============================================================================
+// Occlusion (scalar, survivors only)
+// ============================================================================
+bool GraphicsEngine::SphereOccluded(const OcclusionBuffer& occ, const float3& c, float r)
+{
+    if (!occ.maxDepth || occ.width == 0 || occ.height == 0) return false;
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX;
+    for (int i = 0; i < 8; i++) {
+        float4 p{ c.x + ((i & 1) ? r : -r), c.y + ((i & 2) ? r : -r), c.z + ((i & 4) ? r : -r), 1.0f };
+        float4 h = m_mul_row(p, occ.objectToClip);
+        if (h.w <= SOL_MATH_EPS) return false; // straddles the near plane
+        float iw = 1.0f / h.w;
+        float x = h.x * iw, y = h.y * iw, z = h.z * iw;
+        minX = SOL_MIN(minX, x); maxX = SOL_MAX(maxX, x);
+        minY = SOL_MIN(minY, y); maxY = SOL_MAX(maxY, y);
+        minZ = SOL_MIN(minZ, z);
+    }
+    if (minZ <= 0.0f) return false;
+
+    // NDC -> tile rect (Y down)
+    auto tile = [](float v, uint32_t n) { int t = (int)(v * float(n)); return t < 0 ? 0 : (t >= (int)n ? (int)n - 1 : t); };
+    const int x0 = tile(minX * 0.5f + 0.5f, occ.width),  x1 = tile(maxX * 0.5f + 0.5f, occ.width);
+    const int y0 = tile(-maxY * 0.5f + 0.5f, occ.height), y1 = tile(-minY * 0.5f + 0.5f, occ.height);
+    for (int y = y0; y <= y1; y++)
+        for (int x = x0; x <= x1; x++)
+            if (occ.maxDepth[size_t(y) * occ.width + x] >= minZ) return false;
+    return true;
+}
+
+// ============================================================================
+// Meshlet culling
+// ============================================================================
+namespace {
+    inline int Bits4(int m) { return (m & 1) + ((m >> 1) & 1) + ((m >> 2) & 1) + ((m >> 3) & 1); }
+
+    inline void EmitRange(std::vector<IndexRange>& out, const Meshlet& m)
+    {
+        const uint32_t first = m.triangleOffset, count = m.triangleCount * 3;
+        if (!out.empty() && out.back().firstIndex + out.back().indexCount == first) out.back().indexCount += count;
+        else out.push_back({ first, count });
+    }
+}
+
+uint32_t GraphicsEngine::CullMeshlets(const MeshletMesh& mesh, const MeshletCullData& soa, const CullView& view,
+                                      std::vector<IndexRange>& outRanges, const OcclusionBuffer* occlusion,
+                                      MeshletCullStats* stats)
+{
+    outRanges.clear();
+    MeshletCullStats st{};
+    st.tested = soa.count;
+
+    auto survivor = [&](uint32_t i) {
+        if (occlusion && SphereOccluded(*occlusion, { soa.cx[i], soa.cy[i], soa.cz[i] }, soa.radius[i])) { st.occlusionCulled++; return; }
+        EmitRange(outRanges, mesh.meshlets[i]);
+        st.visible++;
+    };
+
+#if GE_CULL_SSE
+    __m128 pnx[6], pny[6], pnz[6], pd[6];
+    for (int p = 0; p < 6; p++) {
+        pnx[p] = _mm_set1_ps(view.planes[p].normal.x); pny[p] = _mm_set1_ps(view.planes[p].normal.y);
+        pnz[p] = _mm_set1_ps(view.planes[p].normal.z); pd[p] = _mm_set1_ps(view.planes[p].offset);
+    }
+    const __m128 ex = _mm_set1_ps(view.eye.x), ey = _mm_set1_ps(view.eye.y), ez = _mm_set1_ps(view.eye.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (uint32_t i = 0; i < soa.count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&soa.cx[i]), cy = _mm_loadu_ps(&soa.cy[i]), cz = _mm_loadu_ps(&soa.cz[i]);
+        const __m128 r = _mm_loadu_ps(&soa.radius[i]);
+        const __m128 negR = _mm_sub_ps(zero, r);
+
+        // inside all planes: dot(n,c) - d >= -r
+        __m128 in = _mm_cmpge_ps(_mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pnx[0], cx), _mm_mul_ps(pny[0], cy)), _mm_mul_ps(pnz[0], cz)), pd[0]), negR);
+        for (int p = 1; p < 6; p++) {
+            __m128 s = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pnx[p], cx), _mm_mul_ps(pny[p], cy)), _mm_mul_ps(pnz[p], cz)), pd[p]);
+            in = _mm_and_ps(in, _mm_cmpge_ps(s, negR));
+        }
+
+        // backface cone: dot(c - eye, axis) >= cutoff * |c - eye| + r
+        const __m128 dx = _mm_sub_ps(cx, ex), dy = _mm_sub_ps(cy, ey), dz = _mm_sub_ps(cz, ez);
+        const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        const __m128 proj = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(&soa.ax[i])), _mm_mul_ps(dy, _mm_loadu_ps(&soa.ay[i]))),
+                                       _mm_mul_ps(dz, _mm_loadu_ps(&soa.az[i])));
+        const __m128 back = _mm_cmpge_ps(proj, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&soa.cutoff[i]), len), r));
+
+        const int lanes = (soa.count - i >= 4) ? 0xF : ((1 << (soa.count - i)) - 1);
+        const int inMask = _mm_movemask_ps(in) & lanes;
+        const int visMask = _mm_movemask_ps(_mm_andnot_ps(back, in)) & lanes;
+        st.frustumCulled += uint32_t(Bits4(lanes & ~inMask));
+        st.coneCulled += uint32_t(Bits4(inMask & ~visMask));
+
+        for (int l = 0; l < 4; l++) if (visMask & (1 << l)) survivor(i + l);
+    }
+#else
+    for (uint32_t i = 0; i < soa.count; i++) {
+        const float3 c{ soa.cx[i], soa.cy[i], soa.cz[i] };
+        const float r = soa.radius[i];
+        bool in = true;
+        for (int p = 0; p < 6 && in; p++) in = plane_signed_distance(view.planes[p], c) >= -r;
+        if (!in) { st.frustumCulled++; continue; }
+        const float3 d = c - view.eye;
+        if (dot(d, float3{ soa.ax[i], soa.ay[i], soa.az[i] }) >= soa.cutoff[i] * length(d) + r) { st.coneCulled++; continue; }
+        survivor(i);
+    }
+#endif
+
+    st.ranges = (uint32_t)outRanges.size();
+    if (stats) *stats = st;
+    return st.visible;
+}
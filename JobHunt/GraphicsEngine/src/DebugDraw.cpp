@@ -0,0 +1,348 @@
+#include "DebugDraw.h"
+#include "Text.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+using namespace GraphicsEngine;
+
+namespace {
+    constexpr uint32_t kDepthCount = uint32_t(DebugDepth::Count);
+    constexpr uint32_t kMaxSphereSegments = 64;
+
+    // Timed line segments: two vertices and one remaining lifetime per segment
+    struct TimedLines {
+        std::vector<VertexPC> vertices;
+        std::vector<float>    remaining;
+
+        void Append(const VertexPC* v, uint32_t count, float duration)
+        {
+            vertices.insert(vertices.end(), v, v + count);
+            remaining.insert(remaining.end(), count / 2, duration);
+        }
+        void Clear() { vertices.clear(); remaining.clear(); }
+    };
+
+    // Labels with their text; remaining <= 0 = this frame only
+    struct Labels {
+        std::vector<DebugLabel> items;
+        std::vector<float>      remaining;
+        std::vector<char>       chars;
+
+        void Append(const float3& pos, uint32_t color, std::string_view text, float duration)
+        {
+            items.push_back({ pos, color, uint32_t(chars.size()), uint32_t(text.size()) });
+            remaining.push_back(duration);
+            chars.insert(chars.end(), text.begin(), text.end());
+        }
+        void Clear() { items.clear(); remaining.clear(); chars.clear(); }
+    };
+
+    // One per calling thread. Vectors keep their capacity, so after warm-up appends don't allocate.
+    struct ThreadBuffer {
+        std::mutex            lock;             // uncontended except while Collect drains it
+        std::vector<VertexPC> lines[kDepthCount];
+        TimedLines            timed[kDepthCount];
+        Labels                labels;
+        std::atomic<bool>     orphaned{ false }; // owning thread exited; freed by the next Collect
+        bool                  drainedOrphan = false;   // was orphaned when Collect drained it (Registry::lock)
+    };
+
+    struct Registry {
+        std::mutex                                 lock;          // buffer list
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::mutex                                 collectLock;   // everything below
+        TimedLines                                 timed[kDepthCount];
+        Labels                                     timedLabels;
+        DebugDrawStats                             stats;
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    struct LocalHandle {
+        ThreadBuffer* buffer = nullptr;
+        ~LocalHandle() { if (buffer) buffer->orphaned.store(true, std::memory_order_release); }
+    };
+
+    ThreadBuffer& Local()
+    {
+        thread_local LocalHandle handle;
+        if (!handle.buffer) {
+            Registry& r = GetRegistry();
+            std::lock_guard<std::mutex> g(r.lock);
+            r.buffers.push_back(std::make_unique<ThreadBuffer>());
+            handle.buffer = r.buffers.back().get();
+        }
+        return *handle.buffer;
+    }
+
+    void Emit(const VertexPC* v, uint32_t count, DebugDepth depth, float duration)
+    {
+        ThreadBuffer& tb = Local();
+        const uint32_t d = uint32_t(depth);
+        std::lock_guard<std::mutex> g(tb.lock);
+        if (duration > 0.0f) tb.timed[d].Append(v, count, duration);
+        else                 tb.lines[d].insert(tb.lines[d].end(), v, v + count);
+    }
+
+    // 12 edges of a box given as corners indexed by bit pattern (bit0 = +x, bit1 = +y, bit2 = +z)
+    void EmitBox(const float3 (&p)[8], const float3& color, DebugDepth depth, float duration)
+    {
+        static const int E[12][2] = { {0,1},{1,3},{3,2},{2,0},{4,5},{5,7},{7,6},{6,4},{0,4},{1,5},{3,7},{2,6} };
+        VertexPC v[24];
+        for (int i = 0; i < 12; i++) {
+            v[i * 2 + 0] = { p[E[i][0]], color };
+            v[i * 2 + 1] = { p[E[i][1]], color };
+        }
+        Emit(v, 24, depth, duration);
+    }
+
+    // Drops expired items; survivors keep their order
+    void Age(TimedLines& t, float dt)
+    {
+        size_t out = 0;
+        for (size_t s = 0; s < t.remaining.size(); s++) {
+            const float left = t.remaining[s] - dt;
+            if (left <= 0.0f) continue;
+            t.remaining[out] = left;
+            t.vertices[out * 2 + 0] = t.vertices[s * 2 + 0];
+            t.vertices[out * 2 + 1] = t.vertices[s * 2 + 1];
+            out++;
+        }
+        t.remaining.resize(out);
+        t.vertices.resize(out * 2);
+    }
+
+    void Age(Labels& l, float dt)
+    {
+        size_t out = 0, chars = 0;
+        for (size_t i = 0; i < l.items.size(); i++) {
+            const float left = l.remaining[i] - dt;
+            if (left <= 0.0f) continue;
+            DebugLabel item = l.items[i];
+            std::copy_n(l.chars.begin() + item.offset, item.length, l.chars.begin() + chars);   // never moves right
+            item.offset = uint32_t(chars);
+            chars += item.length;
+            l.items[out] = item;
+            l.remaining[out] = left;
+            out++;
+        }
+        l.items.resize(out);
+        l.remaining.resize(out);
+        l.chars.resize(chars);
+    }
+
+    void AppendLabel(DebugDrawFrame& out, const DebugLabel& l, const char* text)
+    {
+        out.labels.push_back({ l.pos, l.color, uint32_t(out.chars.size()), l.length });
+        out.chars.insert(out.chars.end(), text, text + l.length);
+    }
+}
+
+// ============================================================================
+// Primitives
+// ============================================================================
+void DebugDraw::Line(const float3& a, const float3& b, const float3& color, DebugDepth depth, float duration)
+{
+    const VertexPC v[2] = { { a, color }, { b, color } };
+    Emit(v, 2, depth, duration);
+}
+
+void DebugDraw::Lines(const VertexPC* vertices, uint32_t count, DebugDepth depth, float duration)
+{
+    count &= ~1u;   // whole segments only
+    if (count) Emit(vertices, count, depth, duration);
+}
+
+void DebugDraw::Box(const AABB_t& box, const float3& color, DebugDepth depth, float duration)
+{
+    const float3 c = box.center, e = box.extents;
+    float3 p[8];
+    for (int i = 0; i < 8; i++)
+        p[i] = { c.x + (i & 1 ? e.x : -e.x), c.y + (i & 2 ? e.y : -e.y), c.z + (i & 4 ? e.z : -e.z) };
+    EmitBox(p, color, depth, duration);
+}
+
+void DebugDraw::Box(const float4x4& world, const float3& extents, const float3& color, DebugDepth depth, float duration)
+{
+    float3 p[8];
+    for (int i = 0; i < 8; i++)
+        p[i] = transform_point({ i & 1 ? extents.x : -extents.x, i & 2 ? extents.y : -extents.y, i & 4 ? extents.z : -extents.z }, world);
+    EmitBox(p, color, depth, duration);
+}
+
+void DebugDraw::Frustum(const float3 corners[8], const float3& color, DebugDepth depth, float duration)
+{
+    // tl,tr,bl,br -> the box corner numbering (x = right, y = bottom, z = far) has the same edges
+    const float3 p[8] = { corners[0], corners[1], corners[2], corners[3], corners[4], corners[5], corners[6], corners[7] };
+    EmitBox(p, color, depth, duration);
+}
+
+void DebugDraw::Frustum(const float4x4& CW, float fovY, float aspect, float zn, float zf, const float3& color,
+                        DebugDepth depth, float duration)
+{
+    const float3 right{ CW[0].x, CW[0].y, CW[0].z };
+    const float3 up{ CW[1].x, CW[1].y, CW[1].z };
+    const float3 fwd{ CW[2].x, CW[2].y, CW[2].z };
+    const float3 pos{ CW[3].x, CW[3].y, CW[3].z };
+    const float t = std::tan(fovY * 0.5f);
+    float3 c[8];
+    for (int i = 0; i < 8; i++) {
+        const float z = (i & 4) ? zf : zn;
+        const float h = t * z, w = h * aspect;
+        c[i] = pos + fwd * z + up * ((i & 2) ? -h : h) + right * ((i & 1) ? w : -w);
+    }
+    Frustum(c, color, depth, duration);
+}
+
+void DebugDraw::Sphere(const float3& center, float radius, const float3& color, DebugDepth depth, float duration, uint32_t segments)
+{
+    segments = std::clamp(segments, 4u, kMaxSphereSegments);
+    VertexPC v[3 * kMaxSphereSegments * 2];
+    uint32_t n = 0;
+    const float step = 6.28318530718f / float(segments);
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        auto at = [&](uint32_t k) {
+            const float s = std::sin(step * float(k)) * radius, c = std::cos(step * float(k)) * radius;
+            return axis == 0 ? center + float3{ 0, s, c } : axis == 1 ? center + float3{ s, 0, c } : center + float3{ s, c, 0 };
+        };
+        for (uint32_t k = 0; k < segments; k++) {
+            v[n++] = { at(k), color };
+            v[n++] = { at(k + 1), color };
+        }
+    }
+    Emit(v, n, depth, duration);
+}
+
+void DebugDraw::Axes(const float4x4& world, float size, DebugDepth depth, float duration)
+{
+    const float3 o = transform_point({ 0, 0, 0 }, world);
+    const VertexPC v[6] = {
+        { o, { 1,0,0 } }, { transform_point({ size,0,0 }, world), { 1,0,0 } },
+        { o, { 0,1,0 } }, { transform_point({ 0,size,0 }, world), { 0,1,0 } },
+        { o, { 0,0,1 } }, { transform_point({ 0,0,size }, world), { 0,0,1 } },
+    };
+    Emit(v, 6, depth, duration);
+}
+
+void DebugDraw::Text(const float3& pos, std::string_view utf8, const float3& color, float duration)
+{
+    ThreadBuffer& tb = Local();
+    std::lock_guard<std::mutex> g(tb.lock);
+    tb.labels.Append(pos, PackRGBA8(color), utf8, duration);
+}
+
+// ============================================================================
+// Frame merge
+// ============================================================================
+void DebugDraw::Collect(float dt, DebugDrawFrame& out, const std::function<VertexPC*(uint32_t count)>& allocate)
+{
+    Registry& r = GetRegistry();
+    std::lock_guard<std::mutex> cg(r.collectLock);
+    std::lock_guard<std::mutex> rg(r.lock);   // a thread drawing for the first time waits for the merge
+
+    // Every buffer stays locked for the whole merge, so a thread's calls land in one frame. An
+    // exited thread sets `orphaned` after its last call, so one seen here has nothing left to add.
+    for (auto& b : r.buffers) {
+        b->lock.lock();
+        b->drainedOrphan = b->orphaned.load(std::memory_order_acquire);
+    }
+
+    // New timed items join the shared store (and draw this frame from there)
+    for (auto& b : r.buffers) {
+        for (uint32_t d = 0; d < kDepthCount; d++) {
+            TimedLines& src = b->timed[d];
+            r.timed[d].vertices.insert(r.timed[d].vertices.end(), src.vertices.begin(), src.vertices.end());
+            r.timed[d].remaining.insert(r.timed[d].remaining.end(), src.remaining.begin(), src.remaining.end());
+            src.Clear();
+        }
+    }
+
+    size_t total = 0;
+    for (uint32_t d = 0; d < kDepthCount; d++) {
+        total += r.timed[d].vertices.size();
+        for (auto& b : r.buffers) total += b->lines[d].size();
+    }
+    out.lines.clear();
+    out.labels.clear();
+    out.chars.clear();
+    VertexPC* base = nullptr;
+    if (total) {
+        if (allocate) base = allocate(uint32_t(total));
+        else { out.lines.resize(total); base = out.lines.data(); }
+    }
+
+    // Tested lines first, then overlay: one vertex range per draw
+    VertexPC* dst = base;
+    for (uint32_t d = 0; d < kDepthCount; d++) {
+        out.lineStart[d] = uint32_t(dst - base);
+        for (auto& b : r.buffers) {
+            dst = std::copy(b->lines[d].begin(), b->lines[d].end(), dst);
+            b->lines[d].clear();
+        }
+        dst = std::copy(r.timed[d].vertices.begin(), r.timed[d].vertices.end(), dst);
+        out.lineCount[d] = uint32_t(dst - base) - out.lineStart[d];
+    }
+
+    for (auto& b : r.buffers) {
+        const Labels& l = b->labels;
+        for (size_t i = 0; i < l.items.size(); i++) {
+            const DebugLabel& item = l.items[i];
+            if (l.remaining[i] > 0.0f)
+                r.timedLabels.Append(item.pos, item.color, { l.chars.data() + item.offset, item.length }, l.remaining[i]);
+            else
+                AppendLabel(out, item, l.chars.data() + item.offset);
+        }
+        b->labels.Clear();
+    }
+    for (const DebugLabel& item : r.timedLabels.items)
+        AppendLabel(out, item, r.timedLabels.chars.data() + item.offset);
+
+    r.stats.threads = uint32_t(r.buffers.size());
+    for (auto& b : r.buffers) b->lock.unlock();
+
+    // Only buffers already orphaned when drained are empty for good; a thread that drew after the
+    // merge and exited since keeps its buffer until the next Collect picks those items up
+    r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end(),
+        [](const std::unique_ptr<ThreadBuffer>& b) { return b->drainedOrphan; }), r.buffers.end());
+
+    // Age after drawing, so even a short duration shows at least once
+    uint32_t persistent = 0;
+    for (uint32_t d = 0; d < kDepthCount; d++) {
+        Age(r.timed[d], dt);
+        persistent += uint32_t(r.timed[d].remaining.size());
+    }
+    Age(r.timedLabels, dt);
+    persistent += uint32_t(r.timedLabels.items.size());
+
+    r.stats.lineVertices = uint32_t(total);
+    r.stats.labels = uint32_t(out.labels.size());
+    r.stats.persistent = persistent;
+}
+
+void DebugDraw::Clear()
+{
+    Registry& r = GetRegistry();
+    std::lock_guard<std::mutex> cg(r.collectLock);
+    std::lock_guard<std::mutex> rg(r.lock);
+    for (auto& b : r.buffers) {
+        std::lock_guard<std::mutex> g(b->lock);
+        for (uint32_t d = 0; d < kDepthCount; d++) { b->lines[d].clear(); b->timed[d].Clear(); }
+        b->labels.Clear();
+    }
+    for (uint32_t d = 0; d < kDepthCount; d++) r.timed[d].Clear();
+    r.timedLabels.Clear();
+}
+
+DebugDrawStats DebugDraw::GetStats()
+{
+    Registry& r = GetRegistry();
+    std::lock_guard<std::mutex> cg(r.collectLock);
+    return r.stats;
+}
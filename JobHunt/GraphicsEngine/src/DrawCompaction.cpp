@@ -0,0 +1,103 @@
+#include "DrawCompaction.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace GraphicsEngine;
+
+namespace {
+
+constexpr uint32_t kMinBlockItems = 4096;     // below this a block is not worth a job
+constexpr uint32_t kBlocksPerThread = 4;      // slack for uneven scheduling
+constexpr uint32_t kSlotGrain = 256;
+
+template <typename Fn> void Dispatch(JobSystem* jobs, uint32_t count, uint32_t grain, Fn&& fn)
+{
+    if (jobs && count > grain) jobs->ParallelFor(count, grain, fn);
+    else if (count) fn(0u, count);
+}
+
+}
+
+void DrawCompactor::Configure(uint32_t bucketCount, std::span<const DrawMesh> meshes)
+{
+    m_meshes.assign(meshes.begin(), meshes.end());
+    m_meshCount = (uint32_t)meshes.size();
+    m_slotTotal.assign(size_t(bucketCount) * m_meshCount, 0);
+    m_slotFirst.assign(m_slotTotal.size(), 0);
+    m_buckets.assign(bucketCount, DrawBucket{});
+    m_args.resize(m_slotTotal.size());
+}
+
+void DrawCompactor::Build(std::span<const DrawItem> items, JobSystem* jobs)
+{
+    const uint32_t n = (uint32_t)items.size();
+    const uint32_t slots = SlotCount();
+    const uint32_t threads = jobs ? jobs->GetThreadCount() : 1;
+
+    // Few blocks: the histograms are blocks x slots, and each block is one job
+    m_blockCount = std::clamp((n + kMinBlockItems - 1) / kMinBlockItems, 1u, threads * kBlocksPerThread);
+    m_blockSize = (n + m_blockCount - 1) / m_blockCount;
+    m_blockOffsets.assign(size_t(m_blockCount) * slots, 0);
+    m_instances.resize(n);
+
+    // 1. Histogram per block
+    Dispatch(jobs, m_blockCount, 1, [&](uint32_t b0, uint32_t b1) {
+        for (uint32_t b = b0; b < b1; b++) {
+            uint32_t* counts = &m_blockOffsets[size_t(b) * slots];
+            const uint32_t end = std::min(n, (b + 1) * m_blockSize);
+            for (uint32_t i = b * m_blockSize; i < end; i++) {
+                assert(items[i].bucket < m_buckets.size() && items[i].mesh < m_meshCount);
+                counts[Slot(items[i])]++;
+            }
+        }
+    });
+
+    // 2. Per slot: total, and each block's offset within the slot...
+    Dispatch(jobs, slots, kSlotGrain, [&](uint32_t s0, uint32_t s1) {
+        for (uint32_t s = s0; s < s1; s++) {
+            uint32_t sum = 0;
+            for (uint32_t b = 0; b < m_blockCount; b++) {
+                uint32_t& c = m_blockOffsets[size_t(b) * slots + s];
+                const uint32_t count = c;
+                c = sum;
+                sum += count;
+            }
+            m_slotTotal[s] = sum;
+        }
+    });
+    // ...then where each slot starts (the only serial pass, over slots, not items)...
+    uint32_t running = 0;
+    for (uint32_t s = 0; s < slots; s++) {
+        m_slotFirst[s] = running;
+        running += m_slotTotal[s];
+    }
+    // ...which becomes every block's write cursor
+    Dispatch(jobs, slots, kSlotGrain, [&](uint32_t s0, uint32_t s1) {
+        for (uint32_t b = 0; b < m_blockCount; b++)
+            for (uint32_t s = s0; s < s1; s++) m_blockOffsets[size_t(b) * slots + s] += m_slotFirst[s];
+    });
+
+    // 3. Scatter; blocks write disjoint ranges, and item order is kept within a slot
+    Dispatch(jobs, m_blockCount, 1, [&](uint32_t b0, uint32_t b1) {
+        for (uint32_t b = b0; b < b1; b++) {
+            uint32_t* cursor = &m_blockOffsets[size_t(b) * slots];
+            const uint32_t end = std::min(n, (b + 1) * m_blockSize);
+            for (uint32_t i = b * m_blockSize; i < end; i++) m_instances[cursor[Slot(items[i])]++] = items[i].instance;
+        }
+    });
+
+    // 4. Non-empty slots become args; slots are bucket-major, so each bucket's args are contiguous
+    m_argCount = 0;
+    for (uint32_t bucket = 0; bucket < (uint32_t)m_buckets.size(); bucket++) {
+        DrawBucket& out = m_buckets[bucket];
+        out = DrawBucket{ m_argCount, 0, 0 };
+        for (uint32_t mesh = 0; mesh < m_meshCount; mesh++) {
+            const uint32_t s = bucket * m_meshCount + mesh;
+            if (!m_slotTotal[s]) continue;
+            m_args[m_argCount++] = { m_meshes[mesh].vertexCount, m_slotTotal[s], m_meshes[mesh].firstVertex, m_slotFirst[s] };
+            out.instanceCount += m_slotTotal[s];
+        }
+        out.argCount = m_argCount - out.firstArg;
+    }
+}
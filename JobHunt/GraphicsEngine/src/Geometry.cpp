@@ -1,4 +1,5 @@
 #include "Geometry.h"
+#include <unordered_map>
 using namespace GraphicsEngine;
 static void pushLine(const float3& a, const float3& b, const float3& c, std::vector<VertexPC>& out){ out.push_back({a,c}); out.push_back({b,c}); }
 void Geom::BuildGridXZ(float halfExtent, float spacing, float3 color, std::vector<VertexPC>& outLines){
@@ -21,3 +22,210 @@ void Geom::BuildSolidCubePNC(float h, std::vector<VertexPNC>& outTris){
     tri(p001,p101,p100,{ 0,-1,0}, c); tri(p001,p100,p000,{ 0,-1,0}, c);
     tri(p010,p110,p111,{ 0, 1,0}, m); tri(p010,p111,p011,{ 0, 1,0}, m);
 }
+
+// ============================================================================
+// Meshlets
+// ============================================================================
+namespace {
+    constexpr uint32_t kMeshletVertexCap = 255;   // local ids are uint8_t, 0xFF marks "not in meshlet"
+    constexpr uint32_t kMeshletTriangleCap = 256;
+
+    struct MeshletBuilder
+    {
+        const uint8_t* pos = nullptr; size_t stride = 0;
+        std::vector<uint32_t> adjOffset, adjCount, adjTris;   // live triangles per vertex (CSR, swap-removed)
+        std::vector<uint8_t>  emitted;
+        std::vector<uint8_t>  local;                          // source vertex -> local id in current meshlet (0xFF = none)
+
+        const float3& P(uint32_t v) const { return *reinterpret_cast<const float3*>(pos + size_t(v) * stride); }
+
+        void RemoveTriangle(const uint32_t* tri, uint32_t t)
+        {
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = tri[k]; uint32_t* list = &adjTris[adjOffset[v]]; uint32_t& n = adjCount[v];
+                for (uint32_t i = 0; i < n; i++) if (list[i] == t) { list[i] = list[n - 1]; n--; break; }
+            }
+        }
+    };
+
+    // Ritter bounding sphere over the meshlet's vertices.
+    void ComputeSphere(const MeshletBuilder& b, const uint32_t* verts, uint32_t count, float3& outC, float& outR)
+    {
+        uint32_t pmin[3] = { 0,0,0 }, pmax[3] = { 0,0,0 };
+        for (uint32_t i = 1; i < count; i++) {
+            const float3& p = b.P(verts[i]);
+            for (int a = 0; a < 3; a++) {
+                if (p[a] < b.P(verts[pmin[a]])[a]) pmin[a] = i;
+                if (p[a] > b.P(verts[pmax[a]])[a]) pmax[a] = i;
+            }
+        }
+        int axis = 0; float best = -1.0f;
+        for (int a = 0; a < 3; a++) {
+            float3 d = b.P(verts[pmax[a]]) - b.P(verts[pmin[a]]); float d2 = dot(d, d);
+            if (d2 > best) { best = d2; axis = a; }
+        }
+        float3 c = (b.P(verts[pmin[axis]]) + b.P(verts[pmax[axis]])) * 0.5f;
+        float  r = std::sqrt(best) * 0.5f;
+        for (uint32_t i = 0; i < count; i++) {
+            const float3& p = b.P(verts[i]);
+            float d = length(p - c);
+            if (d > r) { float nr = (r + d) * 0.5f; c = c + (p - c) * ((nr - r) / d); r = nr; }
+        }
+        outC = c; outR = r;
+    }
+
+    void ComputeBounds(const MeshletBuilder& b, const MeshletMesh& mm, const Meshlet& m, MeshletBounds& out)
+    {
+        ComputeSphere(b, &mm.vertices[m.vertexOffset], m.vertexCount, out.center, out.radius);
+
+        // Normal cone from unit triangle normals (D3D clockwise front faces, left-handed)
+        float3 normals[kMeshletTriangleCap];
+        uint32_t nCount = 0; float3 axis{ 0,0,0 };
+        for (uint32_t t = 0; t < m.triangleCount; t++) {
+            const uint32_t* tri = &mm.indices[m.triangleOffset + t * 3];
+            float3 n = cross(b.P(tri[1]) - b.P(tri[0]), b.P(tri[2]) - b.P(tri[0]));
+            float L = length(n);
+            if (L <= 1e-12f) continue;
+            n = n * (1.0f / L);
+            normals[nCount++] = n; axis += n;
+        }
+        out.coneAxis = normalize_safe(axis, float3{ 0,0,1 });
+        out.coneCutoff = 1.0f;
+        if (nCount == 0 || length(axis) < SOL_MATH_EPS) return;
+
+        float minDot = 1.0f;
+        for (uint32_t i = 0; i < nCount; i++) minDot = SOL_MIN(minDot, dot(normals[i], out.coneAxis));
+        // Cones wider than ~84 degrees half-angle can't reject anything useful
+        if (minDot > 0.1f) out.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+bool Geom::BuildMeshlets(const float3* positions, size_t positionStride, size_t vertexCount,
+                         const uint32_t* indices, size_t indexCount, MeshletMesh& out,
+                         uint32_t maxVertices, uint32_t maxTriangles)
+{
+    out.meshlets.clear(); out.bounds.clear(); out.vertices.clear(); out.triangles.clear(); out.indices.clear();
+    maxVertices  = SOL_MAX(3u, SOL_MIN(maxVertices, kMeshletVertexCap));
+    maxTriangles = SOL_MAX(1u, SOL_MIN(maxTriangles, kMeshletTriangleCap));
+    const uint32_t triCount = uint32_t(indexCount / 3);
+    if (!positions || !indices || triCount == 0) return true;
+    // Every index is used to address per-vertex arrays below and ends up in the remap
+    for (size_t i = 0; i < size_t(triCount) * 3; i++)
+        if (indices[i] >= vertexCount) return false;
+
+    MeshletBuilder b;
+    b.pos = reinterpret_cast<const uint8_t*>(positions);
+    b.stride = positionStride ? positionStride : sizeof(float3);
+
+    // Vertex -> triangle adjacency
+    b.adjOffset.assign(vertexCount + 1, 0);
+    b.adjCount.assign(vertexCount, 0);
+    for (size_t i = 0; i < size_t(triCount) * 3; i++) b.adjCount[indices[i]]++;
+    for (size_t v = 0; v < vertexCount; v++) b.adjOffset[v + 1] = b.adjOffset[v] + b.adjCount[v];
+    b.adjTris.resize(b.adjOffset[vertexCount]);
+    std::fill(b.adjCount.begin(), b.adjCount.end(), 0u);
+    for (uint32_t t = 0; t < triCount; t++)
+        for (int k = 0; k < 3; k++) { uint32_t v = indices[t * 3 + k]; b.adjTris[b.adjOffset[v] + b.adjCount[v]++] = t; }
+
+    b.emitted.assign(triCount, 0);
+    b.local.assign(vertexCount, 0xFF);
+
+    out.meshlets.reserve(triCount / maxTriangles + 1);
+    out.indices.reserve(size_t(triCount) * 3);
+    out.triangles.reserve(size_t(triCount) * 3);
+
+    Meshlet cur{};
+    auto flush = [&]() {
+        if (cur.triangleCount == 0) return;
+        for (uint32_t i = 0; i < cur.vertexCount; i++) b.local[out.vertices[cur.vertexOffset + i]] = 0xFF;
+        out.meshlets.push_back(cur);
+        cur = Meshlet{};
+        cur.vertexOffset = (uint32_t)out.vertices.size();
+        cur.triangleOffset = (uint32_t)out.indices.size();
+    };
+    auto newVerts = [&](uint32_t t) {
+        const uint32_t* tri = &indices[t * 3];
+        return uint32_t(b.local[tri[0]] == 0xFF) + uint32_t(b.local[tri[1]] == 0xFF) + uint32_t(b.local[tri[2]] == 0xFF);
+    };
+    auto append = [&](uint32_t t) {
+        const uint32_t* tri = &indices[t * 3];
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = tri[k];
+            if (b.local[v] == 0xFF) { b.local[v] = (uint8_t)cur.vertexCount++; out.vertices.push_back(v); }
+            out.triangles.push_back(b.local[v]);
+            out.indices.push_back(v);
+        }
+        cur.triangleCount++;
+        b.emitted[t] = 1;
+        b.RemoveTriangle(tri, t);
+    };
+
+    uint32_t seedCursor = 0;
+    for (uint32_t emittedCount = 0; emittedCount < triCount; emittedCount++)
+    {
+        // Best neighbour: fewest new vertices, then fewest remaining live triangles (finishes fans/strips first)
+        uint32_t best = ~0u, bestExtra = 4, bestLive = ~0u;
+        for (uint32_t i = 0; i < cur.vertexCount && bestExtra > 0; i++) {
+            uint32_t v = out.vertices[cur.vertexOffset + i];
+            const uint32_t* list = &b.adjTris[b.adjOffset[v]];
+            for (uint32_t j = 0; j < b.adjCount[v]; j++) {
+                uint32_t t = list[j];
+                uint32_t extra = newVerts(t);
+                const uint32_t* tri = &indices[t * 3];
+                uint32_t live = b.adjCount[tri[0]] + b.adjCount[tri[1]] + b.adjCount[tri[2]];
+                if (extra < bestExtra || (extra == bestExtra && live < bestLive)) { best = t; bestExtra = extra; bestLive = live; }
+            }
+        }
+
+        if (best != ~0u && (cur.vertexCount + bestExtra > maxVertices || cur.triangleCount + 1 > maxTriangles)) {
+            flush(); best = ~0u;
+        }
+        if (best == ~0u) {
+            // Meshlet has no live neighbours (or was just flushed): seed from the next unused triangle in input order
+            while (b.emitted[seedCursor]) seedCursor++;
+            best = seedCursor;
+            if (cur.vertexCount + newVerts(best) > maxVertices || cur.triangleCount + 1 > maxTriangles) flush();
+        }
+        append(best);
+    }
+    flush();
+
+    out.bounds.resize(out.meshlets.size());
+    for (size_t i = 0; i < out.meshlets.size(); i++) ComputeBounds(b, out, out.meshlets[i], out.bounds[i]);
+    return true;
+}
+
+bool Geom::BuildMeshlets(const std::vector<VertexPNC>& verts, const std::vector<uint32_t>& indices, MeshletMesh& out,
+                         uint32_t maxVertices, uint32_t maxTriangles)
+{
+    return BuildMeshlets(verts.empty() ? nullptr : &verts[0].pos, sizeof(VertexPNC), verts.size(),
+                  indices.data(), indices.size(), out, maxVertices, maxTriangles);
+}
+
+void Geom::BuildClusterLod(const float3* positions, size_t positionStride, size_t vertexCount,
+                           const uint32_t* indices, size_t indexCount, float cellSize, std::vector<uint32_t>& outIndices)
+{
+    outIndices.clear();
+    if (!positions || vertexCount == 0 || cellSize <= 0.0f) return;
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(positions);
+    const float inv = 1.0f / cellSize;
+
+    // 21 bits per axis is plenty for a LOD grid
+    std::unordered_map<uint64_t, uint32_t> cells;
+    cells.reserve(vertexCount / 4 + 16);
+    std::vector<uint32_t> remap(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float3& p = *reinterpret_cast<const float3*>(base + v * positionStride);
+        const uint64_t cx = uint64_t(int64_t(std::floor(p.x * inv)) & 0x1FFFFF);
+        const uint64_t cy = uint64_t(int64_t(std::floor(p.y * inv)) & 0x1FFFFF);
+        const uint64_t cz = uint64_t(int64_t(std::floor(p.z * inv)) & 0x1FFFFF);
+        remap[v] = cells.emplace((cx << 42) | (cy << 21) | cz, uint32_t(v)).first->second;
+    }
+
+    outIndices.reserve(indexCount / 2);
+    for (size_t t = 0; t + 2 < indexCount; t += 3) {
+        const uint32_t a = remap[indices[t]], b = remap[indices[t + 1]], c = remap[indices[t + 2]];
+        if (a == b || b == c || a == c) continue;
+        outIndices.insert(outIndices.end(), { a, b, c });
+    }
+}
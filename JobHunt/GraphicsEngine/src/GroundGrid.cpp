@@ -0,0 +1,94 @@
+#include "GroundGrid.h"
+
+using namespace GraphicsEngine;
+
+// ============================================================================
+// Chunk selection
+// ============================================================================
+uint32_t GraphicsEngine::ChunkLod(const ChunkRingDesc& desc, const float3& eye, const AABB_t& b)
+{
+    // Distance from the eye to the closest point of the chunk box
+    float3 d{ SOL_MAX(std::fabs(eye.x - b.center.x) - b.extents.x, 0.0f),
+              SOL_MAX(std::fabs(eye.y - b.center.y) - b.extents.y, 0.0f),
+              SOL_MAX(std::fabs(eye.z - b.center.z) - b.extents.z, 0.0f) };
+    float dist = length(d);
+    uint32_t lod = 0;
+    for (float limit = desc.lodDistance; dist >= limit && lod < desc.maxLod; limit *= 2.0f) lod++;
+    return lod;
+}
+
+void GraphicsEngine::SelectChunks(const ChunkRingDesc& desc, const float3& eye, const CullView* view, std::vector<GridChunk>& out)
+{
+    out.clear();
+    const float s = desc.chunkSize;
+    const int32_t ex = (int32_t)std::floor(eye.x / s);
+    const int32_t ez = (int32_t)std::floor(eye.z / s);
+    const float maxDist = float(desc.radius) * s;
+    const float halfY = (desc.maxY - desc.minY) * 0.5f;
+
+    for (int32_t z = ez - desc.radius; z <= ez + desc.radius; z++) {
+        for (int32_t x = ex - desc.radius; x <= ex + desc.radius; x++) {
+            GridChunk c;
+            c.x = x; c.z = z;
+            c.bounds.center = { (float(x) + 0.5f) * s, desc.minY + halfY, (float(z) + 0.5f) * s };
+            c.bounds.extents = { s * 0.5f, SOL_MAX(halfY, 0.01f), s * 0.5f };
+
+            // Circular ring (closest point on XZ)
+            float dx = SOL_MAX(std::fabs(eye.x - c.bounds.center.x) - c.bounds.extents.x, 0.0f);
+            float dz = SOL_MAX(std::fabs(eye.z - c.bounds.center.z) - c.bounds.extents.z, 0.0f);
+            if (dx * dx + dz * dz > maxDist * maxDist) continue;
+            if (view && !AabbVisible(*view, c.bounds)) continue;
+
+            c.lod = ChunkLod(desc, eye, c.bounds);
+            out.push_back(c);
+        }
+    }
+}
+
+// ============================================================================
+// Grid / ground
+// ============================================================================
+uint32_t GroundGrid::LinesPerChunk(uint32_t lod) const
+{
+    int n = (int)(m_desc.chunkSize / (m_spacing * float(1u << lod)) + 0.5f);
+    return (uint32_t)SOL_MAX(n, 1);
+}
+
+void GroundGrid::Update(const float3& eye, const CullView* view)
+{
+    SelectChunks(m_desc, eye, view, m_visible);
+    m_lineVertexCount = 0;
+    for (const GridChunk& c : m_visible) m_lineVertexCount += LinesPerChunk(c.lod) * 4;
+}
+
+void GroundGrid::WriteLines(VertexPC* dst) const
+{
+    const float s = m_desc.chunkSize;
+    const float3 axisX{ 1,0,0 }, axisZ{ 0,0,1 };
+    for (const GridChunk& c : m_visible) {
+        // Each chunk owns the lines on its min edges; the max edge belongs to the neighbour,
+        // and coarser levels are strict subsets of finer ones so LOD seams line up.
+        const uint32_t n = LinesPerChunk(c.lod);
+        const float step = s / float(n);
+        const float x0 = float(c.x) * s, z0 = float(c.z) * s;
+        const float3 col = m_lineColor * (1.0f / float(1u + c.lod));
+        for (uint32_t k = 0; k < n; k++) {
+            const float x = x0 + float(k) * step, z = z0 + float(k) * step;
+            const float3 cx = (c.x == 0 && k == 0) ? axisZ : col;   // x == 0 runs along Z
+            const float3 cz = (c.z == 0 && k == 0) ? axisX : col;   // z == 0 runs along X
+            *dst++ = { { x, 0, z0 }, cx };      *dst++ = { { x, 0, z0 + s }, cx };
+            *dst++ = { { x0, 0, z }, cz };      *dst++ = { { x0 + s, 0, z }, cz };
+        }
+    }
+}
+
+void GroundGrid::WriteGround(VertexPNC* dst) const
+{
+    const float s = m_desc.chunkSize;
+    const float3 n{ 0,1,0 };
+    for (const GridChunk& c : m_visible) {
+        const float x0 = float(c.x) * s, z0 = float(c.z) * s, x1 = x0 + s, z1 = z0 + s;
+        *dst++ = { { x0,0,z0 }, n, m_groundColor }; *dst++ = { { x1,0,z0 }, n, m_groundColor }; *dst++ = { { x1,0,z1 }, n, m_groundColor };
+        *dst++ = { { x0,0,z0 }, n, m_groundColor }; *dst++ = { { x1,0,z1 }, n, m_groundColor }; *dst++ = { { x0,0,z1 }, n, m_groundColor };
+    }
+}
@@ -0,0 +1,56 @@
+#include "Hud.h"
+#include <utility>
+
+using namespace GraphicsEngine;
+
+// ============================================================================
+// Primitives
+// ============================================================================
+void HudBuilder::Rect(float x0, float y0, float x1, float y1, const float3& c)
+{
+    m_out.push_back({ {x0,y0,0}, c }); m_out.push_back({ {x1,y0,0}, c }); m_out.push_back({ {x1,y1,0}, c });
+    m_out.push_back({ {x0,y0,0}, c }); m_out.push_back({ {x1,y1,0}, c }); m_out.push_back({ {x0,y1,0}, c });
+}
+
+// ============================================================================
+// Retained elements
+// ============================================================================
+RetainedHud::ElementId RetainedHud::Add(HudLayer layer)
+{
+    Element e;
+    e.layer = layer;
+    m_elements.push_back(std::move(e));
+    m_dirty[uint32_t(layer)] = true;
+    return ElementId(m_elements.size() - 1);
+}
+
+void RetainedHud::Invalidate()
+{
+    for (Element& e : m_elements) e.built = false;
+}
+
+void RetainedHud::Append(HudLayer layer)
+{
+    for (const Element& e : m_elements)
+        if (e.layer == layer) m_packed.insert(m_packed.end(), e.vertices.begin(), e.vertices.end());
+}
+
+void RetainedHud::Pack()
+{
+    const bool staticDirty = m_dirty[uint32_t(HudLayer::Static)];
+    const bool dynamicDirty = m_dirty[uint32_t(HudLayer::Dynamic)];
+    if (!staticDirty && !dynamicDirty) return;
+
+    if (staticDirty) {
+        m_packed.clear();
+        Append(HudLayer::Static);
+        m_staticCount = uint32_t(m_packed.size());
+        m_version[uint32_t(HudLayer::Static)]++;
+    } else {
+        m_packed.resize(m_staticCount);   // keeps capacity: no allocation once warmed up
+    }
+    Append(HudLayer::Dynamic);
+    m_version[uint32_t(HudLayer::Dynamic)]++;
+    m_dirty[uint32_t(HudLayer::Static)] = m_dirty[uint32_t(HudLayer::Dynamic)] = false;
+    m_stats.packs++;
+}
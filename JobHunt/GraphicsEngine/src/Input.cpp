@@ -0,0 +1,145 @@
+#include "Input.h"
+#include <cstring>
+#include <fstream>
+
+using namespace GraphicsEngine;
+
+// ============================================================================
+// InputRecording
+// ============================================================================
+double InputRecording::Duration() const
+{
+    double t = 0.0;
+    for (const InputFrame& f : frames) t += f.dt;
+    return t;
+}
+
+bool InputRecording::Save(const std::string& path) const
+{
+    InputRecordingHeader hdr;
+    hdr.frameCount = (uint32_t)frames.size();
+    hdr.eventCount = (uint32_t)events.size();
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    f.write(reinterpret_cast<const char*>(frames.data()), std::streamsize(frames.size() * sizeof(InputFrame)));
+    f.write(reinterpret_cast<const char*>(events.data()), std::streamsize(events.size() * sizeof(InputEvent)));
+    return bool(f);
+}
+
+bool InputRecording::Load(const std::string& path)
+{
+    frames.clear();
+    events.clear();
+
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) return false;
+    const uint64_t fileSize = uint64_t(f.tellg());
+    f.seekg(0);
+    InputRecordingHeader hdr;
+    if (!f.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) ||
+        std::memcmp(hdr.magic, "GEIR", 4) != 0 || hdr.version != kInputRecordingVersion)
+        return false;
+
+    // The counts must account for the file exactly, before they size anything
+    if (sizeof(hdr) + uint64_t(hdr.frameCount) * sizeof(InputFrame) + uint64_t(hdr.eventCount) * sizeof(InputEvent) != fileSize)
+        return false;
+
+    std::vector<InputFrame> fr(hdr.frameCount);
+    std::vector<InputEvent> ev(hdr.eventCount);
+    if (!f.read(reinterpret_cast<char*>(fr.data()), std::streamsize(fr.size() * sizeof(InputFrame))) ||
+        !f.read(reinterpret_cast<char*>(ev.data()), std::streamsize(ev.size() * sizeof(InputEvent))))
+        return false;
+
+    // Frames must tile the event array in order
+    uint64_t next = 0;
+    for (const InputFrame& fi : fr) {
+        if (fi.firstEvent != next || !(fi.dt >= 0.0f)) return false;
+        next += fi.eventCount;
+    }
+    if (next != ev.size()) return false;
+
+    frames = std::move(fr);
+    events = std::move(ev);
+    return true;
+}
+
+// ============================================================================
+// InputState
+// ============================================================================
+void InputState::Apply(const InputEvent& e)
+{
+    switch (e.type) {
+    case InputEventType::KeyDown: if (e.key < 256) keys[e.key] = true;  break;
+    case InputEventType::KeyUp:   if (e.key < 256) keys[e.key] = false; break;
+    case InputEventType::MouseMove: mouseX = e.x; mouseY = e.y; buttons = e.buttons; break;
+    case InputEventType::MouseWheel: break;
+    }
+}
+
+// ============================================================================
+// InputStream
+// ============================================================================
+void InputStream::Push(const InputEvent& e)
+{
+    if (m_mode != Mode::Replay) m_queue.push_back(e);
+}
+
+float InputStream::BeginFrame(float measuredDt, std::span<const InputEvent>& events)
+{
+    if (m_mode == Mode::Replay) {
+        if (m_replayFrame >= m_replay.frames.size()) {
+            events = {};
+            return m_fixedDt > 0.0f ? m_fixedDt : measuredDt;
+        }
+        const InputFrame& fr = m_replay.frames[m_replayFrame];
+        events = m_replay.FrameEvents(m_replayFrame++);
+        return m_fixedDt > 0.0f ? m_fixedDt : fr.dt;
+    }
+
+    // Hand out this frame's queue and start the next one empty
+    m_frameEvents.swap(m_queue);
+    m_queue.clear();
+    if (m_mode == Mode::Recording) {
+        m_recording.frames.push_back({ measuredDt, (uint32_t)m_recording.events.size(), (uint32_t)m_frameEvents.size() });
+        m_recording.events.insert(m_recording.events.end(), m_frameEvents.begin(), m_frameEvents.end());
+    }
+    events = m_frameEvents;
+    return measuredDt;
+}
+
+float InputStream::PeekDt(float measuredDt) const
+{
+    if (m_mode != Mode::Replay) return measuredDt;
+    if (m_fixedDt > 0.0f) return m_fixedDt;
+    return m_replayFrame < m_replay.frames.size() ? m_replay.frames[m_replayFrame].dt : measuredDt;
+}
+
+void InputStream::StartRecording()
+{
+    m_recording = {};
+    m_mode = Mode::Recording;
+}
+
+InputRecording InputStream::StopRecording()
+{
+    if (m_mode == Mode::Recording) m_mode = Mode::Live;
+    return std::move(m_recording);
+}
+
+void InputStream::StartReplay(InputRecording recording, float fixedDt)
+{
+    m_replay = std::move(recording);
+    m_replayFrame = 0;
+    m_fixedDt = fixedDt;
+    m_queue.clear();
+    m_mode = Mode::Replay;
+}
+
+void InputStream::StopReplay()
+{
+    if (m_mode == Mode::Replay) m_mode = Mode::Live;
+    m_replay = {};
+    m_replayFrame = 0;
+}
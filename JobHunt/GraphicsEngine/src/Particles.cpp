@@ -0,0 +1,192 @@
+#include "Particles.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#define GE_PARTICLE_SSE 1
+#else
+#define GE_PARTICLE_SSE 0
+#endif
+
+using namespace GraphicsEngine;
+
+namespace {
+
+constexpr uint32_t kKeyGrain = 16384;
+constexpr uint32_t kGatherGrain = 32768;
+constexpr uint32_t kExpandGrain = 8192;
+// Sort keys are the top 24 bits of the view depth: a relative precision of 2^-15 (3 mm at 100 m) is
+// plenty for blending order and saves a radix pass
+constexpr uint32_t kKeyBits = 24;
+constexpr uint32_t kCulledKey = (1u << kKeyBits) - 1;   // sorts after every visible particle
+
+template <typename Fn> void Dispatch(JobSystem* jobs, uint32_t count, uint32_t grain, Fn&& fn)
+{
+    if (jobs && count > grain) jobs->ParallelFor(count, grain, fn);
+    else if (count) fn(0u, count);
+}
+
+// Alpha scaled by the particle's remaining life
+uint32_t Fade(uint32_t color, float age, float life)
+{
+    const float alpha = float(color >> 24) * std::max(0.0f, 1.0f - age / life);
+    return (color & 0x00FFFFFFu) | (uint32_t(alpha + 0.5f) << 24);
+}
+
+}
+
+void ParticleSystem::SetCapacity(uint32_t capacity)
+{
+    m_capacity = capacity;
+    m_count = std::min(m_count, capacity);
+    m_visible = 0;
+    for (std::vector<float>* a : { &m_px, &m_py, &m_pz, &m_vx, &m_vy, &m_vz, &m_age, &m_life, &m_size })
+        a->resize(capacity);
+    m_color.resize(capacity);
+    m_keys.resize(capacity);
+    m_indices.resize(capacity);
+    std::iota(m_indices.begin(), m_indices.end(), 0u);
+}
+
+uint32_t ParticleSystem::Random()
+{
+    m_seed ^= m_seed << 13; m_seed ^= m_seed >> 17; m_seed ^= m_seed << 5;
+    return m_seed;
+}
+
+uint32_t ParticleSystem::Emit(const ParticleEmitterDesc& e, uint32_t count)
+{
+    count = std::min(count, m_capacity - m_count);
+    auto signedUnit = [&] { return float(Random() & 0xFFFF) * (2.0f / 65535.0f) - 1.0f; };
+    for (uint32_t k = 0; k < count; k++) {
+        const uint32_t i = m_count++;
+        m_px[i] = e.position.x; m_py[i] = e.position.y; m_pz[i] = e.position.z;
+        m_vx[i] = e.velocity.x + e.spread * signedUnit();
+        m_vy[i] = e.velocity.y + e.spread * signedUnit();
+        m_vz[i] = e.velocity.z + e.spread * signedUnit();
+        m_age[i] = 0.0f;
+        // Staggered lifetimes, so a burst does not vanish in one frame
+        m_life[i] = e.lifetime * (0.75f + 0.125f * (signedUnit() + 1.0f));
+        m_size[i] = e.size;
+        m_color[i] = e.color;
+    }
+    return count;
+}
+
+void ParticleSystem::Simulate(float dt, const float3& gravity)
+{
+    // Straight SoA loops; the compiler vectorizes them
+    for (uint32_t i = 0; i < m_count; i++) {
+        m_vx[i] += gravity.x * dt; m_vy[i] += gravity.y * dt; m_vz[i] += gravity.z * dt;
+        m_px[i] += m_vx[i] * dt;   m_py[i] += m_vy[i] * dt;   m_pz[i] += m_vz[i] * dt;
+        m_age[i] += dt;
+    }
+
+    // Expired: the last particle moves into the hole (order does not matter, Sort restores it)
+    for (uint32_t i = 0; i < m_count;) {
+        if (m_age[i] < m_life[i]) { i++; continue; }
+        const uint32_t last = --m_count;
+        m_px[i] = m_px[last]; m_py[i] = m_py[last]; m_pz[i] = m_pz[last];
+        m_vx[i] = m_vx[last]; m_vy[i] = m_vy[last]; m_vz[i] = m_vz[last];
+        m_age[i] = m_age[last]; m_life[i] = m_life[last]; m_size[i] = m_size[last]; m_color[i] = m_color[last];
+    }
+}
+
+void ParticleSystem::Sort(const float4x4& cameraToWorld, float nearZ, JobSystem* jobs)
+{
+    const float3 forward{ cameraToWorld[2].x, cameraToWorld[2].y, cameraToWorld[2].z };
+    const float3 eye{ cameraToWorld[3].x, cameraToWorld[3].y, cameraToWorld[3].z };
+
+    // Far to near is descending depth; depth > 0 here, so the inverted float bits sort ascending.
+    // Behind / too close: a key past every visible one, so those end up last.
+    std::atomic<uint32_t> visible{ 0 };
+    Dispatch(jobs, m_count, kKeyGrain, [&](uint32_t i0, uint32_t i1) {
+        uint32_t count = 0;
+        for (uint32_t i = i0; i < i1; i++) {
+            const float depth = (m_px[i] - eye.x) * forward.x + (m_py[i] - eye.y) * forward.y + (m_pz[i] - eye.z) * forward.z;
+            uint32_t bits;
+            std::memcpy(&bits, &depth, sizeof(bits));
+            const bool inFront = depth > nearZ;
+            m_keys[i] = inFront ? ~bits >> (32 - kKeyBits) : kCulledKey;
+            count += inFront;
+        }
+        visible.fetch_add(count, std::memory_order_relaxed);
+    });
+    m_visible = visible.load(std::memory_order_relaxed);
+
+    m_sorter.Sort({ m_keys.data(), m_count }, { m_indices.data(), m_count }, jobs, kKeyBits);
+
+    // Permute every array into the sorted order. The first frame this is a random gather; after
+    // that the order barely changes and it streams.
+    const RadixItem* order = m_sorter.Items().data();
+    m_gatherF.resize(m_capacity);
+    m_gatherU.resize(m_capacity);
+    for (std::vector<float>* a : { &m_px, &m_py, &m_pz, &m_vx, &m_vy, &m_vz, &m_age, &m_life, &m_size }) {
+        Dispatch(jobs, m_count, kGatherGrain, [&](uint32_t k0, uint32_t k1) {
+            for (uint32_t k = k0; k < k1; k++) m_gatherF[k] = (*a)[order[k].value];
+        });
+        a->swap(m_gatherF);
+    }
+    Dispatch(jobs, m_count, kGatherGrain, [&](uint32_t k0, uint32_t k1) {
+        for (uint32_t k = k0; k < k1; k++) m_gatherU[k] = m_color[order[k].value];
+    });
+    m_color.swap(m_gatherU);
+}
+
+void ParticleSystem::Expand(const float4x4& cameraToWorld, ParticleVertex* out, JobSystem* jobs) const
+{
+    Dispatch(jobs, m_visible, kExpandGrain, [&](uint32_t k0, uint32_t k1) {
+        const float3 right{ cameraToWorld[0].x, cameraToWorld[0].y, cameraToWorld[0].z };
+        const float3 up{ cameraToWorld[1].x, cameraToWorld[1].y, cameraToWorld[1].z };
+        uint32_t k = k0;
+#if GE_PARTICLE_SSE
+        // Four particles per step, one per lane; each corner's x / y / z / colour vectors transpose
+        // into four 16-byte vertices (the colour bits ride in w)
+        const __m128 rx = _mm_set1_ps(right.x), ry = _mm_set1_ps(right.y), rz = _mm_set1_ps(right.z);
+        const __m128 ux = _mm_set1_ps(up.x), uy = _mm_set1_ps(up.y), uz = _mm_set1_ps(up.z);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+        const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+        for (; k + 4 <= k1; k += 4) {
+            const __m128 px = _mm_loadu_ps(&m_px[k]), py = _mm_loadu_ps(&m_py[k]), pz = _mm_loadu_ps(&m_pz[k]);
+            const __m128 s = _mm_loadu_ps(&m_size[k]);
+            const __m128 fade = _mm_max_ps(zero, _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(&m_age[k]), _mm_loadu_ps(&m_life[k]))));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_color[k]));
+            const __m128 alpha = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(c, 24)), fade);
+            const __m128 color = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(c, rgbMask), _mm_slli_epi32(_mm_cvtps_epi32(alpha), 24)));
+
+            const __m128 sx = _mm_mul_ps(rx, s), sy = _mm_mul_ps(ry, s), sz = _mm_mul_ps(rz, s);   // right * size
+            const __m128 tx = _mm_mul_ps(ux, s), ty = _mm_mul_ps(uy, s), tz = _mm_mul_ps(uz, s);   // up * size
+            const __m128 topX = _mm_add_ps(px, tx), topY = _mm_add_ps(py, ty), topZ = _mm_add_ps(pz, tz);
+            const __m128 botX = _mm_sub_ps(px, tx), botY = _mm_sub_ps(py, ty), botZ = _mm_sub_ps(pz, tz);
+            float* dst = &out[size_t(k) * 4].pos.x;
+            for (int corner = 0; corner < 4; corner++) {
+                const bool top = corner < 2, plus = corner & 1;
+                __m128 x = top ? topX : botX, y = top ? topY : botY, z = top ? topZ : botZ, w = color;
+                x = plus ? _mm_add_ps(x, sx) : _mm_sub_ps(x, sx);
+                y = plus ? _mm_add_ps(y, sy) : _mm_sub_ps(y, sy);
+                z = plus ? _mm_add_ps(z, sz) : _mm_sub_ps(z, sz);
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+                _mm_storeu_ps(dst + 0 * 16 + corner * 4, x);
+                _mm_storeu_ps(dst + 1 * 16 + corner * 4, y);
+                _mm_storeu_ps(dst + 2 * 16 + corner * 4, z);
+                _mm_storeu_ps(dst + 3 * 16 + corner * 4, w);
+            }
+        }
+#endif
+        for (; k < k1; k++) {
+            const float3 c{ m_px[k], m_py[k], m_pz[k] };
+            const float3 r = right * m_size[k], u = up * m_size[k];
+            const uint32_t color = Fade(m_color[k], m_age[k], m_life[k]);
+            ParticleVertex* v = &out[size_t(k) * 4];
+            v[0] = { c + u - r, color };
+            v[1] = { c + u + r, color };
+            v[2] = { c - u - r, color };
+            v[3] = { c - u + r, color };
+        }
+    });
+}
@@ -4,7 +4,12 @@
 #include "Geometry.h"
 #include "D3D12Helpers.h"
 #include "SolMath.h"
+#include "Assets/D3DShaderCompiler.h"
+#include "DebugDraw.h"
+#include "Core/Counters.h"
+#include "Core/Profiler.h"
 
+#include <algorithm>
 #include <vector>
 #include <array>
 #include <chrono>
@@ -61,26 +66,54 @@ static inline D3D12_RESOURCE_DESC MakeBufferDesc(UINT64 bytes)
     return d;
 }
 
+// Pixel-space ortho (y down, origin top-left) for the overlays
+static inline float4x4 PixelOrtho(float W, float H)
+{
+    const float l = 0, r = W, t = 0, b = H, zn = 0, zf = 1;
+    float4x4 P = m_identity();
+    P[0].x = 2.0f / (r - l);
+    P[1].y = 2.0f / (t - b);
+    P[2].z = 1.0f / (zf - zn);
+    P[3].x = -(r + l) / (r - l);
+    P[3].y = -(t + b) / (t - b);
+    P[3].z = -zn / (zf - zn);
+    return P;
+}
+
 // Pretty shader compiler (prints errors to Output window)
 template<typename T>
 static inline void ThrowIfFailedHR(HRESULT hr, const T& msg) {
     if (FAILED(hr)) throw std::runtime_error(msg);
 }
-static inline void CompileShader(LPCWSTR file, LPCSTR entry, LPCSTR target, ComPtr<ID3DBlob>& out, UINT flags = 0)
+
+static D3DShaderCompiler s_shaderCompiler;
+
+// Everything in the desc that changes the compiled pipeline; shaders and root signature by content
+static Hash128 PipelineKey(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& d, const Hash128& rootSigKey)
 {
-    ComPtr<ID3DBlob> errs;
-    HRESULT hr = D3DCompileFromFile(file, nullptr, nullptr, entry, target, flags, 0, &out, &errs);
-    if (errs) OutputDebugStringA((const char*)errs->GetBufferPointer());
-    if (FAILED(hr)) {
-        std::string s = "Shader compile failed: ";
-        s += entry; s += "/"; s += target; s += " in ";
-        int len = WideCharToMultiByte(CP_UTF8, 0, file, -1, nullptr, 0, nullptr, nullptr);
-        std::string path(len > 0 ? len - 1 : 0, '\0');
-        if (len > 1) WideCharToMultiByte(CP_UTF8, 0, file, -1, path.data(), len, nullptr, nullptr);
-        s += path;
-        if (errs) { s += "\n"; s += (const char*)errs->GetBufferPointer(); }
-        throw std::runtime_error(s);
+    Hasher128 h;
+    h.Add(rootSigKey);
+    for (const D3D12_SHADER_BYTECODE* bc : { &d.VS, &d.PS, &d.DS, &d.HS, &d.GS })
+        h.Add(bc->pShaderBytecode, bc->pShaderBytecode ? bc->BytecodeLength : 0);
+    h.AddPod(d.BlendState);
+    h.AddPod(d.SampleMask);
+    h.AddPod(d.RasterizerState);
+    h.AddPod(d.DepthStencilState);
+    for (UINT i = 0; i < d.InputLayout.NumElements; i++) {
+        D3D12_INPUT_ELEMENT_DESC e = d.InputLayout.pInputElementDescs[i];
+        h.Add(std::string_view(e.SemanticName));
+        e.SemanticName = nullptr;
+        h.AddPod(e);
     }
+    h.AddPod(d.IBStripCutValue);
+    h.AddPod(d.PrimitiveTopologyType);
+    h.AddPod(d.NumRenderTargets);
+    h.AddPod(d.RTVFormats);
+    h.AddPod(d.DSVFormat);
+    h.AddPod(d.SampleDesc);
+    h.AddPod(d.NodeMask);
+    h.AddPod(d.Flags);
+    return h.Get();
 }
 
 // ============================================================================
@@ -93,6 +126,7 @@ bool Renderer::Initialize(HWND hwnd, uint32_t width, uint32_t height)
 {
     m_hwnd = hwnd;
     m_width = width; m_height = height;
+    PROFILE_THREAD("Main");
     if (!CreateDevice())                      return false;
     if (!CreateCommandObjects())              return false;
     if (!CreateSwapchainAndRTVs(hwnd, width, height)) return false;
@@ -100,6 +134,7 @@ bool Renderer::Initialize(HWND hwnd, uint32_t width, uint32_t height)
     if (!CreateRootAndPSO())                  return false;
     if (!CreateGeometry())                    return false;
     if (!CreateShadowMap(2048))               return false;
+    if (!CreateTextResources())               return false;
     // Cameras
     m_camera.SetLens(to_radians(60.0f), float(width) / float(height), 0.1f, 500.0f);
     m_camera.SetPosition({ -5.0f, 3.0f, -5.0f });
@@ -117,12 +152,39 @@ bool Renderer::Initialize(HWND hwnd, uint32_t width, uint32_t height)
         float3 c{ (r01() - 0.5f) * 60.0f, r01() * 5.0f, (r01() - 0.5f) * 60.0f };
         float3 e{ 0.5f + r01() * 1.5f, 0.5f + r01() * 1.5f, 0.5f + r01() * 1.5f };
         float3 col{ 0.4f + 0.6f * r01(), 0.4f + 0.6f * r01(), 0.4f + 0.6f * r01() };
-        m_debugBoxes.push_back({ AABB_t{ c, e }, col });
+        RenderProxyDesc box;
+        box.localBounds = AABB_t{ c, e };
+        box.color = col;
+        box.kind = kProxyDebugBox;
+        m_scene.Create(Bounds{ AABB_t{ c, e } }, Color{ col }, RenderProxy{ m_renderQueue.Create(box) });
     }
-    // Frame-time graph priming
-    //for (float& v : m_frameTimes) v = 5.56f; // ~180 FPS baseline (1000ms/144 = 6.94ms)
-    for (float& v : m_frameTimes) v = 16.6f;
-    m_ftHead = 0;
+    m_player = m_scene.Create(Transform{ { 0.0f, 0.5f, 0.0f } }, Player{});
+    const Transform cube{ { 9.4f, 0.9f, 0.0f }, 0.0f, { 1.0f, 11.0f, 1.0f } };
+    RenderProxyDesc cubeProxy;
+    cubeProxy.world = TransformMatrix(cube);
+    m_testCube = m_scene.Create(cube, MeshInstance{}, RenderProxy{ m_renderQueue.Create(cubeProxy) });
+    // Particle fountain next to the spawn point
+    m_particles.SetCapacity(kParticleCapacity);
+    m_fountain.position = { -3.0f, 0.0f, 3.0f };
+    m_fountain.velocity = { 0.0f, 6.0f, 0.0f };
+    m_fountain.spread = 1.2f;
+    m_fountain.lifetime = 1.3f;
+    m_fountain.size = 0.06f;
+    m_fountain.color = PackRGBA8({ 1.0f, 0.6f, 0.2f }, 0.8f);
+    // Frame statistics stages (the frame interval is stage 0)
+    m_stage.update       = m_frameStats.AddStage("Update");
+    m_stage.render       = m_frameStats.AddStage("Render");
+    m_stage.waitForFrame = m_frameStats.AddStage("WaitForFrame");
+    m_stage.cull         = m_frameStats.AddStage("Cull");
+    m_stage.shadow       = m_frameStats.AddStage("ShadowPass");
+    m_stage.scene        = m_frameStats.AddStage("Scene");
+    m_stage.particles    = m_frameStats.AddStage("Particles");
+    m_stage.debugDraw    = m_frameStats.AddStage("DebugDraw");
+    m_stage.hud          = m_frameStats.AddStage("HUD");
+    m_stage.text         = m_frameStats.AddStage("Text");
+    m_stage.present      = m_frameStats.AddStage("Present");
+    // Counters keep their Counter index as the stats id
+    for (const CounterInfo& c : kCounterInfo) m_frameStats.AddCounter(c.name, c.unit);
     // Defaults / toggles
     m_vsync = true;
     m_camMode = CameraMode::Free;
@@ -138,9 +200,9 @@ bool Renderer::Initialize(HWND hwnd, uint32_t width, uint32_t height)
     if (!m_dynamicUpload.Init(m_device.Get(), size_t(512) * 1024 * 1024, kFrameCount))
         return false;
 
-    m_hudVertices.reserve(4096);
-    m_boxLineVertices.reserve(200 * 24);
-    m_frustumVertices.reserve(64);
+    // HUD shapes; the readouts are text, see UpdateHud
+    m_hudIds.crosshair = m_hud.Add(HudLayer::Static);
+    m_hudIds.toggles   = m_hud.Add(HudLayer::Static);
 
     return true;
 }
@@ -148,10 +210,20 @@ bool Renderer::Initialize(HWND hwnd, uint32_t width, uint32_t height)
 void Renderer::Shutdown()
 {
     if (m_cmdQueue) WaitForGPU();
+
+    // Tail latency of the run, for comparing builds; Reset so the destructor's Shutdown is a no-op
+    if (m_frameStats.Frames()) {
+        m_frameStats.WriteCsv("frame_stats.csv");
+        m_frameStats.WriteJson("frame_stats.json");
+        m_frameStats.Reset();
+    }
     if (m_fenceEvent) { CloseHandle(m_fenceEvent); m_fenceEvent = nullptr; }
 
     m_cbMapped = nullptr;
     m_cbUpload.Reset();
+    m_hudMapped = nullptr;
+    m_hudBuffer.Reset();
+    m_hudCapacity = 0;
     m_depth.Reset();
     for (auto& bb : m_backBuffers) bb.Reset();
     m_rtvHeap.Reset();
@@ -161,21 +233,20 @@ void Renderer::Shutdown()
     m_swapchain.Reset();
     m_cmdQueue.Reset();
 
-    m_psoShadow.Reset();
-    m_psoNoDepth.Reset();
-    m_psoLines.Reset();
-    m_pso.Reset();
+    for (auto& pass : m_pipelines)
+        for (auto& pso : pass) pso.Reset();
     m_rootSig.Reset();
 
-    m_vbLines.Reset();
     m_vbTris.Reset();
 
     m_dsvHeapShadow.Reset();
     m_srvHeap.Reset();
     m_shadowTex.Reset();
+    m_glyphTex.Reset();
 
     //m_transientUploads.clear();
 
+    m_shaderCache.Save();   // blobs of pipelines first built after startup
     m_device.Reset();
 }
 
@@ -285,10 +356,10 @@ bool Renderer::CreateDepth(uint32_t w, uint32_t h)
 // ============================================================================
 bool Renderer::CreateRootAndPSO()
 {
-    // Root: b0 (SceneCB), t0 (Shadow SRV), s0 (static sampler), s1 (comparison sampler)
+    // Root: b0 (SceneCB), t0 (Shadow SRV), t1 (glyph atlas), s0 (static sampler), s1 (comparison sampler)
     D3D12_DESCRIPTOR_RANGE range{};
     range.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-    range.NumDescriptors = 1;
+    range.NumDescriptors = 2;
     range.BaseShaderRegister = 0; // t0
     range.RegisterSpace = 0;
     range.OffsetInDescriptorsFromTableStart = 0;
@@ -301,7 +372,7 @@ bool Renderer::CreateRootAndPSO()
     params[0].Descriptor.RegisterSpace = 0;
     params[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
-    // t0 : ShadowMap SRV (descriptor table)
+    // t0, t1 : ShadowMap + glyph atlas SRVs (descriptor table)
     D3D12_ROOT_DESCRIPTOR_TABLE tbl{};
     tbl.NumDescriptorRanges = 1;
     tbl.pDescriptorRanges = &range;
@@ -343,125 +414,50 @@ bool Renderer::CreateRootAndPSO()
     ComPtr<ID3DBlob> sigBlob, errBlob;
     ThrowIfFailed(D3D12SerializeRootSignature(&rs, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob));
     ThrowIfFailed(m_device->CreateRootSignature(0, sigBlob->GetBufferPointer(), sigBlob->GetBufferSize(), IID_PPV_ARGS(&m_rootSig)));
-
-    // Compile shaders
-    UINT cf = 0;
+    m_rootSigKey = HashBytes128(sigBlob->GetBufferPointer(), sigBlob->GetBufferSize());
+
+    // Shaders: precompiled permutations from the archive, otherwise the content-hashed cache
+    // (compiled only on a miss). Pipelines are built per (pass, permutation); the ones the frame
+    // can ask for are built here so toggles never hitch.
+    const auto startupBegin = std::chrono::steady_clock::now();
+    m_shaderCache.Open("ShaderCache.bin");
+    m_shaderArchive.Open("Shaders\\Shaders.gesa");
+    for (uint32_t p = 0; p < kEngineProgramCount; p++)
+        m_archivePrograms[p] = m_shaderArchive.FindProgram(EngineShaderPrograms()[p].name);
+    m_shaderFlags = 0;
 #if defined(_DEBUG)
-    cf = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+    m_shaderFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
-    ComPtr<ID3DBlob> vsL, psL, gsL, vsT, psT;
-    CompileShader(L"Shaders\\Basic.hlsl", "VSMain", "vs_5_0", vsL, cf);
-    CompileShader(L"Shaders\\Basic.hlsl", "PSMain", "ps_5_0", psL, cf);
-    CompileShader(L"Shaders\\BasicLit.hlsl", "VSMainLit", "vs_5_0", vsT, cf);
-    CompileShader(L"Shaders\\BasicLit.hlsl", "PSMainLit", "ps_5_0", psT, cf);
-
-    // Input layouts
-    D3D12_INPUT_ELEMENT_DESC layoutL[] = {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "COLOR",    0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
-    D3D12_INPUT_ELEMENT_DESC layoutT[] = {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "COLOR",    0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
-
-    // Blending
-    D3D12_BLEND_DESC blend{};
-    D3D12_RENDER_TARGET_BLEND_DESC rtb{};
-    rtb.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
-    rtb.BlendEnable = FALSE;
-    blend.RenderTarget[0] = rtb;
-
-    // STANDARD Z (fix): write ALL, compare LESS_EQUAL
-    D3D12_DEPTH_STENCIL_DESC ds{};
-    ds.DepthEnable = TRUE;
-    ds.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
-    ds.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
-    ds.StencilEnable = FALSE;
-
-    // Lines: no depth writes
-    D3D12_DEPTH_STENCIL_DESC dsLines = ds;
-    dsLines.DepthEnable = FALSE;           
-    dsLines.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
-
-    // Triangles two-sided (avoid winding surprises)
-    D3D12_RASTERIZER_DESC rastTri{};
-    rastTri.FillMode = D3D12_FILL_MODE_SOLID;
-    rastTri.CullMode = D3D12_CULL_MODE_NONE;
-    rastTri.FrontCounterClockwise = FALSE;
-    rastTri.DepthClipEnable = TRUE;
-
-    // Lines: never cull (GS quads)
-    D3D12_RASTERIZER_DESC rastLines = rastTri;
-    rastLines.CullMode = D3D12_CULL_MODE_NONE;
-
-
-    // Shadow pass: standard Z, two-sided
-    D3D12_DEPTH_STENCIL_DESC dsShadow{};
-    dsShadow.DepthEnable = TRUE;
-    dsShadow.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
-    dsShadow.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
-    dsShadow.StencilEnable = FALSE;
-
-    D3D12_RASTERIZER_DESC rastShadow = rastTri;
-
-    // PSO: triangles (lit)
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC dT{};
-    dT.pRootSignature = m_rootSig.Get();
-    dT.VS = { vsT->GetBufferPointer(), vsT->GetBufferSize() };
-    dT.PS = { psT->GetBufferPointer(), psT->GetBufferSize() };
-    dT.BlendState = blend;
-    dT.RasterizerState = rastTri;
-    dT.DepthStencilState = ds;
-    dT.SampleMask = UINT_MAX;
-    dT.InputLayout = { layoutT, _countof(layoutT) };
-    dT.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    dT.NumRenderTargets = 1;
-    dT.RTVFormats[0] = m_backbufferFormat;
-    dT.DSVFormat = m_depthFormat;
-    dT.SampleDesc.Count = 1;
-    ThrowIfFailed(m_device->CreateGraphicsPipelineState(&dT, IID_PPV_ARGS(&m_pso)));
-
-    // PSO: lines (unlit, GS thick)
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC dL{};
-    dL.pRootSignature = m_rootSig.Get();
-    dL.VS = { vsL->GetBufferPointer(), vsL->GetBufferSize() };
-    dL.PS = { psL->GetBufferPointer(), psL->GetBufferSize() };
-    dL.BlendState = blend;
-    dL.RasterizerState = rastLines;
-    dL.DepthStencilState = dsLines;
-    dL.SampleMask = UINT_MAX;
-    dL.InputLayout = { layoutL, _countof(layoutL) };
-    dL.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
-    dL.NumRenderTargets = 1;
-    dL.RTVFormats[0] = m_backbufferFormat;
-    dL.DSVFormat = m_depthFormat;
-    dL.SampleDesc.Count = 1;
-    ThrowIfFailed(m_device->CreateGraphicsPipelineState(&dL, IID_PPV_ARGS(&m_psoLines)));
-
-    // PSO: HUD (unlit triangles, depth OFF)
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC dHUD = dL;
-    dHUD.GS = { nullptr, 0 };
-    dHUD.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    dHUD.DepthStencilState.DepthEnable = FALSE;
-    ThrowIfFailed(m_device->CreateGraphicsPipelineState(&dHUD, IID_PPV_ARGS(&m_psoNoDepth)));
-
-    // PSO: shadow (depth-only; standard Z)
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC dS{};
-    dS.pRootSignature = m_rootSig.Get();
-    dS.VS = { vsT->GetBufferPointer(), vsT->GetBufferSize() };
-    dS.PS = { nullptr, 0 }; // depth-only
-    dS.BlendState = blend;
-    dS.RasterizerState = rastShadow;
-    dS.DepthStencilState = dsShadow;
-    dS.SampleMask = UINT_MAX;
-    dS.InputLayout = { layoutT, _countof(layoutT) };
-    dS.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    dS.NumRenderTargets = 0;
-    dS.DSVFormat = DXGI_FORMAT_D32_FLOAT;
-    dS.SampleDesc.Count = 1;
-    ThrowIfFailed(m_device->CreateGraphicsPipelineState(&dS, IID_PPV_ARGS(&m_psoShadow)));
+    for (uint32_t kw : { kKeywordAmbient, kKeywordLighting | kKeywordAmbient, kKeywordLighting | kKeywordShadows | kKeywordAmbient }) {
+        GetPipeline(Pass::Lit, kw);
+        GetPipeline(Pass::Lit, kw | kKeywordInstanced);
+    }
+    GetPipeline(Pass::Lines);
+    GetPipeline(Pass::LinesDepth);
+    GetPipeline(Pass::Overlay);
+    GetPipeline(Pass::Shadow);
+    GetPipeline(Pass::Shadow, kKeywordInstanced);
+    GetPipeline(Pass::Text);
+    GetPipeline(Pass::Particles);
+
+    // New bytecode / driver blobs go to disk now
+    m_shaderCache.Save();
+    const ShaderCacheStats& sc = m_shaderCache.GetStats();
+    m_startup.pipelineMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+    char msg[256];
+    sprintf_s(msg, "Pipelines: %.1f ms (%s) | shaders %u archived, %u cached / %u compiled in %.1f ms, key %.2f ms | PSOs %u hit / %u built\n",
+             m_startup.pipelineMs, sc.misses || m_startup.psoMisses ? "cold" : "warm", m_startup.archiveHits, sc.hits, sc.misses,
+             sc.compileSeconds * 1000.0, sc.keySeconds * 1000.0, m_startup.psoHits, m_startup.psoMisses);
+    OutputDebugStringA(msg);
+
+    // Indirect draws (DrawCompacted)
+    D3D12_INDIRECT_ARGUMENT_DESC drawArg{};
+    drawArg.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW;
+    D3D12_COMMAND_SIGNATURE_DESC sigDesc{};
+    sigDesc.ByteStride = sizeof(D3D12_DRAW_ARGUMENTS);
+    sigDesc.NumArgumentDescs = 1;
+    sigDesc.pArgumentDescs = &drawArg;
+    ThrowIfFailed(m_device->CreateCommandSignature(&sigDesc, nullptr, IID_PPV_ARGS(&m_drawSignature)));
 
     // Constant buffer (upload)
     D3D12_HEAP_PROPERTIES hu{}; hu.Type = D3D12_HEAP_TYPE_UPLOAD;
@@ -476,52 +472,217 @@ bool Renderer::CreateRootAndPSO()
 }
 
 // ============================================================================
-// Geometry (build & upload VBs)
+// Shaders / pipelines
 // ============================================================================
-bool Renderer::CreateGeometry()
+std::span<const uint8_t> Renderer::LoadShader(uint32_t program, uint32_t keywords, ShaderStage stage)
 {
-    std::vector<VertexPC>  grid, axes; //cubeWire;
-    Geom::BuildGridXZ(100.0f, 1.0f, { 0.25f,0.25f,0.25f }, grid);
-    Geom::BuildAxes(1.5f, axes);
-    
+    const ShaderProgramDesc& prog = EngineShaderPrograms()[program];
+    const ShaderDesc desc = PermutationShaderDesc(prog, keywords & prog.keywords, stage, "Shaders", m_shaderFlags);
+
+    // The archive slot is used only if it was built from exactly these sources and flags
+    Hash128 key, archived;
+    if (m_shaderCache.ShaderKey(desc, s_shaderCompiler, key)) {
+        const std::span<const uint8_t> code = m_shaderArchive.Find(m_archivePrograms[program], keywords, stage, &archived);
+        if (!code.empty() && archived == key) { m_startup.archiveHits++; return code; }
+    }
 
-    std::vector<VertexPNC> cubeSolid;
-    Geom::BuildSolidCubePNC(0.5f, cubeSolid);
+    std::span<const uint8_t> code;
+    std::string errors;
+    if (!m_shaderCache.GetShader(desc, s_shaderCompiler, code, &errors)) {
+        std::string s = "Shader compile failed: ";
+        s += desc.entry; s += "/"; s += desc.target; s += " in "; s += desc.path;
+        s += " ["; s += ShaderKeywordString(keywords & prog.keywords); s += "]";
+        if (!errors.empty()) { s += "\n"; s += errors; }
+        throw std::runtime_error(s);
+    }
+    return code;
+}
 
-    // Pack line VB ranges
-    m_lines.clear();
+// Lit / overlay follow the light and shadow toggles; SHADOWS alone would sample a stale map
+uint32_t Renderer::LitKeywords() const
+{
+    uint32_t kw = kKeywordAmbient;
+    if (m_lightEnabled) kw |= kKeywordLighting;
+    if (m_lightEnabled && m_shadowsEnabled) kw |= kKeywordShadows;
+    return kw;
+}
 
-    m_lineRanges.gridStart = (UINT)m_lines.size();
-    m_lines.insert(m_lines.end(), grid.begin(), grid.end());
-    m_lineRanges.gridCount = (UINT)grid.size();
+D3D12_GRAPHICS_PIPELINE_STATE_DESC Renderer::PipelineDesc(Pass pass, uint32_t keywords)
+{
+    static const D3D12_INPUT_ELEMENT_DESC layoutPC[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR",    0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    };
+    static const D3D12_INPUT_ELEMENT_DESC layoutPNC[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR",    0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    };
+    // INSTANCED: layoutPNC plus the object-to-world rows per instance in slot 1
+    static const D3D12_INPUT_ELEMENT_DESC layoutPNCInstanced[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT,    0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR",    0, DXGI_FORMAT_R32G32B32_FLOAT,    0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "WORLD",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1,  0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "WORLD",    1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "WORLD",    2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "WORLD",    3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+    };
+    const D3D12_INPUT_LAYOUT_DESC lit = (keywords & kKeywordInstanced)
+        ? D3D12_INPUT_LAYOUT_DESC{ layoutPNCInstanced, _countof(layoutPNCInstanced) }
+        : D3D12_INPUT_LAYOUT_DESC{ layoutPNC, _countof(layoutPNC) };
+    // ParticleVertex, four per particle
+    static const D3D12_INPUT_ELEMENT_DESC layoutParticle[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR",    0, DXGI_FORMAT_R8G8B8A8_UNORM,  0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    };
+    // GlyphInstance, one per quad
+    static const D3D12_INPUT_ELEMENT_DESC layoutGlyph[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R16G16B16A16_UINT,  0, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "COLOR",    0, DXGI_FORMAT_R8G8B8A8_UNORM,     0, 24, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+    };
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC d{};
+    d.pRootSignature = m_rootSig.Get();
+    d.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    d.SampleMask = UINT_MAX;
+    d.SampleDesc.Count = 1;
+
+    // Triangles two-sided (avoid winding surprises); lines never culled either
+    d.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    d.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    d.RasterizerState.FrontCounterClockwise = FALSE;
+    d.RasterizerState.DepthClipEnable = TRUE;
+
+    // STANDARD Z: write ALL, compare LESS_EQUAL
+    d.DepthStencilState.DepthEnable = TRUE;
+    d.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+    d.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+    d.DepthStencilState.StencilEnable = FALSE;
+
+    d.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    d.NumRenderTargets = 1;
+    d.RTVFormats[0] = m_backbufferFormat;
+    d.DSVFormat = m_depthFormat;
+
+    std::span<const uint8_t> vs, ps;
+    switch (pass) {
+    case Pass::Lit:
+        vs = LoadShader(kProgramBasicLit, keywords, ShaderStage::Vertex);
+        ps = LoadShader(kProgramBasicLit, keywords, ShaderStage::Pixel);
+        d.InputLayout = lit;
+        break;
+    case Pass::Lines:      // unlit, no depth
+    case Pass::LinesDepth: // unlit, depth-tested but not written
+    case Pass::Overlay:    // HUD: unlit triangles, depth off
+        vs = LoadShader(kProgramBasic, keywords, ShaderStage::Vertex);
+        ps = LoadShader(kProgramBasic, keywords, ShaderStage::Pixel);
+        d.InputLayout = { layoutPC, _countof(layoutPC) };
+        d.DepthStencilState.DepthEnable = pass == Pass::LinesDepth;
+        d.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+        if (pass != Pass::Overlay) d.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
+        break;
+    case Pass::Shadow:     // depth-only, standard Z
+        vs = LoadShader(kProgramBasicLit, keywords, ShaderStage::Vertex);
+        d.InputLayout = lit;
+        d.NumRenderTargets = 0;
+        d.RTVFormats[0] = DXGI_FORMAT_UNKNOWN;
+        d.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+        break;
+    case Pass::Text:       // instanced glyph quads, alpha-blended over everything
+    case Pass::Particles:  // sorted billboards, alpha-blended, depth-tested but not written
+        vs = LoadShader(pass == Pass::Text ? kProgramText : kProgramParticle, keywords, ShaderStage::Vertex);
+        ps = LoadShader(pass == Pass::Text ? kProgramText : kProgramParticle, keywords, ShaderStage::Pixel);
+        d.InputLayout = pass == Pass::Text ? D3D12_INPUT_LAYOUT_DESC{ layoutGlyph, _countof(layoutGlyph) }
+                                           : D3D12_INPUT_LAYOUT_DESC{ layoutParticle, _countof(layoutParticle) };
+        d.DepthStencilState.DepthEnable = pass == Pass::Particles;
+        d.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+        {
+            D3D12_RENDER_TARGET_BLEND_DESC& bl = d.BlendState.RenderTarget[0];
+            bl.BlendEnable = TRUE;
+            bl.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+            bl.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+            bl.BlendOp = D3D12_BLEND_OP_ADD;
+            bl.SrcBlendAlpha = D3D12_BLEND_ONE;
+            bl.DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+            bl.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+        }
+        break;
+    default:
+        throw std::runtime_error("PipelineDesc: unknown pass");
+    }
+    d.VS = { vs.data(), vs.size() };
+    d.PS = { ps.data(), ps.size() };
+    return d;
+}
 
-    m_lineRanges.axesStart = (UINT)m_lines.size();
-    m_lines.insert(m_lines.end(), axes.begin(), axes.end());
-    m_lineRanges.axesCount = (UINT)axes.size();
+ID3D12PipelineState* Renderer::GetPipeline(Pass pass, uint32_t keywords)
+{
+    keywords &= (1u << kShaderKeywordCount) - 1;
+    ComPtr<ID3D12PipelineState>& pso = m_pipelines[uint32_t(pass)][keywords];
+    if (!pso) CreatePipeline(PipelineDesc(pass, keywords), pso);
+    return pso.Get();
+}
 
-    m_vertexCountLines = (UINT)m_lines.size();
+void Renderer::BindPipeline(ID3D12GraphicsCommandList* cmd, ID3D12PipelineState* pso)
+{
+    if (pso == m_boundPso) return;
+    cmd->SetPipelineState(pso);
+    m_boundPso = pso;
+    COUNTER_ADD(PsoSwitches, 1);
+}
+
+UINT Renderer::WriteConstants(const void* data, UINT bytes)
+{
+    const UINT off = (UINT)((m_cbHead + 255) & ~255u);
+    m_cbHead = off + bytes;
+    memcpy(m_cbMapped + off, data, bytes);
+    COUNTER_ADD(CbBytes, bytes);
+    return off;
+}
+
+void Renderer::CreatePipeline(D3D12_GRAPHICS_PIPELINE_STATE_DESC desc, ComPtr<ID3D12PipelineState>& out)
+{
+    const Hash128 key = PipelineKey(desc, m_rootSigKey);
+    const std::span<const uint8_t> cached = m_shaderCache.Find(key);
+    if (!cached.empty()) {
+        desc.CachedPSO = { cached.data(), cached.size() };
+        if (SUCCEEDED(m_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&out)))) { m_startup.psoHits++; return; }
+        desc.CachedPSO = {};   // driver / adapter changed: rebuild and replace the blob
+    }
+    ThrowIfFailed(m_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&out)));
+    m_startup.psoMisses++;
+    ComPtr<ID3DBlob> blob;
+    if (SUCCEEDED(out->GetCachedBlob(&blob))) m_shaderCache.Store(key, blob->GetBufferPointer(), blob->GetBufferSize());
+}
+
+// ============================================================================
+// Geometry (build & upload VBs)
+// ============================================================================
+bool Renderer::CreateGeometry()
+{
+    // Grid + ground are chunked around the camera and streamed per frame (see GroundGrid)
+    m_ground.SetDesc(ChunkRingDesc{});
+    m_ground.SetSpacing(1.0f);
+    m_ground.SetColors({ 0.25f,0.25f,0.25f }, { 0.5f, 0.5f, 0.5f });
+
+    // Optional: falls back to the flat ground when no terrain file ships with the build
+    LoadTerrain("Assets\\terrain.getr");
+
+    std::vector<VertexPNC> cubeSolid;
+    Geom::BuildSolidCubePNC(0.5f, cubeSolid);
 
     // Triangles (lit)
     m_trisLit = cubeSolid;
     m_vertexCountTris = (UINT)m_trisLit.size();
+    // Mesh 0 for indirect draws; proxies only use the cube so far
+    const DrawMesh cubeMesh{ m_vertexCountTris, 0 };
+    m_drawCompactor.Configure(kMaterialCount, { &cubeMesh, 1 });
 
-    // Create & upload line VB
-    const UINT vbL = (UINT)(m_lines.size() * sizeof(VertexPC));
+    // Create & upload tri VB (debug lines are immediate-mode, see DebugDraw)
     D3D12_HEAP_PROPERTIES hd{}; hd.Type = D3D12_HEAP_TYPE_DEFAULT;
-    D3D12_RESOURCE_DESC   rdL = MakeBufferDesc(vbL);
-
-    ThrowIfFailed(m_device->CreateCommittedResource(&hd, D3D12_HEAP_FLAG_NONE, &rdL,
-        D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&m_vbLines)));  
-
-    ComPtr<ID3D12Resource> uplL;
     D3D12_HEAP_PROPERTIES hu{}; hu.Type = D3D12_HEAP_TYPE_UPLOAD;
-    ThrowIfFailed(m_device->CreateCommittedResource(&hu, D3D12_HEAP_FLAG_NONE, &rdL,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uplL)));
-    void* mp = nullptr; ThrowIfFailed(uplL->Map(0, nullptr, &mp));
-    memcpy(mp, m_lines.data(), vbL);
-    uplL->Unmap(0, nullptr);
-
-    // Create & upload tri VB
     const UINT vbT = (UINT)(m_trisLit.size() * sizeof(VertexPNC));
     D3D12_RESOURCE_DESC rdT = MakeBufferDesc(vbT);
 
@@ -537,34 +698,25 @@ bool Renderer::CreateGeometry()
     memcpy(mp2, m_trisLit.data(), vbT);
     uplT->Unmap(0, nullptr);
 
-    // Copy & transition both VBs
+    // Copy & transition
     ThrowIfFailed(m_cmdAlloc[m_frameIndex]->Reset());
     ThrowIfFailed(m_cmdList->Reset(m_cmdAlloc[m_frameIndex].Get(), nullptr));
-    m_cmdList->CopyResource(m_vbLines.Get(), uplL.Get());
     m_cmdList->CopyResource(m_vbTris.Get(), uplT.Get());
 
-    D3D12_RESOURCE_BARRIER b[2]{};
-    for (int i = 0; i < 2; i++)
-    {
-        b[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        b[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        b[i].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-        b[i].Transition.StateAfter = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
-    }
-    b[0].Transition.pResource = m_vbLines.Get();
-    b[1].Transition.pResource = m_vbTris.Get();
+    D3D12_RESOURCE_BARRIER b{};
+    b.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    b.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    b.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+    b.Transition.StateAfter = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+    b.Transition.pResource = m_vbTris.Get();
 
-    m_cmdList->ResourceBarrier(2, b);
+    m_cmdList->ResourceBarrier(1, &b);
     ThrowIfFailed(m_cmdList->Close());
     ID3D12CommandList* lists[] = { m_cmdList.Get() };
     m_cmdQueue->ExecuteCommandLists(1, lists);
     WaitForGPU();
 
-    // VB views
-    m_vbLinesView.BufferLocation = m_vbLines->GetGPUVirtualAddress();
-    m_vbLinesView.StrideInBytes = sizeof(VertexPC);
-    m_vbLinesView.SizeInBytes = vbL;
-
+    // VB view
     m_vbTrisView.BufferLocation = m_vbTris->GetGPUVirtualAddress();
     m_vbTrisView.StrideInBytes = sizeof(VertexPNC);
     m_vbTrisView.SizeInBytes = vbT;
@@ -609,9 +761,9 @@ bool Renderer::CreateShadowMap(uint32_t size)
     dsv.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
     m_device->CreateDepthStencilView(m_shadowTex.Get(), &dsv, m_shadowDsv);
 
-    // SRV heap (shader-visible)
+    // SRV heap (shader-visible): t0 shadow map, t1 glyph atlas (CreateTextResources)
     D3D12_DESCRIPTOR_HEAP_DESC srvDesc{};
-    srvDesc.NumDescriptors = 1;
+    srvDesc.NumDescriptors = 2;
     srvDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
     srvDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
     ThrowIfFailed(m_device->CreateDescriptorHeap(&srvDesc, IID_PPV_ARGS(&m_srvHeap)));
@@ -629,6 +781,77 @@ bool Renderer::CreateShadowMap(uint32_t size)
     return true;
 }
 
+// ============================================================================
+// Text (glyph atlas texture + SRV)
+// ============================================================================
+bool Renderer::CreateTextResources()
+{
+    m_glyphAtlas.BakeBuiltin();
+    const UINT w = m_glyphAtlas.Width(), h = m_glyphAtlas.Height();
+
+    D3D12_RESOURCE_DESC tex{};
+    tex.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    tex.Width = w;
+    tex.Height = h;
+    tex.DepthOrArraySize = 1;
+    tex.MipLevels = 1;
+    tex.Format = DXGI_FORMAT_R8_UNORM;
+    tex.SampleDesc.Count = 1;
+
+    D3D12_HEAP_PROPERTIES hd{}; hd.Type = D3D12_HEAP_TYPE_DEFAULT;
+    ThrowIfFailed(m_device->CreateCommittedResource(&hd, D3D12_HEAP_FLAG_NONE, &tex,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&m_glyphTex)));
+
+    // Staging rows are 256-byte aligned
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT fp{};
+    UINT64 uploadBytes = 0;
+    m_device->GetCopyableFootprints(&tex, 0, 1, 0, &fp, nullptr, nullptr, &uploadBytes);
+
+    ComPtr<ID3D12Resource> upl;
+    D3D12_HEAP_PROPERTIES hu{}; hu.Type = D3D12_HEAP_TYPE_UPLOAD;
+    D3D12_RESOURCE_DESC rd = MakeBufferDesc(uploadBytes);
+    ThrowIfFailed(m_device->CreateCommittedResource(&hu, D3D12_HEAP_FLAG_NONE, &rd,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&upl)));
+    uint8_t* mp = nullptr; ThrowIfFailed(upl->Map(0, nullptr, reinterpret_cast<void**>(&mp)));
+    for (UINT y = 0; y < h; y++)
+        memcpy(mp + fp.Offset + size_t(y) * fp.Footprint.RowPitch, m_glyphAtlas.Pixels().data() + size_t(y) * w, w);
+    upl->Unmap(0, nullptr);
+
+    ThrowIfFailed(m_cmdAlloc[m_frameIndex]->Reset());
+    ThrowIfFailed(m_cmdList->Reset(m_cmdAlloc[m_frameIndex].Get(), nullptr));
+    D3D12_TEXTURE_COPY_LOCATION dst{}, src{};
+    dst.pResource = m_glyphTex.Get();
+    dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    dst.SubresourceIndex = 0;
+    src.pResource = upl.Get();
+    src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    src.PlacedFootprint = fp;
+    m_cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+
+    D3D12_RESOURCE_BARRIER b{};
+    b.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    b.Transition.pResource = m_glyphTex.Get();
+    b.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    b.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+    b.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    m_cmdList->ResourceBarrier(1, &b);
+    ThrowIfFailed(m_cmdList->Close());
+    ID3D12CommandList* lists[] = { m_cmdList.Get() };
+    m_cmdQueue->ExecuteCommandLists(1, lists);
+    WaitForGPU();
+
+    // Slot 1 of the shadow map's heap, so the one table binds both
+    D3D12_SHADER_RESOURCE_VIEW_DESC srv{};
+    srv.Format = DXGI_FORMAT_R8_UNORM;
+    srv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srv.Texture2D.MipLevels = 1;
+    D3D12_CPU_DESCRIPTOR_HANDLE slot = m_srvHeap->GetCPUDescriptorHandleForHeapStart();
+    slot.ptr += m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    m_device->CreateShaderResourceView(m_glyphTex.Get(), &srv, slot);
+    return true;
+}
+
 // ============================================================================
 // Resize / Sync
 // ============================================================================
@@ -697,8 +920,55 @@ void Renderer::MoveToNextFrame() {
 // ============================================================================
 void Renderer::OnKeyDown(WPARAM k)
 {
-    if (k < 256) m_keys[k] = true;
+    m_input.Push({ InputEventType::KeyDown, 0, uint16_t(k) });
+}
+
+void Renderer::OnKeyUp(WPARAM k)
+{
+    m_input.Push({ InputEventType::KeyUp, 0, uint16_t(k) });
+}
+
+void Renderer::OnMouseMove(int x, int y, bool lmb, bool rmb)
+{
+    m_input.Push({ InputEventType::MouseMove, uint8_t((lmb ? kInputLeft : 0) | (rmb ? kInputRight : 0)), 0, x, y });
+}
+
+void Renderer::OnMouseWheel(int delta)
+{
+    m_input.Push({ InputEventType::MouseWheel, 0, 0, delta });
+}
+
+void Renderer::StartInputRecording()
+{
+    m_input.StartRecording();
+}
+
+bool Renderer::StopInputRecording(const std::string& path)
+{
+    return m_input.StopRecording().Save(path);
+}
+
+bool Renderer::StartInputReplay(const std::string& path, float fixedDt)
+{
+    InputRecording rec;
+    if (!rec.Load(path)) return false;
+    m_input.StartReplay(std::move(rec), fixedDt);
+    return true;
+}
+
+void Renderer::ApplyInput(const InputEvent& e)
+{
+    switch (e.type) {
+    case InputEventType::KeyDown:    m_inputState.Apply(e); HandleKeyDown(e.key); break;
+    case InputEventType::KeyUp:      m_inputState.Apply(e); break;
+    // Handled against the previous position / buttons, then applied
+    case InputEventType::MouseMove:  HandleMouseMove(e.x, e.y, (e.buttons & kInputRight) != 0); m_inputState.Apply(e); break;
+    case InputEventType::MouseWheel: HandleMouseWheel(e.x); break;
+    }
+}
 
+void Renderer::HandleKeyDown(uint32_t k)
+{
     switch (k)
     {
     case 'F': ToggleFrustum(); break;
@@ -719,7 +989,7 @@ void Renderer::OnKeyDown(WPARAM k)
         // FIX: When switching TO ThirdPerson/Orbit, position camera properly behind player
         if ((oldMode == CameraMode::Free) && (m_camMode == CameraMode::ThirdPerson || m_camMode == CameraMode::Orbit))
         {
-            float3 target = (m_camMode == CameraMode::Orbit) ? m_orbitFocus : m_player.pos;
+            float3 target = (m_camMode == CameraMode::Orbit) ? m_orbitFocus : PlayerPosition();
             float dist = (m_camMode == CameraMode::Orbit) ? m_orbitDist : m_followDist;
 
             // Get camera's current forward direction
@@ -749,6 +1019,8 @@ void Renderer::OnKeyDown(WPARAM k)
     case 'B': m_shadowsEnabled = !m_shadowsEnabled; break;
     case 'T': m_showTestCube = !m_showTestCube; break;
     case 'R': m_showRandomCubes = !m_showRandomCubes; break;
+    case 'X': ToggleParticles(); break;
+    case 'P': m_showCounters = !m_showCounters; break;
     case 'N': m_lightAutoOrbit = !m_lightAutoOrbit; break;
 
     case 'J': m_lightYaw -= 0.08f; break;
@@ -756,29 +1028,37 @@ void Renderer::OnKeyDown(WPARAM k)
     case 'I': m_lightPitch += 0.08f; if (m_lightPitch > 1.35f) m_lightPitch = 1.35f; break;
     case 'K': m_lightPitch -= 0.08f; if (m_lightPitch < -1.35f) m_lightPitch = -1.35f; break;
 
+#if GE_PROFILE
+    // Last 300 frames of CPU scopes, for chrome://tracing or ui.perfetto.dev
+    case VK_F9: {
+        const bool ok = Profiler::ExportChromeTrace("profile.json", 300);
+        OutputDebugStringA(ok ? "Profiler: wrote profile.json\n" : "Profiler: could not write profile.json\n");
+    } break;
+#endif
+
     // --- Frustum offset controls ---
     case VK_HOME: { // up +Y
-        float step = (GetAsyncKeyState(VK_CONTROL) & 0x8000) ? m_frustumStep * 5.0f : m_frustumStep;
+        float step = m_inputState.Down(VK_CONTROL) ? m_frustumStep * 5.0f : m_frustumStep;
         m_frustumOffset.y += step;
     } break;
 
     case VK_END: {  // down -Y
-        float step = (GetAsyncKeyState(VK_CONTROL) & 0x8000) ? m_frustumStep * 5.0f : m_frustumStep;
+        float step = m_inputState.Down(VK_CONTROL) ? m_frustumStep * 5.0f : m_frustumStep;
         m_frustumOffset.y -= step;
     } break;
 
     case VK_INSERT: { // +X (right)
-        float step = (GetAsyncKeyState(VK_CONTROL) & 0x8000) ? m_frustumStep * 5.0f : m_frustumStep;
+        float step = m_inputState.Down(VK_CONTROL) ? m_frustumStep * 5.0f : m_frustumStep;
         m_frustumOffset.x += step;
     } break;
 
     case VK_DELETE: { // -X (left)
-        float step = (GetAsyncKeyState(VK_CONTROL) & 0x8000) ? m_frustumStep * 5.0f : m_frustumStep;
+        float step = m_inputState.Down(VK_CONTROL) ? m_frustumStep * 5.0f : m_frustumStep;
         m_frustumOffset.x -= step;
     } break;
 
     case 'M': { // -Z backward
-        float step = (GetAsyncKeyState(VK_CONTROL) & 0x8000) ? m_frustumStep * 5.0f : m_frustumStep;
+        float step = m_inputState.Down(VK_CONTROL) ? m_frustumStep * 5.0f : m_frustumStep;
         m_frustumOffset.z -= step;
     } break;
 
@@ -790,23 +1070,19 @@ void Renderer::OnKeyDown(WPARAM k)
     }
 }
 
-void Renderer::OnKeyUp(WPARAM k) { if (k < 256) m_keys[k] = false; }
-
-void Renderer::OnMouseMove(int x, int y, bool /*lmb*/, bool rmb)
+void Renderer::HandleMouseMove(int x, int y, bool rmb)
 {
-    if (rmb && m_rmb)
+    if (rmb && (m_inputState.buttons & kInputRight))
     {
-        float dx = float(x - m_lastMouseX);
-        float dy = float(y - m_lastMouseY);
+        float dx = float(x - m_inputState.mouseX);
+        float dy = float(y - m_inputState.mouseY);
         float mag = std::sqrt(dx * dx + dy * dy);
         float gain = 1.0f + m_mouseAccel * mag;
         m_camera.YawPitch(dx * m_mouseSens * gain, dy * m_mouseSens * gain);
     }
-    m_rmb = rmb;
-    m_lastMouseX = x; m_lastMouseY = y;
 }
 
-void Renderer::OnMouseWheel(int delta)
+void Renderer::HandleMouseWheel(int delta)
 {
     float fov = m_camera.GetFovY();
     float step = (delta > 0) ? -to_radians(2.0f) : to_radians(2.0f);
@@ -818,60 +1094,100 @@ void Renderer::OnMouseWheel(int delta)
 
 void Renderer::MovePlayer(float dx, float dy, float dz)
 {
-    m_player.pos.x += dx; m_player.pos.y += dy; m_player.pos.z += dz;
+    if (Transform* t = m_scene.Get<Transform>(m_player)) {
+        t->position.x += dx; t->position.y += dy; t->position.z += dz;
+    }
+}
+
+float3 Renderer::PlayerPosition() const
+{
+    const Transform* t = m_scene.Get<Transform>(m_player);
+    return t ? t->position : float3{ 0, 0, 0 };
+}
+
+bool Renderer::LoadTerrain(const std::string& path)
+{
+    if (!m_terrain.Open(path)) return false;
+    m_terrain.SetStreamer(&m_streamer);
+
+    // Centre the map on the world origin; LOD 0 covers 4 leaves, each level doubles
+    const TerrainFileHeader& h = m_terrain.GetHeader();
+    const float half = float(h.size) * h.sampleSpacing * 0.5f;
+    m_terrain.SetOrigin({ -half, 0.0f, -half });
+    m_terrain.SetLod(16, float(h.leafSize) * h.sampleSpacing * 4.0f);
+    m_terrain.SetTileBudget(64);
+    return true;
 }
 
 void Renderer::Update(float dt)
 {
-    float s = kBaseMoveSpeed * ((GetAsyncKeyState(VK_LSHIFT) & 0x8000) ? kSprintMul : 1.0f);
+    PROFILE_SCOPE("Renderer::Update");
+    FrameStats::Scope stat(m_frameStats, m_stage.update);
+    m_frameStats.RecordFrame(dt);
+
+    // This frame's input; when replaying, the recorded events and dt replace the live ones
+    std::span<const InputEvent> events;
+    dt = m_input.BeginFrame(dt, events);
+    for (const InputEvent& e : events) ApplyInput(e);
+
+    float s = kBaseMoveSpeed * (m_inputState.Down(VK_SHIFT) ? kSprintMul : 1.0f);
 
-    if (m_keys['W']) m_camera.TranslateRelative(0, 0, +s * dt);
-    if (m_keys['S']) m_camera.TranslateRelative(0, 0, -s * dt);
-    if (m_keys['A']) m_camera.TranslateRelative(-s * dt, 0, 0);
-    if (m_keys['D']) m_camera.TranslateRelative(+s * dt, 0, 0);
-    if (m_keys['Q']) m_camera.TranslateRelative(0, -s * dt, 0);
-    if (m_keys['E']) m_camera.TranslateRelative(0, +s * dt, 0);
+    if (m_inputState.Down('W')) m_camera.TranslateRelative(0, 0, +s * dt);
+    if (m_inputState.Down('S')) m_camera.TranslateRelative(0, 0, -s * dt);
+    if (m_inputState.Down('A')) m_camera.TranslateRelative(-s * dt, 0, 0);
+    if (m_inputState.Down('D')) m_camera.TranslateRelative(+s * dt, 0, 0);
+    if (m_inputState.Down('Q')) m_camera.TranslateRelative(0, -s * dt, 0);
+    if (m_inputState.Down('E')) m_camera.TranslateRelative(0, +s * dt, 0);
 
     float p = 3.0f;
-    if (m_keys[VK_LEFT])  MovePlayer(-p * dt, 0, 0);
-    if (m_keys[VK_RIGHT]) MovePlayer(+p * dt, 0, 0);
-    if (m_keys[VK_UP])    MovePlayer(0, 0, +p * dt);
-    if (m_keys[VK_DOWN])  MovePlayer(0, 0, -p * dt);
-    if (m_keys[VK_PRIOR]) MovePlayer(0, +p * dt, 0);
-    if (m_keys[VK_NEXT])  MovePlayer(0, -p * dt, 0);
+    if (m_inputState.Down(VK_LEFT))  MovePlayer(-p * dt, 0, 0);
+    if (m_inputState.Down(VK_RIGHT)) MovePlayer(+p * dt, 0, 0);
+    if (m_inputState.Down(VK_UP))    MovePlayer(0, 0, +p * dt);
+    if (m_inputState.Down(VK_DOWN))  MovePlayer(0, 0, -p * dt);
+    if (m_inputState.Down(VK_PRIOR)) MovePlayer(0, +p * dt, 0);
+    if (m_inputState.Down(VK_NEXT))  MovePlayer(0, -p * dt, 0);
 
     if (m_camMode != CameraMode::Free)
     {
-        float3 target = (m_camMode == CameraMode::Orbit) ? m_orbitFocus : m_player.pos;
+        float3 target = (m_camMode == CameraMode::Orbit) ? m_orbitFocus : PlayerPosition();
         float  dist = (m_camMode == CameraMode::Orbit) ? m_orbitDist : m_followDist;
         float3 camP = target + float3{ 0, 1.2f, -dist };
         m_camera.SetPosition(camP);
 
         // Update player camera position
-        m_playerCam.SetPosition(m_player.pos + m_frustumOffset);
+        m_playerCam.SetPosition(PlayerPosition() + m_frustumOffset);
     }
 
     UpdateLight(dt);
 
-    m_lastFrameMs = dt * 1000.0f;
-    m_frameTimes[m_ftHead] = m_lastFrameMs;
-    m_ftHead = (m_ftHead + 1) % (int)m_frameTimes.size();
+    // Particles spawn at a fixed rate; RenderParticles sorts and draws them
+    if (m_showParticles) {
+        m_particleSpawn += kParticleRate * dt;
+        const uint32_t spawn = uint32_t(m_particleSpawn);
+        m_particleSpawn -= float(spawn);
+        m_particles.Emit(m_fountain, spawn);
+        m_particles.Simulate(dt);
+    }
 
+    m_debugDt += dt;   // ages timed DebugDraw items at the next Collect
     m_timeSinceTitle += dt;
-    m_fpsAccum += dt; m_fpsFrames++;
     if (m_timeSinceTitle > 0.5f) { UpdateTitleFPS(m_hwnd); m_timeSinceTitle = 0.0f; }
+
+    // This frame's proxy changes (ours and the game's) go to the render side
+    m_renderQueue.Submit();
 }
 
 void Renderer::UpdateTitleFPS(HWND hwnd)
 {
-    float fps = (m_fpsFrames / (m_fpsAccum > 0 ? m_fpsAccum : 1));
+    // Percentiles over the last half second rather than a plain average, so hitches show up
+    const StageSummary frame = m_frameStats.WindowSummary(FrameStats::kFrameStage);
+    const float fps = frame.meanMs > 0.0 ? float(1000.0 / frame.meanMs) : 0.0f;
     m_lastFPS = fps;
-    m_fpsAccum = 0.0f; m_fpsFrames = 0;
 
-    wchar_t t[256];
+    wchar_t t[320];
     swprintf_s(t, _countof(t),
-        L"DX12 Engine Prototype | FPS: %.1f | VSync: %s | Light %s Auto:%s | Random:%s Test:%s | FrustumOff (%.2f, %.2f, %.2f)",
-        fps,
+        L"DX12 Engine Prototype | FPS: %.1f | p50 %.2f p99 %.2f max %.2f ms | stutters %llu | VSync: %s | Light %s Auto:%s | Random:%s Test:%s | FrustumOff (%.2f, %.2f, %.2f)",
+        fps, frame.p50Ms, frame.p99Ms, frame.maxMs, (unsigned long long)m_frameStats.WindowStutters(),
         m_vsync ? L"On" : L"Off",
         m_lightEnabled ? L"On" : L"Off",
         m_lightAutoOrbit ? L"On" : L"Off",
@@ -880,6 +1196,7 @@ void Renderer::UpdateTitleFPS(HWND hwnd)
         m_frustumOffset.x, m_frustumOffset.y, m_frustumOffset.z);
 
     SetWindowTextW(hwnd, t);
+    m_frameStats.ResetWindow();
 }
 
 // ============================================================================
@@ -900,11 +1217,13 @@ void Renderer::UpdateLight(float dt)
     }
 
     float3 dir = ComputeLightDir();
-    float3 target = m_testCubePos;
+    const Transform* cube = m_scene.Get<Transform>(m_testCube);
+    float3 target = cube ? cube->position : float3{ 0, 0, 0 };
     float3 up{ 0,1,0 };
     float  dist = 30.0f;
     float3 pos = target - dir * dist;
 
+    m_lightPos = pos;
     m_lightView = look_at(pos, target, up);
 
     // INCREASE ORTHO BOUNDS FOR BETTER COVERAGE
@@ -912,11 +1231,47 @@ void Renderer::UpdateLight(float dt)
     m_lightProj = ortho_off_center(-orthoHalf, +orthoHalf, -orthoHalf, +orthoHalf, 1.0f, 200.0f);
 }
 
+// ============================================================================
+// Culling: every view of the frame in one walk of the render scene
+// ============================================================================
+void Renderer::CullViews()
+{
+    PROFILE_SCOPE("Renderer::CullViews");
+    FrameStats::Scope stat(m_frameStats, m_stage.cull);
+
+    m_views[kViewMain] = MakeCullView(m_camera.GetCameraToWorld(), m_camera.GetFovY(), m_camera.GetAspect(),
+                                      m_camera.GetNearZ(), m_camera.GetFarZ());
+
+    // Player frustum: player position + user-controlled offset, near/far from the cull override
+    m_playerCam.SetPosition(PlayerPosition() + m_frustumOffset);
+    const float nearZ = m_useCullOverride ? m_cullNear : m_playerCam.GetNearZ();
+    float farZ = m_useCullOverride ? m_cullFar : m_playerCam.GetFarZ();
+    if (farZ <= nearZ + 0.001f) farZ = nearZ + 0.001f;
+    m_views[kViewPlayer] = MakeCullView(m_playerCam.GetCameraToWorld(), m_playerCam.GetFovY(), m_playerCam.GetAspect(),
+                                        nearZ, farZ, &m_playerFrustumPts);
+
+    // Light: the shadow map's orthographic volume
+    m_views[kViewLight] = MakeCullViewFromClip(m_mul(m_lightView, m_lightProj), m_lightPos);
+
+    // A view whose pass is off asks for no kind and costs the walk nothing
+    const uint32_t kinds[kViewCount] = {
+        m_showTestCube ? (uint32_t)kProxyMesh : 0u,
+        m_showRandomCubes ? (uint32_t)kProxyDebugBox : 0u,
+        (m_shadowsEnabled && m_lightEnabled) ? (uint32_t)kProxyMesh : 0u,
+    };
+    m_viewSet.Set(m_views);
+    COUNTER_ADD(BoxesTested, m_renderScene.CullViews(m_viewSet, kinds, m_visibility));
+    if (m_showRandomCubes)
+        COUNTER_ADD(BoxesCulled, m_renderScene.ProxyCount(kProxyDebugBox) - m_visibility.Count(kViewPlayer));
+}
+
 // ============================================================================
 // Record world draws
 // ============================================================================
 void Renderer::RecordDrawCalls(ID3D12GraphicsCommandList* cmd)
 {
+    PROFILE_SCOPE("Renderer::RecordDrawCalls");
+    FrameStats::Scope stat(m_frameStats, m_stage.scene);
     auto rtv = m_rtvHeap->GetCPUDescriptorHandleForHeapStart(); rtv.ptr += SIZE_T(m_rtvDescriptorSize) * SIZE_T(m_frameIndex);
     auto dsv = m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
 
@@ -944,9 +1299,7 @@ void Renderer::RecordDrawCalls(ID3D12GraphicsCommandList* cmd)
 
             WriteCB(MVP, cb, lightDir, 0.0f, 0.0f, 0.0f, &lightMVP);  
 
-            UINT off = (UINT)((m_cbHead + 255) & ~255u);
-            m_cbHead = off + sizeof(SceneCB);
-            memcpy(m_cbMapped + off, &cb, sizeof(SceneCB));
+            const UINT off = WriteConstants(&cb, sizeof(SceneCB));
             cmd->SetGraphicsRootConstantBufferView(0, m_cbUpload->GetGPUVirtualAddress() + off);
         };
     auto bindMVP_Lines = [&](const float4x4& M, float thicknessPx)
@@ -960,318 +1313,309 @@ void Renderer::RecordDrawCalls(ID3D12GraphicsCommandList* cmd)
 
             WriteCB(MVP, cb, m_lightEnabled ? L : float3{ 0,0,0 }, (float)m_width, (float)m_height, thicknessPx, &lightMVP);
 
-            UINT off = (UINT)((m_cbHead + 255) & ~255u);
-            m_cbHead = off + sizeof(SceneCB);
-            memcpy(m_cbMapped + off, &cb, sizeof(SceneCB));
+            const UINT off = WriteConstants(&cb, sizeof(SceneCB));
             cmd->SetGraphicsRootConstantBufferView(0, m_cbUpload->GetGPUVirtualAddress() + off);
         };
 
-    // Frustum from player
-    // Frustum camera = player position + user-controlled offset
-    m_playerCam.SetPosition(m_player.pos + m_frustumOffset);
-    // Build frustum using render camera's orientation and player position + offset
-    float4x4 RCW = m_camera.GetCameraToWorld();
-    float3 fwd = { RCW[2].x, RCW[2].y, RCW[2].z };
-    float3 up = { RCW[1].x, RCW[1].y, RCW[1].z };
-    float4x4 FrCW = camera_to_world(m_player.pos + m_frustumOffset, fwd, up);
+    // Main-view chunk selection (ground + grid share the visible set); the view comes from CullViews
+    const CullView& mainView = m_views[kViewMain];
+    m_ground.Update(m_camera.GetPosition(), &mainView);
 
+    // TERRAIN (CDLOD: quadtree selection, tiles streamed on demand, morphed patches)
+    if (m_terrain.IsOpen()) {
+        const float3 eye = m_camera.GetPosition();
+        m_streamer.PumpUploads(kStreamUploadBudget);
+        m_terrain.Select(eye, &mainView);
+        m_terrain.StreamTiles(eye, 16);
+    }
 
-    struct Plane { float3 n{}; float d{}; };
-    struct Fr6 { Plane p[6]; float3 c[8]; };
-
-    auto cross3 = [](const float3& a, const float3& b)->float3 {
-        return float3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
-        };
-    auto normalize3 = [](const float3& v)->float3 {
-        float L = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-        if (L <= 0.0f) return float3{ 0,0,0 };
-        float inv = 1.0f / L; return float3{ v.x * inv, v.y * inv, v.z * inv };
-        };
-    auto makePlane = [&](const float3& a, const float3& b, const float3& c)->Plane {
-        float3 n = normalize3(cross3(b - a, c - a));
-        float d = -(n.x * a.x + n.y * a.y + n.z * a.z);
-        return { n,d };
-        };
-
-    auto buildWorldFrustum = [&](Fr6& F, const float4x4& CW, float fovY, float aspect, float zn, float zf)
-        {
-            const float3 right{ CW[0].x, CW[0].y, CW[0].z };
-            const float3 up{ CW[1].x, CW[1].y, CW[1].z };
-            const float3 fwd{ CW[2].x, CW[2].y, CW[2].z };
-            const float3 pos{ CW[3].x, CW[3].y, CW[3].z };
-
-            const float t = std::tan(fovY * 0.5f);
-            const float nh = t * zn, nw = nh * aspect;
-            const float fh = t * zf, fw = fh * aspect;
-
-            const float3 nc = pos + fwd * zn;
-            const float3 fc = pos + fwd * zf;
-
-            const float3 ntl = nc + up * nh - right * nw;
-            const float3 ntr = nc + up * nh + right * nw;
-            const float3 nbl = nc - up * nh - right * nw;
-            const float3 nbr = nc - up * nh + right * nw;
-            const float3 ftl = fc + up * fh - right * fw;
-            const float3 ftr = fc + up * fh + right * fw;
-            const float3 fbl = fc - up * fh - right * fw;
-            const float3 fbr = fc - up * fh + right * fw;
-
-            F.c[0] = ntl; F.c[1] = ntr; F.c[2] = nbl; F.c[3] = nbr;
-            F.c[4] = ftl; F.c[5] = ftr; F.c[6] = fbl; F.c[7] = fbr;
-
-            F.p[0] = makePlane(nbl, ntl, ftl); // Left
-            F.p[1] = makePlane(nbr, fbr, ftr); // Right
-            F.p[2] = makePlane(nbl, fbl, fbr); // Bottom
-            F.p[3] = makePlane(ntl, ftl, ftr); // Top
-            F.p[4] = makePlane(ntl, ntr, nbr); // Near
-            F.p[5] = makePlane(ftr, ftl, fbl); // Far
-
-            const float3 ctr{
-                (ntl.x + ntr.x + nbl.x + nbr.x + ftl.x + ftr.x + fbl.x + fbr.x) * (1.0f / 8.0f),
-                (ntl.y + ntr.y + nbl.y + nbr.y + ftl.y + ftr.y + fbl.y + fbr.y) * (1.0f / 8.0f),
-                (ntl.z + ntr.z + nbl.z + nbr.z + ftl.z + ftr.z + fbl.z + fbr.z) * (1.0f / 8.0f)
-            };
-            for (int i = 0; i < 6; i++) {
-                float s = F.p[i].n.x * ctr.x + F.p[i].n.y * ctr.y + F.p[i].n.z * ctr.z + F.p[i].d;
-                if (s > 0.0f) { F.p[i].n = float3{ -F.p[i].n.x,-F.p[i].n.y,-F.p[i].n.z }; F.p[i].d = -F.p[i].d; }
-            }
-    };
+    if (m_terrain.IsOpen() && m_terrain.GetVertexCount()) {
+        const float3 eye = m_camera.GetPosition();
+        const UINT bytes = m_terrain.GetVertexCount() * (UINT)sizeof(VertexPNC);
+        auto alloc = m_dynamicUpload.Allocate(bytes, 256);
+        m_terrain.WriteVertices(reinterpret_cast<VertexPNC*>(alloc.cpuPtr), eye);
+
+        // Both patch topologies are tiny (<= 3 KB); every node reuses them via BaseVertexLocation
+        D3D12_INDEX_BUFFER_VIEW ib[2]{};
+        for (int q = 0; q < 2; q++) {
+            const std::vector<uint16_t>& idx = m_terrain.GetPatchIndices(q == 1);
+            const UINT ibBytes = (UINT)(idx.size() * sizeof(uint16_t));
+            auto ia = m_dynamicUpload.Allocate(ibBytes, 256);
+            memcpy(ia.cpuPtr, idx.data(), ibBytes);
+            ib[q].BufferLocation = ia.gpuAddress;
+            ib[q].SizeInBytes = ibBytes;
+            ib[q].Format = DXGI_FORMAT_R16_UINT;
+        }
 
-    auto aabbIntersectsFrustum = [&](const AABB_t& b, const Fr6& F)->bool
-        {
-            const float3 c = b.center, e = b.extents;
-            for (int i = 0; i < 6; i++) {
-                const float3 n = F.p[i].n;
-                const float  s = n.x * c.x + n.y * c.y + n.z * c.z + F.p[i].d;
-                const float  r = std::fabs(n.x) * e.x + std::fabs(n.y) * e.y + std::fabs(n.z) * e.z;
-                if (s > r) return false;
-            }
-            return true;
-    };
+        D3D12_VERTEX_BUFFER_VIEW vb{};
+        vb.BufferLocation = alloc.gpuAddress;
+        vb.StrideInBytes = sizeof(VertexPNC);
+        vb.SizeInBytes = bytes;
 
-    float nearZ = m_useCullOverride ? m_cullNear : m_playerCam.GetNearZ();
-    float farZ = m_useCullOverride ? m_cullFar : m_playerCam.GetFarZ();
-    if (farZ <= nearZ + 0.001f) farZ = nearZ + 0.001f;
+        BindPipeline(cmd, GetPipeline(Pass::Lit, LitKeywords()));
+        cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        cmd->IASetVertexBuffers(0, 1, &vb);
 
-    Fr6 F{};
-    buildWorldFrustum(F, m_playerCam.GetCameraToWorld(), m_playerCam.GetFovY(), m_playerCam.GetAspect(), nearZ, farZ);
+        float3 L = ComputeLightDir();
+        bindMVP(m_identity(), m_lightEnabled ? L : float3{ 0,0,0 });
 
+        const uint32_t fullQuads = (uint32_t)(m_terrain.GetPatchIndices(false).size() / 6);
+        int bound = -1;
+        for (const TerrainNode& n : m_terrain.GetNodes()) {
+            const int q = (n.quads * n.quads == fullQuads) ? 0 : 1;
+            if (q != bound) { cmd->IASetIndexBuffer(&ib[q]); bound = q; }
+            cmd->DrawIndexedInstanced(ib[q].SizeInBytes / (UINT)sizeof(uint16_t), 1, 0, (INT)n.firstVertex, 0);
+        }
+        COUNTER_ADD(DrawCalls, m_terrain.GetNodes().size());
+    }
     // SOLID GROUND (white) for shadows
-    {
-        struct VPNC { float3 p; float3 n; float3 c; };
-        const float3 groundCol{ 0.5f, 0.5f, 0.5f };
-        VPNC ground[6] = {
-            {{-50,0,-50},{0,1,0},groundCol},
-            {{ 50,0,-50},{0,1,0},groundCol},
-            {{ 50,0, 50},{0,1,0},groundCol},
-            {{-50,0,-50},{0,1,0},groundCol},
-            {{ 50,0, 50},{0,1,0},groundCol},
-            {{-50,0, 50},{0,1,0},groundCol},
-        };
-
-        const UINT bytes = sizeof(ground);
+    else if (m_ground.GetGroundVertexCount()) {
+        const UINT bytes = m_ground.GetGroundVertexCount() * (UINT)sizeof(VertexPNC);
         auto alloc = m_dynamicUpload.Allocate(bytes, 256);
-        memcpy(alloc.cpuPtr, ground, bytes);
+        m_ground.WriteGround(reinterpret_cast<VertexPNC*>(alloc.cpuPtr));
 
         D3D12_VERTEX_BUFFER_VIEW vb{};
         vb.BufferLocation = alloc.gpuAddress;
-        vb.StrideInBytes = sizeof(VPNC);
+        vb.StrideInBytes = sizeof(VertexPNC);
         vb.SizeInBytes = bytes;
 
-        cmd->SetPipelineState(m_pso.Get());
+        BindPipeline(cmd, GetPipeline(Pass::Lit, LitKeywords()));
         cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         cmd->IASetVertexBuffers(0, 1, &vb);
 
         float3 L = ComputeLightDir();
         bindMVP(m_identity(), m_lightEnabled ? L : float3{ 0,0,0 });
 
-        cmd->DrawInstanced(6, 1, 0, 0);
+        cmd->DrawInstanced(m_ground.GetGroundVertexCount(), 1, 0, 0);
+        COUNTER_ADD(DrawCalls, 1);
     }
 
-    // GRID
-    if (m_showGrid) {
-        cmd->SetPipelineState(m_psoLines.Get());
+    // GRID (visible chunks only, density by distance)
+    if (m_showGrid && m_ground.GetLineVertexCount()) {
+        const UINT bytes = m_ground.GetLineVertexCount() * (UINT)sizeof(VertexPC);
+        auto alloc = m_dynamicUpload.Allocate(bytes, 256);
+        m_ground.WriteLines(reinterpret_cast<VertexPC*>(alloc.cpuPtr));
+
+        D3D12_VERTEX_BUFFER_VIEW vb{};
+        vb.BufferLocation = alloc.gpuAddress;
+        vb.StrideInBytes = sizeof(VertexPC);
+        vb.SizeInBytes = bytes;
+
+        BindPipeline(cmd, GetPipeline(Pass::Lines));
         cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-        cmd->IASetVertexBuffers(0, 1, &m_vbLinesView);
+        cmd->IASetVertexBuffers(0, 1, &vb);
         bindMVP_Lines(m_identity(),1.00f);
-        cmd->DrawInstanced(m_lineRanges.gridCount, 1, m_lineRanges.gridStart, 0);
+        cmd->DrawInstanced(m_ground.GetLineVertexCount(), 1, 0, 0);
+        COUNTER_ADD(DrawCalls, 1);
     }
 
-    // RANDOMIZED BOXES (culled)
-    if (m_showRandomCubes && !m_debugBoxes.empty()) {
-        m_boxLineVertices.clear();
-
-        auto addBox = [&](const AABB_t& b, const float3& col) {
-            const float3 c = b.center, e = b.extents;
-            const float3 p[8] = {
-                {c.x - e.x,c.y - e.y,c.z - e.z},{c.x + e.x,c.y - e.y,c.z - e.z},
-                {c.x - e.x,c.y + e.y,c.z - e.z},{c.x + e.x,c.y + e.y,c.z - e.z},
-                {c.x - e.x,c.y - e.y,c.z + e.z},{c.x + e.x,c.y - e.y,c.z + e.z},
-                {c.x - e.x,c.y + e.y,c.z + e.z},{c.x + e.x,c.y + e.y,c.z + e.z}
-            };
-            static const int E[12][2] = { {0,1},{1,3},{3,2},{2,0},{4,5},{5,7},{7,6},{6,4},{0,4},{1,5},{3,7},{2,6} };
-            for (int i = 0; i < 12; i++) {
-                m_boxLineVertices.push_back({ p[E[i][0]], col });
-                m_boxLineVertices.push_back({ p[E[i][1]], col });
-            }
-            };
-
-        for (const auto& bx : m_debugBoxes)
-            if (aabbIntersectsFrustum(bx.aabb, F))
-                addBox(bx.aabb, bx.color);
-
-        if (!m_boxLineVertices.empty()) {
-            const UINT bytes = (UINT)m_boxLineVertices.size() * (UINT)sizeof(VertexPC);
-            auto alloc = m_dynamicUpload.Allocate(bytes, 256);
-            memcpy(alloc.cpuPtr, m_boxLineVertices.data(), bytes);
-
-            D3D12_VERTEX_BUFFER_VIEW v{};
-            v.BufferLocation = alloc.gpuAddress;
-            v.StrideInBytes = sizeof(VertexPC);
-            v.SizeInBytes = bytes;
-
-            cmd->SetPipelineState(m_psoLines.Get());
-            cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-            cmd->IASetVertexBuffers(0, 1, &v);
-            bindMVP_Lines(m_identity(), 2.5f);
-            cmd->DrawInstanced((UINT)m_boxLineVertices.size(), 1, 0, 0);
-        }
+    // RANDOMIZED BOXES (culled against the player frustum in CullViews)
+    if (m_showRandomCubes) {
+        m_visibility.ForEach(kViewPlayer, [&](RenderProxyId id) {
+            DebugDraw::Box(m_renderScene.WorldBounds(id), m_renderScene.Color(id));
+        });
     }
 
     // PLAYER AXES
-    {
-        cmd->SetPipelineState(m_psoLines.Get());
-        cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-        cmd->IASetVertexBuffers(0, 1, &m_vbLinesView);
-        float4x4 Mplayer = m_translation(m_player.pos);
-        bindMVP_Lines(Mplayer, 2.5f);
-        cmd->DrawInstanced(m_lineRanges.axesCount, 1, m_lineRanges.axesStart, 0);
-    }
+    DebugDraw::Axes(m_translation(PlayerPosition()), 1.5f, DebugDepth::Overlay);
 
-    // TEST CUBE (lit)
+    // MESH PROXIES (lit, culled against the main view): the test cube and whatever the game spawned,
+    // compacted into one ExecuteIndirect per material
     if (m_showTestCube) {
-        cmd->SetPipelineState(m_pso.Get());
+        m_drawItems.clear();
+        m_visibility.ForEach(kViewMain, [&](RenderProxyId id) {
+            m_drawItems.push_back({ m_renderScene.Material(id), m_renderScene.Mesh(id), id });
+        });
+        m_drawCompactor.Build(m_drawItems, &m_jobs);
+
         cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         cmd->IASetVertexBuffers(0, 1, &m_vbTrisView);
-
-        float4x4 M = m_trs(m_testCubePos, q_from_axis_angle(float3{ 0,1,0 }, m_testCubeYaw), m_testCubeScale);
-        float3 L = ComputeLightDir();
-        bindMVP(M, m_lightEnabled ? L : float3{ 0,0,0 });
-        cmd->DrawInstanced(m_vertexCountTris, 1, 0, 0);
+        bindMVP(m_identity(), m_lightEnabled ? ComputeLightDir() : float3{ 0,0,0 });   // M comes per instance
+        ID3D12PipelineState* psos[kMaterialCount];
+        for (ID3D12PipelineState*& p : psos) p = GetPipeline(Pass::Lit, LitKeywords() | kKeywordInstanced);
+        DrawCompacted(cmd, psos);
     }
 
     // FRUSTUM VIZ
     if (m_showPlayerFrustum) {
-        std::vector<VertexPC> fr; fr.reserve(24 + 12);
-        auto add = [&](const float3& a, const float3& b, const float3& col) {
-            fr.push_back({ a,col }); fr.push_back({ b,col });
-            };
-        const float3 edgeCol{ 1,1,0 };
-        // near
-        add(F.c[0], F.c[1], edgeCol); add(F.c[1], F.c[3], edgeCol); add(F.c[3], F.c[2], edgeCol); add(F.c[2], F.c[0], edgeCol);
-        // far
-        add(F.c[4], F.c[5], edgeCol); add(F.c[5], F.c[7], edgeCol); add(F.c[7], F.c[6], edgeCol); add(F.c[6], F.c[4], edgeCol);
-        // connectors
-        add(F.c[0], F.c[4], edgeCol); add(F.c[1], F.c[5], edgeCol); add(F.c[2], F.c[6], edgeCol); add(F.c[3], F.c[7], edgeCol);
-
-        // detector normals
+        const Points& pts = m_playerFrustumPts;
+        DebugDraw::Frustum(pts.data(), float3{ 1,1,0 }, DebugDepth::Overlay);
+
+        // detector normals (drawn outward; the view's planes point in)
         auto centroid4 = [](const float3& a, const float3& b, const float3& c, const float3& d)->float3 {
             return float3{ (a.x + b.x + c.x + d.x) * 0.25f, (a.y + b.y + c.y + d.y) * 0.25f, (a.z + b.z + c.z + d.z) * 0.25f };
             };
-        const float3 nearCtr = centroid4(F.c[0], F.c[1], F.c[2], F.c[3]);
-        const float3 farCtr = centroid4(F.c[4], F.c[5], F.c[6], F.c[7]);
-        const float3 leftCtr = centroid4(F.c[0], F.c[2], F.c[4], F.c[6]);
-        const float3 rightCtr = centroid4(F.c[1], F.c[3], F.c[5], F.c[7]);
-        const float3 topCtr = centroid4(F.c[0], F.c[1], F.c[4], F.c[5]);
-        const float3 botCtr = centroid4(F.c[2], F.c[3], F.c[6], F.c[7]);
+        const float3 nearCtr = centroid4(pts[NEAR_TopLeft], pts[NEAR_TopRight], pts[NEAR_BottomLeft], pts[NEAR_BottomRight]);
+        const float3 farCtr = centroid4(pts[FAR_TopLeft], pts[FAR_TopRight], pts[FAR_BottomLeft], pts[FAR_BottomRight]);
+        const float3 leftCtr = centroid4(pts[NEAR_TopLeft], pts[NEAR_BottomLeft], pts[FAR_TopLeft], pts[FAR_BottomLeft]);
+        const float3 rightCtr = centroid4(pts[NEAR_TopRight], pts[NEAR_BottomRight], pts[FAR_TopRight], pts[FAR_BottomRight]);
+        const float3 topCtr = centroid4(pts[NEAR_TopLeft], pts[NEAR_TopRight], pts[FAR_TopLeft], pts[FAR_TopRight]);
+        const float3 botCtr = centroid4(pts[NEAR_BottomLeft], pts[NEAR_BottomRight], pts[FAR_BottomLeft], pts[FAR_BottomRight]);
         const float len = length(farCtr - nearCtr) * 0.15f;
 
         const float3 colLeft{ 1.0f,0.25f,0.25f }, colRight{ 0.25f,1.0f,0.25f };
         const float3 colTop{ 0.25f,0.25f,1.0f }, colBottom{ 1.0f,0.0f,1.0f };
         const float3 colNear{ 0.0f,1.0f,1.0f }, colFar{ 1.0f,1.0f,0.0f };
 
-        add(leftCtr, leftCtr + F.p[0].n * len, colLeft);
-        add(rightCtr, rightCtr + F.p[1].n * len, colRight);
-        add(botCtr, botCtr + F.p[2].n * len, colBottom);
-        add(topCtr, topCtr + F.p[3].n * len, colTop);
-        add(nearCtr, nearCtr + F.p[4].n * len, colNear);
-        add(farCtr, farCtr + F.p[5].n * len, colFar);
-
-        const UINT bytes = (UINT)fr.size() * (UINT)sizeof(VertexPC);
-        if (bytes) {
-            auto alloc = m_dynamicUpload.Allocate(bytes, 256);
-            memcpy(alloc.cpuPtr, fr.data(), bytes);
-
-            D3D12_VERTEX_BUFFER_VIEW vb{};
-            vb.BufferLocation = alloc.gpuAddress;
-            vb.StrideInBytes = sizeof(VertexPC);
-            vb.SizeInBytes = bytes;
-
-            cmd->SetPipelineState(m_psoLines.Get());
-            cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-            cmd->IASetVertexBuffers(0, 1, &vb);
-            bindMVP_Lines(m_identity(), 2.5f);
-            cmd->DrawInstanced((UINT)fr.size(), 1, 0, 0);
-
-            //m_transientUploads.push_back(dyn);
-        }
+        const Plane_t* P = m_views[kViewPlayer].planes;
+        DebugDraw::Line(leftCtr, leftCtr - P[F_LEFT].normal * len, colLeft, DebugDepth::Overlay);
+        DebugDraw::Line(rightCtr, rightCtr - P[F_RIGHT].normal * len, colRight, DebugDepth::Overlay);
+        DebugDraw::Line(botCtr, botCtr - P[F_BOTTOM].normal * len, colBottom, DebugDepth::Overlay);
+        DebugDraw::Line(topCtr, topCtr - P[F_TOP].normal * len, colTop, DebugDepth::Overlay);
+        DebugDraw::Line(nearCtr, nearCtr - P[F_NEAR].normal * len, colNear, DebugDepth::Overlay);
+        DebugDraw::Line(farCtr, farCtr - P[F_FAR].normal * len, colFar, DebugDepth::Overlay);
     }
 }
 
-// HUD (crosshair; can add more later)
-void Renderer::RenderHUD(ID3D12GraphicsCommandList* cmd)
+// ============================================================================
+// Indirect submission
+// ============================================================================
+static_assert(sizeof(DrawArgs) == sizeof(D3D12_DRAW_ARGUMENTS), "DrawArgs is uploaded as-is");
+
+// Instance matrices in draw order, then the args, both from the upload ring (GENERIC_READ covers
+// vertex and indirect-argument reads). The caller has set root constants without M and slot 0.
+void Renderer::DrawCompacted(ID3D12GraphicsCommandList* cmd, std::span<ID3D12PipelineState* const> bucketPsos)
 {
-    struct Vtx { float3 pos; float3 color; };
-    std::vector<Vtx> hud; hud.reserve(4096);
+    const std::span<const uint32_t> instances = m_drawCompactor.Instances();
+    const std::span<const DrawArgs> args = m_drawCompactor.Args();
+    if (args.empty()) return;
 
-    auto addRect = [&](float x0, float y0, float x1, float y1, const float3& c)
-        {
-            hud.push_back({ {x0,y0,0}, c }); hud.push_back({ {x1,y0,0}, c }); hud.push_back({ {x1,y1,0}, c });
-            hud.push_back({ {x0,y0,0}, c }); hud.push_back({ {x1,y1,0}, c }); hud.push_back({ {x0,y1,0}, c });
-        };
+    const UINT matrixBytes = (UINT)(instances.size() * sizeof(float4x4));
+    auto inst = m_dynamicUpload.Allocate(matrixBytes, 256);
+    float4x4* dst = reinterpret_cast<float4x4*>(inst.cpuPtr);
+    for (size_t i = 0; i < instances.size(); i++) dst[i] = m_renderScene.World(instances[i]);
+    auto argAlloc = m_dynamicUpload.Allocate(args.size_bytes(), 256);
+    memcpy(argAlloc.cpuPtr, args.data(), args.size_bytes());
 
-    // 7-seg digits ------------------------------------------------------------
-    auto addH = [&](float x, float y, float w, float t, const float3& c) { addRect(x, y, x + w, y + t, c); };
-    auto addV = [&](float x, float y, float t, float h, const float3& c) { addRect(x, y, x + t, y + h, c); };
+    D3D12_VERTEX_BUFFER_VIEW vb{};
+    vb.BufferLocation = inst.gpuAddress;
+    vb.SizeInBytes = matrixBytes;
+    vb.StrideInBytes = sizeof(float4x4);
+    cmd->IASetVertexBuffers(1, 1, &vb);
+
+    ID3D12Resource* ring = m_dynamicUpload.GetBuffer();
+    const UINT64 argOffset = argAlloc.gpuAddress - ring->GetGPUVirtualAddress();
+    const std::span<const DrawBucket> buckets = m_drawCompactor.Buckets();
+    for (uint32_t b = 0; b < (uint32_t)buckets.size(); b++) {
+        if (!buckets[b].argCount) continue;
+        BindPipeline(cmd, bucketPsos[b]);
+        cmd->ExecuteIndirect(m_drawSignature.Get(), buckets[b].argCount, ring,
+                             argOffset + UINT64(buckets[b].firstArg) * sizeof(DrawArgs), nullptr, 0);
+        COUNTER_ADD(DrawCalls, 1);
+    }
+}
 
-    auto addDigit = [&](int d, float x, float y, float s, float th, const float3& c)
-        {
-            bool seg[7] = {};
-            switch (d) {
-            case 0: seg[0] = seg[1] = seg[2] = seg[3] = seg[4] = seg[5] = true; break;
-            case 1: seg[1] = seg[2] = true; break;
-            case 2: seg[0] = seg[1] = seg[6] = seg[4] = seg[3] = true; break;
-            case 3: seg[0] = seg[1] = seg[6] = seg[2] = seg[3] = true; break;
-            case 4: seg[5] = seg[6] = seg[1] = seg[2] = true; break;
-            case 5: seg[0] = seg[5] = seg[6] = seg[2] = seg[3] = true; break;
-            case 6: seg[0] = seg[5] = seg[6] = seg[2] = seg[3] = seg[4] = true; break;
-            case 7: seg[0] = seg[1] = seg[2] = true; break;
-            case 8: for (int i = 0; i < 7; i++) seg[i] = true; break;
-            case 9: seg[0] = seg[1] = seg[2] = seg[3] = seg[5] = seg[6] = true; break;
-            }
-            float x0 = x, x1 = x + s, y0 = y, ym = y + s, y2 = y + 2 * s;
-            if (seg[0]) addH(x0 + th, y0, s - 2 * th, th, c);
-            if (seg[1]) addV(x1 - th, y0 + th, th, s - 2 * th, c);
-            if (seg[2]) addV(x1 - th, ym + th, th, s - 2 * th, c);
-            if (seg[3]) addH(x0 + th, y2 - th, s - 2 * th, th, c);
-            if (seg[4]) addV(x0, ym + th, th, s - 2 * th, c);
-            if (seg[5]) addV(x0, y0 + th, th, s - 2 * th, c);
-            if (seg[6]) addH(x0 + th, ym - th * 0.5f, s - 2 * th, th, c);
-        };
+// Particles: sorted far to near on the job system, expanded into camera-facing quads in the upload
+// ring and alpha blended over the opaque scene, kParticleBatch quads per draw (16-bit indices).
+void Renderer::RenderParticles(ID3D12GraphicsCommandList* cmd)
+{
+    PROFILE_SCOPE("Renderer::RenderParticles");
+    FrameStats::Scope stat(m_frameStats, m_stage.particles);
+    if (!m_showParticles || !m_particles.GetCount()) return;
 
-    auto addFloat = [&](float value, float x, float y, float s, float th, const float3& c)
-        {
-            if (value < 0) value = -value;
-            int v10 = (int)(value * 10.0f + 0.5f);
-            int d1 = (v10 / 1000) % 10, d2 = (v10 / 100) % 10, d3 = (v10 / 10) % 10, d4 = v10 % 10;
-            float dx = 0;
-            if (d1) { addDigit(d1, x + dx, y, s, th, c); dx += s * 1.6f; }
-            addDigit(d2, x + dx, y, s, th, c); dx += s * 1.6f;
-            addDigit(d3, x + dx, y, s, th, c); // decimal point
-            addRect(x + dx + s * 0.9f, y + 2 * s - th, x + dx + s * 1.1f, y + 2 * s, c); dx += s * 1.4f;
-            addDigit(d4, x + dx, y, s, th, c);
-        };
+    // Far to near on the job system, then four corners each straight into the ring
+    const float4x4 cameraToWorld = m_camera.GetCameraToWorld();
+    m_particles.Sort(cameraToWorld, m_camera.GetNearZ(), &m_jobs);
+    const uint32_t visible = m_particles.VisibleCount();
+    if (!visible) return;
+
+    const UINT bytes = visible * 4 * (UINT)sizeof(ParticleVertex);
+    auto alloc = m_dynamicUpload.Allocate(bytes, 256);
+    m_particles.Expand(cameraToWorld, reinterpret_cast<ParticleVertex*>(alloc.cpuPtr), &m_jobs);
+
+    // One quad pattern of 16-bit indices; batches reuse it via BaseVertexLocation
+    const uint32_t batchQuads = std::min(visible, kParticleBatch);
+    const UINT ibBytes = batchQuads * 6 * (UINT)sizeof(uint16_t);
+    auto ia = m_dynamicUpload.Allocate(ibBytes, 256);
+    uint16_t* idx = reinterpret_cast<uint16_t*>(ia.cpuPtr);
+    for (uint32_t q = 0; q < batchQuads; q++, idx += 6) {
+        const uint16_t v = uint16_t(q * 4);
+        idx[0] = v; idx[1] = uint16_t(v + 1); idx[2] = uint16_t(v + 2);
+        idx[3] = uint16_t(v + 2); idx[4] = uint16_t(v + 1); idx[5] = uint16_t(v + 3);
+    }
+
+    D3D12_VERTEX_BUFFER_VIEW vb{};
+    vb.BufferLocation = alloc.gpuAddress;
+    vb.StrideInBytes = sizeof(ParticleVertex);
+    vb.SizeInBytes = bytes;
+    D3D12_INDEX_BUFFER_VIEW ib{};
+    ib.BufferLocation = ia.gpuAddress;
+    ib.SizeInBytes = ibBytes;
+    ib.Format = DXGI_FORMAT_R16_UINT;
+
+    SceneCB cb{};
+    WriteCB(m_mul(m_camera.GetView(), m_camera.GetProj()), cb, float3{ 0,0,0 }, 0.0f, 0.0f, 0.0f, nullptr);
+    const UINT off = WriteConstants(&cb, sizeof(SceneCB));
+
+    cmd->SetGraphicsRootSignature(m_rootSig.Get());
+    cmd->SetGraphicsRootConstantBufferView(0, m_cbUpload->GetGPUVirtualAddress() + off);
+    BindPipeline(cmd, GetPipeline(Pass::Particles));
+    cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    cmd->IASetVertexBuffers(0, 1, &vb);
+    cmd->IASetIndexBuffer(&ib);
+    // Batches in sorted order, so the blend stays far to near across draws
+    for (uint32_t first = 0; first < visible; first += kParticleBatch) {
+        const uint32_t quads = std::min(visible - first, kParticleBatch);
+        cmd->DrawIndexedInstanced(quads * 6, 1, 0, (INT)(first * 4), 0);
+        COUNTER_ADD(DrawCalls, 1);
+    }
+    COUNTER_ADD(Particles, visible);
+}
+
+// Debug lines from every thread: one upload, one draw per depth mode. Labels are projected here
+// and join the frame's text batch.
+void Renderer::RenderDebugDraw(ID3D12GraphicsCommandList* cmd)
+{
+    PROFILE_SCOPE("Renderer::RenderDebugDraw");
+    FrameStats::Scope stat(m_frameStats, m_stage.debugDraw);
+    // Merged straight into the upload ring
+    UploadAlloc::Allocation alloc{};
+    UINT bytes = 0;
+    DebugDraw::Collect(m_debugDt, m_debugFrame, [&](uint32_t count) {
+        bytes = count * (UINT)sizeof(VertexPC);
+        alloc = m_dynamicUpload.Allocate(bytes, 256);
+        return reinterpret_cast<VertexPC*>(alloc.cpuPtr);
+    });
+    m_debugDt = 0.0f;
+
+    const float4x4 VP = m_mul(m_camera.GetView(), m_camera.GetProj());
+    const float W = (float)m_width, H = (float)m_height;
+    for (const DebugLabel& l : m_debugFrame.labels) {
+        const float4 clip = m_mul_row(float4{ l.pos.x, l.pos.y, l.pos.z, 1.0f }, VP);
+        if (clip.w <= 1e-4f) continue;   // behind the eye
+        const float x = (clip.x / clip.w * 0.5f + 0.5f) * W;
+        const float y = (0.5f - clip.y / clip.w * 0.5f) * H;
+        m_text.Draw(m_debugFrame.LabelText(l), x, y, 2.0f, l.color);
+    }
+
+    if (!bytes) return;
+
+    D3D12_VERTEX_BUFFER_VIEW vb{};
+    vb.BufferLocation = alloc.gpuAddress;
+    vb.StrideInBytes = sizeof(VertexPC);
+    vb.SizeInBytes = bytes;
 
+    SceneCB cb{};
+    WriteCB(VP, cb, float3{ 0,0,0 }, W, H, 2.5f, nullptr);
+    const UINT off = WriteConstants(&cb, sizeof(SceneCB));
+
+    cmd->SetGraphicsRootSignature(m_rootSig.Get());
+    cmd->SetGraphicsRootConstantBufferView(0, m_cbUpload->GetGPUVirtualAddress() + off);
+    cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+    cmd->IASetVertexBuffers(0, 1, &vb);
+    const Pass passes[] = { Pass::LinesDepth, Pass::Lines };   // by DebugDepth
+    for (uint32_t d = 0; d < uint32_t(DebugDepth::Count); d++) {
+        if (!m_debugFrame.lineCount[d]) continue;
+        BindPipeline(cmd, GetPipeline(passes[d]));
+        cmd->DrawInstanced(m_debugFrame.lineCount[d], 1, m_debugFrame.lineStart[d], 0);
+        COUNTER_ADD(DrawCalls, 1);
+    }
+}
+
+// HUD (crosshair, toggles, readouts). The shapes are retained and rebuild only when what they
+// show changes; the readouts are text and go out with the rest of the frame's text
+void Renderer::UpdateHud()
+{
     // Colors used for HUD
     const float3 dark{ 1.00f,1.00f,1.00f };
     const float3 dim{ 1.00f,1.00f,1.00f };
@@ -1281,95 +1625,124 @@ void Renderer::RenderHUD(ID3D12GraphicsCommandList* cmd)
 
     const float W = (float)m_width, H = (float)m_height;
 
-    // Crosshair 
-    {
+    // Crosshair
+    m_hud.Update(m_hudIds.crosshair, uint64_t(m_width) | (uint64_t(m_height) << 32), [&](HudBuilder& b) {
         const float cx = W * 0.5f, cy = H * 0.5f, len = 30.0f, th = 4.0f;
-        addRect(cx - len, cy - th * 0.5f, cx + len, cy + th * 0.5f, dark);
-        addRect(cx - th * 0.5f, cy - len, cx + th * 0.5f, cy + len, dark);
-    }
-
-    // FPS label + number
+        b.Rect(cx - len, cy - th * 0.5f, cx + len, cy + th * 0.5f, dark);
+        b.Rect(cx - th * 0.5f, cy - len, cx + th * 0.5f, cy + len, dark);
+    });
+
+    // Toggle boxes (Light, Shadows, Grid, Frustum, Test, Random, Particles)
+    const bool toggles[] = { m_lightEnabled, m_shadowsEnabled, m_showGrid, m_showPlayerFrustum, m_showTestCube, m_showRandomCubes, m_showParticles };
+    uint64_t toggleKey = uint64_t(m_height) << 8;
+    for (size_t i = 0; i < _countof(toggles); i++) toggleKey |= uint64_t(toggles[i]) << i;
+    m_hud.Update(m_hudIds.toggles, toggleKey, [&](HudBuilder& b) {
+        float x = 16.0f;
+        const float y = H - 16.0f - 12.0f;
+        for (bool t : toggles) { b.Rect(x, y, x + 12.0f, y + 12.0f, t ? on : off); x += 16.0f; }
+    });
+
+    // Toggle letters above the boxes
+    const uint32_t label = PackRGBA8(yel), value = PackRGBA8(dim);
     {
-        float x = 16.0f, y = 16.0f;
-        // simple "FPS" label
-        // F
-        addV(x, y, 2.0f, 2 * 10.0f, yel); addH(x, y, 10.0f, 2.0f, yel); addH(x, y + 10.0f, 8.0f, 2.0f, yel);
-        x += 10.0f * 1.8f;
-        // P
-        addV(x, y, 2.0f, 2 * 10.0f, yel); addH(x, y, 10.0f, 2.0f, yel); addV(x + 10.0f - 2.0f, y, 2.0f, 10.0f, yel); addH(x, y + 10.0f, 10.0f, 2.0f, yel);
-        x += 10.0f * 1.8f;
-        // S
-        addH(x, y, 10.0f, 2.0f, yel); addV(x, y, 2.0f, 10.0f, yel); addH(x, y + 10.0f, 10.0f, 2.0f, yel); addV(x + 10.0f - 2.0f, y + 10.0f, 2.0f, 10.0f, yel); addH(x, y + 20.0f - 2.0f, 10.0f, 2.0f, yel);
-
-        // number
-        float fps = (m_lastFPS > 0 ? m_lastFPS : 0.0f);
-        addFloat(fps, 16.0f + 10.0f * 1.8f * 3.0f + 12.0f, 16.0f, 9.0f, 2.0f, dark);
+        float x = 17.0f;
+        const float y = H - 16.0f - 12.0f - 18.0f;
+        for (const char* l : { "L", "S", "G", "F", "T", "R", "P" }) { m_text.Draw(l, x, y, 2.0f, label); x += 16.0f; }
     }
 
-    // POS / YAW / PITCH / SPEED
-    {
-        float x = 16.0f, y = 16.0f + 32.0f;
-
-        // camera world position
-        float3 cp = m_camera.GetPosition();
-        addFloat(cp.x, x, y, 8.0f, 1.6f, dim); x += 8.0f * 5.0f;
-        addFloat(cp.y, x, y, 8.0f, 1.6f, dim); x += 8.0f * 5.0f;
-        addFloat(cp.z, x, y, 8.0f, 1.6f, dim);
-
-        // yaw / pitch
-        float4x4 CW = m_camera.GetCameraToWorld();
-        float3 fwd{ CW[2].x, CW[2].y, CW[2].z };
-        float yaw = std::atan2f(fwd.x, fwd.z) * 57.2957795f;
-        float pitch = std::asin(SOL_MAX(-1.0f, SOL_MIN(1.0f, fwd.y))) * 57.2957795f;
-
-        x = 16.0f; y += 24.0f;
-        addFloat(yaw, x, y, 8.0f, 1.6f, dim); x += 8.0f * 5.0f;
-        addFloat(pitch, x, y, 8.0f, 1.6f, dim);
-
-        // speed (pixels/frame estimate)
-        static float3 lastPos = { 0,0,0 }; static bool initPos = false;
-        float speed = 0.0f;
-        if (!initPos) { lastPos = cp; initPos = true; }
-        else { float3 d = cp - lastPos; speed = length(d) * 60.0f; lastPos = cp; }
-        x = 16.0f; y += 24.0f;
-        addFloat(speed, x, y, 8.0f, 1.6f, dim);
+    // Readouts: text through the shaped-string cache, labels and values drawn separately so the
+    // labels stay cached
+    char buf[96];
+    const float fps = (m_lastFPS > 0 ? m_lastFPS : 0.0f);
+    float x = 16.0f + m_text.Draw("FPS ", 16.0f, 16.0f, 3.0f, label).width;
+    snprintf(buf, sizeof(buf), "%.1f", fps);
+    m_text.Draw(buf, x, 16.0f, 3.0f, value);
+
+    const float3 cp = m_camera.GetPosition();
+    x = 16.0f + m_text.Draw("POS ", 16.0f, 16.0f + 32.0f, 2.0f, label).width;
+    snprintf(buf, sizeof(buf), "%.1f %.1f %.1f", cp.x, cp.y, cp.z);
+    m_text.Draw(buf, x, 16.0f + 32.0f, 2.0f, value);
+
+    const float4x4 CW = m_camera.GetCameraToWorld();
+    const float3 fwd{ CW[2].x, CW[2].y, CW[2].z };
+    const float yaw = std::atan2f(fwd.x, fwd.z) * 57.2957795f;
+    const float pitch = std::asin(SOL_MAX(-1.0f, SOL_MIN(1.0f, fwd.y))) * 57.2957795f;
+    x = 16.0f + m_text.Draw("YAW ", 16.0f, 16.0f + 32.0f + 24.0f, 2.0f, label).width;
+    snprintf(buf, sizeof(buf), "%.1f\xC2\xB0  PITCH %.1f\xC2\xB0", yaw, pitch);
+    m_text.Draw(buf, x, 16.0f + 32.0f + 24.0f, 2.0f, value);
+
+    // speed (units/s at a nominal 60 Hz)
+    float speed = 0.0f;
+    if (m_hudPosValid) speed = length(cp - m_hudLastPos) * 60.0f;
+    m_hudLastPos = cp;
+    m_hudPosValid = true;
+    x = 16.0f + m_text.Draw("SPD ", 16.0f, 16.0f + 32.0f + 48.0f, 2.0f, label).width;
+    snprintf(buf, sizeof(buf), "%.1f", speed);
+    m_text.Draw(buf, x, 16.0f + 32.0f + 48.0f, 2.0f, value);
+
+    // Last frame's counters, one per line under the readouts
+    if (m_showCounters) {
+        const CounterFrame& counters = Counters::LastFrame();
+        float y = 16.0f + 32.0f + 48.0f + 36.0f;
+        for (uint32_t i = 0; i < kCounterCount; i++, y += 24.0f) {
+            x = 16.0f + m_text.Draw(kCounterInfo[i].name, 16.0f, y, 2.0f, label).width + 8.0f;
+            const uint64_t v = counters.values[i];
+            if (kCounterInfo[i].unit[0] == 'B' && v >= 1024)
+                snprintf(buf, sizeof(buf), "%.1f KB", double(v) / 1024.0);
+            else
+                snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+            m_text.Draw(buf, x, y, 2.0f, value);
+        }
     }
+}
 
-    // Toggle boxes (Light, Shadows, Grid, Frustum, Test, Random)
-    {
-        float x = 16.0f, y = H - 16.0f - 12.0f;
-        auto box = [&](bool onOff) { addRect(x, y, x + 12.0f, y + 12.0f, onOff ? on : off); x += 16.0f; };
-        box(m_lightEnabled);
-        box(m_shadowsEnabled);
-        box(m_showGrid);
-        box(m_showPlayerFrustum);
-        box(m_showTestCube);
-        box(m_showRandomCubes);
+void Renderer::RenderHUD(ID3D12GraphicsCommandList* cmd)
+{
+    PROFILE_SCOPE("Renderer::RenderHUD");
+    FrameStats::Scope stat(m_frameStats, m_stage.hud);
+    UpdateHud();
+    m_hud.Pack();
+    const std::span<const VertexPC> verts = m_hud.Vertices();
+    if (verts.empty()) return;
+
+    // Persistent upload buffer, one slice per frame in flight (this frame's slice is idle after the
+    // fence wait). Grows rarely: the old buffer may still be read, so drain the GPU first.
+    if (verts.size() > m_hudCapacity) {
+        if (m_hudBuffer) WaitForGPU();
+        m_hudCapacity = SOL_MAX((UINT)verts.size(), m_hudCapacity * 2);
+        m_hudCapacity = SOL_MAX(m_hudCapacity, 4096u);
+        m_hudBuffer.Reset();
+        D3D12_HEAP_PROPERTIES hu{}; hu.Type = D3D12_HEAP_TYPE_UPLOAD;
+        D3D12_RESOURCE_DESC rd = MakeBufferDesc(UINT64(m_hudCapacity) * sizeof(VertexPC) * kFrameCount);
+        ThrowIfFailed(m_device->CreateCommittedResource(&hu, D3D12_HEAP_FLAG_NONE, &rd,
+            D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_hudBuffer)));
+        ThrowIfFailed(m_hudBuffer->Map(0, nullptr, reinterpret_cast<void**>(&m_hudMapped)));
+        for (HudSlice& s : m_hudSlices) s = HudSlice{};
     }
 
-    if (hud.empty()) return;
-
-    // Upload vertices
-    // Upload vertices
-    const UINT bytes = (UINT)(hud.size() * sizeof(Vtx));
-    auto alloc = m_dynamicUpload.Allocate(bytes, 256);
-    memcpy(alloc.cpuPtr, hud.data(), bytes);
+    // Copy only the layers this slice has not seen yet
+    const UINT64 sliceOffset = UINT64(m_frameIndex) * m_hudCapacity * sizeof(VertexPC);
+    VertexPC* slice = reinterpret_cast<VertexPC*>(m_hudMapped + sliceOffset);
+    HudSlice& hs = m_hudSlices[m_frameIndex];
+    const uint64_t staticVersion = m_hud.LayerVersion(HudLayer::Static);
+    const uint64_t dynamicVersion = m_hud.LayerVersion(HudLayer::Dynamic);
+    if (hs.staticVersion != staticVersion) {
+        memcpy(slice, verts.data(), verts.size_bytes());
+        COUNTER_ADD(UploadBytes, verts.size_bytes());
+    } else if (hs.dynamicVersion != dynamicVersion) {
+        const UINT first = m_hud.LayerStart(HudLayer::Dynamic);
+        memcpy(slice + first, verts.data() + first, m_hud.LayerCount(HudLayer::Dynamic) * sizeof(VertexPC));
+        COUNTER_ADD(UploadBytes, m_hud.LayerCount(HudLayer::Dynamic) * sizeof(VertexPC));
+    }
+    hs.staticVersion = staticVersion;
+    hs.dynamicVersion = dynamicVersion;
 
     D3D12_VERTEX_BUFFER_VIEW vb{};
-    vb.BufferLocation = alloc.gpuAddress;
-    vb.StrideInBytes = sizeof(Vtx);
-    vb.SizeInBytes = bytes;
+    vb.BufferLocation = m_hudBuffer->GetGPUVirtualAddress() + sliceOffset;
+    vb.StrideInBytes = sizeof(VertexPC);
+    vb.SizeInBytes = (UINT)verts.size_bytes();
 
-
-    // Pixel-space ortho
-    const float l = 0, r = W, t = 0, b = H, zn = 0, zf = 1;
-    float4x4 P = m_identity();
-    P[0].x = 2.0f / (r - l);
-    P[1].y = 2.0f / (t - b);
-    P[2].z = 1.0f / (zf - zn);
-    P[3].x = -(r + l) / (r - l);
-    P[3].y = -(t + b) / (t - b);
-    P[3].z = -zn / (zf - zn);
+    const float4x4 P = PixelOrtho((float)m_width, (float)m_height);
 
     cmd->SetGraphicsRootSignature(m_rootSig.Get());
     if (m_srvHeap) {
@@ -1382,25 +1755,57 @@ void Renderer::RenderHUD(ID3D12GraphicsCommandList* cmd)
         {
             SceneCB cb{}; float4x4 MVP = m_mul(M, P);
             WriteCB(MVP, cb, /*light*/float3{ 0,0,0 }, 0.0f, 0.0f, 0.0f, nullptr);
-            UINT off = (UINT)((m_cbHead + 255) & ~255u);
-            m_cbHead = off + sizeof(SceneCB);
-            memcpy(m_cbMapped + off, &cb, sizeof(SceneCB));
+            const UINT off = WriteConstants(&cb, sizeof(SceneCB));
             cmd->SetGraphicsRootConstantBufferView(0, m_cbUpload->GetGPUVirtualAddress() + off);
         };
 
-    cmd->SetPipelineState(m_psoNoDepth.Get());
+    BindPipeline(cmd, GetPipeline(Pass::Overlay));
     cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     cmd->IASetVertexBuffers(0, 1, &vb);
     bindHUD(m_identity());
-    cmd->DrawInstanced((UINT)hud.size(), 1, 0, 0);
+    cmd->DrawInstanced((UINT)verts.size(), 1, 0, 0);
+    COUNTER_ADD(DrawCalls, 1);
+}
+
+// All of this frame's text (HUD readouts, overlays) in one instanced draw: 4-vertex strip per glyph
+void Renderer::RenderText(ID3D12GraphicsCommandList* cmd)
+{
+    PROFILE_SCOPE("Renderer::RenderText");
+    FrameStats::Scope stat(m_frameStats, m_stage.text);
+    const std::span<const GlyphInstance> glyphs = m_text.Instances();
+    if (glyphs.empty()) return;
+
+    const UINT bytes = (UINT)glyphs.size_bytes();
+    auto alloc = m_dynamicUpload.Allocate(bytes, 256);
+    memcpy(alloc.cpuPtr, glyphs.data(), bytes);
+
+    D3D12_VERTEX_BUFFER_VIEW vb{};
+    vb.BufferLocation = alloc.gpuAddress;
+    vb.StrideInBytes = sizeof(GlyphInstance);
+    vb.SizeInBytes = bytes;
+
+    SceneCB cb{};
+    WriteCB(PixelOrtho((float)m_width, (float)m_height), cb, float3{ 0,0,0 }, 0.0f, 0.0f, 0.0f, nullptr);
+    const UINT off = WriteConstants(&cb, sizeof(SceneCB));
 
-    //m_transientUploads.push_back(dyn);
+    cmd->SetGraphicsRootSignature(m_rootSig.Get());
+    ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
+    cmd->SetDescriptorHeaps(1, heaps);
+    cmd->SetGraphicsRootDescriptorTable(1, m_shadowSrv); // table start: t0 shadow, t1 atlas
+    cmd->SetGraphicsRootConstantBufferView(0, m_cbUpload->GetGPUVirtualAddress() + off);
+    BindPipeline(cmd, GetPipeline(Pass::Text));
+    cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    cmd->IASetVertexBuffers(0, 1, &vb);
+    cmd->DrawInstanced(4, (UINT)glyphs.size(), 0, 0);
+    COUNTER_ADD(DrawCalls, 1);
 }
 
 
 // Depth-only shadow pass
 void Renderer::RenderShadowPass(ID3D12GraphicsCommandList* cmd)
 {
+    PROFILE_SCOPE("Renderer::RenderShadowPass");
+    FrameStats::Scope stat(m_frameStats, m_stage.shadow);
     if (!m_shadowsEnabled || !m_lightEnabled) return;
 
     if (m_shadowState != D3D12_RESOURCE_STATE_DEPTH_WRITE) {
@@ -1420,7 +1825,6 @@ void Renderer::RenderShadowPass(ID3D12GraphicsCommandList* cmd)
     cmd->ClearDepthStencilView(m_shadowDsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 
     cmd->SetGraphicsRootSignature(m_rootSig.Get());
-    cmd->SetPipelineState(m_psoShadow.Get());
     cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     cmd->IASetVertexBuffers(0, 1, &m_vbTrisView);
 
@@ -1431,15 +1835,23 @@ void Renderer::RenderShadowPass(ID3D12GraphicsCommandList* cmd)
             float4x4 MVP = m_mul(M, VP);
             float4x4 lightMVP = m_mul(M, VP);  // SAME as main pass!
             WriteCB(MVP, cb, ComputeLightDir(), 0, 0, 0, &lightMVP);  // Pass lightMVP
-            UINT off = (UINT)((m_cbHead + 255) & ~255u);
-            m_cbHead = off + sizeof(SceneCB);
-            memcpy(m_cbMapped + off, &cb, sizeof(SceneCB));
+            const UINT off = WriteConstants(&cb, sizeof(SceneCB));
             cmd->SetGraphicsRootConstantBufferView(0, m_cbUpload->GetGPUVirtualAddress() + off);
     };
 
-    float4x4 M = m_trs(m_testCubePos, q_from_axis_angle(float3{ 0,1,0 }, m_testCubeYaw), m_testCubeScale);
-    bindShadow(M);
-    cmd->DrawInstanced(m_vertexCountTris, 1, 0, 0);
+    // Casters outside the camera view still shadow it, so this pass is culled against the light's
+    // own volume (kViewLight), not the camera's. Depth-only: every material shares the one shadow
+    // pipeline.
+    m_drawItems.clear();
+    m_visibility.ForEach(kViewLight, [&](RenderProxyId id) {
+        m_drawItems.push_back({ m_renderScene.Material(id), m_renderScene.Mesh(id), id });
+    });
+    m_drawCompactor.Build(m_drawItems, &m_jobs);
+
+    bindShadow(m_identity());   // M comes per instance
+    ID3D12PipelineState* psos[kMaterialCount];
+    for (ID3D12PipelineState*& p : psos) p = GetPipeline(Pass::Shadow, kKeywordInstanced);
+    DrawCompacted(cmd, psos);
 
     if (m_shadowState != D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE) {
         D3D12_RESOURCE_BARRIER b{};
@@ -1458,18 +1870,27 @@ void Renderer::RenderShadowPass(ID3D12GraphicsCommandList* cmd)
 // ============================================================================
 void Renderer::Render()
 {
-    auto t0 = std::chrono::high_resolution_clock::now();
+    PROFILE_SCOPE("Renderer::Render");
+    FrameStats::Scope stat(m_frameStats, m_stage.render);
 
     // Wait for this frame's command allocator to be free before using it
     if (m_fence->GetCompletedValue() < m_fenceValues[m_frameIndex]) {
+        PROFILE_SCOPE("Renderer::WaitForFrame");
+        FrameStats::Scope waitStat(m_frameStats, m_stage.waitForFrame);
         ThrowIfFailed(m_fence->SetEventOnCompletion(m_fenceValues[m_frameIndex], m_fenceEvent));
         WaitForSingleObject(m_fenceEvent, INFINITE);
     }
 
     m_dynamicUpload.BeginFrame(m_frameIndex);
+    m_text.Begin();
 
     ThrowIfFailed(m_cmdAlloc[m_frameIndex]->Reset());
     ThrowIfFailed(m_cmdList->Reset(m_cmdAlloc[m_frameIndex].Get(), nullptr));
+    m_boundPso = nullptr;
+
+    // Only the proxies that changed since the last frame are touched
+    m_renderScene.ApplyUpdates(m_renderQueue);
+    CullViews();
 
     RenderShadowPass(m_cmdList.Get());
 
@@ -1485,7 +1906,10 @@ void Renderer::Render()
     m_cmdList->RSSetScissorRects(1, &m_scissor);
 
     RecordDrawCalls(m_cmdList.Get());
+    RenderParticles(m_cmdList.Get());
+    RenderDebugDraw(m_cmdList.Get());
     RenderHUD(m_cmdList.Get());
+    RenderText(m_cmdList.Get());
 
     D3D12_RESOURCE_BARRIER toPresent{};
     toPresent.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -1499,12 +1923,21 @@ void Renderer::Render()
     ID3D12CommandList* lists[] = { m_cmdList.Get() };
     m_cmdQueue->ExecuteCommandLists(1, lists);
 
-    ThrowIfFailed(m_swapchain->Present(m_vsync ? 1 : 0, 0));
-    MoveToNextFrame();
+    {
+        PROFILE_SCOPE("Renderer::Present");
+        FrameStats::Scope presentStat(m_frameStats, m_stage.present);
+        ThrowIfFailed(m_swapchain->Present(m_vsync ? 1 : 0, 0));
+        MoveToNextFrame();
+    }
+    EndFrameCounters();
+}
 
-    auto t1 = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> ms = t1 - t0;
-    m_lastFrameMs = (float)ms.count();
-    m_frameTimes[m_ftHead] = m_lastFrameMs;
-    m_ftHead = (m_ftHead + 1) % (int)m_frameTimes.size();
+// This frame's counters into the HUD (next frame), the profiler trace and the stats export
+void Renderer::EndFrameCounters()
+{
+    const CounterFrame& frame = Counters::EndFrame();
+    for (uint32_t i = 0; i < kCounterCount; i++) {
+        PROFILE_COUNTER(kCounterInfo[i].name, frame.values[i]);
+        m_frameStats.RecordCounter(i, frame.values[i]);
+    }
 }
@@ -0,0 +1,211 @@
+#include "Scene/DynamicBvh.h"
+#include <algorithm>
+
+using namespace GraphicsEngine;
+
+namespace {
+
+float3 Min3(const float3& a, const float3& b) { return { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) }; }
+float3 Max3(const float3& a, const float3& b) { return { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) }; }
+
+// Surface area of the box (halved: only comparisons use it)
+float Area(const float3& mn, const float3& mx)
+{
+    const float3 d = mx - mn;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+bool Contains(const float3& outerMin, const float3& outerMax, const float3& mn, const float3& mx)
+{
+    return outerMin.x <= mn.x && outerMin.y <= mn.y && outerMin.z <= mn.z &&
+           mx.x <= outerMax.x && mx.y <= outerMax.y && mx.z <= outerMax.z;
+}
+
+}
+
+// ============================================================================
+// Node pool
+// ============================================================================
+uint32_t DynamicBvh::AllocateNode()
+{
+    if (m_free == kNull) {
+        m_nodes.emplace_back();
+        return (uint32_t)m_nodes.size() - 1;
+    }
+    const uint32_t i = m_free;
+    m_free = m_nodes[i].parent;
+    m_nodes[i] = Node{};
+    return i;
+}
+
+void DynamicBvh::FreeNode(uint32_t i)
+{
+    m_nodes[i].parent = m_free;
+    m_nodes[i].height = UINT32_MAX;
+    m_free = i;
+}
+
+void DynamicBvh::Clear()
+{
+    m_nodes.clear();
+    m_root = m_free = kNull;
+    m_leaves = 0;
+}
+
+// ============================================================================
+// Leaves
+// ============================================================================
+uint32_t DynamicBvh::Insert(const AABB_t& bounds, uint32_t data, uint32_t mask)
+{
+    const uint32_t leaf = AllocateNode();
+    Node& n = m_nodes[leaf];
+    const float3 fat{ m_margin, m_margin, m_margin };
+    n.min = bounds.center - bounds.extents - fat;
+    n.max = bounds.center + bounds.extents + fat;
+    n.data = data;
+    n.mask = mask;
+    InsertLeaf(leaf);
+    m_leaves++;
+    return leaf;
+}
+
+void DynamicBvh::Remove(uint32_t leaf)
+{
+    assert(leaf < m_nodes.size() && m_nodes[leaf].IsLeaf());
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    m_leaves--;
+}
+
+bool DynamicBvh::Move(uint32_t leaf, const AABB_t& bounds)
+{
+    Node& n = m_nodes[leaf];
+    const float3 mn = bounds.center - bounds.extents, mx = bounds.center + bounds.extents;
+    if (Contains(n.min, n.max, mn, mx)) return false;
+
+    RemoveLeaf(leaf);
+    const float3 fat{ m_margin, m_margin, m_margin };
+    n.min = mn - fat;
+    n.max = mx + fat;
+    InsertLeaf(leaf);
+    return true;
+}
+
+void DynamicBvh::InsertLeaf(uint32_t leaf)
+{
+    if (m_root == kNull) {
+        m_root = leaf;
+        m_nodes[leaf].parent = kNull;
+        return;
+    }
+
+    // Walk down to the sibling that grows the tree's total area the least
+    const float3 lmin = m_nodes[leaf].min, lmax = m_nodes[leaf].max;
+    uint32_t index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& n = m_nodes[index];
+        const float area = Area(n.min, n.max);
+        const float combined = Area(Min3(n.min, lmin), Max3(n.max, lmax));
+        const float cost = 2.0f * combined;                  // new parent here
+        const float inherited = 2.0f * (combined - area);    // growth pushed onto every ancestor below
+
+        float childCost[2];
+        for (int c = 0; c < 2; c++) {
+            const Node& ch = m_nodes[n.child[c]];
+            const float grown = Area(Min3(ch.min, lmin), Max3(ch.max, lmax));
+            childCost[c] = (ch.IsLeaf() ? grown : grown - Area(ch.min, ch.max)) + inherited;
+        }
+        if (cost < childCost[0] && cost < childCost[1]) break;
+        index = n.child[childCost[1] < childCost[0] ? 1 : 0];
+    }
+
+    const uint32_t sibling = index;
+    const uint32_t oldParent = m_nodes[sibling].parent;
+    const uint32_t parent = AllocateNode();
+    m_nodes[parent].parent = oldParent;
+    m_nodes[parent].child[0] = sibling;
+    m_nodes[parent].child[1] = leaf;
+    m_nodes[sibling].parent = parent;
+    m_nodes[leaf].parent = parent;
+    if (oldParent == kNull) m_root = parent;
+    else m_nodes[oldParent].child[m_nodes[oldParent].child[0] == sibling ? 0 : 1] = parent;
+
+    Refit(parent);
+}
+
+void DynamicBvh::RemoveLeaf(uint32_t leaf)
+{
+    if (leaf == m_root) {
+        m_root = kNull;
+        return;
+    }
+
+    const uint32_t parent = m_nodes[leaf].parent;
+    const uint32_t grandParent = m_nodes[parent].parent;
+    const uint32_t sibling = m_nodes[parent].child[m_nodes[parent].child[0] == leaf ? 1 : 0];
+    m_nodes[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    if (grandParent == kNull) {
+        m_root = sibling;
+        return;
+    }
+    m_nodes[grandParent].child[m_nodes[grandParent].child[0] == parent ? 0 : 1] = sibling;
+    Refit(grandParent);
+}
+
+// ============================================================================
+// Refit / balance
+// ============================================================================
+void DynamicBvh::Combine(uint32_t i)
+{
+    Node& n = m_nodes[i];
+    const Node& a = m_nodes[n.child[0]];
+    const Node& b = m_nodes[n.child[1]];
+    n.min = Min3(a.min, b.min);
+    n.max = Max3(a.max, b.max);
+    n.height = 1 + std::max(a.height, b.height);
+    n.mask = a.mask | b.mask;
+}
+
+void DynamicBvh::Refit(uint32_t i)
+{
+    while (i != kNull) {
+        i = Balance(i);
+        Combine(i);
+        i = m_nodes[i].parent;
+    }
+}
+
+// If one child of `a` is more than one level taller, rotates that child up into a's place and
+// hands its shorter grandchild to `a`. Returns the node now at a's position.
+uint32_t DynamicBvh::Balance(uint32_t a)
+{
+    Node& A = m_nodes[a];
+    if (A.IsLeaf() || A.height < 2) return a;
+
+    const int diff = int(m_nodes[A.child[1]].height) - int(m_nodes[A.child[0]].height);
+    if (diff >= -1 && diff <= 1) return a;
+
+    const int tall = diff > 1 ? 1 : 0;     // child slot rotated up
+    const uint32_t up = A.child[tall];
+    Node& U = m_nodes[up];
+    const uint32_t g0 = U.child[0], g1 = U.child[1];
+    // U keeps its taller child and takes `a` in the other slot; `a` takes the shorter grandchild
+    const bool keep0 = m_nodes[g0].height > m_nodes[g1].height;
+    const uint32_t kept = keep0 ? g0 : g1, given = keep0 ? g1 : g0;
+
+    U.parent = A.parent;
+    if (U.parent == kNull) m_root = up;
+    else m_nodes[U.parent].child[m_nodes[U.parent].child[0] == a ? 0 : 1] = up;
+
+    U.child[0] = a;
+    U.child[1] = kept;
+    A.parent = up;
+    A.child[tall] = given;
+    m_nodes[given].parent = a;
+
+    Combine(a);
+    Combine(up);
+    return up;
+}
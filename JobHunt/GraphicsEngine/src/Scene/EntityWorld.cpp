@@ -0,0 +1,292 @@
+#include "Scene/EntityWorld.h"
+#include <bit>
+#include <new>
+
+using namespace GraphicsEngine;
+
+namespace {
+
+constexpr std::align_val_t kChunkAlign{ 64 };
+
+std::byte* AllocateChunk()
+{
+    return static_cast<std::byte*>(::operator new(Archetype::kChunkBytes, kChunkAlign));
+}
+
+void FreeChunk(std::byte* p)
+{
+    ::operator delete(p, kChunkAlign);
+}
+
+// Component ids in mask, ascending
+template <typename Fn> void ForEachBit(ComponentMask mask, Fn&& fn)
+{
+    while (mask) {
+        fn(uint32_t(std::countr_zero(mask)));
+        mask &= mask - 1;
+    }
+}
+
+}
+
+// ============================================================================
+// Archetype
+// ============================================================================
+Archetype::Archetype(ComponentMask mask)
+    : m_mask(mask)
+{
+    for (uint32_t i = 0; i < kComponentTypeCount; i++) m_offsets[i] = m_edges[i] = kAbsent;
+
+    uint32_t rowBytes = sizeof(Entity);
+    ForEachBit(mask, [&](uint32_t id) { rowBytes += kComponentInfo[id].size; });
+
+    // Largest row count whose arrays, each aligned for its type, fit in one chunk
+    for (m_capacity = kChunkBytes / rowBytes; m_capacity > 1; m_capacity--) {
+        size_t end = size_t(sizeof(Entity)) * m_capacity;
+        ForEachBit(mask, [&](uint32_t id) {
+            const ComponentInfo& ci = kComponentInfo[id];
+            end = (end + ci.align - 1) & ~size_t(ci.align - 1);
+            m_offsets[id] = uint32_t(end);
+            end += size_t(ci.size) * m_capacity;
+        });
+        if (end <= kChunkBytes) break;
+    }
+}
+
+Archetype::~Archetype()
+{
+    for (ArchetypeChunk& c : m_chunks) FreeChunk(c.data);
+    if (m_spare) FreeChunk(m_spare);
+}
+
+uint32_t Archetype::PushRow(Entity e)
+{
+    if (m_count == ChunkCount() * m_capacity) {
+        std::byte* data = m_spare ? m_spare : AllocateChunk();
+        m_spare = nullptr;
+        m_chunks.push_back({ data, 0 });
+    }
+    m_chunks.back().count++;
+    RowEntity(m_count) = e;
+    return m_count++;
+}
+
+Entity Archetype::RemoveRow(uint32_t row)
+{
+    const uint32_t last = m_count - 1;
+    Entity moved{};
+    if (row != last) {
+        moved = RowEntity(last);
+        RowEntity(row) = moved;
+        ForEachBit(m_mask, [&](uint32_t id) { std::memcpy(Row(row, id), Row(last, id), kComponentInfo[id].size); });
+    }
+
+    m_count--;
+    if (--m_chunks.back().count == 0) {
+        if (m_spare) FreeChunk(m_spare);
+        m_spare = m_chunks.back().data;
+        m_chunks.pop_back();
+    }
+    return moved;
+}
+
+// ============================================================================
+// EntityWorld
+// ============================================================================
+EntityWorld::EntityWorld() = default;
+EntityWorld::~EntityWorld() = default;
+
+uint32_t EntityWorld::GetArchetype(ComponentMask mask)
+{
+    auto it = m_archetypeByMask.find(mask);
+    if (it != m_archetypeByMask.end()) return it->second;
+
+    const uint32_t index = (uint32_t)m_archetypes.size();
+    m_archetypes.push_back(std::make_unique<Archetype>(mask));
+    m_archetypeByMask.emplace(mask, index);
+    return index;
+}
+
+uint32_t EntityWorld::ArchetypeWithToggled(uint32_t archetype, uint32_t component)
+{
+    uint32_t& edge = m_archetypes[archetype]->m_edges[component];
+    if (edge == Archetype::kAbsent) {
+        edge = GetArchetype(m_archetypes[archetype]->m_mask ^ (ComponentMask(1) << component));
+        m_archetypes[edge]->m_edges[component] = archetype;
+    }
+    return edge;
+}
+
+const EntityWorld::EntityRecord* EntityWorld::Find(Entity e) const
+{
+    if (e.index >= m_records.size()) return nullptr;
+    const EntityRecord& r = m_records[e.index];
+    return (r.generation == e.generation && r.archetype != UINT32_MAX) ? &r : nullptr;
+}
+
+bool EntityWorld::IsAlive(Entity e) const { return Find(e) != nullptr; }
+
+Entity EntityWorld::Create(ComponentMask mask, const void* const* values)
+{
+    assert(!m_iterating && "structural change while iterating: use an EntityCommandBuffer");
+
+    Entity e;
+    if (!m_freeSlots.empty()) {
+        e.index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        e.index = (uint32_t)m_records.size();
+        m_records.emplace_back();
+    }
+    EntityRecord& r = m_records[e.index];
+    e.generation = r.generation;
+
+    r.archetype = GetArchetype(mask);
+    Archetype& a = *m_archetypes[r.archetype];
+    r.row = a.PushRow(e);
+    ForEachBit(mask, [&](uint32_t id) {
+        const void* v = values && values[id] ? values[id] : kComponentInfo[id].defaultValue;
+        std::memcpy(a.Row(r.row, id), v, kComponentInfo[id].size);
+    });
+    m_alive++;
+    return e;
+}
+
+void EntityWorld::Destroy(Entity e)
+{
+    assert(!m_iterating && "structural change while iterating: use an EntityCommandBuffer");
+    if (!Find(e)) return;
+
+    EntityRecord& r = m_records[e.index];
+    const Entity moved = m_archetypes[r.archetype]->RemoveRow(r.row);
+    if (moved.IsValid()) m_records[moved.index].row = r.row;
+
+    r.archetype = UINT32_MAX;
+    r.generation++;
+    m_freeSlots.push_back(e.index);
+    m_alive--;
+}
+
+void EntityWorld::MoveEntity(Entity e, uint32_t toArchetype)
+{
+    EntityRecord& r = m_records[e.index];
+    Archetype& from = *m_archetypes[r.archetype];
+    Archetype& to = *m_archetypes[toArchetype];
+
+    const uint32_t row = to.PushRow(e);
+    ForEachBit(to.m_mask, [&](uint32_t id) {
+        const void* v = (from.m_mask >> id) & 1 ? from.Row(r.row, id) : kComponentInfo[id].defaultValue;
+        std::memcpy(to.Row(row, id), v, kComponentInfo[id].size);
+    });
+
+    const Entity moved = from.RemoveRow(r.row);
+    if (moved.IsValid()) m_records[moved.index].row = r.row;
+    r.archetype = toArchetype;
+    r.row = row;
+}
+
+void EntityWorld::AddComponent(Entity e, uint32_t component, const void* value)
+{
+    const EntityRecord* r = Find(e);
+    if (!r) return;
+    if (!((m_archetypes[r->archetype]->m_mask >> component) & 1)) {
+        assert(!m_iterating && "structural change while iterating: use an EntityCommandBuffer");
+        MoveEntity(e, ArchetypeWithToggled(r->archetype, component));
+    }
+    if (value) std::memcpy(m_archetypes[r->archetype]->Row(r->row, component), value, kComponentInfo[component].size);
+}
+
+void EntityWorld::RemoveComponent(Entity e, uint32_t component)
+{
+    const EntityRecord* r = Find(e);
+    if (!r || !((m_archetypes[r->archetype]->m_mask >> component) & 1)) return;
+    assert(!m_iterating && "structural change while iterating: use an EntityCommandBuffer");
+    MoveEntity(e, ArchetypeWithToggled(r->archetype, component));
+}
+
+void* EntityWorld::GetComponent(Entity e, uint32_t component) const
+{
+    const EntityRecord* r = Find(e);
+    if (!r) return nullptr;
+    const Archetype& a = *m_archetypes[r->archetype];
+    return (a.m_mask >> component) & 1 ? a.Row(r->row, component) : nullptr;
+}
+
+ComponentMask EntityWorld::GetMask(Entity e) const
+{
+    const EntityRecord* r = Find(e);
+    return r ? m_archetypes[r->archetype]->m_mask : 0;
+}
+
+const std::vector<Archetype*>& EntityWorld::Match(ComponentMask all, ComponentMask none)
+{
+    QueryCache* q = nullptr;
+    for (const auto& c : m_queries)
+        if (c->all == all && c->none == none) { q = c.get(); break; }
+    if (!q) {
+        m_queries.push_back(std::make_unique<QueryCache>());
+        q = m_queries.back().get();
+        q->all = all;
+        q->none = none;
+    }
+
+    for (; q->seen < m_archetypes.size(); q->seen++) {
+        Archetype* a = m_archetypes[q->seen].get();
+        if ((a->m_mask & all) == all && !(a->m_mask & none)) q->archetypes.push_back(a);
+    }
+    return q->archetypes;
+}
+
+void EntityWorld::Playback(EntityCommandBuffer& cmds)
+{
+    using Op = EntityCommandBuffer::Op;
+    const std::byte* p = cmds.m_data.data();
+    const std::byte* end = p + cmds.m_data.size();
+    auto get = [&](auto& v) { std::memcpy(&v, p, sizeof(v)); p += sizeof(v); };
+
+    while (p < end) {
+        Op op;
+        get(op);
+        switch (op) {
+        case Op::Create: {
+            uint32_t n;
+            get(n);
+            const void* values[kComponentTypeCount] = {};
+            ComponentMask mask = 0;
+            for (uint32_t i = 0; i < n; i++) {
+                uint32_t id;
+                get(id);
+                values[id] = p;   // unaligned, but only ever memcpy'd
+                mask |= ComponentMask(1) << id;
+                p += kComponentInfo[id].size;
+            }
+            Create(mask, values);
+            break;
+        }
+        case Op::Destroy: {
+            Entity e;
+            get(e);
+            Destroy(e);
+            break;
+        }
+        case Op::Add: {
+            Entity e;
+            uint32_t id;
+            get(e);
+            get(id);
+            AddComponent(e, id, p);
+            p += kComponentInfo[id].size;
+            break;
+        }
+        case Op::Remove: {
+            Entity e;
+            uint32_t id;
+            get(e);
+            get(id);
+            RemoveComponent(e, id);
+            break;
+        }
+        }
+    }
+    cmds.Clear();
+}
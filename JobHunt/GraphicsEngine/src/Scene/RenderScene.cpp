@@ -0,0 +1,194 @@
+#include "Scene/RenderScene.h"
+#include "Core/Counters.h"
+#include "Core/Profiler.h"
+
+using namespace GraphicsEngine;
+
+// ============================================================================
+// RenderCommandQueue (game side)
+// ============================================================================
+RenderProxyId RenderCommandQueue::Create(const RenderProxyDesc& desc)
+{
+    RenderProxyId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = m_nextId++;
+    }
+    Put(Op::Create);
+    Put(id);
+    Put(desc);
+    return id;
+}
+
+void RenderCommandQueue::Destroy(RenderProxyId id)
+{
+    Put(Op::Destroy);
+    Put(id);
+    // Reusable at once: the render side applies commands in order, so the destroy lands first
+    m_freeIds.push_back(id);
+}
+
+void RenderCommandQueue::SetTransform(RenderProxyId id, const float4x4& world)
+{
+    Put(Op::SetTransform);
+    Put(id);
+    Put(world);
+}
+
+void RenderCommandQueue::SetBounds(RenderProxyId id, const AABB_t& localBounds)
+{
+    Put(Op::SetBounds);
+    Put(id);
+    Put(localBounds);
+}
+
+void RenderCommandQueue::SetVisible(RenderProxyId id, bool visible)
+{
+    Put(Op::SetVisible);
+    Put(id);
+    Put(uint8_t(visible));
+}
+
+void RenderCommandQueue::Submit()
+{
+    if (m_recording.empty()) return;
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_submitted.empty()) m_submitted.swap(m_recording);
+    else m_submitted.insert(m_submitted.end(), m_recording.begin(), m_recording.end());
+    m_recording.clear();
+}
+
+// ============================================================================
+// RenderScene (render side)
+// ============================================================================
+void RenderScene::MarkDirty(RenderProxyId id)
+{
+    if (m_state[id].dirty) return;
+    m_state[id].dirty = true;
+    m_dirty.push_back(id);
+}
+
+void RenderScene::CountKind(uint32_t kind, int delta)
+{
+    for (uint32_t b = 0; b < 32; b++)
+        if (kind & (1u << b)) m_kindCount[b] += delta;
+}
+
+uint32_t RenderScene::ProxyCount(uint32_t kinds) const
+{
+    uint32_t n = 0;
+    for (uint32_t b = 0; b < 32; b++)
+        if (kinds & (1u << b)) n += m_kindCount[b];
+    return n;
+}
+
+RenderScene::UpdateStats RenderScene::ApplyUpdates(RenderCommandQueue& queue)
+{
+    PROFILE_SCOPE("RenderScene::ApplyUpdates");
+    {
+        std::lock_guard<std::mutex> lock(queue.m_lock);
+        m_applying.swap(queue.m_submitted);
+    }
+
+    using Op = RenderCommandQueue::Op;
+    UpdateStats stats;
+    const std::byte* p = m_applying.data();
+    const std::byte* end = p + m_applying.size();
+    auto get = [&](auto& v) { std::memcpy(&v, p, sizeof(v)); p += sizeof(v); };
+
+    while (p < end) {
+        Op op;
+        RenderProxyId id;
+        get(op);
+        get(id);
+        stats.commands++;
+        switch (op) {
+        case Op::Create: {
+            RenderProxyDesc desc;
+            get(desc);
+            if (id >= m_state.size()) {
+                m_state.resize(id + 1);
+                m_world.resize(id + 1);
+                m_worldBounds.resize(id + 1);
+            }
+            ProxyState& s = m_state[id];
+            s.localBounds = desc.localBounds;
+            s.color = desc.color;
+            s.mesh = desc.mesh;
+            s.material = desc.material;
+            s.kind = desc.kind;
+            s.alive = true;
+            s.visible = desc.visible;
+            m_world[id] = desc.world;
+            m_alive++;
+            CountKind(s.kind, +1);
+            MarkDirty(id);
+            break;
+        }
+        case Op::Destroy: {
+            ProxyState& s = m_state[id];
+            if (!s.alive) break;
+            if (s.leaf != DynamicBvh::kNull) m_bvh.Remove(s.leaf);
+            s.leaf = DynamicBvh::kNull;
+            s.alive = false;
+            m_alive--;
+            CountKind(s.kind, -1);
+            break;
+        }
+        case Op::SetTransform:
+            get(m_world[id]);
+            MarkDirty(id);
+            break;
+        case Op::SetBounds:
+            get(m_state[id].localBounds);
+            MarkDirty(id);
+            break;
+        case Op::SetVisible: {
+            uint8_t v;
+            get(v);
+            m_state[id].visible = v != 0;
+            MarkDirty(id);
+            break;
+        }
+        }
+    }
+    m_applying.clear();
+
+    // World bounds and BVH leaves, for the proxies touched above only
+    for (RenderProxyId id : m_dirty) {
+        ProxyState& s = m_state[id];
+        s.dirty = false;
+        if (!s.alive) continue;
+        stats.dirty++;
+        m_worldBounds[id] = aabb_transform_affine(s.localBounds, m_world[id]);
+
+        // Hidden proxies leave the tree, so they cost culling nothing
+        if (!s.visible) {
+            if (s.leaf != DynamicBvh::kNull) m_bvh.Remove(s.leaf);
+            s.leaf = DynamicBvh::kNull;
+        } else if (s.leaf == DynamicBvh::kNull) {
+            s.leaf = m_bvh.Insert(m_worldBounds[id], id, s.kind);
+            stats.reinserted++;
+        } else if (m_bvh.Move(s.leaf, m_worldBounds[id])) {
+            stats.reinserted++;
+        }
+    }
+    m_dirty.clear();
+
+    COUNTER_ADD(ProxyUpdates, stats.dirty);
+    return stats;
+}
+
+uint32_t RenderScene::CullViews(const CullViewSet& views, std::span<const uint32_t> kinds, VisibilityMasks& out) const
+{
+    PROFILE_SCOPE("RenderScene::CullViews");
+    out.Reset(views.Count(), (uint32_t)m_state.size());
+    return m_bvh.QueryViews(views, kinds, [&](uint32_t id, uint32_t partial, uint32_t inside) {
+        // The fat box straddles `partial`; the exact bounds decide those
+        uint32_t visible = inside;
+        if (partial) visible |= views.Classify(m_worldBounds[id].center, m_worldBounds[id].extents, partial);
+        for (; visible; visible &= visible - 1) out.Set((uint32_t)std::countr_zero(visible), id);
+    });
+}
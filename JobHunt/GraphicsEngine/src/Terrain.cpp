@@ -0,0 +1,544 @@
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace GraphicsEngine;
+
+namespace {
+    bool IsPow2(uint32_t v) { return v && !(v & (v - 1)); }
+    uint32_t Log2(uint32_t v) { uint32_t r = 0; while (v >>= 1) r++; return r; }
+
+    bool TerrainLevels(uint32_t size, uint32_t leafSize, uint32_t& levels)
+    {
+        if (leafSize < 2 || !IsPow2(leafSize) || size % leafSize) return false;
+        uint32_t n = size / leafSize;
+        levels = 1;
+        while (n > 1) { if (n & 1) return false; n >>= 1; levels++; }
+        return true;
+    }
+
+    // Distance from a point to the closest point of an AABB
+    float BoxDistanceSq(const float3& p, const AABB_t& b)
+    {
+        float dx = SOL_MAX(std::fabs(p.x - b.center.x) - b.extents.x, 0.0f);
+        float dy = SOL_MAX(std::fabs(p.y - b.center.y) - b.extents.y, 0.0f);
+        float dz = SOL_MAX(std::fabs(p.z - b.center.z) - b.extents.z, 0.0f);
+        return dx * dx + dy * dy + dz * dz;
+    }
+}
+
+// ============================================================================
+// Offline build
+// ============================================================================
+bool GraphicsEngine::BuildTerrainFile(const std::string& path, const TerrainBuildDesc& desc, const TerrainSampleFn& source)
+{
+    TerrainFileHeader hdr;
+    if (!TerrainLevels(desc.size, desc.leafSize, hdr.levels)) return false;
+    // Power-of-two tiles and base map keep runtime sampling to shifts and masks
+    if (!IsPow2(desc.tileSize) || desc.size % desc.tileSize || desc.tileSize % desc.leafSize) return false;
+    if (!IsPow2(desc.baseSize) || desc.size % desc.baseSize) return false;
+
+    hdr.size = desc.size;
+    hdr.tileSize = desc.tileSize;
+    hdr.leafSize = desc.leafSize;
+    hdr.baseSize = desc.baseSize;
+    hdr.sampleSpacing = desc.sampleSpacing;
+    hdr.heightScale = desc.heightScale;
+    hdr.heightOffset = desc.heightOffset;
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    hdr.tilesOffset = sizeof(hdr);
+
+    const uint32_t T = desc.tileSize, TS = T + 1, L = desc.leafSize;
+    const uint32_t tiles = desc.size / T, leaves = desc.size / L, leavesPerTile = T / L;
+    const uint32_t B = desc.baseSize, BS = B + 1, baseStep = desc.size / B;
+
+    std::vector<uint16_t> leafMinMax(size_t(leaves) * leaves * 2);
+    std::vector<uint16_t> base(size_t(BS) * BS);
+    std::vector<uint16_t> tile(size_t(TS) * TS);
+
+    for (uint32_t tz = 0; tz < tiles; tz++) {
+        for (uint32_t tx = 0; tx < tiles; tx++) {
+            const uint32_t x0 = tx * T, z0 = tz * T;
+            source(x0, z0, TS, TS, tile.data());
+            f.write(reinterpret_cast<const char*>(tile.data()), tile.size() * sizeof(uint16_t));
+
+            // Leaves inside this tile (their max edge is the tile's shared border)
+            for (uint32_t lz = 0; lz < leavesPerTile; lz++) {
+                for (uint32_t lx = 0; lx < leavesPerTile; lx++) {
+                    uint16_t mn = 0xFFFF, mx = 0;
+                    for (uint32_t z = lz * L; z <= (lz + 1) * L; z++) {
+                        const uint16_t* row = &tile[size_t(z) * TS + lx * L];
+                        for (uint32_t x = 0; x <= L; x++) { mn = std::min(mn, row[x]); mx = std::max(mx, row[x]); }
+                    }
+                    const size_t leaf = size_t(tz * leavesPerTile + lz) * leaves + (tx * leavesPerTile + lx);
+                    leafMinMax[leaf * 2 + 0] = mn;
+                    leafMinMax[leaf * 2 + 1] = mx;
+                }
+            }
+
+            // Point-sampled low-res base map (samples on the shared border are written twice, same value)
+            for (uint32_t bz = (z0 + baseStep - 1) / baseStep; bz * baseStep <= z0 + T && bz <= B; bz++)
+                for (uint32_t bx = (x0 + baseStep - 1) / baseStep; bx * baseStep <= x0 + T && bx <= B; bx++)
+                    base[size_t(bz) * BS + bx] = tile[size_t(bz * baseStep - z0) * TS + (bx * baseStep - x0)];
+        }
+    }
+
+    // Min/max pyramid, leaves first
+    hdr.pyramidOffset = uint64_t(f.tellp());
+    std::vector<uint16_t> level = std::move(leafMinMax), parent;
+    for (uint32_t n = leaves;; n >>= 1) {
+        f.write(reinterpret_cast<const char*>(level.data()), level.size() * sizeof(uint16_t));
+        if (n == 1) break;
+        const uint32_t pn = n >> 1;
+        parent.assign(size_t(pn) * pn * 2, 0);
+        for (uint32_t z = 0; z < pn; z++) {
+            for (uint32_t x = 0; x < pn; x++) {
+                uint16_t mn = 0xFFFF, mx = 0;
+                for (uint32_t c = 0; c < 4; c++) {
+                    const size_t child = size_t(z * 2 + (c >> 1)) * n + (x * 2 + (c & 1));
+                    mn = std::min(mn, level[child * 2 + 0]);
+                    mx = std::max(mx, level[child * 2 + 1]);
+                }
+                parent[(size_t(z) * pn + x) * 2 + 0] = mn;
+                parent[(size_t(z) * pn + x) * 2 + 1] = mx;
+            }
+        }
+        level.swap(parent);
+    }
+
+    hdr.baseOffset = uint64_t(f.tellp());
+    f.write(reinterpret_cast<const char*>(base.data()), base.size() * sizeof(uint16_t));
+
+    f.seekp(0);
+    f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    return bool(f);
+}
+
+// ============================================================================
+// Open / close
+// ============================================================================
+bool Terrain::Open(const std::string& path)
+{
+    Close();
+    m_file.open(path, std::ios::binary);
+    if (!m_file) return false;
+
+    TerrainFileHeader hdr;
+    uint32_t levels = 0;
+    if (!m_file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) ||
+        std::memcmp(hdr.magic, "GETR", 4) != 0 || hdr.version != 1 ||
+        !TerrainLevels(hdr.size, hdr.leafSize, levels) || levels != hdr.levels ||
+        !IsPow2(hdr.tileSize) || hdr.size % hdr.tileSize || !IsPow2(hdr.baseSize) || hdr.size % hdr.baseSize) {
+        Close();
+        return false;
+    }
+    m_hdr = hdr;
+
+    size_t nodes = 0;
+    m_levelOffset.resize(levels);
+    for (uint32_t l = 0; l < levels; l++) {
+        m_levelOffset[l] = nodes;
+        nodes += size_t(NodesPerSide(l)) * NodesPerSide(l);
+    }
+    m_minMax.resize(nodes * 2);
+    m_base.resize(size_t(hdr.baseSize + 1) * (hdr.baseSize + 1));
+
+    m_file.seekg(std::streamoff(hdr.pyramidOffset));
+    m_file.read(reinterpret_cast<char*>(m_minMax.data()), m_minMax.size() * sizeof(uint16_t));
+    m_file.seekg(std::streamoff(hdr.baseOffset));
+    m_file.read(reinterpret_cast<char*>(m_base.data()), m_base.size() * sizeof(uint16_t));
+    if (!m_file) { Close(); return false; }
+
+    const uint32_t tiles = hdr.size / hdr.tileSize;
+    m_tilesPerSide = tiles;
+    m_tileShift = Log2(hdr.tileSize);
+    m_baseShift = Log2(hdr.size / hdr.baseSize);
+    m_tileSlot.assign(size_t(tiles) * tiles, -1);
+    m_tileRequested.assign(size_t(tiles) * tiles, 0);
+    m_tileStream.assign(size_t(tiles) * tiles, kInvalidStream);
+    m_path = path;
+    m_streamFile = m_streamer ? m_streamer->OpenFile(path) : 0;
+    SetLod(m_gridDim, m_lodDistance, m_morphRatio);
+    return true;
+}
+
+void Terrain::Close()
+{
+    CancelStreaming();
+    if (m_file.is_open()) m_file.close();
+    m_file.clear();
+    m_hdr = TerrainFileHeader{};
+    m_levelOffset.clear();
+    m_minMax.clear();
+    m_base.clear();
+    m_tileSlot.clear();
+    m_tileRequested.clear();
+    m_tileStream.clear();
+    m_path.clear();
+    m_streamFile = 0;
+    m_tilesPerSide = m_tileShift = m_baseShift = 0;
+    m_tiles.clear();
+    m_nodes.clear();
+    m_vertexCount = 0;
+}
+
+void Terrain::SetLod(uint32_t gridDim, float lodDistance, float morphStartRatio)
+{
+    // Quadrant patches need an even half grid so their origins stay on the coarser lattice
+    m_gridDim = SOL_MAX(gridDim & ~3u, 4u);
+    if (m_hdr.leafSize) m_gridDim = SOL_MIN(m_gridDim, m_hdr.leafSize);
+    m_lodDistance = lodDistance;
+    m_morphRatio = clamp(morphStartRatio, 0.0f, 0.99f);
+
+    const uint32_t levels = SOL_MAX(m_hdr.levels, 1u);
+    m_ranges.resize(levels);
+    m_morphStart.resize(levels);
+    m_morphEnd.resize(levels);
+    float prev = 0.0f, range = lodDistance;
+    for (uint32_t l = 0; l < levels; l++, range *= 2.0f) {
+        m_ranges[l] = range;
+        m_morphEnd[l] = range;
+        m_morphStart[l] = prev + (range - prev) * m_morphRatio;
+        prev = range;
+    }
+
+    BuildPatch(m_gridDim, m_patchFull);
+    BuildPatch(m_gridDim / 2, m_patchHalf);
+}
+
+void Terrain::BuildPatch(uint32_t quads, std::vector<uint16_t>& out) const
+{
+    // Clockwise seen from +Y (D3D front face)
+    const uint32_t row = quads + 1;
+    out.clear();
+    out.reserve(size_t(quads) * quads * 6);
+    for (uint32_t z = 0; z < quads; z++) {
+        for (uint32_t x = 0; x < quads; x++) {
+            const uint16_t a = uint16_t(z * row + x), b = uint16_t(a + 1);
+            const uint16_t c = uint16_t(a + row), d = uint16_t(c + 1);
+            out.insert(out.end(), { a, c, d, a, d, b });
+        }
+    }
+}
+
+// ============================================================================
+// Quadtree selection
+// ============================================================================
+void Terrain::NodeMinMax(uint32_t level, uint32_t nx, uint32_t nz, float& mn, float& mx) const
+{
+    const size_t i = m_levelOffset[level] + size_t(nz) * NodesPerSide(level) + nx;
+    const float s = m_hdr.heightScale / 65535.0f;
+    mn = m_hdr.heightOffset + m_origin.y + float(m_minMax[i * 2 + 0]) * s;
+    mx = m_hdr.heightOffset + m_origin.y + float(m_minMax[i * 2 + 1]) * s;
+}
+
+AABB_t Terrain::NodeBounds(uint32_t level, uint32_t nx, uint32_t nz) const
+{
+    float mn, mx;
+    NodeMinMax(level, nx, nz, mn, mx);
+    const float size = float(m_hdr.leafSize << level) * m_hdr.sampleSpacing;
+    AABB_t b;
+    b.center = { m_origin.x + (float(nx) + 0.5f) * size, (mn + mx) * 0.5f, m_origin.z + (float(nz) + 0.5f) * size };
+    b.extents = { size * 0.5f, SOL_MAX((mx - mn) * 0.5f, 0.01f), size * 0.5f };
+    return b;
+}
+
+void Terrain::AddNode(uint32_t x, uint32_t z, uint32_t level, uint32_t quads)
+{
+    TerrainNode n;
+    n.x = x; n.z = z; n.level = level; n.quads = quads;
+    n.firstVertex = m_vertexCount;
+    m_vertexCount += (quads + 1) * (quads + 1);
+    m_nodes.push_back(n);
+}
+
+// Returns false when the node is outside its level's range, so the parent has to cover the area.
+bool Terrain::SelectNode(const float3& eye, const CullView* view, uint32_t level, uint32_t nx, uint32_t nz)
+{
+    const AABB_t b = NodeBounds(level, nx, nz);
+    if (BoxDistanceSq(eye, b) > m_ranges[level] * m_ranges[level]) return false;
+    if (view && !AabbVisible(*view, b)) return true;   // culled, nothing to draw
+
+    const uint32_t nodeQuads = m_hdr.leafSize << level;
+    if (level == 0 || BoxDistanceSq(eye, b) > m_ranges[level - 1] * m_ranges[level - 1]) {
+        AddNode(nx * nodeQuads, nz * nodeQuads, level, m_gridDim);
+        return true;
+    }
+
+    // Children that are too far for the finer level are drawn as quadrants at this level
+    for (uint32_t c = 0; c < 4; c++) {
+        const uint32_t cx = nx * 2 + (c & 1), cz = nz * 2 + (c >> 1);
+        if (SelectNode(eye, view, level - 1, cx, cz)) continue;
+        if (view && !AabbVisible(*view, NodeBounds(level - 1, cx, cz))) continue;
+        AddNode(cx * (nodeQuads / 2), cz * (nodeQuads / 2), level, m_gridDim / 2);
+    }
+    return true;
+}
+
+void Terrain::Select(const float3& eye, const CullView* view)
+{
+    m_nodes.clear();
+    m_vertexCount = 0;
+    if (!IsOpen()) return;
+    const uint32_t top = m_hdr.levels - 1;
+    const uint32_t roots = NodesPerSide(top);
+    for (uint32_t z = 0; z < roots; z++)
+        for (uint32_t x = 0; x < roots; x++)
+            SelectNode(eye, view, top, x, z);
+}
+
+// ============================================================================
+// Tile streaming
+// ============================================================================
+void Terrain::SetStreamer(AssetStreamer* streamer)
+{
+    CancelStreaming();
+    m_streamer = streamer;
+    m_streamFile = (m_streamer && IsOpen()) ? m_streamer->OpenFile(m_path) : 0;
+}
+
+void Terrain::CancelStreaming()
+{
+    for (int32_t t : m_streaming) {
+        if (m_streamer) m_streamer->Cancel(m_tileStream[t]);
+        m_tileStream[t] = kInvalidStream;
+    }
+    m_streaming.clear();
+}
+
+bool Terrain::LoadTile(int32_t tileIndex, Tile& slot)
+{
+    const size_t samples = size_t(m_hdr.tileSize + 1) * (m_hdr.tileSize + 1);
+    slot.samples.resize(samples);
+    m_file.clear();
+    m_file.seekg(std::streamoff(m_hdr.tilesOffset + uint64_t(tileIndex) * samples * sizeof(uint16_t)));
+    if (!m_file.read(reinterpret_cast<char*>(slot.samples.data()), samples * sizeof(uint16_t))) return false;
+    slot.index = tileIndex;
+    slot.lastUsed = m_frame;
+    return true;
+}
+
+int32_t Terrain::AcquireSlot()
+{
+    if (m_tiles.size() < m_tileBudget) {
+        m_tiles.emplace_back();
+        return int32_t(m_tiles.size() - 1);
+    }
+    // LRU among tiles not needed this frame
+    int32_t slot = -1;
+    uint64_t oldest = m_frame;
+    for (size_t i = 0; i < m_tiles.size(); i++)
+        if (m_tiles[i].lastUsed < oldest) { oldest = m_tiles[i].lastUsed; slot = int32_t(i); }
+    if (slot < 0) return -1;
+    if (m_tiles[slot].index >= 0) m_tileSlot[m_tiles[slot].index] = -1;
+    m_tiles[slot].index = -1;
+    return slot;
+}
+
+void Terrain::InstallTile(int32_t tileIndex, const uint8_t* data, size_t size)
+{
+    m_tileStream[tileIndex] = kInvalidStream;
+    m_streaming.erase(std::find(m_streaming.begin(), m_streaming.end(), tileIndex));
+
+    const size_t samples = size_t(m_hdr.tileSize + 1) * (m_hdr.tileSize + 1);
+    if (size != samples * sizeof(uint16_t) || m_tileSlot[tileIndex] >= 0) return;
+    const int32_t slot = AcquireSlot();
+    if (slot < 0) return;   // budget full of tiles in use; requested again next frame
+
+    Tile& tile = m_tiles[slot];
+    tile.samples.resize(samples);
+    std::memcpy(tile.samples.data(), data, size);
+    tile.index = tileIndex;
+    tile.lastUsed = m_frame;
+    m_tileSlot[tileIndex] = slot;
+}
+
+uint32_t Terrain::StreamTiles(const float3& eye, uint32_t maxLoads)
+{
+    if (!IsOpen()) return 0;
+    ++m_frame;
+
+    // Only nodes finer than the base map need full-resolution tiles
+    const uint32_t T = m_hdr.tileSize, tiles = m_hdr.size / T, baseStep = m_hdr.size / m_hdr.baseSize;
+    std::vector<std::pair<float, int32_t>> missing;
+    for (const TerrainNode& n : m_nodes) {
+        const uint32_t step = (m_hdr.leafSize << n.level) / m_gridDim;
+        if (step >= baseStep) continue;
+        const uint32_t span = n.quads * step;
+        const uint32_t tx0 = n.x / T, tz0 = n.z / T;
+        const uint32_t tx1 = SOL_MIN((n.x + span) / T, tiles - 1), tz1 = SOL_MIN((n.z + span) / T, tiles - 1);
+        for (uint32_t tz = tz0; tz <= tz1; tz++) {
+            for (uint32_t tx = tx0; tx <= tx1; tx++) {
+                const int32_t t = int32_t(tz * tiles + tx);
+                if (m_tileRequested[t] == m_frame) continue;
+                m_tileRequested[t] = m_frame;
+                if (m_tileSlot[t] >= 0) { m_tiles[m_tileSlot[t]].lastUsed = m_frame; continue; }
+                const float s = float(T) * m_hdr.sampleSpacing;
+                const float dx = m_origin.x + (float(tx) + 0.5f) * s - eye.x;
+                const float dz = m_origin.z + (float(tz) + 0.5f) * s - eye.z;
+                missing.push_back({ dx * dx + dz * dz, t });
+            }
+        }
+    }
+    std::sort(missing.begin(), missing.end());
+
+    uint32_t loads = 0;
+    if (m_streamFile) {
+        // Tiles that dropped out of the selection are not worth the bandwidth any more
+        for (size_t i = 0; i < m_streaming.size();) {
+            const int32_t t = m_streaming[i];
+            if (m_tileRequested[t] == m_frame) { i++; continue; }
+            m_streamer->Cancel(m_tileStream[t]);
+            m_tileStream[t] = kInvalidStream;
+            m_streaming[i] = m_streaming.back();
+            m_streaming.pop_back();
+        }
+
+        // Selected nodes are in the frustum, so every missing tile is a visible request
+        const uint32_t bytes = (T + 1) * (T + 1) * uint32_t(sizeof(uint16_t));
+        for (const auto& [d, t] : missing) {
+            const float priority = StreamPriority(std::sqrt(d), true);
+            if (m_tileStream[t] != kInvalidStream) { m_streamer->SetPriority(m_tileStream[t], priority); continue; }
+            if (loads >= maxLoads) continue;
+            StreamRequestDesc req;
+            req.file = m_streamFile;
+            req.offset = m_hdr.tilesOffset + uint64_t(t) * bytes;
+            req.size = bytes;
+            req.priority = priority;
+            req.upload = [this, t = t](const uint8_t* data, size_t size) { InstallTile(t, data, size); };
+            m_tileStream[t] = m_streamer->Request(std::move(req));
+            if (m_tileStream[t] == kInvalidStream) break;
+            m_streaming.push_back(t);
+            loads++;
+        }
+        return loads;
+    }
+
+    for (const auto& [d, t] : missing) {
+        if (loads >= maxLoads) break;
+        const int32_t slot = AcquireSlot();
+        if (slot < 0 || !LoadTile(t, m_tiles[slot])) break;
+        m_tileSlot[t] = slot;
+        loads++;
+    }
+    return loads;
+}
+
+// ============================================================================
+// Sampling / vertices
+// ============================================================================
+float Terrain::RawSample(uint32_t x, uint32_t z) const
+{
+    const uint32_t T = m_hdr.tileSize, last = m_tilesPerSide - 1;
+    const uint32_t tx = SOL_MIN(x >> m_tileShift, last), tz = SOL_MIN(z >> m_tileShift, last);
+    const int32_t slot = m_tileSlot[size_t(tz) * m_tilesPerSide + tx];
+    if (slot >= 0)
+        return float(m_tiles[slot].samples[size_t(z - (tz << m_tileShift)) * (T + 1) + (x - (tx << m_tileShift))]);
+
+    // Bilinear from the resident base map
+    const uint32_t B = m_hdr.baseSize, mask = (1u << m_baseShift) - 1;
+    const float invStep = 1.0f / float(1u << m_baseShift);
+    const uint32_t bx = SOL_MIN(x >> m_baseShift, B - 1), bz = SOL_MIN(z >> m_baseShift, B - 1);
+    const float fx = x >= (B << m_baseShift) ? 1.0f : float(x & mask) * invStep;
+    const float fz = z >= (B << m_baseShift) ? 1.0f : float(z & mask) * invStep;
+    const uint16_t* r0 = &m_base[size_t(bz) * (B + 1) + bx];
+    const uint16_t* r1 = r0 + (B + 1);
+    const float h0 = float(r0[0]) + (float(r0[1]) - float(r0[0])) * fx;
+    const float h1 = float(r1[0]) + (float(r1[1]) - float(r1[0])) * fx;
+    return h0 + (h1 - h0) * fz;
+}
+
+float Terrain::SampleHeight(float sx, float sz) const
+{
+    const float maxc = float(m_hdr.size);
+    sx = clamp(sx, 0.0f, maxc);
+    sz = clamp(sz, 0.0f, maxc);
+    const uint32_t x0 = SOL_MIN(uint32_t(sx), m_hdr.size - 1), z0 = SOL_MIN(uint32_t(sz), m_hdr.size - 1);
+    const float fx = sx - float(x0), fz = sz - float(z0);
+    const float h00 = RawSample(x0, z0), h10 = RawSample(x0 + 1, z0);
+    const float h01 = RawSample(x0, z0 + 1), h11 = RawSample(x0 + 1, z0 + 1);
+    const float h0 = h00 + (h10 - h00) * fx, h1 = h01 + (h11 - h01) * fx;
+    return h0 + (h1 - h0) * fz;
+}
+
+float Terrain::GetHeightAt(float worldX, float worldZ) const
+{
+    if (!IsOpen()) return m_origin.y;
+    const float inv = 1.0f / m_hdr.sampleSpacing;
+    const float h = SampleHeight((worldX - m_origin.x) * inv, (worldZ - m_origin.z) * inv);
+    return m_origin.y + m_hdr.heightOffset + h * (m_hdr.heightScale / 65535.0f);
+}
+
+void Terrain::WriteVertices(VertexPNC* dst, const float3& eye) const
+{
+    const float sp = m_hdr.sampleSpacing;
+    const float hs = m_hdr.heightScale / 65535.0f, hb = m_origin.y + m_hdr.heightOffset;
+    const float3 grass{ 0.36f, 0.45f, 0.28f }, rock{ 0.45f, 0.42f, 0.40f };
+    const int32_t maxc = int32_t(m_hdr.size);
+
+    // Patch heights plus a one-vertex apron, fetched once per node and shared by
+    // position, morph target and normal
+    std::vector<float> heights;
+    heights.reserve(size_t(m_gridDim + 3) * (m_gridDim + 3));
+
+    for (const TerrainNode& n : m_nodes) {
+        const uint32_t step = (m_hdr.leafSize << n.level) / m_gridDim;
+        const float ms = m_morphStart[n.level], me = m_morphEnd[n.level];
+        const float invMorph = 1.0f / SOL_MAX(me - ms, 1e-4f);
+        const float normalY = 2.0f * float(step) * sp / hs;   // central differences in raw units
+
+        const int32_t row = int32_t(n.quads) + 3;
+        heights.resize(size_t(row) * row);
+        for (int32_t j = 0; j < row; j++) {
+            const int32_t gz = SOL_MIN(SOL_MAX(int32_t(n.z) + (j - 1) * int32_t(step), 0), maxc);
+            for (int32_t i = 0; i < row; i++) {
+                const int32_t gx = SOL_MIN(SOL_MAX(int32_t(n.x) + (i - 1) * int32_t(step), 0), maxc);
+                heights[size_t(j) * row + i] = RawSample(uint32_t(gx), uint32_t(gz));
+            }
+        }
+
+        for (int32_t j = 0; j <= int32_t(n.quads); j++) {
+            const float* hr = &heights[size_t(j + 1) * row + 1];
+            const float wz = m_origin.z + float(n.z + j * step) * sp;
+            for (int32_t i = 0; i <= int32_t(n.quads); i++) {
+                const float wx = m_origin.x + float(n.x + i * step) * sp;
+                const float h = hr[i];
+
+                // Morph factor from the unmorphed 3D distance; odd vertices slide onto their even
+                // neighbour (height included), so at k = 1 the patch matches the next coarser level.
+                const float3 d{ wx - eye.x, hb + h * hs - eye.y, wz - eye.z };
+                const float k = saturate((length(d) - ms) * invMorph);
+                const int32_t ox = i & 1, oz = j & 1;
+                const float target = hr[i - ox - oz * row];
+                const float mh = h + (target - h) * k;
+
+                float3 nrm{ hr[i - 1] - hr[i + 1], normalY, hr[i - row] - hr[i + row] };
+                nrm = normalize_safe(nrm, { 0,1,0 });
+
+                const float slope = saturate((1.0f - nrm.y) * 3.0f);
+                dst->pos = { wx - float(ox) * float(step) * sp * k, hb + mh * hs, wz - float(oz) * float(step) * sp * k };
+                dst->normal = nrm;
+                dst->color = grass + (rock - grass) * slope;
+                ++dst;
+            }
+        }
+    }
+}
+
+TerrainMemoryStats Terrain::GetMemoryStats() const
+{
+    TerrainMemoryStats s;
+    s.pyramidBytes = m_minMax.size() * sizeof(uint16_t);
+    s.baseBytes = m_base.size() * sizeof(uint16_t);
+    for (const Tile& t : m_tiles) {
+        s.tileBytes += t.samples.capacity() * sizeof(uint16_t);
+        if (t.index >= 0) s.residentTiles++;
+    }
+    const uint32_t tiles = m_hdr.tileSize ? m_hdr.size / m_hdr.tileSize : 0;
+    s.totalTiles = tiles * tiles;
+    return s;
+}
@@ -0,0 +1,221 @@
+#include "Text.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+using namespace GraphicsEngine;
+
+namespace {
+    constexpr uint32_t kGlyphW = 5, kGlyphH = 7;
+    constexpr uint32_t kCellW = 8, kCellH = 8;        // 1px gutter at least; Load() never bleeds anyway
+    constexpr uint32_t kAdvance = 6, kLineHeight = 9;
+    constexpr uint32_t kReplacement = 0xFFFD;
+
+    // 5x7 bitmaps, one byte per row top to bottom, bit 4 = leftmost column. Printable ASCII 0x20-0x7E.
+    constexpr uint8_t kAscii[95][kGlyphH] = {
+        {0x00,0x00,0x00,0x00,0x00,0x00,0x00}, {0x04,0x04,0x04,0x04,0x00,0x00,0x04}, // space !
+        {0x0A,0x0A,0x0A,0x00,0x00,0x00,0x00}, {0x0A,0x0A,0x1F,0x0A,0x1F,0x0A,0x0A}, // " #
+        {0x04,0x0F,0x14,0x0E,0x05,0x1E,0x04}, {0x18,0x19,0x02,0x04,0x08,0x13,0x03}, // $ %
+        {0x0C,0x12,0x14,0x08,0x15,0x12,0x0D}, {0x0C,0x04,0x08,0x00,0x00,0x00,0x00}, // & '
+        {0x02,0x04,0x08,0x08,0x08,0x04,0x02}, {0x08,0x04,0x02,0x02,0x02,0x04,0x08}, // ( )
+        {0x00,0x04,0x15,0x0E,0x15,0x04,0x00}, {0x00,0x04,0x04,0x1F,0x04,0x04,0x00}, // * +
+        {0x00,0x00,0x00,0x00,0x0C,0x04,0x08}, {0x00,0x00,0x00,0x1F,0x00,0x00,0x00}, // , -
+        {0x00,0x00,0x00,0x00,0x00,0x0C,0x0C}, {0x00,0x01,0x02,0x04,0x08,0x10,0x00}, // . /
+        {0x0E,0x11,0x13,0x15,0x19,0x11,0x0E}, {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}, // 0 1
+        {0x0E,0x11,0x01,0x02,0x04,0x08,0x1F}, {0x1F,0x02,0x04,0x02,0x01,0x11,0x0E}, // 2 3
+        {0x02,0x06,0x0A,0x12,0x1F,0x02,0x02}, {0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E}, // 4 5
+        {0x06,0x08,0x10,0x1E,0x11,0x11,0x0E}, {0x1F,0x01,0x02,0x04,0x08,0x08,0x08}, // 6 7
+        {0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E}, {0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C}, // 8 9
+        {0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x00}, {0x00,0x0C,0x0C,0x00,0x0C,0x04,0x08}, // : ;
+        {0x02,0x04,0x08,0x10,0x08,0x04,0x02}, {0x00,0x00,0x1F,0x00,0x1F,0x00,0x00}, // < =
+        {0x08,0x04,0x02,0x01,0x02,0x04,0x08}, {0x0E,0x11,0x01,0x02,0x04,0x00,0x04}, // > ?
+        {0x0E,0x11,0x01,0x0D,0x15,0x15,0x0E}, {0x0E,0x11,0x11,0x11,0x1F,0x11,0x11}, // @ A
+        {0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E}, {0x0E,0x11,0x10,0x10,0x10,0x11,0x0E}, // B C
+        {0x1C,0x12,0x11,0x11,0x11,0x12,0x1C}, {0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F}, // D E
+        {0x1F,0x10,0x10,0x1E,0x10,0x10,0x10}, {0x0E,0x11,0x10,0x17,0x11,0x11,0x0F}, // F G
+        {0x11,0x11,0x11,0x1F,0x11,0x11,0x11}, {0x0E,0x04,0x04,0x04,0x04,0x04,0x0E}, // H I
+        {0x07,0x02,0x02,0x02,0x02,0x12,0x0C}, {0x11,0x12,0x14,0x18,0x14,0x12,0x11}, // J K
+        {0x10,0x10,0x10,0x10,0x10,0x10,0x1F}, {0x11,0x1B,0x15,0x15,0x11,0x11,0x11}, // L M
+        {0x11,0x11,0x19,0x15,0x13,0x11,0x11}, {0x0E,0x11,0x11,0x11,0x11,0x11,0x0E}, // N O
+        {0x1E,0x11,0x11,0x1E,0x10,0x10,0x10}, {0x0E,0x11,0x11,0x11,0x15,0x12,0x0D}, // P Q
+        {0x1E,0x11,0x11,0x1E,0x14,0x12,0x11}, {0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E}, // R S
+        {0x1F,0x04,0x04,0x04,0x04,0x04,0x04}, {0x11,0x11,0x11,0x11,0x11,0x11,0x0E}, // T U
+        {0x11,0x11,0x11,0x11,0x11,0x0A,0x04}, {0x11,0x11,0x11,0x15,0x15,0x15,0x0A}, // V W
+        {0x11,0x11,0x0A,0x04,0x0A,0x11,0x11}, {0x11,0x11,0x11,0x0A,0x04,0x04,0x04}, // X Y
+        {0x1F,0x01,0x02,0x04,0x08,0x10,0x1F}, {0x0E,0x08,0x08,0x08,0x08,0x08,0x0E}, // Z [
+        {0x00,0x10,0x08,0x04,0x02,0x01,0x00}, {0x0E,0x02,0x02,0x02,0x02,0x02,0x0E}, // \ ]
+        {0x04,0x0A,0x11,0x00,0x00,0x00,0x00}, {0x00,0x00,0x00,0x00,0x00,0x00,0x1F}, // ^ _
+        {0x08,0x04,0x02,0x00,0x00,0x00,0x00}, {0x00,0x00,0x0E,0x01,0x0F,0x11,0x0F}, // ` a
+        {0x10,0x10,0x16,0x19,0x11,0x11,0x1E}, {0x00,0x00,0x0E,0x10,0x10,0x11,0x0E}, // b c
+        {0x01,0x01,0x0D,0x13,0x11,0x11,0x0F}, {0x00,0x00,0x0E,0x11,0x1F,0x10,0x0E}, // d e
+        {0x06,0x09,0x08,0x1C,0x08,0x08,0x08}, {0x00,0x0F,0x11,0x11,0x0F,0x01,0x0E}, // f g
+        {0x10,0x10,0x16,0x19,0x11,0x11,0x11}, {0x04,0x00,0x0C,0x04,0x04,0x04,0x0E}, // h i
+        {0x02,0x00,0x06,0x02,0x02,0x12,0x0C}, {0x10,0x10,0x12,0x14,0x18,0x14,0x12}, // j k
+        {0x0C,0x04,0x04,0x04,0x04,0x04,0x0E}, {0x00,0x00,0x1A,0x15,0x15,0x11,0x11}, // l m
+        {0x00,0x00,0x16,0x19,0x11,0x11,0x11}, {0x00,0x00,0x0E,0x11,0x11,0x11,0x0E}, // n o
+        {0x00,0x00,0x1E,0x11,0x1E,0x10,0x10}, {0x00,0x00,0x0D,0x13,0x0F,0x01,0x01}, // p q
+        {0x00,0x00,0x16,0x19,0x10,0x10,0x10}, {0x00,0x00,0x0E,0x10,0x0E,0x01,0x1E}, // r s
+        {0x08,0x08,0x1C,0x08,0x08,0x09,0x06}, {0x00,0x00,0x11,0x11,0x11,0x13,0x0D}, // t u
+        {0x00,0x00,0x11,0x11,0x11,0x0A,0x04}, {0x00,0x00,0x11,0x11,0x15,0x15,0x0A}, // v w
+        {0x00,0x00,0x11,0x0A,0x04,0x0A,0x11}, {0x00,0x00,0x11,0x11,0x0F,0x01,0x0E}, // x y
+        {0x00,0x00,0x1F,0x02,0x04,0x08,0x1F}, {0x02,0x04,0x04,0x08,0x04,0x04,0x02}, // z {
+        {0x04,0x04,0x04,0x04,0x04,0x04,0x04}, {0x08,0x04,0x04,0x02,0x04,0x04,0x08}, // | }
+        {0x00,0x00,0x08,0x15,0x02,0x00,0x00},                                        // ~
+    };
+
+    struct ExtraGlyph { uint32_t codepoint; uint8_t rows[kGlyphH]; };
+    constexpr ExtraGlyph kExtra[] = {
+        { 0x00B0, {0x0C,0x12,0x12,0x0C,0x00,0x00,0x00} },   // degree
+        { 0x00B1, {0x04,0x04,0x1F,0x04,0x04,0x00,0x1F} },   // plus-minus
+        { 0x00B5, {0x00,0x00,0x11,0x11,0x13,0x1D,0x10} },   // micro
+        { kReplacement, {0x1F,0x11,0x11,0x11,0x11,0x11,0x1F} },
+    };
+}
+
+// ============================================================================
+// Atlas
+// ============================================================================
+void GlyphAtlas::BakeBuiltin()
+{
+    const uint32_t count = 95 + uint32_t(std::size(kExtra));
+    const uint32_t columns = 16;
+    m_width = columns * kCellW;
+    m_height = (count + columns - 1) / columns * kCellH;
+    m_height = (m_height + 63) & ~63u;                 // keep the texture a friendly size
+    m_pixels.assign(size_t(m_width) * m_height, 0);
+    m_lineHeight = kLineHeight;
+
+    uint32_t cell = 0;
+    auto bake = [&](const uint8_t (&rows)[kGlyphH]) {
+        Glyph g;
+        g.u = uint16_t(cell % columns * kCellW);
+        g.v = uint16_t(cell / columns * kCellH);
+        g.w = kGlyphW;
+        g.h = kGlyphH;
+        g.advance = kAdvance;
+        for (uint32_t y = 0; y < kGlyphH; y++)
+            for (uint32_t x = 0; x < kGlyphW; x++)
+                if (rows[y] & (0x10u >> x)) m_pixels[size_t(g.v + y) * m_width + g.u + x] = 255;
+        cell++;
+        return g;
+    };
+
+    for (uint32_t c = 0; c < 95; c++) m_ascii[0x20 + c] = bake(kAscii[c]);
+    m_extra.clear();
+    for (const ExtraGlyph& e : kExtra) {
+        const Glyph g = bake(e.rows);
+        if (e.codepoint == kReplacement) m_replacement = g;
+        else m_extra.push_back({ e.codepoint, g });
+    }
+    // Control characters draw nothing but still advance (layout handles \n and \t itself)
+    for (uint32_t c = 0; c < 0x20; c++) m_ascii[c] = m_ascii[0x20];
+    m_ascii[0x7F] = m_replacement;
+}
+
+const Glyph& GlyphAtlas::Find(uint32_t codepoint) const
+{
+    if (codepoint < 128) return m_ascii[codepoint];
+    auto it = std::lower_bound(m_extra.begin(), m_extra.end(), codepoint,
+        [](const std::pair<uint32_t, Glyph>& e, uint32_t cp) { return e.first < cp; });
+    return (it != m_extra.end() && it->first == codepoint) ? it->second : m_replacement;
+}
+
+// ============================================================================
+// UTF-8 / layout
+// ============================================================================
+uint32_t GraphicsEngine::DecodeUtf8(std::string_view s, size_t& pos)
+{
+    const uint8_t b0 = uint8_t(s[pos++]);
+    if (b0 < 0x80) return b0;
+
+    uint32_t need, cp, min;
+    if      ((b0 & 0xE0) == 0xC0) { need = 1; cp = b0 & 0x1F; min = 0x80; }
+    else if ((b0 & 0xF0) == 0xE0) { need = 2; cp = b0 & 0x0F; min = 0x800; }
+    else if ((b0 & 0xF8) == 0xF0) { need = 3; cp = b0 & 0x07; min = 0x10000; }
+    else return kReplacement;
+
+    if (pos + need > s.size()) return kReplacement;
+    for (uint32_t i = 0; i < need; i++) {
+        const uint8_t b = uint8_t(s[pos + i]);
+        if ((b & 0xC0) != 0x80) return kReplacement;
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    // Overlong forms, surrogates and out-of-range values are malformed
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return kReplacement;
+    pos += need;
+    return cp;
+}
+
+void GraphicsEngine::ShapeText(const GlyphAtlas& atlas, std::string_view utf8, ShapedText& out)
+{
+    out.glyphs.clear();
+    const float lineHeight = float(atlas.LineHeight());
+    float penX = 0.0f, penY = 0.0f, width = 0.0f;
+    size_t pos = 0;
+    while (pos < utf8.size()) {
+        const uint32_t cp = DecodeUtf8(utf8, pos);
+        if (cp == '\n') { width = std::max(width, penX); penX = 0.0f; penY += lineHeight; continue; }
+        const Glyph& g = atlas.Find(cp == '\t' ? ' ' : cp);
+        if (cp == '\t') {
+            const float tab = float(g.advance) * 4.0f;
+            penX = (std::floor(penX / tab) + 1.0f) * tab;
+            continue;
+        }
+        if (cp > ' ') out.glyphs.push_back({ penX + g.xoff, penY + g.yoff, g.u, g.v, g.w, g.h });
+        penX += g.advance;
+    }
+    out.width = std::max(width, penX);
+    out.height = utf8.empty() ? 0.0f : penY + lineHeight;
+}
+
+// ============================================================================
+// Batch
+// ============================================================================
+void TextBatch::Begin()
+{
+    m_instances.clear();
+    m_frame++;
+    m_stats.glyphs = m_stats.strings = m_stats.cacheHits = m_stats.cacheMisses = 0;
+
+    // Sweep occasionally; a stale entry only costs memory until then. Text that changes every
+    // frame (timers, coordinates) can outrun that, so a full cache keeps only last frame's strings.
+    const bool full = m_cache.size() > kMaxCached;
+    if ((m_frame & 63) == 0 || full) {
+        const uint64_t keep = full ? 0 : kEvictFrames;
+        for (auto it = m_cache.begin(); it != m_cache.end();)
+            it = (m_frame - it->second.lastUsed > keep) ? m_cache.erase(it) : std::next(it);
+    }
+    m_stats.cached = uint32_t(m_cache.size());
+}
+
+const ShapedText& TextBatch::Shape(std::string_view utf8)
+{
+    ShapedText& shaped = m_cache[HashBytes128(utf8.data(), utf8.size())];
+    if (shaped.lastUsed == 0) {
+        ShapeText(*m_atlas, utf8, shaped);
+        m_stats.cacheMisses++;
+    } else {
+        m_stats.cacheHits++;
+    }
+    shaped.lastUsed = m_frame + 1;   // never 0, so "not shaped yet" stays distinguishable
+    return shaped;
+}
+
+TextExtent TextBatch::Draw(std::string_view utf8, float x, float y, float scale, uint32_t color)
+{
+    const ShapedText& shaped = Shape(utf8);
+    m_stats.strings++;
+    m_stats.glyphs += uint32_t(shaped.glyphs.size());
+    const size_t first = m_instances.size();
+    m_instances.resize(first + shaped.glyphs.size());
+    GlyphInstance* out = m_instances.data() + first;
+    for (const ShapedGlyph& g : shaped.glyphs)
+        *out++ = { x + g.x * scale, y + g.y * scale, g.w * scale, g.h * scale, g.u, g.v, g.w, g.h, color };
+    return { shaped.width * scale, shaped.height * scale };
+}
+
+TextExtent TextBatch::Measure(std::string_view utf8, float scale)
+{
+    const ShapedText& shaped = Shape(utf8);
+    return { shaped.width * scale, shaped.height * scale };
+}
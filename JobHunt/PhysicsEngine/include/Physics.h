@@ -1,5 +1,8 @@
 #pragma once
-#if defined(PHYSICSENGINE_EXPORTS)
+// PHYSICSENGINE_STATIC: compiled straight into a tool instead of imported from the DLL
+#if !defined(_WIN32) || defined(PHYSICSENGINE_STATIC)
+#  define PHYSICS_API
+#elif defined(PHYSICSENGINE_EXPORTS)
 #  define PHYSICS_API __declspec(dllexport)
 #else
 #  define PHYSICS_API __declspec(dllimport)
@@ -0,0 +1,211 @@
+// AnimBench: skeletal animation throughput. Builds a generated skeleton and looping clips, compresses
+// them (reports size and the measured per-track error against the tolerances), then animates N
+// characters per frame: a two-level blend tree over three clips, then local-to-model, spread over
+// the job system. The SIMD sample / blend / local-to-model paths are checked against the scalar
+// SolMath reference first. Results go to JSON.
+//   AnimBench [--characters N] [--joints N] [--frames N] [--passes N] [--threads N] [--out results.json]
+#include "Animation/AnimationClip.h"
+#include "Animation/BlendTree.h"
+#include "Animation/Pose.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+constexpr uint32_t kClipCount = 3;
+
+// Each joint hangs off one of the four joints before it: long chains with some branching
+Skeleton MakeSkeleton(uint32_t joints)
+{
+    Skeleton s;
+    s.parents.resize(joints);
+    s.bindPose.resize(joints);
+    for (uint32_t j = 0; j < joints; j++) {
+        s.parents[j] = j ? int16_t(j - 1 - Hash(j) % std::min(j, 4u)) : int16_t(-1);
+        s.bindPose[j].translation = j ? float3{ 0.02f * (Unit(Hash(j * 3)) - 0.5f), 0.12f, 0.02f * (Unit(Hash(j * 5)) - 0.5f) }
+                                      : float3{ 0, 1, 0 };
+    }
+    return s;
+}
+
+// Looping clip: every joint swings about its own axis with a whole number of cycles per clip; every
+// fourth joint holds still (a constant track), and only the root translates
+RawClip MakeClip(const Skeleton& skeleton, uint32_t clipIndex, uint32_t frames)
+{
+    RawClip raw;
+    raw.sampleRate = 30.0f;
+    raw.frameCount = frames;
+    raw.jointCount = skeleton.JointCount();
+    raw.samples.resize(size_t(frames) * raw.jointCount);
+    for (uint32_t j = 0; j < raw.jointCount; j++) {
+        const uint32_t h = Hash(j * 7919 + clipIndex * 104729);
+        const float3 axis = normalize_safe(float3{ Unit(h) - 0.5f, Unit(h >> 8) - 0.5f, Unit(h >> 16) - 0.5f }, { 0, 0, 1 });
+        const float amplitude = (j % 4 == 3) ? 0.0f : 0.2f + 0.6f * Unit(Hash(h));
+        const float cycles = float(1 + Hash(h + 1) % 3), phase = 2.0f * kPi * Unit(Hash(h + 2));
+        for (uint32_t f = 0; f < frames; f++) {
+            const float u = frames > 1 ? float(f) / float(frames - 1) : 0.0f;
+            JointTransform& t = raw.samples[size_t(f) * raw.jointCount + j];
+            t.rotation = q_from_axis_angle(axis, amplitude * std::sin(2.0f * kPi * cycles * u + phase));
+            t.translation = skeleton.bindPose[j].translation;
+            if (j == 0) t.translation += float3{ 0.3f * std::sin(2.0f * kPi * u), 0.05f * std::sin(4.0f * kPi * u), 0 };
+        }
+    }
+    return raw;
+}
+
+// Scalar reference: q_nlerp / m_trs / m_mul over the same compressed keys
+bool Verify(const Skeleton& skeleton, std::span<const AnimationClip> clips, const BlendTree& tree, std::span<const float> params)
+{
+    BlendTree::Context ctx;
+    Pose pose;
+    tree.Evaluate(clips, params, pose, ctx);
+    std::vector<float4x4> model(skeleton.JointCount());
+    LocalToModel(skeleton, pose, model);
+
+    // The bench tree: blend(blend(clip0, clip1, p3), clip2, p4) with times p0..p2
+    float maxRot = 0, maxPos = 0;
+    std::vector<float4x4> ref(skeleton.JointCount());
+    for (uint32_t j = 0; j < skeleton.JointCount(); j++) {
+        const JointTransform s0 = clips[0].SampleJoint(j, params[0]);
+        const JointTransform s1 = clips[1].SampleJoint(j, params[1]);
+        const JointTransform s2 = clips[2].SampleJoint(j, params[2]);
+        const quat r = q_nlerp(q_nlerp(s0.rotation, s1.rotation, params[3]), s2.rotation, params[4]);
+        const float3 t = lerp(lerp(s0.translation, s1.translation, params[3]), s2.translation, params[4]);
+        maxRot = std::max(maxRot, 1.0f - std::fabs(q_dot(r, pose.Rotation(j))));
+        maxPos = std::max(maxPos, length(t - pose.Translation(j)));
+
+        const float4x4 local = m_trs(t, r, skeleton.bindPose[j].scale);
+        ref[j] = skeleton.parents[j] < 0 ? local : m_mul(local, ref[skeleton.parents[j]]);
+        for (int row = 0; row < 4; row++) maxPos = std::max(maxPos, length(ref[j][row] - model[j][row]));
+    }
+    return maxRot < 1e-5f && maxPos < 1e-4f;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t characters = 1000, joints = 60, frames = 90, passes = 20, threads = UINT32_MAX;
+    std::string outPath = "anim_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--characters") && more) characters = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--joints") && more) joints = uint32_t(std::clamp(std::atoi(argv[++i]), 1, 32767));
+        else if (!std::strcmp(argv[i], "--frames") && more) frames = uint32_t(std::clamp(std::atoi(argv[++i]), 2, 65536));
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && more) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: AnimBench [--characters N] [--joints N] [--frames N] [--passes N] [--threads N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    // --threads 1 = everything on the main thread
+    JobSystem jobs(threads == UINT32_MAX ? UINT32_MAX : (threads ? threads - 1 : 0));
+
+    // Content
+    const Skeleton skeleton = MakeSkeleton(joints);
+    const ClipCompression settings;
+    std::vector<AnimationClip> clips;
+    size_t rawBytes = 0, packedBytes = 0;
+    uint32_t keys = 0, tracks = 0;
+    float maxRotError = 0, maxPosError = 0;
+    for (uint32_t c = 0; c < kClipCount; c++) {
+        const RawClip raw = MakeClip(skeleton, c, frames);
+        std::vector<TrackError> errors;
+        clips.push_back(AnimationClip::Compress(raw, settings, &errors));
+        rawBytes += raw.samples.size() * sizeof(JointTransform);
+        packedBytes += clips.back().SizeBytes();
+        for (const TrackError& e : errors) {
+            maxRotError = std::max(maxRotError, e.rotation);
+            maxPosError = std::max(maxPosError, e.translation);
+            keys += e.rotationKeys + e.translationKeys;
+            tracks += 2;
+        }
+    }
+    const bool withinBounds = maxRotError <= settings.rotationTolerance && maxPosError <= settings.translationTolerance;
+
+    // blend(blend(clip0, clip1, w0), clip2, w1); params: three clip times, then the two weights
+    BlendTree tree;
+    const uint32_t inner = tree.AddBlend(tree.AddClip(0, 0), tree.AddClip(1, 1), 3);
+    tree.AddBlend(inner, tree.AddClip(2, 2), 4);
+
+    std::vector<float> params(size_t(characters) * tree.ParamCount());
+    auto setParams = [&](uint32_t pass) {
+        for (uint32_t c = 0; c < characters; c++) {
+            float* p = &params[size_t(c) * tree.ParamCount()];
+            const float t = float(pass) / 60.0f + 0.137f * float(c);
+            p[0] = t; p[1] = t * 1.1f; p[2] = t * 0.9f;
+            p[3] = 0.2f + 0.6f * Unit(Hash(c));
+            p[4] = 0.1f + 0.4f * Unit(Hash(c + characters));
+        }
+    };
+    setParams(0);
+
+    bool ok = withinBounds;
+    for (uint32_t c = 0; c < std::min(characters, 16u) && ok; c++)
+        ok = Verify(skeleton, clips, tree, { &params[size_t(c) * tree.ParamCount()], tree.ParamCount() });
+
+    // Per frame: evaluate + local-to-model per character, batched over the job system
+    std::vector<Pose> poses(characters);
+    std::vector<float4x4> model(size_t(characters) * joints);
+    double bestEvaluate = 1e30, bestModel = 1e30, bestFrame = 1e30;
+    for (uint32_t pass = 0; pass < passes; pass++) {
+        setParams(pass);
+        const Clock::time_point t0 = Clock::now();
+        jobs.ParallelFor(characters, 16, [&](uint32_t begin, uint32_t end) {
+            thread_local BlendTree::Context ctx;
+            for (uint32_t c = begin; c < end; c++)
+                tree.Evaluate(clips, { &params[size_t(c) * tree.ParamCount()], tree.ParamCount() }, poses[c], ctx);
+        });
+        const Clock::time_point t1 = Clock::now();
+        jobs.ParallelFor(characters, 16, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t c = begin; c < end; c++)
+                LocalToModel(skeleton, poses[c], { &model[size_t(c) * joints], joints });
+        });
+        const Clock::time_point t2 = Clock::now();
+        bestEvaluate = std::min(bestEvaluate, Seconds(t0, t1));
+        bestModel = std::min(bestModel, Seconds(t1, t2));
+        bestFrame = std::min(bestFrame, Seconds(t0, t2));
+    }
+
+    const double jointsPerFrame = double(characters) * joints;
+    std::printf("AnimBench: %u characters x %u joints, %u clips x %u frames, %u threads, %s\n",
+                characters, joints, kClipCount, frames, jobs.GetThreadCount(), ok ? "verified" : "MISMATCH");
+    std::printf("  clips      %8.1f KB raw -> %6.1f KB (%.1fx), %.2f keys/track, max error %.5f rad / %.6f (tolerance %.4f / %.4f)\n",
+                rawBytes / 1024.0, packedBytes / 1024.0, packedBytes ? double(rawBytes) / double(packedBytes) : 0.0,
+                tracks ? double(keys) / tracks : 0.0, maxRotError, maxPosError, settings.rotationTolerance, settings.translationTolerance);
+    std::printf("  sample+blend   %8.3f ms  %7.1f ns/joint\n", bestEvaluate * 1e3, bestEvaluate * 1e9 / jointsPerFrame);
+    std::printf("  local->model   %8.3f ms  %7.1f ns/joint\n", bestModel * 1e3, bestModel * 1e9 / jointsPerFrame);
+    std::printf("  frame          %8.3f ms  %7.2f us/character\n", bestFrame * 1e3, bestFrame * 1e6 / characters);
+
+    char buf[1024];
+    std::snprintf(buf, sizeof(buf),
+                  "{\n  \"benchmark\": \"anim_bench\",\n  \"characters\": %u,\n  \"joints\": %u,\n  \"clips\": %u,\n  \"frames\": %u,\n"
+                  "  \"threads\": %u,\n  \"verified\": %s,\n"
+                  "  \"compression\": { \"rawBytes\": %zu, \"bytes\": %zu, \"keysPerTrack\": %.3f, \"maxRotationError\": %.6f, \"maxTranslationError\": %.7f,"
+                  " \"rotationTolerance\": %.6f, \"translationTolerance\": %.7f },\n"
+                  "  \"results\": [\n"
+                  "    { \"name\": \"sample+blend\", \"ms\": %.4f, \"nsPerJoint\": %.3f },\n"
+                  "    { \"name\": \"local->model\", \"ms\": %.4f, \"nsPerJoint\": %.3f },\n"
+                  "    { \"name\": \"frame\", \"ms\": %.4f, \"usPerCharacter\": %.3f }\n  ]\n}\n",
+                  characters, joints, kClipCount, frames, jobs.GetThreadCount(), ok ? "true" : "false",
+                  rawBytes, packedBytes, tracks ? double(keys) / tracks : 0.0, maxRotError, maxPosError,
+                  settings.rotationTolerance, settings.translationTolerance,
+                  bestEvaluate * 1e3, bestEvaluate * 1e9 / jointsPerFrame, bestModel * 1e3, bestModel * 1e9 / jointsPerFrame,
+                  bestFrame * 1e3, bestFrame * 1e6 / characters);
+
+    if (!WriteFile(outPath, buf, "AnimBench")) return 1;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+#pragma once
+// Helpers shared by the headless benchmarks under Tools/: wall-clock timing, best-of-N measurement,
+// a reproducible hash for generated scenes and the JSON result file. Header-only, so a bench
+// target only adds "${CMAKE_SOURCE_DIR}/Tools" to its include directories.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double Seconds(Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double>(b - a).count(); }
+
+// Best of `passes` runs of fn, in seconds
+template <typename Fn> double BestOf(uint32_t passes, Fn&& fn)
+{
+    double best = 1e30;
+    for (uint32_t p = 0; p < passes; p++) {
+        const Clock::time_point t0 = Clock::now();
+        fn();
+        best = std::min(best, Seconds(t0, Clock::now()));
+    }
+    return best;
+}
+
+// Integer mixer: the same scene on every run and platform, unlike <random> distributions
+inline uint32_t Hash(uint32_t x)
+{
+    x ^= x >> 16; x *= 0x7feb352dU; x ^= x >> 15; x *= 0x846ca68bU; x ^= x >> 16;
+    return x;
+}
+inline float Unit(uint32_t h) { return float(h & 0xFFFF) / 65535.0f; }
+
+// Writes the result file; on failure reports it as `tool` and returns false
+inline bool WriteFile(const std::string& path, const std::string& text, const char* tool)
+{
+    FILE* f = std::fopen(path.c_str(), "wb");
+    const bool ok = f && std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    if (f) std::fclose(f);
+    if (!ok) std::fprintf(stderr, "%s: cannot write %s\n", tool, path.c_str());
+    return ok;
+}
+
+}
@@ -0,0 +1,158 @@
+// CullBench: multi-view culling cost as the view count grows. Scatters proxies over a large world
+// in a RenderScene, then culls 1 to 32 views of a split-screen frame (per player: the camera, four
+// shadow cascades, three probe faces) two ways: one RenderScene::Cull walk per view, and one
+// RenderScene::CullViews walk for all of them. Both must leave the same visible set per view.
+// Results go to JSON.
+//   CullBench [--proxies N] [--passes N] [--out results.json]
+#include "Common/Bench.h"
+#include "Culling.h"
+#include "Scene/RenderScene.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kWorldHalf = 500.0f;
+constexpr uint32_t kViewsPerPlayer = 8;
+
+struct Row {
+    uint32_t views, visible, nodesShared, nodesSeparate;
+    double   shared, separate;
+    bool     ok;
+};
+
+uint32_t g_seed = 0x2545F491u;
+float Random01()
+{
+    g_seed ^= g_seed << 13; g_seed ^= g_seed >> 17; g_seed ^= g_seed << 5;
+    return float(g_seed & 0xFFFFFF) * (1.0f / 16777215.0f);
+}
+
+void Fill(RenderScene& scene, uint32_t count)
+{
+    RenderCommandQueue queue;
+    for (uint32_t i = 0; i < count; i++) {
+        RenderProxyDesc d;
+        const float s = 0.5f + 2.5f * Random01();
+        d.world = m_mul(m_scale({ s, s, s }), m_translation({ (Random01() * 2 - 1) * kWorldHalf, Random01() * 20.0f,
+                                                               (Random01() * 2 - 1) * kWorldHalf }));
+        d.kind = kProxyMesh;
+        queue.Create(d);
+    }
+    queue.Submit();
+    scene.ApplyUpdates(queue);
+}
+
+// Player p's views: camera, four cascades around it (an orthographic light looking down and
+// sideways), three 90-degree probe faces at its position
+std::vector<CullView> MakeViews(uint32_t count)
+{
+    std::vector<CullView> views;
+    const float3 lightDir = normalize_safe(float3{ 0.4f, -0.8f, 0.45f });
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t player = i / kViewsPerPlayer, k = i % kViewsPerPlayer;
+        const float yaw = 0.7f + 1.9f * float(player);
+        const float3 pos{ std::cos(yaw) * 120.0f * float(player), 2.0f, std::sin(yaw) * 120.0f * float(player) };
+        const float3 fwd{ std::sin(yaw), -0.05f, std::cos(yaw) };
+        if (k == 0) {
+            views.push_back(MakeCullView(camera_to_world(pos, fwd, { 0, 1, 0 }), 1.0f, 16.0f / 9.0f, 0.1f, 400.0f));
+        } else if (k <= 4) {
+            // Cascade k covers the camera's first 25 * 3^(k-1) metres
+            const float radius = 25.0f * std::pow(3.0f, float(k - 1)) * 0.5f;
+            const float3 center = pos + fwd * radius;
+            const float4x4 view = look_at(center - lightDir * 300.0f, center, { 0, 1, 0 });
+            const float4x4 proj = ortho_off_center(-radius, radius, -radius, radius, 1.0f, 600.0f);
+            views.push_back(MakeCullViewFromClip(m_mul(view, proj), center - lightDir * 300.0f));
+        } else {
+            const float a = yaw + 1.5707963f * float(k - 5);
+            views.push_back(MakeCullView(camera_to_world(pos, { std::sin(a), 0, std::cos(a) }, { 0, 1, 0 }), 1.5707963f, 1.0f, 0.1f, 60.0f));
+        }
+    }
+    return views;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t proxies = 100'000, passes = 10;
+    std::string outPath = "cull_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--proxies") && more) proxies = uint32_t(std::max(1.0, std::atof(argv[++i])));
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: CullBench [--proxies N] [--passes N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    RenderScene scene;
+    Fill(scene, proxies);
+    const uint32_t ids = proxies;   // a fresh queue hands out ids 0..proxies-1
+
+    std::vector<Row> rows;
+    bool allOk = true;
+    CullViewSet set;
+    VisibilityMasks shared, separate;
+    for (const uint32_t count : { 1u, 2u, 4u, 8u, 16u, 32u }) {
+        const std::vector<CullView> views = MakeViews(count);
+        const std::vector<uint32_t> kinds(count, kProxyMesh);
+        Row row{};
+        row.views = count;
+
+        row.shared = BestOf(passes, [&] {
+            set.Set(views);
+            row.nodesShared = scene.CullViews(set, kinds, shared);
+        });
+        row.separate = BestOf(passes, [&] {
+            separate.Reset(count, ids);
+            row.nodesSeparate = 0;
+            for (uint32_t v = 0; v < count; v++)
+                row.nodesSeparate += scene.Cull(views[v], kProxyMesh, [&](RenderProxyId id, bool) { separate.Set(v, id); });
+        });
+
+        row.ok = true;
+        for (uint32_t v = 0; v < count; v++) {
+            row.visible += shared.Count(v);
+            for (uint32_t w = 0; w < shared.WordCount(); w++) row.ok &= shared.Word(v, w) == separate.Word(v, w);
+        }
+        allOk &= row.ok;
+        rows.push_back(row);
+    }
+
+    std::printf("CullBench: %u proxies, BVH height %u, best of %u passes\n", proxies, scene.Bvh().Height(), passes);
+    std::printf("  %5s %9s  %10s %10s  %10s %10s  %8s %8s  %s\n", "views", "visible", "nodes", "nodes sep", "shared",
+                "separate", "x 1 view", "sep x1", "check");
+    std::string json;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf), "{\n  \"benchmark\": \"cull_bench\",\n  \"proxies\": %u,\n  \"verified\": %s,\n  \"results\": [",
+                  proxies, allOk ? "true" : "false");
+    json += buf;
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Row& r = rows[i];
+        // Cost relative to culling the first view alone: N separate walks approach N, the shared walk should not
+        const double scale = r.shared / rows[0].shared, scaleSeparate = r.separate / rows[0].separate;
+        std::printf("  %5u %9u  %10u %10u  %8.3fms %8.3fms  %8.2f %8.2f  %s\n", r.views, r.visible, r.nodesShared,
+                    r.nodesSeparate, r.shared * 1e3, r.separate * 1e3, scale, scaleSeparate, r.ok ? "ok" : "MISMATCH");
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    { \"views\": %u, \"visible\": %u, \"nodesShared\": %u, \"nodesSeparate\": %u,"
+                      " \"sharedMs\": %.4f, \"separateMs\": %.4f, \"sharedScale\": %.3f, \"separateScale\": %.3f, \"ok\": %s }",
+                      i ? "," : "", r.views, r.visible, r.nodesShared, r.nodesSeparate, r.shared * 1e3, r.separate * 1e3,
+                      scale, scaleSeparate, r.ok ? "true" : "false");
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+
+    if (!WriteFile(outPath, json, "CullBench")) return 1;
+    return allOk ? 0 : 1;
+}
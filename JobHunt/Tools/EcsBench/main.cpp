@@ -0,0 +1,159 @@
+// EcsBench: EntityWorld throughput at scale. Creates N entities (Transform + Velocity, every
+// fourth also Color, so queries span two archetypes), then times chunk iteration serial, per
+// entity and on the job system, adding and removing a component on every entity, a parallel pass
+// that destroys half of them through command buffers, and destroying the rest. Results go to JSON.
+//   EcsBench [--entities N] [--passes N] [--threads N] [--out results.json]
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include "Scene/EntityWorld.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kDt = 1.0f / 60.0f;
+
+struct Result {
+    const char* name;
+    double      seconds;     // best pass
+    uint64_t    items;       // entities touched per pass
+};
+
+// Best of `passes` runs of fn, which reports how many entities it touched
+template <typename Fn> Result Measure(const char* name, uint32_t passes, Fn&& fn)
+{
+    Result r{ name, 0, 0 };
+    r.seconds = BestOf(passes, [&] { r.items = fn(); });
+    return r;
+}
+
+void Integrate(uint32_t count, Transform* t, const Velocity* v)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        t[i].position.x += v[i].value.x * kDt;
+        t[i].position.y += v[i].value.y * kDt;
+        t[i].position.z += v[i].value.z * kDt;
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t entities = 1'000'000, passes = 5, threads = UINT32_MAX;
+    std::string outPath = "ecs_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--entities") && more) entities = uint32_t(std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && more) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: EcsBench [--entities N] [--passes N] [--threads N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    // --threads 1 = everything on the main thread
+    JobSystem jobs(threads == UINT32_MAX ? UINT32_MAX : (threads ? threads - 1 : 0));
+    std::vector<Result> results;
+    auto world = std::make_unique<EntityWorld>();
+    std::vector<Entity> handles(entities);
+
+    auto populate = [&] {
+        for (uint32_t i = 0; i < entities; i++) {
+            const uint32_t h = Hash(i);
+            const Transform t{ { float(h & 1023), float((h >> 10) & 1023) - 512.0f, float(h >> 20) }, 0.0f, { 1, 1, 1 } };
+            const Velocity v{ { 1.0f, (h & 1) ? 1.0f : -1.0f, 0.5f } };
+            handles[i] = (i & 3) ? world->Create(t, v) : world->Create(t, v, Color{});
+        }
+        return uint64_t(entities);
+    };
+    // Creation is measured once, on an empty world: later passes would reuse the freed slots
+    results.push_back(Measure("create", 1, populate));
+
+    results.push_back(Measure("iterate chunks", passes, [&] {
+        world->ForEachChunk<Transform, const Velocity>([](uint32_t n, const Entity*, Transform* t, const Velocity* v) { Integrate(n, t, v); });
+        return uint64_t(world->EntityCount());
+    }));
+    results.push_back(Measure("iterate entities", passes, [&] {
+        world->ForEach<Transform, const Velocity>([](Entity, Transform& t, const Velocity& v) {
+            t.position.x += v.value.x * kDt;
+            t.position.y += v.value.y * kDt;
+            t.position.z += v.value.z * kDt;
+        });
+        return uint64_t(world->EntityCount());
+    }));
+    results.push_back(Measure("iterate parallel", passes, [&] {
+        world->ParallelForEachChunk<Transform, const Velocity>(jobs, [](uint32_t n, const Entity*, Transform* t, const Velocity* v) { Integrate(n, t, v); }, 8);
+        return uint64_t(world->EntityCount());
+    }));
+    uint64_t colored = 0;
+    results.push_back(Measure("query 2nd archetype", passes, [&] {
+        colored = 0;
+        world->ForEachChunk<const Color>([&](uint32_t n, const Entity*, const Color*) { colored += n; });
+        return colored;
+    }));
+
+    // Structural changes: every entity moves to the +Bounds archetype and back
+    results.push_back(Measure("add component", 1, [&] {
+        for (Entity e : handles) world->Add(e, Bounds{});
+        return uint64_t(entities);
+    }));
+    results.push_back(Measure("remove component", 1, [&] {
+        for (Entity e : handles) world->Remove<Bounds>(e);
+        return uint64_t(entities);
+    }));
+    results.push_back(Measure("get component", passes, [&] {
+        float sum = 0.0f;
+        for (Entity e : handles) sum += world->Get<Transform>(e)->position.x;
+        if (sum == -1.0f) std::printf(" ");   // keep the loop
+        return uint64_t(entities);
+    }));
+
+    // Jobs decide, command buffers apply: destroy everything moving down (half the world)
+    results.push_back(Measure("deferred destroy (par)", 1, [&] {
+        const uint64_t before = world->EntityCount();
+        world->ParallelForEachChunk<const Velocity>(jobs, [](EntityCommandBuffer& cmds, uint32_t n, const Entity* e, const Velocity* v) {
+            for (uint32_t i = 0; i < n; i++)
+                if (v[i].value.y < 0.0f) cmds.Destroy(e[i]);
+        }, 8);
+        return before - world->EntityCount();
+    }));
+    const uint32_t survivors = world->EntityCount();
+
+    results.push_back(Measure("destroy", 1, [&] {
+        const uint64_t before = world->EntityCount();
+        for (Entity e : handles) world->Destroy(e);
+        return before;
+    }));
+
+    std::printf("EcsBench: %u entities, %u threads, %u archetypes, %u left after deferred destroy\n",
+                entities, jobs.GetThreadCount(), world->ArchetypeCount(), survivors);
+    std::string json;
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "{\n  \"benchmark\": \"ecs_bench\",\n  \"entities\": %u,\n  \"threads\": %u,\n  \"passes\": %u,\n  \"results\": [",
+                  entities, jobs.GetThreadCount(), passes);
+    json += buf;
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        const double mps = r.seconds > 0 ? double(r.items) / r.seconds * 1e-6 : 0.0;
+        const double ns = r.items ? r.seconds * 1e9 / double(r.items) : 0.0;
+        std::printf("  %-24s %9llu  %9.3f ms  %8.2f ns/entity  %8.1f M/s\n", r.name, (unsigned long long)r.items, r.seconds * 1e3, ns, mps);
+        std::snprintf(buf, sizeof(buf), "%s\n    { \"name\": \"%s\", \"entities\": %llu, \"ms\": %.4f, \"nsPerEntity\": %.3f, \"millionPerSec\": %.3f }",
+                      i ? "," : "", r.name, (unsigned long long)r.items, r.seconds * 1e3, ns, mps);
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+
+    if (!WriteFile(outPath, json, "EcsBench")) return 1;
+    return 0;
+}
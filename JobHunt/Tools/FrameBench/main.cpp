@@ -0,0 +1,410 @@
+// FrameBench: the CPU side of a frame, headless, over generated box scenes. Per frame: camera
+// path + scene update, frustum culling, per-object constant writes, debug-line vertex generation
+// and the ground/grid, all allocated from an UploadRing over host memory. Results go to JSON.
+//   FrameBench [--preset NAME]... [--suite quick|full] [--frames N] [--warmup N]
+//              [--path orbit|flythrough|still] [--threads N] [--upload-mb N] [--out results.json]
+//   NAME = <static|dynamic|clustered>-<1k|10k|100k|1m|10m|count>, e.g. clustered-100k
+#include "Camera.h"
+#include "Common/Bench.h"
+#include "Core/FrameStats.h"
+#include "Core/JobSystem.h"
+#include "Culling.h"
+#include "DebugDraw.h"
+#include "GroundGrid.h"
+#include "Memory/UploadRing.h"
+#include "SolMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float    kBoxesPerSquareMeter = 0.25f;     // world grows with the box count, density stays fixed
+constexpr float    kFixedDt = 1.0f / 60.0f;
+constexpr uint32_t kCullBatch = 16384;
+constexpr uint32_t kFrameCount = 3;                  // upload ring slices, as in the renderer
+
+enum class Layout { Static, Dynamic, Clustered };
+enum class CameraPath { Orbit, Flythrough, Still };
+
+const char* LayoutName(Layout l) { return l == Layout::Static ? "static" : l == Layout::Dynamic ? "dynamic" : "clustered"; }
+const char* PathName(CameraPath p) { return p == CameraPath::Orbit ? "orbit" : p == CameraPath::Flythrough ? "flythrough" : "still"; }
+
+struct Preset {
+    std::string name;
+    Layout      layout = Layout::Static;
+    uint64_t    boxes = 0;
+};
+
+bool ParsePreset(const std::string& name, Preset& out)
+{
+    const size_t dash = name.find('-');
+    if (dash == std::string::npos) return false;
+    const std::string layout = name.substr(0, dash), count = name.substr(dash + 1);
+    if (layout == "static") out.layout = Layout::Static;
+    else if (layout == "dynamic") out.layout = Layout::Dynamic;
+    else if (layout == "clustered") out.layout = Layout::Clustered;
+    else return false;
+
+    char* end = nullptr;
+    double n = std::strtod(count.c_str(), &end);
+    if (end == count.c_str()) return false;
+    if (*end == 'k' || *end == 'K') { n *= 1e3; end++; }
+    else if (*end == 'm' || *end == 'M') { n *= 1e6; end++; }
+    if (*end || n < 1.0) return false;
+    out.name = name;
+    out.boxes = uint64_t(n);
+    return true;
+}
+
+// Same size and stride as the renderer's SceneCB, so the write traffic matches bindMVP
+struct ObjectCB {
+    float4x4 mvp;
+    float    lightDir[4];
+    float    viewport[4];
+    float4x4 lightMVP;
+};
+static_assert(sizeof(ObjectCB) == 160, "matches SceneCB");
+
+// Box bounds in one array (what the cull reads), everything else beside it
+struct BoxScene {
+    std::vector<AABB_t>   bounds;
+    std::vector<uint32_t> color;    // RGB8
+    std::vector<float>    baseY, phase;   // dynamic only
+    float                 halfSize = 0.0f;
+};
+
+float3 UnpackColor(uint32_t c)
+{
+    return { float(c & 255) / 255.0f, float((c >> 8) & 255) / 255.0f, float((c >> 16) & 255) / 255.0f };
+}
+
+void BuildScene(const Preset& p, BoxScene& s)
+{
+    const uint64_t n = p.boxes;
+    s.halfSize = 0.5f * std::sqrt(float(n) / kBoxesPerSquareMeter);
+    s.bounds.resize(n);
+    s.color.resize(n);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    auto rnd = [&] { return u01(rng); };
+
+    // Clustered: ~2000 boxes per cluster, normally distributed around uniformly placed centres
+    std::vector<float3> clusters;
+    if (p.layout == Layout::Clustered) {
+        clusters.resize(std::max<uint64_t>(1, n / 2000));
+        for (float3& c : clusters) c = { (rnd() * 2.0f - 1.0f) * s.halfSize, 0.0f, (rnd() * 2.0f - 1.0f) * s.halfSize };
+    }
+    std::normal_distribution<float> gauss(0.0f, 20.0f);
+
+    for (uint64_t i = 0; i < n; i++) {
+        float3 c;
+        if (p.layout == Layout::Clustered) {
+            const float3& k = clusters[i % clusters.size()];
+            c = { std::clamp(k.x + gauss(rng), -s.halfSize, s.halfSize), rnd() * 5.0f,
+                  std::clamp(k.z + gauss(rng), -s.halfSize, s.halfSize) };
+        }
+        else {
+            c = { (rnd() * 2.0f - 1.0f) * s.halfSize, rnd() * 5.0f, (rnd() * 2.0f - 1.0f) * s.halfSize };
+        }
+        const float3 e{ 0.5f + rnd() * 1.5f, 0.5f + rnd() * 1.5f, 0.5f + rnd() * 1.5f };
+        s.bounds[i] = AABB_t{ c, e };
+        s.color[i] = uint32_t(100 + rnd() * 155) | (uint32_t(100 + rnd() * 155) << 8) | (uint32_t(100 + rnd() * 155) << 16);
+    }
+
+    if (p.layout == Layout::Dynamic) {
+        s.baseY.resize(n);
+        s.phase.resize(n);
+        for (uint64_t i = 0; i < n; i++) { s.baseY[i] = s.bounds[i].center.y; s.phase[i] = rnd() * 6.2831853f; }
+    }
+}
+
+// Camera from a fresh basis each frame: yaw/pitch towards `target`
+Camera PlaceCamera(const float3& eye, const float3& target)
+{
+    Camera cam;
+    const float3 d = target - eye;
+    const float yaw = std::atan2(d.x, d.z);
+    const float pitch = std::atan2(d.y, std::sqrt(d.x * d.x + d.z * d.z));
+    cam.SetPosition(eye);
+    cam.YawPitch(yaw, pitch);
+    return cam;
+}
+
+Camera CameraAt(CameraPath path, float t, float duration, float halfSize)
+{
+    const float r = std::max(20.0f, halfSize * 0.7f);
+    switch (path) {
+    case CameraPath::Orbit: {
+        const float a = t * 0.25f;
+        return PlaceCamera({ std::sin(a) * r, 25.0f, std::cos(a) * r }, { 0.0f, 0.0f, 0.0f });
+    }
+    case CameraPath::Flythrough: {
+        // Corner to corner at low altitude, swaying left and right
+        const float k = duration > 0.0f ? t / duration : 0.0f;
+        const float3 eye{ -r + 2.0f * r * k, 12.0f, -r + 2.0f * r * k };
+        const float sway = std::sin(t * 0.8f) * 0.5f;
+        return PlaceCamera(eye, eye + float3{ std::sin(0.785f + sway), -0.15f, std::cos(0.785f + sway) });
+    }
+    case CameraPath::Still:
+    default:
+        return PlaceCamera({ 0.0f, 30.0f, -r }, { 0.0f, 0.0f, 0.0f });
+    }
+}
+
+struct RunResult {
+    Preset     preset;
+    double     setupSeconds = 0.0;
+    double     visibleAvg = 0.0, uploadAvg = 0.0, lineVertsAvg = 0.0;
+    uint64_t   visibleMax = 0, uploadMax = 0, uploadOverflows = 0;
+    FrameStats stats;
+    struct { uint32_t update, cull, constants, vertices, ground; } stage{};
+};
+
+void Run(const Preset& preset, CameraPath path, uint32_t frames, uint32_t warmup, JobSystem& jobs,
+         UploadRing& ring, RunResult& r)
+{
+    r.preset = preset;
+    r.stage = { r.stats.AddStage("Update"), r.stats.AddStage("Cull"), r.stats.AddStage("Constants"),
+                r.stats.AddStage("Vertices"), r.stats.AddStage("Ground") };
+
+    const auto s0 = Clock::now();
+    BoxScene scene;
+    BuildScene(preset, scene);
+    r.setupSeconds = Seconds(s0, Clock::now());
+
+    GroundGrid ground;
+    ground.SetDesc(ChunkRingDesc{});
+    ground.SetSpacing(1.0f);
+
+    const uint64_t n = scene.bounds.size();
+    const uint32_t batches = uint32_t((n + kCullBatch - 1) / kCullBatch);
+    std::vector<std::vector<uint32_t>> batchVisible(batches);
+    std::vector<uint32_t> visible;
+    DebugDrawFrame debugFrame;
+    std::vector<VertexPC> spill, lineSpill;
+    std::vector<VertexPNC> groundSpill;
+    DebugDraw::Clear();
+
+    const float duration = float(frames + warmup) * kFixedDt;
+    const float4x4 lightVP = m_mul(look_at({ 60.0f, 120.0f, -60.0f }, { 0, 0, 0 }, { 0, 1, 0 }),
+                                   perspective_fov(to_radians(60.0f), 1.0f, 10.0f, 1000.0f));
+
+    for (uint32_t f = 0; f < warmup + frames; f++) {
+        const bool measured = f >= warmup;
+        const float t = float(f) * kFixedDt;
+        const auto frameBegin = Clock::now();
+        ring.BeginFrame(f % kFrameCount);
+
+        // Update: camera path, then the moving boxes
+        Camera cam;
+        {
+            const auto b = Clock::now();
+            cam = CameraAt(path, t, duration, scene.halfSize);
+            if (preset.layout == Layout::Dynamic) {
+                jobs.ParallelFor(uint32_t(n), kCullBatch, [&](uint32_t begin, uint32_t end) {
+                    for (uint32_t i = begin; i < end; i++)
+                        scene.bounds[i].center.y = scene.baseY[i] + 1.5f * std::sin(t * 2.0f + scene.phase[i]);
+                });
+            }
+            if (measured) r.stats.Record(r.stage.update, Seconds(b, Clock::now()));
+        }
+
+        TheFrustum_t fr; Points pts;
+        frustum_build(fr, pts, cam.GetCameraToWorld(), cam.GetFovY(), cam.GetAspect(), cam.GetNearZ(), cam.GetFarZ());
+        const CullView view = MakeCullView(fr, cam.GetPosition());
+
+        // Cull: per-batch lists, concatenated in batch order so the result is deterministic
+        {
+            const auto b = Clock::now();
+            jobs.ParallelFor(batches, 1, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t k = begin; k < end; k++) {
+                    std::vector<uint32_t>& out = batchVisible[k];
+                    out.clear();
+                    const uint32_t last = uint32_t(std::min<uint64_t>(n, uint64_t(k + 1) * kCullBatch));
+                    for (uint32_t i = k * kCullBatch; i < last; i++)
+                        if (AabbVisible(view, scene.bounds[i])) out.push_back(i);
+                }
+            });
+            visible.clear();
+            for (const auto& v : batchVisible) visible.insert(visible.end(), v.begin(), v.end());
+            if (measured) r.stats.Record(r.stage.cull, Seconds(b, Clock::now()));
+        }
+        const uint32_t visibleCount = uint32_t(visible.size());
+
+        // Constants: one 256-byte aligned record per visible object, as bindMVP writes them
+        {
+            const auto b = Clock::now();
+            const size_t bytes = size_t(visibleCount) * 256;
+            if (bytes && ring.GetAvailableThisFrame() >= bytes + 256) {
+                uint8_t* dst = ring.Allocate(bytes, 256).cpuPtr;
+                const float4x4 VP = m_mul(cam.GetView(), cam.GetProj());
+                jobs.ParallelFor(visibleCount, 1024, [&](uint32_t begin, uint32_t end) {
+                    for (uint32_t i = begin; i < end; i++) {
+                        const AABB_t& box = scene.bounds[visible[i]];
+                        const float4x4 M = m_mul(m_scale(box.extents), m_translation(box.center));
+                        ObjectCB cb{};
+                        cb.mvp = m_mul(M, VP);
+                        cb.lightMVP = m_mul(M, lightVP);
+                        std::memcpy(dst + size_t(i) * 256, &cb, sizeof(cb));
+                    }
+                });
+            }
+            else if (bytes) r.uploadOverflows++;
+            if (measured) r.stats.Record(r.stage.constants, Seconds(b, Clock::now()));
+        }
+
+        // Vertices: box outlines through DebugDraw (emitted from the workers), merged into the ring
+        uint32_t lineVerts = 0;
+        {
+            const auto b = Clock::now();
+            jobs.ParallelFor(visibleCount, 1024, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++)
+                    DebugDraw::Box(scene.bounds[visible[i]], UnpackColor(scene.color[visible[i]]));
+            });
+            DebugDraw::Collect(kFixedDt, debugFrame, [&](uint32_t count) -> VertexPC* {
+                lineVerts = count;
+                const size_t bytes = size_t(count) * sizeof(VertexPC);
+                if (ring.GetAvailableThisFrame() < bytes + 256) {   // counted, and kept off the ring
+                    r.uploadOverflows++;
+                    spill.resize(count);
+                    return spill.data();
+                }
+                return reinterpret_cast<VertexPC*>(ring.Allocate(bytes, 256).cpuPtr);
+            });
+            if (measured) r.stats.Record(r.stage.vertices, Seconds(b, Clock::now()));
+        }
+
+        // Ground + grid over the visible chunk ring; an overflow is counted and written off the ring,
+        // like the debug lines, so the stage still does its work
+        {
+            const auto b = Clock::now();
+            ground.Update(cam.GetPosition(), &view);
+            auto target = [&]<typename V>(uint32_t count, std::vector<V>& fallback) -> V* {
+                const size_t bytes = size_t(count) * sizeof(V);
+                if (ring.GetAvailableThisFrame() < bytes + 256) {
+                    r.uploadOverflows++;
+                    fallback.resize(count);
+                    return fallback.data();
+                }
+                return reinterpret_cast<V*>(ring.Allocate(bytes, 256).cpuPtr);
+            };
+            if (const uint32_t gv = ground.GetGroundVertexCount()) ground.WriteGround(target(gv, groundSpill));
+            if (const uint32_t lv = ground.GetLineVertexCount()) ground.WriteLines(target(lv, lineSpill));
+            if (measured) r.stats.Record(r.stage.ground, Seconds(b, Clock::now()));
+        }
+
+        if (!measured) continue;
+        r.stats.RecordFrame(Seconds(frameBegin, Clock::now()));
+        const uint64_t used = ring.GetUsedThisFrame();
+        r.visibleAvg += visibleCount;
+        r.visibleMax = std::max<uint64_t>(r.visibleMax, visibleCount);
+        r.uploadAvg += double(used);
+        r.uploadMax = std::max<uint64_t>(r.uploadMax, used);
+        r.lineVertsAvg += lineVerts;
+    }
+    if (frames) { r.visibleAvg /= frames; r.uploadAvg /= frames; r.lineVertsAvg /= frames; }
+}
+
+void AppendStage(std::string& out, const char* name, const StageSummary& s, bool first)
+{
+    char buf[320];
+    std::snprintf(buf, sizeof(buf),
+                  "%s\n        \"%s\": { \"meanMs\": %.4f, \"p50Ms\": %.4f, \"p95Ms\": %.4f, \"p99Ms\": %.4f, \"p999Ms\": %.4f, \"maxMs\": %.4f }",
+                  first ? "" : ",", name, s.meanMs, s.p50Ms, s.p95Ms, s.p99Ms, s.p999Ms, s.maxMs);
+    out += buf;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<Preset> presets;
+    std::string suite = "quick", outPath = "frame_bench.json";
+    CameraPath path = CameraPath::Orbit;
+    uint32_t frames = 300, warmup = 30, threads = UINT32_MAX, uploadMb = 384;
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--preset") && more) {
+            Preset p;
+            if (!ParsePreset(argv[++i], p)) { std::fprintf(stderr, "FrameBench: bad preset %s\n", argv[i]); return 1; }
+            presets.push_back(p);
+        }
+        else if (!std::strcmp(argv[i], "--suite") && more) suite = argv[++i];
+        else if (!std::strcmp(argv[i], "--frames") && more) frames = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--warmup") && more) warmup = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && more) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--upload-mb") && more) uploadMb = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--path") && more) {
+            const std::string p = argv[++i];
+            if (p == "orbit") path = CameraPath::Orbit;
+            else if (p == "flythrough") path = CameraPath::Flythrough;
+            else if (p == "still") path = CameraPath::Still;
+            else { std::fprintf(stderr, "FrameBench: unknown path %s\n", p.c_str()); return 1; }
+        }
+        else {
+            std::fprintf(stderr, "usage: FrameBench [--preset <static|dynamic|clustered>-<1k..10m>]... [--suite quick|full]\n"
+                                 "                  [--frames N] [--warmup N] [--path orbit|flythrough|still] [--threads N]\n"
+                                 "                  [--upload-mb N] [--out results.json]\n");
+            return 1;
+        }
+    }
+    if (presets.empty()) {
+        std::vector<const char*> counts = { "1k", "10k", "100k" };
+        if (suite == "full") { counts.push_back("1m"); counts.push_back("10m"); }
+        for (const char* layout : { "static", "dynamic", "clustered" })
+            for (const char* c : counts) { Preset p; ParsePreset(std::string(layout) + "-" + c, p); presets.push_back(p); }
+    }
+
+    // --threads 1 = everything on the main thread
+    JobSystem jobs(threads == UINT32_MAX ? UINT32_MAX : (threads ? threads - 1 : 0));
+    const size_t ringBytes = size_t(uploadMb) << 20;
+    std::unique_ptr<uint8_t[]> ringMemory(new uint8_t[ringBytes]);
+    UploadRing ring;
+    ring.Init(ringMemory.get(), 0, ringBytes, kFrameCount);
+
+    std::string json;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf), "{\n  \"benchmark\": \"frame_bench\",\n  \"threads\": %u,\n  \"frames\": %u,\n  \"warmup\": %u,\n  \"path\": \"%s\",\n  \"runs\": [",
+                  jobs.GetThreadCount(), frames, warmup, PathName(path));
+    json += buf;
+
+    for (size_t k = 0; k < presets.size(); k++) {
+        auto r = std::make_unique<RunResult>();
+        Run(presets[k], path, frames, warmup, jobs, ring, *r);
+
+        const StageSummary fs = r->stats.Summary(FrameStats::kFrameStage);
+        std::printf("%-16s %9llu boxes  visible %8.0f  frame p50 %7.3f p99 %7.3f ms  upload %6.1f MB%s\n",
+                    presets[k].name.c_str(), (unsigned long long)presets[k].boxes, r->visibleAvg, fs.p50Ms, fs.p99Ms,
+                    r->uploadAvg / 1048576.0, r->uploadOverflows ? "  (upload ring overflowed)" : "");
+
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    {\n      \"preset\": \"%s\", \"layout\": \"%s\", \"boxes\": %llu, \"setupSeconds\": %.3f,\n"
+                      "      \"visibleAvg\": %.1f, \"visibleMax\": %llu, \"lineVerticesAvg\": %.1f,\n"
+                      "      \"uploadBytesAvg\": %.0f, \"uploadBytesMax\": %llu, \"uploadOverflows\": %llu, \"stutters\": %llu,\n"
+                      "      \"stages\": {",
+                      k ? "," : "", presets[k].name.c_str(), LayoutName(presets[k].layout), (unsigned long long)presets[k].boxes,
+                      r->setupSeconds, r->visibleAvg, (unsigned long long)r->visibleMax, r->lineVertsAvg, r->uploadAvg,
+                      (unsigned long long)r->uploadMax, (unsigned long long)r->uploadOverflows, (unsigned long long)r->stats.StutterCount());
+        json += buf;
+        for (uint32_t s = 0; s < r->stats.StageCount(); s++)
+            AppendStage(json, r->stats.StageName(s), r->stats.Summary(s), s == 0);
+        json += "\n      }\n    }";
+    }
+    json += "\n  ]\n}\n";
+
+    if (!WriteFile(outPath, json, "FrameBench")) return 1;
+    std::printf("wrote %s\n", outPath.c_str());
+    return 0;
+}
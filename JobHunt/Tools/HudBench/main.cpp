@@ -0,0 +1,273 @@
+// HudBench: per-frame CPU time and upload bytes of the HUD, headless. Replays what
+// Renderer::UpdateHud / RenderHUD do each frame - retained crosshair and toggle boxes,
+// RetainedHud::Pack, and the copy into one persistent upload slice per frame in flight of only the
+// layers that slice has not seen - against the immediate-mode HUD it replaced (every shape rebuilt
+// and uploaded every frame). A frame-time bar stands in for a per-frame (Dynamic layer) shape. The
+// readouts, text through TextBatch and the dynamic ring, are timed on their own. Scenarios: camera
+// still, camera moving, toggles flipping and the window resizing. Every frame of a checked pass,
+// the slice the GPU would read must equal an immediate rebuild vertex for vertex. Results go to JSON.
+//   HudBench [--frames N] [--out results.json]
+#include "Common/Bench.h"
+#include "Hud.h"
+#include "Text.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr uint32_t kFrameCount = 3;        // frames in flight, as Renderer
+constexpr uint32_t kToggles = 7;
+
+enum class Scenario { Still, Moving, Toggling, Count };
+const char* const kScenarioNames[] = { "camera still", "camera moving", "toggles + resize" };
+
+// What the HUD shows on frame f of a scenario
+struct HudState {
+    uint32_t width = 1280, height = 720;
+    bool     toggles[kToggles] = { true, true, true, false, true, false, true };
+    float    fps = 0.0f, frameMs = 0.0f, speed = 0.0f;
+    float3   pos{ 0, 1.5f, -5 };
+    float    yaw = 0.0f, pitch = 0.0f;
+};
+
+HudState StateAt(Scenario s, uint32_t f)
+{
+    HudState st;
+    st.fps = 60.0f + float(Hash(f / 30) % 40) * 0.1f;          // the title refresh: twice a second
+    if (s == Scenario::Still) return st;
+    const float t = float(f) / 60.0f;
+    st.pos = { 20.0f * std::sin(t * 0.3f), 1.5f + std::sin(t), 20.0f * std::cos(t * 0.3f) };
+    st.yaw = std::fmod(t * 17.0f, 360.0f) - 180.0f;
+    st.pitch = 10.0f * std::sin(t * 0.7f);
+    st.speed = 6.0f + std::sin(t * 2.0f);
+    st.frameMs = 16.0f + 4.0f * Unit(Hash(f));
+    if (s == Scenario::Toggling) {
+        for (uint32_t i = 0; i < kToggles; i++) st.toggles[i] = ((f / 10 + i) % 3) != 0;
+        if ((f / 500) % 2) { st.width = 1920; st.height = 1080; }
+    }
+    return st;
+}
+
+// The shapes, shared by the retained and immediate paths so both emit the same vertices
+const float3 kDark{ 1, 1, 1 }, kOn{ 0.10f, 0.70f, 0.10f }, kOff{ 0.70f, 0.10f, 0.10f }, kBar{ 0.95f, 0.85f, 0.10f };
+
+void BuildCrosshair(HudBuilder& b, const HudState& st)
+{
+    const float cx = float(st.width) * 0.5f, cy = float(st.height) * 0.5f, len = 30.0f, th = 4.0f;
+    b.Rect(cx - len, cy - th * 0.5f, cx + len, cy + th * 0.5f, kDark);
+    b.Rect(cx - th * 0.5f, cy - len, cx + th * 0.5f, cy + len, kDark);
+}
+
+void BuildToggleBoxes(HudBuilder& b, const HudState& st)
+{
+    float x = 16.0f;
+    const float y = float(st.height) - 16.0f - 12.0f;
+    for (bool t : st.toggles) { b.Rect(x, y, x + 12.0f, y + 12.0f, t ? kOn : kOff); x += 16.0f; }
+}
+
+// One pixel per 0.1 ms, quantised to whole pixels: the key changes when the bar does
+uint64_t FrameBarKey(const HudState& st) { return uint64_t(std::lround(st.frameMs * 10.0f)); }
+void BuildFrameBar(HudBuilder& b, const HudState& st)
+{
+    const float w = float(FrameBarKey(st)), x = float(st.width) - 16.0f - 400.0f;
+    b.HBar(x, 16.0f, w, 8.0f, kBar);
+}
+
+void DrawReadouts(TextBatch& text, const HudState& st)
+{
+    const uint32_t label = PackRGBA8({ 0.95f, 0.85f, 0.10f }), value = PackRGBA8({ 1, 1, 1 });
+    float x = 17.0f;
+    const float y = float(st.height) - 16.0f - 12.0f - 18.0f;
+    for (const char* l : { "L", "S", "G", "F", "T", "R", "P" }) { text.Draw(l, x, y, 2.0f, label); x += 16.0f; }
+
+    char buf[96];
+    x = 16.0f + text.Draw("FPS ", 16.0f, 16.0f, 3.0f, label).width;
+    std::snprintf(buf, sizeof(buf), "%.1f", st.fps);
+    text.Draw(buf, x, 16.0f, 3.0f, value);
+    x = 16.0f + text.Draw("POS ", 16.0f, 48.0f, 2.0f, label).width;
+    std::snprintf(buf, sizeof(buf), "%.1f %.1f %.1f", st.pos.x, st.pos.y, st.pos.z);
+    text.Draw(buf, x, 48.0f, 2.0f, value);
+    x = 16.0f + text.Draw("YAW ", 16.0f, 72.0f, 2.0f, label).width;
+    std::snprintf(buf, sizeof(buf), "%.1f\xC2\xB0  PITCH %.1f\xC2\xB0", st.yaw, st.pitch);
+    text.Draw(buf, x, 72.0f, 2.0f, value);
+    x = 16.0f + text.Draw("SPD ", 16.0f, 96.0f, 2.0f, label).width;
+    std::snprintf(buf, sizeof(buf), "%.1f", st.speed);
+    text.Draw(buf, x, 96.0f, 2.0f, value);
+}
+
+// Renderer's path: retained shapes, versioned slices of one persistent upload buffer
+class RetainedPath {
+public:
+    RetainedPath()
+    {
+        m_crosshair = m_hud.Add(HudLayer::Static);
+        m_toggles = m_hud.Add(HudLayer::Static);
+        m_bar = m_hud.Add(HudLayer::Dynamic);
+    }
+
+    // Returns the bytes copied into the slice
+    uint64_t Frame(const HudState& st, uint32_t frameIndex)
+    {
+        m_hud.Update(m_crosshair, uint64_t(st.width) | (uint64_t(st.height) << 32), [&](HudBuilder& b) { BuildCrosshair(b, st); });
+        uint64_t toggleKey = uint64_t(st.height) << 8;
+        for (uint32_t i = 0; i < kToggles; i++) toggleKey |= uint64_t(st.toggles[i]) << i;
+        m_hud.Update(m_toggles, toggleKey, [&](HudBuilder& b) { BuildToggleBoxes(b, st); });
+        m_hud.Update(m_bar, FrameBarKey(st) | (uint64_t(st.width) << 32), [&](HudBuilder& b) { BuildFrameBar(b, st); });
+        m_hud.Pack();
+
+        // RenderHUD's slice update, with a vector per slice for the mapped buffer
+        const std::span<const VertexPC> verts = m_hud.Vertices();
+        if (verts.size() > m_capacity) {
+            m_capacity = std::max<uint32_t>(std::max<uint32_t>(uint32_t(verts.size()), m_capacity * 2), 4096u);
+            for (std::vector<VertexPC>& s : m_slices) s.assign(m_capacity, VertexPC{});
+            for (SliceVersions& s : m_versions) s = SliceVersions{};
+        }
+        VertexPC* slice = m_slices[frameIndex].data();
+        SliceVersions& hs = m_versions[frameIndex];
+        uint64_t bytes = 0;
+        const uint64_t staticVersion = m_hud.LayerVersion(HudLayer::Static), dynamicVersion = m_hud.LayerVersion(HudLayer::Dynamic);
+        if (hs.staticVersion != staticVersion) {
+            std::memcpy(slice, verts.data(), verts.size_bytes());
+            bytes = verts.size_bytes();
+        } else if (hs.dynamicVersion != dynamicVersion) {
+            const uint32_t first = m_hud.LayerStart(HudLayer::Dynamic), count = m_hud.LayerCount(HudLayer::Dynamic);
+            std::memcpy(slice + first, verts.data() + first, count * sizeof(VertexPC));
+            bytes = count * sizeof(VertexPC);
+        }
+        hs.staticVersion = staticVersion;
+        hs.dynamicVersion = dynamicVersion;
+        return bytes;
+    }
+
+    std::span<const VertexPC> Slice(uint32_t frameIndex) const { return { m_slices[frameIndex].data(), m_hud.Vertices().size() }; }
+    const HudStats& Stats() const { return m_hud.GetStats(); }
+
+private:
+    struct SliceVersions { uint64_t staticVersion = 0, dynamicVersion = 0; };
+
+    RetainedHud m_hud;
+    RetainedHud::ElementId m_crosshair = 0, m_toggles = 0, m_bar = 0;
+    std::vector<VertexPC> m_slices[kFrameCount];
+    SliceVersions m_versions[kFrameCount];
+    uint32_t    m_capacity = 0;
+};
+
+// What RenderHUD did before: every shape rebuilt into a fresh vector and uploaded whole, the
+// static ones first as Pack orders them. Returns the bytes uploaded.
+uint64_t ImmediateFrame(const HudState& st, std::vector<VertexPC>& upload)
+{
+    std::vector<VertexPC> verts;
+    HudBuilder b(verts);
+    BuildCrosshair(b, st);
+    BuildToggleBoxes(b, st);
+    BuildFrameBar(b, st);
+    upload.resize(verts.size());
+    std::memcpy(upload.data(), verts.data(), verts.size() * sizeof(VertexPC));
+    return verts.size() * sizeof(VertexPC);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = 20000;
+    std::string outPath = "hud_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--frames") && more) frames = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: HudBench [--frames N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    GlyphAtlas atlas;
+    atlas.BakeBuiltin();
+    bool ok = true;
+
+    struct Row {
+        double   retainedUs, immediateUs, textUs;
+        uint64_t retainedBytes, immediateBytes, textBytes;
+        uint32_t rebuilt, packs;
+    };
+    Row rows[uint32_t(Scenario::Count)]{};
+    std::vector<HudState> states(frames);
+    std::vector<VertexPC> upload;
+    for (uint32_t s = 0; s < uint32_t(Scenario::Count); s++) {
+        const Scenario scenario = Scenario(s);
+        for (uint32_t f = 0; f < frames; f++) states[f] = StateAt(scenario, f);
+        Row& row = rows[s];
+
+        // Checked pass: what the GPU would read from this frame's slice is the immediate HUD
+        {
+            RetainedPath retained;
+            uint32_t bad = 0;
+            for (uint32_t f = 0; f < frames; f++) {
+                retained.Frame(states[f], f % kFrameCount);
+                ImmediateFrame(states[f], upload);
+                const std::span<const VertexPC> got = retained.Slice(f % kFrameCount);
+                if (got.size() != upload.size() || std::memcmp(got.data(), upload.data(), got.size_bytes()) != 0) bad++;
+            }
+            if (bad) {
+                std::fprintf(stderr, "HudBench: MISMATCH %s: %u of %u frames upload a stale HUD\n", kScenarioNames[s], bad, frames);
+                ok = false;
+            }
+        }
+
+        // Timed passes: shapes both ways, then the readout text every frame
+        RetainedPath retained;
+        Clock::time_point t0 = Clock::now();
+        for (uint32_t f = 0; f < frames; f++) row.retainedBytes += retained.Frame(states[f], f % kFrameCount);
+        row.retainedUs = Seconds(t0, Clock::now()) * 1e6 / frames;
+        row.rebuilt = retained.Stats().rebuilt;
+        row.packs = retained.Stats().packs;
+
+        t0 = Clock::now();
+        for (uint32_t f = 0; f < frames; f++) row.immediateBytes += ImmediateFrame(states[f], upload);
+        row.immediateUs = Seconds(t0, Clock::now()) * 1e6 / frames;
+
+        TextBatch text(atlas);
+        t0 = Clock::now();
+        for (uint32_t f = 0; f < frames; f++) {
+            text.Begin();
+            DrawReadouts(text, states[f]);
+            row.textBytes += text.Instances().size_bytes();   // through the dynamic ring every frame
+        }
+        row.textUs = Seconds(t0, Clock::now()) * 1e6 / frames;
+    }
+
+    std::printf("HudBench: %u frames per scenario, %u frames in flight (us and bytes per frame)\n", frames, kFrameCount);
+    std::printf("  %-18s %12s %12s %12s %12s %10s %10s %8s\n", "scenario", "retained us", "retained B", "immediate us",
+                "immediate B", "text us", "text B", "packs");
+    for (uint32_t s = 0; s < uint32_t(Scenario::Count); s++) {
+        const Row& r = rows[s];
+        std::printf("  %-18s %12.3f %12.1f %12.3f %12.1f %10.3f %10.1f %8u\n", kScenarioNames[s], r.retainedUs,
+                    double(r.retainedBytes) / frames, r.immediateUs, double(r.immediateBytes) / frames, r.textUs,
+                    double(r.textBytes) / frames, r.packs);
+    }
+    std::printf("  slices match an immediate rebuild: %s\n", ok ? "ok" : "MISMATCH");
+
+    std::string json = "{\n  \"frames\": " + std::to_string(frames) + ",\n  \"scenarios\": [\n";
+    for (uint32_t s = 0; s < uint32_t(Scenario::Count); s++) {
+        const Row& r = rows[s];
+        char line[384];
+        std::snprintf(line, sizeof(line),
+            "    { \"name\": \"%s\", \"retainedUs\": %.4f, \"retainedBytes\": %.1f, \"immediateUs\": %.4f, "
+            "\"immediateBytes\": %.1f, \"textUs\": %.4f, \"textBytes\": %.1f, \"rebuilt\": %u, \"packs\": %u }%s\n",
+            kScenarioNames[s], r.retainedUs, double(r.retainedBytes) / frames, r.immediateUs, double(r.immediateBytes) / frames,
+            r.textUs, double(r.textBytes) / frames, r.rebuilt, r.packs, s + 1 < uint32_t(Scenario::Count) ? "," : "");
+        json += line;
+    }
+    json += std::string("  ],\n  \"ok\": ") + (ok ? "true" : "false") + "\n}\n";
+    if (!WriteFile(outPath, json, "HudBench")) return 1;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,368 @@
+// MeshBench: load cost of a large mesh from text against the memory-mapped .gemesh. Generates a
+// displaced sphere, writes it as OBJ (v / vn / f v//vn) and as .gemesh with meshlets, raw and LZ4
+// compressed, then times, warm and best of N passes:
+//   mmap     MeshFile::Open plus a read of every vertex, index and meshlet page
+//   copy     the raw .gemesh, every section ReadSection'ed into memory
+//   lz4      the compressed .gemesh, every section decoded into memory on the job system
+//   import   ImportObj, the parallel from_chars importer
+//   text     a plain istream OBJ reader with (position, normal) dedup, the baseline .gemesh replaced
+// and how far each raises the resident set (Linux). Every loaded mesh is checked against the source
+// triangle by triangle, outside the timing. LZ4 decode throughput (GB/s of raw output, serial and
+// parallel) is measured on the block streams alone and checked byte for byte against the raw file.
+// Results go to JSON.
+//   MeshBench [--triangles N] [--passes N] [--threads N] [--dir path] [--out results.json]
+#include "Assets/Compression.h"
+#include "Assets/MeshFile.h"
+#include "Assets/MeshImport.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include "Geometry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+
+constexpr MeshSection kSections[] = { MeshSection::Vertices, MeshSection::Indices, MeshSection::Meshlets, MeshSection::MeshletBounds,
+                                      MeshSection::MeshletVertices, MeshSection::MeshletTriangles, MeshSection::MeshletIndices };
+constexpr size_t kSectionCount = sizeof(kSections) / sizeof(kSections[0]);
+
+struct Row {
+    const char* name;
+    double      seconds;     // best pass
+    double      peakMB;      // resident high-water growth during one load
+    bool        ok;
+};
+
+// Resident set and its high-water mark in bytes (Linux /proc; 0 elsewhere)
+size_t ReadStatus(const char* field)
+{
+#if defined(__linux__)
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    const size_t n = std::strlen(field);
+    while (std::getline(in, line))
+        if (!line.compare(0, n, field)) return size_t(std::strtoull(line.c_str() + n, nullptr, 10)) * 1024;
+#else
+    (void)field;
+#endif
+    return 0;
+}
+size_t ResidentBytes() { return ReadStatus("VmRSS:"); }
+size_t PeakResidentBytes() { return ReadStatus("VmHWM:"); }
+// Hands freed heap back first, so a load cannot hide its growth in what an earlier one left
+void ResetPeakResident()
+{
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+#if defined(__linux__)
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+// UV sphere with a little radial noise, so positions do not compress into a regular lattice
+void MakeMesh(uint32_t triangles, MeshData& mesh)
+{
+    const uint32_t rings = std::max(2u, uint32_t(std::sqrt(double(triangles) / 4.0)));
+    const uint32_t segments = rings * 2;
+    mesh.vertices.reserve(size_t(rings + 1) * (segments + 1));
+    for (uint32_t r = 0; r <= rings; r++) {
+        const float theta = kPi * float(r) / float(rings);
+        for (uint32_t s = 0; s <= segments; s++) {
+            const float phi = 2.0f * kPi * float(s) / float(segments);
+            const float3 n{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+            const float radius = 10.0f + 0.05f * Unit(Hash(r * 65537u + s));
+            mesh.vertices.push_back({ n * radius, n, { 0.8f, 0.8f, 0.8f } });
+        }
+    }
+    mesh.indices.reserve(size_t(rings) * segments * 6);
+    for (uint32_t r = 0; r < rings; r++)
+        for (uint32_t s = 0; s < segments; s++) {
+            const uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    mesh.bounds = ComputeMeshBounds(mesh.vertices);
+    mesh.lods.push_back({ 0, uint32_t(mesh.indices.size()), 0.0f, 0 });
+    Geom::BuildMeshlets(mesh.vertices, mesh.indices, mesh.meshlets);
+}
+
+bool WriteObj(const std::string& path, const MeshData& mesh)
+{
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    for (const VertexPNC& v : mesh.vertices) std::fprintf(f, "v %.6f %.6f %.6f\n", v.pos.x, v.pos.y, v.pos.z);
+    for (const VertexPNC& v : mesh.vertices) std::fprintf(f, "vn %.6f %.6f %.6f\n", v.normal.x, v.normal.y, v.normal.z);
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        const uint32_t a = mesh.indices[t] + 1, b = mesh.indices[t + 1] + 1, c = mesh.indices[t + 2] + 1;
+        std::fprintf(f, "f %u//%u %u//%u %u//%u\n", a, a, b, b, c, c);
+    }
+    return std::fclose(f) == 0;
+}
+
+// The istream importer MeshConvert used before ImportObj: positions, optional normals, polygon
+// faces fan-triangulated, vertices deduplicated on (position, normal) index pairs.
+bool LoadObjText(const std::string& path, std::vector<VertexPNC>& verts, std::vector<uint32_t>& indices)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::vector<float3> positions, normals;
+    std::unordered_map<uint64_t, uint32_t> dedup;
+    std::vector<uint32_t> face;
+    std::string line, tok;
+    while (std::getline(in, line)) {
+        if (line.size() < 2) continue;
+        std::istringstream ls(line);
+        ls >> tok;
+        if (tok == "v")  { float3 p{}; ls >> p.x >> p.y >> p.z; positions.push_back(p); }
+        else if (tok == "vn") { float3 n{}; ls >> n.x >> n.y >> n.z; normals.push_back(n); }
+        else if (tok == "f") {
+            face.clear();
+            while (ls >> tok) {
+                long vi = std::strtol(tok.c_str(), nullptr, 10), ni = 0;
+                const size_t s1 = tok.find('/');
+                if (s1 != std::string::npos) {
+                    const size_t s2 = tok.find('/', s1 + 1);
+                    if (s2 != std::string::npos) ni = std::strtol(tok.c_str() + s2 + 1, nullptr, 10);
+                }
+                if (vi < 0) vi += long(positions.size()) + 1;
+                if (ni < 0) ni += long(normals.size()) + 1;
+                if (vi <= 0 || vi > long(positions.size()) || ni > long(normals.size())) return false;
+
+                const uint64_t key = (uint64_t(vi) << 32) | uint64_t(ni);
+                auto [it, inserted] = dedup.emplace(key, uint32_t(verts.size()));
+                if (inserted) verts.push_back({ positions[vi - 1], ni > 0 ? normals[ni - 1] : float3{ 0, 0, 0 }, { 0.8f, 0.8f, 0.8f } });
+                face.push_back(it->second);
+            }
+            for (size_t k = 2; k < face.size(); k++) indices.insert(indices.end(), { face[0], face[k - 1], face[k] });
+        }
+    }
+    return true;
+}
+
+// Same triangles in the same order, corner positions and normals within the text round trip.
+// Vertex numbering may differ (the text reader numbers vertices in first-use order).
+bool SameTriangles(const MeshData& src, const VertexPNC* verts, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+{
+    if (indexCount != src.lods[0].indexCount) return false;
+    for (size_t i = 0; i < indexCount; i++) {
+        if (indices[i] >= vertexCount) return false;
+        const VertexPNC& a = src.vertices[src.indices[i]];
+        const VertexPNC& b = verts[indices[i]];
+        if (length(a.pos - b.pos) > 1e-4f || length(a.normal - b.normal) > 1e-5f) return false;
+    }
+    return true;
+}
+
+// Every section of an open file decoded (or copied) into one allocation; section i at offsets[i]
+struct Sections {
+    std::unique_ptr<uint8_t[]> data;
+    size_t                     offsets[kSectionCount + 1] = {};
+
+    bool Read(const MeshFile& file, JobSystem* jobs)
+    {
+        for (size_t i = 0; i < kSectionCount; i++) offsets[i + 1] = offsets[i] + size_t(file.GetSectionRawSize(kSections[i]));
+        data.reset(new uint8_t[offsets[kSectionCount]]);
+        bool ok = true;
+        for (size_t i = 0; i < kSectionCount; i++)
+            ok &= file.ReadSection(kSections[i], data.get() + offsets[i], offsets[i + 1] - offsets[i], jobs);
+        return ok;
+    }
+    template <typename T> const T* Get(size_t i) const { return reinterpret_cast<const T*>(data.get() + offsets[i]); }
+    template <typename T> size_t Count(size_t i) const { return (offsets[i + 1] - offsets[i]) / sizeof(T); }
+};
+
+// Empty input, where src and dst are null: must round-trip without touching either
+bool EmptyRoundTrip()
+{
+    uint8_t packed[16];
+    const size_t bytes = Lz4Compress(nullptr, 0, packed, sizeof(packed));
+    return bytes == 1 && Lz4Decompress(packed, bytes, nullptr, 0);
+}
+
+// One load for memory and the check, then `passes` timed loads; release drops a loaded mesh
+Row Run(const char* name, uint32_t passes, const std::function<bool()>& load, const std::function<bool()>& verify,
+        const std::function<void()>& release)
+{
+    Row row{ name, 0, 0, false };
+    ResetPeakResident();
+    const size_t before = ResidentBytes();
+    row.ok = load();
+    row.peakMB = double(PeakResidentBytes() - std::min(PeakResidentBytes(), before)) / 1048576.0;
+    row.ok = row.ok && verify();
+    release();
+    row.seconds = BestOf(passes, [&] { row.ok &= load(); release(); });
+    return row;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t triangles = 1'000'000, passes = 3, threads = UINT32_MAX;
+    std::string dir = ".", outPath = "mesh_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--triangles") && more) triangles = uint32_t(std::max(8.0, std::atof(argv[++i])));
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && more) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--dir") && more) dir = argv[++i];
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: MeshBench [--triangles N] [--passes N] [--threads N] [--dir path] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    // --threads 1 = everything on the main thread
+    JobSystem jobs(threads == UINT32_MAX ? UINT32_MAX : (threads ? threads - 1 : 0));
+
+    MeshData src;
+    MakeMesh(triangles, src);
+    const std::string objPath = dir + "/mesh_bench.obj", meshPath = dir + "/mesh_bench.gemesh";
+    const std::string lz4Path = dir + "/mesh_bench_lz4.gemesh";
+    MeshWriteOptions compressed;
+    compressed.compress = true;
+    compressed.jobs = &jobs;
+    if (!WriteObj(objPath, src) || !WriteMeshFile(meshPath, src) || !WriteMeshFile(lz4Path, src, compressed)) {
+        std::fprintf(stderr, "MeshBench: cannot write to %s\n", dir.c_str());
+        return 1;
+    }
+    const double objMB = double(std::ifstream(objPath, std::ios::ate | std::ios::binary).tellg()) / 1048576.0;
+    const double meshMB = double(std::ifstream(meshPath, std::ios::ate | std::ios::binary).tellg()) / 1048576.0;
+    const double lz4MB = double(std::ifstream(lz4Path, std::ios::ate | std::ios::binary).tellg()) / 1048576.0;
+    // Warm cache: every timed pass reads from memory, not the disk
+    std::vector<char> warm(size_t(objMB * 1048576.0) + 1);
+    std::ifstream(objPath, std::ios::binary).read(warm.data(), std::streamsize(warm.size()));
+    warm = {};
+
+    std::vector<Row> rows;
+
+    MeshFile file;
+    uint64_t touched = 0;
+    rows.push_back(Run("mmap", passes, [&] {
+        if (!file.Open(meshPath)) return false;
+        // One read per 4 KB page of every section, as an upload would
+        uint64_t sum = 0;
+        for (MeshSection s : kSections) {
+            const std::span<const uint8_t> bytes = file.GetSection(s);
+            for (size_t i = 0; i < bytes.size(); i += 4096) sum += bytes[i];
+        }
+        touched += sum;
+        return true;
+    }, [&] {
+        return SameTriangles(src, file.Vertices().data(), file.Vertices().size(), file.Indices().data(), file.Indices().size()) &&
+               file.Meshlets().size() == src.meshlets.meshlets.size();
+    }, [&] { file.Close(); }));
+
+    // End to end: open, then every section in memory, copied from the raw file or decoded from LZ4
+    Sections sections;
+    auto loaded = [&] {
+        return SameTriangles(src, sections.Get<VertexPNC>(0), sections.Count<VertexPNC>(0), sections.Get<uint32_t>(1), sections.Count<uint32_t>(1)) &&
+               sections.Count<Meshlet>(2) == src.meshlets.meshlets.size();
+    };
+    auto unload = [&] { file.Close(); sections = {}; };
+    rows.push_back(Run("copy", passes, [&] { return file.Open(meshPath) && sections.Read(file, &jobs); }, loaded, unload));
+    rows.push_back(Run("lz4", passes, [&] { return file.Open(lz4Path) && sections.Read(file, &jobs); }, loaded, unload));
+
+    LinearArena arena;
+    ImportedMesh imported;
+    ImportOptions importOptions;
+    importOptions.convertHandedness = false;   // compare against the source as written
+    rows.push_back(Run("import", passes, [&] {
+        return ImportObj(objPath, arena, imported, &jobs, importOptions);
+    }, [&] {
+        return SameTriangles(src, imported.vertices, imported.vertexCount, imported.indices, imported.indexCount);
+    }, [&] { arena = LinearArena(); imported = {}; }));
+
+    std::vector<VertexPNC> textVerts;
+    std::vector<uint32_t> textIndices;
+    rows.push_back(Run("text", passes, [&] {
+        return LoadObjText(objPath, textVerts, textIndices);
+    }, [&] {
+        return SameTriangles(src, textVerts.data(), textVerts.size(), textIndices.data(), textIndices.size());
+    }, [&] { textVerts = {}; textIndices = {}; }));
+
+    // Decode alone: every compressed block stream into memory, serial and spread over the jobs,
+    // checked against the raw file's sections
+    MeshFile raw;
+    std::vector<BlockStreamReader> streams;
+    std::vector<std::span<const uint8_t>> expected;
+    uint64_t rawBytes = 0, packedBytes = 0;
+    bool decodeOk = raw.Open(meshPath) && file.Open(lz4Path);
+    for (MeshSection s : kSections) {
+        BlockStreamReader reader;
+        if (!decodeOk || !file.OpenBlockStream(s, reader)) continue;   // stored raw: did not shrink
+        rawBytes += reader.RawSize();
+        packedBytes += file.GetSection(s).size();
+        streams.push_back(std::move(reader));
+        expected.push_back(raw.GetSection(s));
+    }
+    std::vector<uint8_t> decoded(static_cast<size_t>(rawBytes));
+    auto decodeAll = [&](JobSystem* j) {
+        uint8_t* dst = decoded.data();
+        for (const BlockStreamReader& r : streams) {
+            decodeOk &= r.DecodeAll(dst, j);
+            dst += r.RawSize();
+        }
+    };
+    const double serial = BestOf(passes, [&] { decodeAll(nullptr); });
+    const double parallel = BestOf(passes, [&] { decodeAll(&jobs); });
+    size_t at = 0;
+    for (size_t i = 0; i < streams.size(); i++) {
+        decodeOk &= expected[i].size() == streams[i].RawSize() && !std::memcmp(decoded.data() + at, expected[i].data(), expected[i].size());
+        at += expected[i].size();
+    }
+    decodeOk = decodeOk && !streams.empty() && EmptyRoundTrip();
+    file.Close();
+    raw.Close();
+
+    bool allOk = decodeOk;
+    for (const Row& r : rows) allOk &= r.ok;
+    std::printf("MeshBench: %zu verts, %zu tris, %zu meshlets | OBJ %.1f MB, .gemesh %.1f MB, lz4 %.1f MB | %u threads, best of %u, warm\n",
+                src.vertices.size(), src.indices.size() / 3, src.meshlets.meshlets.size(), objMB, meshMB, lz4MB, jobs.GetThreadCount(), passes);
+    const double gbSerial = double(rawBytes) / serial * 1e-9, gbParallel = double(rawBytes) / parallel * 1e-9;
+    std::printf("  lz4 decode, %zu streams %.1f -> %.1f MB: %.2f GB/s serial, %.2f GB/s parallel  %s\n", streams.size(),
+                double(packedBytes) / 1048576.0, double(rawBytes) / 1048576.0, gbSerial, gbParallel, decodeOk ? "ok" : "MISMATCH");
+    std::printf("  %-8s %10s %10s %10s  %s\n", "load", "time", "x mmap", "peak RSS", "check");
+    std::string json;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "{\n  \"benchmark\": \"mesh_bench\",\n  \"vertices\": %zu,\n  \"triangles\": %zu,\n  \"objMB\": %.2f,\n"
+                  "  \"gemeshMB\": %.2f,\n  \"lz4MB\": %.2f,\n  \"threads\": %u,\n  \"verified\": %s,\n"
+                  "  \"lz4DecodeGBps\": { \"serial\": %.3f, \"parallel\": %.3f },\n  \"results\": [",
+                  src.vertices.size(), src.indices.size() / 3, objMB, meshMB, lz4MB, jobs.GetThreadCount(), allOk ? "true" : "false",
+                  gbSerial, gbParallel);
+    json += buf;
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Row& r = rows[i];
+        const double ratio = r.seconds / rows[0].seconds;
+        std::printf("  %-8s %8.2fms %9.1fx %8.1fMB  %s\n", r.name, r.seconds * 1e3, ratio, r.peakMB, r.ok ? "ok" : "MISMATCH");
+        std::snprintf(buf, sizeof(buf), "%s\n    { \"name\": \"%s\", \"ms\": %.4f, \"peakMB\": %.2f, \"ok\": %s }",
+                      i ? "," : "", r.name, r.seconds * 1e3, r.peakMB, r.ok ? "true" : "false");
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+    if (touched == UINT64_MAX) std::printf(" ");   // keep the page reads
+
+    if (!WriteFile(outPath, json, "MeshBench")) return 1;
+    return allOk ? 0 : 1;
+}
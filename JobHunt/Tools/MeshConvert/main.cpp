@@ -0,0 +1,87 @@
+// MeshConvert: OBJ / glTF -> .gemesh (see Assets/MeshFile.h)
+//   MeshConvert <input.obj|.gltf|.glb> <output.gemesh> [--lods N] [--no-meshlets] [--threads N] [--compress]
+#include "Assets/MeshFile.h"
+#include "Assets/MeshImport.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include "Geometry.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: MeshConvert <input.obj|.gltf|.glb> <output.gemesh> [--lods N] [--no-meshlets] [--threads N] [--compress]\n");
+        return 1;
+    }
+    uint32_t lodCount = 4;
+    uint32_t threads = UINT32_MAX;
+    bool meshlets = true;
+    bool compress = false;
+    for (int i = 3; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--lods") && i + 1 < argc) lodCount = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--no-meshlets")) meshlets = false;
+        else if (!std::strcmp(argv[i], "--compress")) compress = true;
+    }
+
+    // --threads 1 = single-threaded import (no pool)
+    std::unique_ptr<JobSystem> jobs;
+    if (threads != 1) jobs = std::make_unique<JobSystem>(threads == UINT32_MAX ? UINT32_MAX : threads - 1);
+
+    MeshData mesh;
+    LinearArena arena;
+    ImportedMesh imported;
+    ImportStats stats;
+    const auto t0 = Clock::now();
+    if (!ImportMesh(argv[1], arena, imported, jobs.get(), ImportOptions{}, &stats) || imported.indexCount == 0) {
+        std::fprintf(stderr, "MeshConvert: failed to read %s\n", argv[1]);
+        return 1;
+    }
+    mesh.vertices.assign(imported.vertices, imported.vertices + imported.vertexCount);
+    mesh.indices.assign(imported.indices, imported.indices + imported.indexCount);
+    const auto t1 = Clock::now();
+    std::printf("import: %.1f MB in %.3fs (%.0f MB/s, %u threads)\n", double(stats.bytes) / 1048576.0,
+                stats.totalSeconds, double(stats.bytes) / 1048576.0 / stats.totalSeconds, stats.threads);
+
+    mesh.bounds = imported.bounds;
+    mesh.lods.push_back({ 0, uint32_t(mesh.indices.size()), 0.0f, 0 });
+    if (meshlets && !Geom::BuildMeshlets(mesh.vertices, mesh.indices, mesh.meshlets)) {
+        std::fprintf(stderr, "MeshConvert: %s has indices past its %zu vertices\n", argv[1], mesh.vertices.size());
+        return 1;
+    }
+
+    // LOD chain: cell size doubles per level until the triangle count stops dropping meaningfully
+    const float3 e = mesh.bounds.extents;
+    float cell = 2.0f * SOL_MAX(e.x, SOL_MAX(e.y, e.z)) / 256.0f;
+    std::vector<uint32_t> lod;
+    for (uint32_t l = 1; l < lodCount; l++, cell *= 2.0f) {
+        Geom::BuildClusterLod(&mesh.vertices[0].pos, sizeof(VertexPNC), mesh.vertices.size(),
+                              mesh.indices.data(), mesh.lods[0].indexCount, cell, lod);
+        if (lod.empty() || lod.size() * 10 > size_t(mesh.lods.back().indexCount) * 9) continue;
+        mesh.lods.push_back({ uint32_t(mesh.indices.size()), uint32_t(lod.size()), cell, 0 });
+        mesh.indices.insert(mesh.indices.end(), lod.begin(), lod.end());
+    }
+    const auto t2 = Clock::now();
+
+    MeshWriteOptions writeOptions;
+    writeOptions.compress = compress;
+    writeOptions.jobs = jobs.get();
+    if (!WriteMeshFile(argv[2], mesh, writeOptions)) {
+        std::fprintf(stderr, "MeshConvert: failed to write %s\n", argv[2]);
+        return 1;
+    }
+    const auto t3 = Clock::now();
+
+    std::printf("%s: %zu verts, %u tris, %zu meshlets, %zu LODs | parse %.2fs build %.2fs write %.2fs\n",
+                argv[2], mesh.vertices.size(), mesh.lods[0].indexCount / 3, mesh.meshlets.meshlets.size(),
+                mesh.lods.size(), Seconds(t0, t1), Seconds(t1, t2), Seconds(t2, t3));
+    return 0;
+}
@@ -0,0 +1,283 @@
+// MeshletBench: meshlet culling cost and correctness. Builds a bumpy procedural sphere, clusters it
+// with Geom::BuildMeshlets (which must also reject an out-of-range index), then culls it from a ring
+// of views (near, far, off-centre, one inside the mesh) with CullMeshlets: frustum + normal cone,
+// then again with a tiled occluder covering the left half of the screen. Each cull must emit exactly
+// the ranges and stats of a scalar per-meshlet reference, and every triangle of every rejected
+// meshlet is checked by brute force: behind one frustum plane, back-facing, or behind the occluder
+// in every tile it covers. Results go to JSON.
+//   MeshletBench [--stacks N] [--passes N] [--out results.json]
+#include "Camera.h"
+#include "Common/Bench.h"
+#include "Culling.h"
+#include "Geometry.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kRadius = 10.0f;
+constexpr uint32_t kTilesX = 80, kTilesY = 45;
+constexpr float kAspect = 16.0f / 9.0f, kFovY = 1.0f, kNear = 0.1f, kFar = 500.0f;
+constexpr uint32_t kViews = 9;
+
+struct View {
+    CullView        cull;
+    float4x4        worldToClip;
+    std::vector<float> depth;   // kTilesX * kTilesY farthest occluder depth
+    OcclusionBuffer occlusion;
+};
+
+// Latitude / longitude sphere with a few percent of smooth bumps, outward-facing in the winding
+// ComputeBounds uses for its normal cones
+void BuildSphere(uint32_t stacks, std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    const uint32_t slices = stacks * 2;
+    positions.clear();
+    indices.clear();
+    for (uint32_t i = 0; i <= stacks; i++) {
+        const float theta = 3.14159265f * float(i) / float(stacks);
+        for (uint32_t j = 0; j <= slices; j++) {
+            const float phi = 6.28318531f * float(j) / float(slices);
+            const float r = kRadius * (1.0f + 0.03f * std::sin(8.0f * theta) * std::sin(8.0f * phi));
+            positions.push_back({ r * std::sin(theta) * std::cos(phi), r * std::cos(theta), r * std::sin(theta) * std::sin(phi) });
+        }
+    }
+    auto tri = [&](uint32_t a, uint32_t b, uint32_t c) {
+        const float3 n = cross(positions[b] - positions[a], positions[c] - positions[a]);
+        if (dot(n, positions[a] + positions[b] + positions[c]) < 0.0f) std::swap(b, c);
+        indices.insert(indices.end(), { a, b, c });
+    };
+    for (uint32_t i = 0; i < stacks; i++)
+        for (uint32_t j = 0; j < slices; j++) {
+            const uint32_t a = i * (slices + 1) + j, b = a + 1, c = a + slices + 1, d = c + 1;
+            tri(a, b, c);
+            tri(b, d, c);
+        }
+}
+
+// View k: orbiting at growing distance, aimed up to ~35 degrees off the centre; the last is inside
+View MakeView(uint32_t k)
+{
+    const float angle = 6.28318531f * float(k) / float(kViews), dist = k + 1 == kViews ? 0.5f * kRadius : 14.0f + 8.0f * float(k);
+    const float3 eye{ dist * std::cos(angle), 0.3f * dist * std::sin(angle * 3.0f), dist * std::sin(angle) };
+    const float aimX = 0.6f * std::sin(angle * 5.0f) * kRadius, aimY = 0.4f * std::cos(angle * 2.0f) * kRadius;
+    const float3 dir = normalize_safe(float3{ aimX, aimY, 0.0f } - eye, float3{ 0, 0, 1 });
+
+    Camera cam;
+    cam.SetLens(kFovY, kAspect, kNear, kFar);
+    cam.SetPosition(eye);
+    cam.YawPitch(std::atan2(dir.x, dir.z), std::asin(dir.y));
+
+    View v;
+    v.cull = MakeCullView(cam.GetCameraToWorld(), kFovY, kAspect, kNear, kFar);
+    v.worldToClip = m_mul(cam.GetView(), cam.GetProj());
+
+    // Occluder: a wall over the left half of the screen, cutting through the near side of the mesh
+    const float wallDist = std::max(kNear * 2.0f, length(eye) - 0.5f * kRadius);
+    const float3 wall = eye + cam.GetCameraToWorld()[2].xyz * wallDist;
+    const float4 h = m_mul_row(float4{ wall.x, wall.y, wall.z, 1.0f }, v.worldToClip);
+    v.depth.assign(size_t(kTilesX) * kTilesY, 1.0f);
+    for (uint32_t y = 0; y < kTilesY; y++)
+        for (uint32_t x = 0; x < kTilesX / 2; x++) v.depth[size_t(y) * kTilesX + x] = h.z / h.w;
+    v.occlusion.maxDepth = v.depth.data();
+    v.occlusion.width = kTilesX;
+    v.occlusion.height = kTilesY;
+    v.occlusion.objectToClip = v.worldToClip;
+    return v;
+}
+
+// The documented tests one meshlet at a time, in CullMeshlets' order, merging ranges the same way
+uint32_t ReferenceCull(const MeshletMesh& mesh, const CullView& view, const OcclusionBuffer* occlusion,
+                       std::vector<IndexRange>& out, MeshletCullStats& st)
+{
+    out.clear();
+    st = {};
+    st.tested = (uint32_t)mesh.meshlets.size();
+    for (size_t i = 0; i < mesh.meshlets.size(); i++) {
+        const MeshletBounds& b = mesh.bounds[i];
+        bool in = true;
+        for (const Plane_t& p : view.planes) in = in && plane_signed_distance(p, b.center) >= -b.radius;
+        if (!in) { st.frustumCulled++; continue; }
+        const float3 d = b.center - view.eye;
+        if (dot(d, b.coneAxis) >= b.coneCutoff * length(d) + b.radius) { st.coneCulled++; continue; }
+        if (occlusion && SphereOccluded(*occlusion, b.center, b.radius)) { st.occlusionCulled++; continue; }
+        const Meshlet& m = mesh.meshlets[i];
+        if (!out.empty() && out.back().firstIndex + out.back().indexCount == m.triangleOffset) out.back().indexCount += m.triangleCount * 3;
+        else out.push_back({ m.triangleOffset, m.triangleCount * 3 });
+        st.visible++;
+    }
+    st.ranges = (uint32_t)out.size();
+    return st.visible;
+}
+
+// A triangle CullMeshlets may drop: wholly behind one plane, facing away, or behind the occluder
+// in every tile its screen rectangle touches. Tolerances cover the bounds' float rounding.
+bool TriangleRejectable(const float3 p[3], const View& v, bool useOcclusion)
+{
+    for (const Plane_t& pl : v.cull.planes) {
+        bool behind = true;
+        for (int k = 0; k < 3; k++) behind = behind && plane_signed_distance(pl, p[k]) < 1e-3f;
+        if (behind) return true;
+    }
+    const float3 n = cross(p[1] - p[0], p[2] - p[0]);
+    const float len = length(n);
+    if (len <= 1e-12f) return true;   // degenerate (poles): never drawn
+    const float3 d = p[0] - v.cull.eye;
+    if (dot(d, n) / len >= -1e-4f * length(d)) return true;
+    if (!useOcclusion) return false;
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX;
+    for (int k = 0; k < 3; k++) {
+        const float4 h = m_mul_row(float4{ p[k].x, p[k].y, p[k].z, 1.0f }, v.worldToClip);
+        if (h.w <= SOL_MATH_EPS) return false;
+        minX = std::min(minX, h.x / h.w); maxX = std::max(maxX, h.x / h.w);
+        minY = std::min(minY, h.y / h.w); maxY = std::max(maxY, h.y / h.w);
+        minZ = std::min(minZ, h.z / h.w);
+    }
+    auto tile = [](float t, uint32_t n) { return std::clamp(int(t * float(n)), 0, int(n) - 1); };
+    for (int y = tile(-maxY * 0.5f + 0.5f, kTilesY); y <= tile(-minY * 0.5f + 0.5f, kTilesY); y++)
+        for (int x = tile(minX * 0.5f + 0.5f, kTilesX); x <= tile(maxX * 0.5f + 0.5f, kTilesX); x++)
+            if (v.depth[size_t(y) * kTilesX + x] >= minZ) return false;
+    return true;
+}
+
+bool SameStats(const MeshletCullStats& a, const MeshletCullStats& b)
+{
+    return a.tested == b.tested && a.frustumCulled == b.frustumCulled && a.coneCulled == b.coneCulled &&
+           a.occlusionCulled == b.occlusionCulled && a.visible == b.visible && a.ranges == b.ranges;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t stacks = 720, passes = 5;
+    std::string outPath = "meshlet_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--stacks") && more) stacks = uint32_t(std::max(4, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: MeshletBench [--stacks N] [--passes N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    BuildSphere(stacks, positions, indices);
+    MeshletMesh mesh;
+    bool built = false;
+    const double buildSeconds = BestOf(1, [&] {
+        built = Geom::BuildMeshlets(positions.data(), sizeof(float3), positions.size(), indices.data(), indices.size(), mesh);
+    });
+    MeshletCullData soa;
+    soa.Build(mesh);
+    const uint32_t meshletCount = soa.count, triCount = uint32_t(indices.size() / 3);
+
+    std::vector<View> views;
+    for (uint32_t k = 0; k < kViews; k++) views.push_back(MakeView(k));
+
+    // Correctness: an index past the vertex count is rejected with nothing built; then the SIMD
+    // pass vs the scalar reference, and every rejected triangle by brute force
+    bool ok = built;
+    {
+        std::vector<uint32_t> corrupt(indices);
+        corrupt[corrupt.size() / 2] = uint32_t(positions.size());
+        MeshletMesh rejected;
+        if (Geom::BuildMeshlets(positions.data(), sizeof(float3), positions.size(), corrupt.data(), corrupt.size(), rejected) ||
+            !rejected.meshlets.empty() || !rejected.indices.empty()) {
+            std::fprintf(stderr, "MeshletBench: MISMATCH out-of-range index accepted\n");
+            ok = false;
+        }
+    }
+    std::vector<IndexRange> ranges, refRanges;
+    std::vector<uint8_t> drawn;
+    uint64_t checkedTris = 0, visibleTris[2] = {}, rangeCount[2] = {};
+    MeshletCullStats totals[2]{};
+    for (uint32_t k = 0; k < kViews; k++) {
+        for (uint32_t occ = 0; occ < 2; occ++) {
+            const OcclusionBuffer* occlusion = occ ? &views[k].occlusion : nullptr;
+            MeshletCullStats st, ref;
+            const uint32_t visible = CullMeshlets(mesh, soa, views[k].cull, ranges, occlusion, &st);
+            ReferenceCull(mesh, views[k].cull, occlusion, refRanges, ref);
+            const bool sameRanges = ranges.size() == refRanges.size() &&
+                std::equal(ranges.begin(), ranges.end(), refRanges.begin(), [](const IndexRange& a, const IndexRange& b) {
+                    return a.firstIndex == b.firstIndex && a.indexCount == b.indexCount;
+                });
+            if (visible != st.visible || !SameStats(st, ref) || !sameRanges) {
+                std::fprintf(stderr, "MeshletBench: MISMATCH view %u%s: %u visible / %u ranges, reference %u / %u\n", k,
+                             occ ? " (occluded)" : "", st.visible, st.ranges, ref.visible, ref.ranges);
+                ok = false;
+            }
+            totals[occ].frustumCulled += st.frustumCulled;
+            totals[occ].coneCulled += st.coneCulled;
+            totals[occ].occlusionCulled += st.occlusionCulled;
+            totals[occ].visible += st.visible;
+            rangeCount[occ] += st.ranges;
+
+            drawn.assign(triCount, 0);
+            for (const IndexRange& r : ranges)
+                for (uint32_t t = r.firstIndex / 3; t < (r.firstIndex + r.indexCount) / 3; t++) drawn[t] = 1;
+            uint32_t missed = 0;
+            for (uint32_t t = 0; t < triCount; t++) {
+                if (drawn[t]) { visibleTris[occ]++; continue; }
+                const float3 p[3] = { positions[mesh.indices[t * 3]], positions[mesh.indices[t * 3 + 1]], positions[mesh.indices[t * 3 + 2]] };
+                checkedTris++;
+                if (!TriangleRejectable(p, views[k], occlusion != nullptr)) missed++;
+            }
+            if (missed) {
+                std::fprintf(stderr, "MeshletBench: MISMATCH view %u%s drops %u visible triangles\n", k, occ ? " (occluded)" : "", missed);
+                ok = false;
+            }
+        }
+    }
+
+    // Cost per meshlet tested, all views
+    const double tested = double(meshletCount) * kViews;
+    const double simd = BestOf(passes, [&] {
+        for (const View& v : views) CullMeshlets(mesh, soa, v.cull, ranges);
+    });
+    const double simdOcc = BestOf(passes, [&] {
+        for (const View& v : views) CullMeshlets(mesh, soa, v.cull, ranges, &v.occlusion);
+    });
+    const double scalar = BestOf(passes, [&] {
+        MeshletCullStats st;
+        for (const View& v : views) ReferenceCull(mesh, v.cull, nullptr, refRanges, st);
+    });
+
+    std::printf("MeshletBench: %u triangles, %u meshlets (avg %.1f tris), built in %.2f s, %u views\n", triCount,
+                meshletCount, double(triCount) / meshletCount, buildSeconds, kViews);
+    std::printf("  %-24s %10s %10s %10s %10s %10s %10s\n", "pass", "ns/meshlt", "frustum", "cone", "occluded", "visible", "draws");
+    const double rows[3] = { simd, simdOcc, scalar };
+    const char* names[3] = { GE_CULL_SSE ? "CullMeshlets (SSE)" : "CullMeshlets (scalar)", "  + occlusion", "scalar reference" };
+    for (uint32_t r = 0; r < 3; r++) {
+        const MeshletCullStats& st = totals[r == 1 ? 1 : 0];
+        std::printf("  %-24s %10.2f %10u %10u %10u %10u %10llu\n", names[r], rows[r] * 1e9 / tested, st.frustumCulled,
+                    st.coneCulled, st.occlusionCulled, st.visible, (unsigned long long)rangeCount[r == 1 ? 1 : 0]);
+    }
+    std::printf("  triangles submitted: %.1f%% (%.1f%% with occlusion); %llu rejected triangles checked: %s\n",
+                100.0 * double(visibleTris[0]) / (double(triCount) * kViews), 100.0 * double(visibleTris[1]) / (double(triCount) * kViews),
+                (unsigned long long)checkedTris, ok ? "ok" : "MISMATCH");
+
+    char json[1024];
+    std::snprintf(json, sizeof(json),
+        "{\n  \"triangles\": %u,\n  \"meshlets\": %u,\n  \"views\": %u,\n  \"buildSeconds\": %.3f,\n  \"simd\": %s,\n"
+        "  \"cullNsPerMeshlet\": %.3f,\n  \"cullOcclusionNsPerMeshlet\": %.3f,\n  \"scalarNsPerMeshlet\": %.3f,\n"
+        "  \"submittedFraction\": %.4f,\n  \"submittedFractionOcclusion\": %.4f,\n  \"ok\": %s\n}\n",
+        triCount, meshletCount, kViews, buildSeconds, GE_CULL_SSE ? "true" : "false", simd * 1e9 / tested,
+        simdOcc * 1e9 / tested, scalar * 1e9 / tested, double(visibleTris[0]) / (double(triCount) * kViews),
+        double(visibleTris[1]) / (double(triCount) * kViews), ok ? "true" : "false");
+    if (!WriteFile(outPath, json, "MeshletBench")) return 1;
+    return ok ? 0 : 1;
+}
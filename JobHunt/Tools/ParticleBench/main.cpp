@@ -0,0 +1,183 @@
+// ParticleBench: per-frame CPU cost of the particle path at 100k to 1M particles. Fills a cloud
+// around a camera (some of it behind), then runs frames of simulate, sort (view-depth keys, radix
+// sort, arrays permuted into draw order) and billboard expansion into a vertex array (what the
+// renderer writes into the upload ring) while the camera turns, serial and on the job system.
+// The first sort of a freshly emitted cloud (random order) is reported on its own, and std::sort of
+// the same keys is the baseline. The order and the expanded corners are checked. Results go to JSON.
+//   ParticleBench [--particles N] [--passes N] [--threads N] [--out results.json]
+// Without --particles it sweeps 100k, 250k, 500k and 1M.
+#include "Camera.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include "Particles.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kNearZ = 0.1f;
+
+struct Row {
+    uint32_t particles, visible;
+    double   firstSort, stdSort;
+    double   simulate, sort, expand;   // per frame, serial (Simulate always is)
+    double   sortJobs, expandJobs;     // per frame, on the job system
+    bool     ok;
+};
+
+float Depth(const ParticleSystem& ps, uint32_t i, const float4x4& cw)
+{
+    const float3 p = ps.Position(i);
+    return (p.x - cw[3].x) * cw[2].x + (p.y - cw[3].y) * cw[2].y + (p.z - cw[3].z) * cw[2].z;
+}
+
+// Visible particles first and far to near, the rest behind the near plane, corners right
+bool Verify(const ParticleSystem& ps, const float4x4& cw, const std::vector<ParticleVertex>& verts)
+{
+    const uint32_t visible = ps.VisibleCount();
+    const float3 right{ cw[0].x, cw[0].y, cw[0].z }, up{ cw[1].x, cw[1].y, cw[1].z };
+    for (uint32_t i = 0; i < ps.GetCount(); i++) {
+        const float d = Depth(ps, i, cw);
+        if (i >= visible) {
+            if (d > kNearZ) return false;
+            continue;
+        }
+        // Keys keep 15 mantissa bits, so neighbours closer than that may come in either order
+        if (d <= kNearZ || (i && d > Depth(ps, i - 1, cw) * (1.0f + 1.0f / 16384.0f))) return false;
+
+        const float3 c = ps.Position(i), r = right * ps.Size(i), u = up * ps.Size(i);
+        const float3 corners[4] = { c + u - r, c + u + r, c - u - r, c - u + r };
+        for (int j = 0; j < 4; j++)
+            if (length(verts[size_t(i) * 4 + j].pos - corners[j]) > 1e-5f) return false;
+    }
+    return true;
+}
+
+void Fill(ParticleSystem& ps, uint32_t count)
+{
+    ps.SetCapacity(count);
+    ps.Clear();
+    ParticleEmitterDesc e;
+    e.velocity = { 0, 2, 0 };
+    e.spread = 8.0f;
+    e.lifetime = 1000.0f;
+    e.color = 0xC0FFA040u;
+    ps.Emit(e, count);
+    ps.Simulate(1.0f, { 0, -1.0f, 0 });   // spreads the burst into a ~16 unit cloud
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<uint32_t> counts = { 100'000, 250'000, 500'000, 1'000'000 };
+    uint32_t passes = 10, threads = UINT32_MAX;
+    std::string outPath = "particle_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--particles") && more) counts = { uint32_t(std::max(1.0, std::atof(argv[++i]))) };
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && more) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: ParticleBench [--particles N] [--passes N] [--threads N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    // --threads 1 = everything on the main thread
+    JobSystem jobs(threads == UINT32_MAX ? UINT32_MAX : (threads ? threads - 1 : 0));
+
+    // Standing inside the cloud near its edge: most particles in front, some behind
+    Camera camera;
+    camera.SetPosition({ 0, 2, -6 });
+    camera.YawPitch(0.3f, -0.1f);
+    const float dt = 1.0f / 60.0f;
+
+    std::vector<Row> rows;
+    bool allOk = true;
+    for (const uint32_t count : counts) {
+        ParticleSystem ps;
+        std::vector<ParticleVertex> verts(size_t(count) * 4);
+        Row row{};
+        row.particles = count;
+
+        // Cold: emission order is random with respect to depth. Baseline first, while it still is:
+        // the same depth keys through std::sort
+        Fill(ps, count);
+        const float4x4 cw0 = camera.GetCameraToWorld();
+        std::vector<uint64_t> keyed(count);
+        row.stdSort = BestOf(passes, [&] {
+            for (uint32_t i = 0; i < count; i++) {
+                const float d = Depth(ps, i, cw0);
+                uint32_t bits;
+                std::memcpy(&bits, &d, sizeof(bits));
+                keyed[i] = (uint64_t(d > kNearZ ? ~bits : 0xFFFFFFFFu) << 32) | i;
+            }
+            std::sort(keyed.begin(), keyed.end());
+        });
+        const Clock::time_point t0 = Clock::now();
+        ps.Sort(cw0, kNearZ);
+        row.firstSort = Seconds(t0, Clock::now());
+
+        // Steady state: a frame at a time, camera turning; best frame per stage
+        for (JobSystem* j : { (JobSystem*)nullptr, &jobs }) {
+            double simulate = 1e30, sort = 1e30, expand = 1e30;
+            for (uint32_t p = 0; p < passes; p++) {
+                camera.YawPitch(0.01f, 0.0f);
+                const float4x4 cw = camera.GetCameraToWorld();
+                const Clock::time_point a = Clock::now();
+                ps.Simulate(dt, { 0, -1.0f, 0 });
+                const Clock::time_point b = Clock::now();
+                ps.Sort(cw, kNearZ, j);
+                const Clock::time_point c = Clock::now();
+                ps.Expand(cw, verts.data(), j);
+                const Clock::time_point d = Clock::now();
+                simulate = std::min(simulate, Seconds(a, b));
+                sort = std::min(sort, Seconds(b, c));
+                expand = std::min(expand, Seconds(c, d));
+            }
+            if (!j) row.simulate = simulate;
+            (j ? row.sortJobs : row.sort) = sort;
+            (j ? row.expandJobs : row.expand) = expand;
+        }
+        row.visible = ps.VisibleCount();
+        row.ok = Verify(ps, camera.GetCameraToWorld(), verts);
+        allOk &= row.ok;
+        rows.push_back(row);
+    }
+
+    std::printf("ParticleBench: %u threads, best of %u frames\n", jobs.GetThreadCount(), passes);
+    std::printf("  %9s %9s  %10s %10s  %10s %10s %10s  %10s %10s  %s\n", "particles", "visible", "sort cold", "std::sort",
+                "simulate", "sort", "expand", "sort jobs", "exp jobs", "check");
+    std::string json;
+    char buf[640];
+    std::snprintf(buf, sizeof(buf), "{\n  \"benchmark\": \"particle_bench\",\n  \"threads\": %u,\n  \"verified\": %s,\n  \"results\": [",
+                  jobs.GetThreadCount(), allOk ? "true" : "false");
+    json += buf;
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Row& r = rows[i];
+        std::printf("  %9u %9u  %8.2fms %8.2fms  %8.2fms %8.2fms %8.2fms  %8.2fms %8.2fms  %s\n", r.particles, r.visible,
+                    r.firstSort * 1e3, r.stdSort * 1e3, r.simulate * 1e3, r.sort * 1e3, r.expand * 1e3, r.sortJobs * 1e3,
+                    r.expandJobs * 1e3, r.ok ? "ok" : "MISMATCH");
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    { \"particles\": %u, \"visible\": %u, \"coldSortMs\": %.4f, \"stdSortMs\": %.4f,"
+                      " \"simulateMs\": %.4f, \"sortMs\": %.4f, \"expandMs\": %.4f, \"sortJobsMs\": %.4f,"
+                      " \"expandJobsMs\": %.4f, \"ok\": %s }",
+                      i ? "," : "", r.particles, r.visible, r.firstSort * 1e3, r.stdSort * 1e3, r.simulate * 1e3,
+                      r.sort * 1e3, r.expand * 1e3, r.sortJobs * 1e3, r.expandJobs * 1e3, r.ok ? "true" : "false");
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+
+    if (!WriteFile(outPath, json, "ParticleBench")) return 1;
+    return allOk ? 0 : 1;
+}
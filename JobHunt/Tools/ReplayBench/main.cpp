@@ -0,0 +1,346 @@
+// ReplayBench: input recording -> replay determinism, headless. A scripted session (WASD + sprint,
+// right-drag mouse look, wheel zoom, F / G / C toggles, arrow keys moving the player) with jittered
+// frame times is pushed through an InputStream while recording, into the same per-frame update the
+// renderer runs (events applied in order, mouse moves handled against the previous state, physics
+// stepped with InputStream::PeekDt before BeginFrame, like Game's main loop). The recording is
+// saved, loaded and replayed: with the recorded dt every frame must match the live run bit for bit,
+// twice, with live events pushed during the replay dropped; with a fixed dt two replays must match
+// each other. Truncated, padded and inconsistent files must fail to Load. Results go to JSON.
+//   ReplayBench [--frames N] [--fixed-dt s] [--dir path] [--out results.json]
+#include "Camera.h"
+#include "Common/Bench.h"
+#include "Input.h"
+#include "Physics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+// Windows virtual-key codes (Input.h), spelled out so this builds without <Windows.h>
+constexpr uint16_t kVkShift = 0x10, kVkLeft = 0x25, kVkUp = 0x26, kVkRight = 0x27, kVkDown = 0x28;
+
+constexpr float kBaseMoveSpeed = 5.0f, kSprintMul = 2.0f, kPlayerSpeed = 3.0f;   // as Renderer
+constexpr uint32_t kBodies = 16;
+
+// Everything the update touches; compared with memcmp, so floats and 32-bit words only
+struct State {
+    float    camera[3], view[16], fovY;
+    float    player[3];
+    float    bodies[kBodies][6];
+    float    mouseSens, time;
+    uint32_t showGrid, showFrustum, camMode, keysDown;
+};
+
+// The input half of Renderer::Update plus Game's physics step, minus the GPU
+class Sim {
+public:
+    Sim()
+    {
+        for (uint32_t i = 0; i < kBodies; i++) {
+            m_bodies[i].x = float(i) - 8.0f;
+            m_bodies[i].y = 5.0f + Unit(Hash(i)) * 5.0f;
+            m_bodies[i].vx = Unit(Hash(i + 100)) - 0.5f;
+        }
+    }
+
+    void Frame(InputStream& input, float measuredDt)
+    {
+        const float stepDt = input.PeekDt(measuredDt);
+        for (PhysicsEngine::World& b : m_bodies) b.Step(stepDt);
+
+        std::span<const InputEvent> events;
+        const float dt = input.BeginFrame(measuredDt, events);
+        for (const InputEvent& e : events) Apply(e);
+
+        const float s = kBaseMoveSpeed * (m_state.Down(kVkShift) ? kSprintMul : 1.0f);
+        if (m_state.Down('W')) m_camera.TranslateRelative(0, 0, +s * dt);
+        if (m_state.Down('S')) m_camera.TranslateRelative(0, 0, -s * dt);
+        if (m_state.Down('A')) m_camera.TranslateRelative(-s * dt, 0, 0);
+        if (m_state.Down('D')) m_camera.TranslateRelative(+s * dt, 0, 0);
+        const float p = kPlayerSpeed * dt;
+        if (m_state.Down(kVkLeft))  m_player.x -= p;
+        if (m_state.Down(kVkRight)) m_player.x += p;
+        if (m_state.Down(kVkUp))    m_player.z += p;
+        if (m_state.Down(kVkDown))  m_player.z -= p;
+        if (m_camMode != 0) m_camera.SetPosition(m_player + float3{ 0, 1.2f, -4.0f });
+        m_time += dt;
+    }
+
+    State Snapshot() const
+    {
+        State s{};
+        const float3& c = m_camera.GetPosition();
+        s.camera[0] = c.x; s.camera[1] = c.y; s.camera[2] = c.z;
+        const float4x4 view = m_camera.GetView();
+        std::memcpy(s.view, &view, sizeof(s.view));
+        s.fovY = m_camera.GetFovY();
+        s.player[0] = m_player.x; s.player[1] = m_player.y; s.player[2] = m_player.z;
+        for (uint32_t i = 0; i < kBodies; i++) {
+            const PhysicsEngine::World& b = m_bodies[i];
+            const float v[6] = { b.x, b.y, b.z, b.vx, b.vy, b.vz };
+            std::memcpy(s.bodies[i], v, sizeof(v));
+        }
+        s.mouseSens = m_mouseSens;
+        s.time = m_time;
+        s.showGrid = m_showGrid; s.showFrustum = m_showFrustum; s.camMode = m_camMode;
+        for (uint32_t k = 0; k < 256; k++) s.keysDown += m_state.keys[k] ? 1 : 0;
+        return s;
+    }
+
+private:
+    void Apply(const InputEvent& e)
+    {
+        switch (e.type) {
+        case InputEventType::KeyDown:
+            m_state.Apply(e);
+            if (e.key == 'F') m_showFrustum ^= 1;
+            if (e.key == 'G') m_showGrid ^= 1;
+            if (e.key == 'C') m_camMode = (m_camMode + 1) % 3;
+            if (e.key == ']') m_mouseSens = std::min(m_mouseSens * 1.1f, 0.02f);
+            break;
+        case InputEventType::KeyUp: m_state.Apply(e); break;
+        case InputEventType::MouseMove:
+            if ((e.buttons & kInputRight) && (m_state.buttons & kInputRight)) {
+                const float dx = float(e.x - m_state.mouseX), dy = float(e.y - m_state.mouseY);
+                m_camera.YawPitch(dx * m_mouseSens, dy * m_mouseSens);
+            }
+            m_state.Apply(e);
+            break;
+        case InputEventType::MouseWheel: {
+            const float fov = std::clamp(m_camera.GetFovY() + (e.x > 0 ? -to_radians(2.0f) : to_radians(2.0f)),
+                                         to_radians(20.0f), to_radians(110.0f));
+            m_camera.SetLens(fov, m_camera.GetAspect(), m_camera.GetNearZ(), m_camera.GetFarZ());
+            break;
+        }
+        }
+    }
+
+    Camera     m_camera;
+    InputState m_state;
+    float3     m_player{ 0, 0, 0 };
+    PhysicsEngine::World m_bodies[kBodies];
+    float      m_mouseSens = 0.005f, m_time = 0.0f;
+    uint32_t   m_showGrid = 1, m_showFrustum = 0, m_camMode = 0;
+};
+
+// Frame f of the scripted session: its events, and a measured dt of 4-30 ms with a hitch every 97th
+void Script(uint32_t f, std::vector<InputEvent>& out, float& measuredDt)
+{
+    static const uint16_t kHeld[] = { 'W', 'A', 'S', 'D', kVkShift, kVkLeft, kVkUp, kVkRight, kVkDown };
+    out.clear();
+    const uint32_t h = Hash(f);
+    measuredDt = f % 97 == 96 ? 0.1f : 0.004f + Unit(h) * 0.026f;
+
+    // Held keys change every 20-40 frames
+    for (uint32_t k = 0; k < sizeof(kHeld) / sizeof(kHeld[0]); k++) {
+        const uint32_t period = 20 + Hash(k) % 21, phase = Hash(k + 50) % period;
+        if ((f + phase) % period == 0) out.push_back({ (Hash(f * 31 + k) & 1) ? InputEventType::KeyDown : InputEventType::KeyUp, 0, kHeld[k] });
+    }
+    // Right-drag look in bursts, a few moves per frame
+    const bool drag = (f / 60) % 2 == 1;
+    const uint32_t moves = drag ? 1 + h % 4 : (h % 8 == 0 ? 1 : 0);
+    for (uint32_t m = 0; m < moves; m++) {
+        const uint32_t g = Hash(f * 8 + m);
+        out.push_back({ InputEventType::MouseMove, uint8_t(drag ? kInputRight : 0), 0,
+                        640 + int32_t(g % 200) - 100, 360 + int32_t((g >> 8) % 120) - 60 });
+    }
+    if (h % 50 == 7) out.push_back({ InputEventType::MouseWheel, 0, 0, (h & 0x100) ? 120 : -120 });
+    static const uint16_t kToggles[] = { 'F', 'G', 'C', ']' };
+    if (h % 70 == 3) {
+        const uint16_t key = kToggles[(h >> 12) % 4];
+        out.push_back({ InputEventType::KeyDown, 0, key });
+        out.push_back({ InputEventType::KeyUp, 0, key });
+    }
+}
+
+// One replay of `rec`; the per-frame states go to `trace`. Noise is pushed as live input every frame
+// and must be dropped.
+State Replay(const InputRecording& rec, float fixedDt, std::vector<State>& trace)
+{
+    InputStream input;
+    input.StartReplay(rec, fixedDt);
+    Sim sim;
+    trace.clear();
+    for (uint32_t f = 0; !input.ReplayFinished(); f++) {
+        input.Push({ InputEventType::KeyDown, 0, 'W' });
+        input.Push({ InputEventType::MouseMove, kInputRight, 0, int32_t(f), int32_t(f) });
+        sim.Frame(input, 1.0f);   // a measured dt that must never be used
+        trace.push_back(sim.Snapshot());
+    }
+    return trace.empty() ? State{} : trace.back();
+}
+
+bool SameTrace(const std::vector<State>& a, const std::vector<State>& b, uint32_t& firstDiff)
+{
+    firstDiff = 0;
+    if (a.size() != b.size()) return false;
+    for (; firstDiff < a.size(); firstDiff++)
+        if (std::memcmp(&a[firstDiff], &b[firstDiff], sizeof(State)) != 0) return false;
+    return true;
+}
+
+bool WriteBytes(const std::string& path, const std::vector<char>& bytes)
+{
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(bytes.data(), std::streamsize(bytes.size()));
+    return bool(f);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frameCount = 20000;
+    float fixedDt = 1.0f / 60.0f;
+    std::string dir = ".", outPath = "replay_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--frames") && more) frameCount = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--fixed-dt") && more) fixedDt = std::max(1e-4f, float(std::atof(argv[++i])));
+        else if (!std::strcmp(argv[i], "--dir") && more) dir = argv[++i];
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: ReplayBench [--frames N] [--fixed-dt s] [--dir path] [--out results.json]\n");
+            return 1;
+        }
+    }
+    bool ok = true;
+    const std::string recPath = dir + "/replay_bench.gerec", badPath = dir + "/replay_bench_bad.gerec";
+
+    // Live session, recorded
+    InputStream live;
+    live.StartRecording();
+    Sim liveSim;
+    std::vector<State> liveTrace;
+    liveTrace.reserve(frameCount);
+    std::vector<InputEvent> events;
+    double liveTime = 0.0;
+    const Clock::time_point t0 = Clock::now();
+    for (uint32_t f = 0; f < frameCount; f++) {
+        float measuredDt = 0.0f;
+        Script(f, events, measuredDt);
+        for (const InputEvent& e : events) live.Push(e);
+        liveSim.Frame(live, measuredDt);
+        liveTrace.push_back(liveSim.Snapshot());
+        liveTime += measuredDt;
+    }
+    const double liveSeconds = Seconds(t0, Clock::now());
+    const InputRecording recorded = live.StopRecording();
+
+    const Clock::time_point t1 = Clock::now();
+    if (!recorded.Save(recPath)) {
+        std::fprintf(stderr, "ReplayBench: cannot write %s\n", recPath.c_str());
+        return 1;
+    }
+    InputRecording loaded;
+    const bool loadOk = loaded.Load(recPath);
+    const double ioSeconds = Seconds(t1, Clock::now());
+    const uint64_t fileBytes = uint64_t(std::ifstream(recPath, std::ios::binary | std::ios::ate).tellg());
+    if (!loadOk || loaded.frames.size() != frameCount || loaded.events.size() != recorded.events.size() ||
+        std::memcmp(loaded.frames.data(), recorded.frames.data(), recorded.frames.size() * sizeof(InputFrame)) != 0 ||
+        std::memcmp(loaded.events.data(), recorded.events.data(), recorded.events.size() * sizeof(InputEvent)) != 0) {
+        std::fprintf(stderr, "ReplayBench: MISMATCH recording does not survive Save / Load\n");
+        return 1;
+    }
+
+    // Recorded dt: the live run, frame for frame, twice
+    std::vector<State> trace;
+    uint32_t diff = 0;
+    const Clock::time_point t2 = Clock::now();
+    Replay(loaded, 0.0f, trace);
+    const double replaySeconds = Seconds(t2, Clock::now());
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        if (pass) Replay(loaded, 0.0f, trace);
+        if (!SameTrace(trace, liveTrace, diff)) {
+            std::fprintf(stderr, "ReplayBench: MISMATCH recorded-dt replay %u diverges from the live run at frame %u of %zu\n",
+                         pass, diff, trace.size());
+            ok = false;
+        }
+    }
+
+    // Fixed dt: two replays agree, and time advances by exactly frames * dt
+    std::vector<State> fixedA, fixedB;
+    Replay(loaded, fixedDt, fixedA);
+    Replay(loaded, fixedDt, fixedB);
+    if (!SameTrace(fixedA, fixedB, diff)) {
+        std::fprintf(stderr, "ReplayBench: MISMATCH fixed-dt replays diverge at frame %u\n", diff);
+        ok = false;
+    }
+    float fixedTime = 0.0f;
+    for (uint32_t f = 0; f < frameCount; f++) fixedTime += fixedDt;
+    if (fixedA.empty() || fixedA.back().time != fixedTime) {
+        std::fprintf(stderr, "ReplayBench: MISMATCH fixed-dt replay simulated %.6f s, expected %.6f\n",
+                     fixedA.empty() ? 0.0 : double(fixedA.back().time), double(fixedTime));
+        ok = false;
+    }
+
+    // Corrupt files: Load refuses them, before sizing anything from the header
+    std::vector<char> good(fileBytes);
+    std::ifstream(recPath, std::ios::binary).read(good.data(), std::streamsize(good.size()));
+    struct Corrupt { const char* name; std::vector<char> bytes; };
+    std::vector<Corrupt> corrupt;
+    corrupt.push_back({ "truncated", std::vector<char>(good.begin(), good.end() - 1) });
+    corrupt.push_back({ "header only", std::vector<char>(good.begin(), good.begin() + sizeof(InputRecordingHeader)) });
+    corrupt.push_back({ "padded", good });
+    corrupt.back().bytes.push_back(0);
+    for (const uint32_t count : { 0xFFFFFFFFu, 0x40000000u }) {
+        InputRecordingHeader hdr;
+        hdr.frameCount = count;
+        hdr.eventCount = count;
+        std::vector<char> bytes(sizeof(hdr));
+        std::memcpy(bytes.data(), &hdr, sizeof(hdr));
+        corrupt.push_back({ count == 0xFFFFFFFFu ? "4G frames" : "1G frames", bytes });
+    }
+    {
+        InputRecordingHeader hdr;
+        std::memcpy(&hdr, good.data(), sizeof(hdr));
+        hdr.frameCount += 1;
+        hdr.eventCount -= uint32_t(sizeof(InputFrame) / sizeof(InputEvent));   // same total size
+        corrupt.push_back({ "counts swapped", good });
+        std::memcpy(corrupt.back().bytes.data(), &hdr, sizeof(hdr));
+    }
+    double rejectSeconds = 0.0;
+    for (const Corrupt& c : corrupt) {
+        if (!WriteBytes(badPath, c.bytes)) {
+            std::fprintf(stderr, "ReplayBench: cannot write %s\n", badPath.c_str());
+            return 1;
+        }
+        InputRecording rec;
+        const Clock::time_point tc = Clock::now();
+        const bool accepted = rec.Load(badPath);
+        rejectSeconds = std::max(rejectSeconds, Seconds(tc, Clock::now()));
+        if (accepted || !rec.frames.empty() || !rec.events.empty()) {
+            std::fprintf(stderr, "ReplayBench: MISMATCH Load accepted a %s file\n", c.name);
+            ok = false;
+        }
+    }
+    std::remove(badPath.c_str());
+
+    const State& last = liveTrace.back();
+    std::printf("ReplayBench: %u frames, %zu events, %.1f s simulated, %.1f KB recording\n", frameCount,
+                recorded.events.size(), liveTime, double(fileBytes) / 1024.0);
+    std::printf("  %-26s %10.3f ms\n", "live + record", liveSeconds * 1e3);
+    std::printf("  %-26s %10.3f ms\n", "save + load", ioSeconds * 1e3);
+    std::printf("  %-26s %10.3f ms  (%.2f us/frame)\n", "replay (recorded dt)", replaySeconds * 1e3, replaySeconds * 1e6 / frameCount);
+    std::printf("  %-26s %10.3f ms  (slowest of %zu)\n", "reject corrupt file", rejectSeconds * 1e3, corrupt.size());
+    std::printf("  final camera (%.3f, %.3f, %.3f), player (%.3f, %.3f), body 0 y %.4f: %s\n", last.camera[0], last.camera[1],
+                last.camera[2], last.player[0], last.player[2], last.bodies[0][1], ok ? "deterministic" : "MISMATCH");
+
+    char json[1024];
+    std::snprintf(json, sizeof(json),
+        "{\n  \"frames\": %u,\n  \"events\": %zu,\n  \"recordingKB\": %.1f,\n  \"liveMs\": %.3f,\n  \"saveLoadMs\": %.3f,\n"
+        "  \"replayUsPerFrame\": %.3f,\n  \"rejectMs\": %.3f,\n  \"deterministic\": %s\n}\n",
+        frameCount, recorded.events.size(), double(fileBytes) / 1024.0, liveSeconds * 1e3, ioSeconds * 1e3,
+        replaySeconds * 1e6 / frameCount, rejectSeconds * 1e3, ok ? "true" : "false");
+    if (!WriteFile(outPath, json, "ReplayBench")) return 1;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+// SceneBench: RenderScene update cost as the number of changed proxies grows. Fills a scene through
+// a RenderCommandQueue, then per frame records a churn of K changes (small nudges that stay in the
+// fat BVH box, teleports, visibility toggles, new local bounds, destroy + recreate), submits it and
+// times ApplyUpdates. A plain array mirrors every command; after each row every live proxy's world
+// bounds, the proxy and leaf counts and the culled set of several views must equal a brute-force
+// pass over that mirror. Then times BVH culling against the brute-force loop. Results go to JSON.
+//   SceneBench [--proxies N] [--frames N] [--passes N] [--out results.json]
+#include "Common/Bench.h"
+#include "Culling.h"
+#include "Scene/RenderScene.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kWorldHalf = 500.0f;
+constexpr uint32_t kViews = 4;
+
+// What the scene should hold for one id, replayed from the recorded commands
+struct Mirror {
+    float4x4 world;
+    AABB_t   localBounds;
+    uint32_t kind = 0;
+    bool     alive = false;
+    bool     visible = false;
+};
+
+struct Row {
+    uint32_t changes, commands, dirty, reinserted;
+    double   record, apply;   // seconds per frame
+    bool     ok;
+};
+
+uint32_t g_rand = 0;
+float Random01() { return Unit(Hash(g_rand++)); }
+float RandomSigned() { return Random01() * 2 - 1; }
+
+RenderProxyDesc RandomProxy()
+{
+    RenderProxyDesc d;
+    const float s = 0.5f + 2.5f * Random01();
+    d.world = m_mul(m_scale({ s, s, s }), m_translation({ RandomSigned() * kWorldHalf, Random01() * 20.0f, RandomSigned() * kWorldHalf }));
+    d.kind = Random01() < 0.1f ? kProxyDebugBox : kProxyMesh;
+    return d;
+}
+
+void Apply(std::vector<Mirror>& mirror, RenderProxyId id, const RenderProxyDesc& d)
+{
+    if (id >= mirror.size()) mirror.resize(id + 1);
+    mirror[id] = { d.world, d.localBounds, d.kind, true, d.visible };
+}
+
+// Records `changes` changes to random live proxies into the queue and the mirror; returns the
+// commands recorded. `touched` collects the ids, so the caller knows how many the scene must redo.
+uint32_t Churn(RenderCommandQueue& queue, std::vector<Mirror>& mirror, uint32_t changes, std::vector<RenderProxyId>& touched)
+{
+    uint32_t commands = 0;
+    for (uint32_t c = 0; c < changes; c++) {
+        RenderProxyId id;
+        do id = Hash(g_rand++) % (uint32_t)mirror.size(); while (!mirror[id].alive);
+        Mirror& m = mirror[id];
+        const float pick = Random01();
+        if (pick < 0.6f) {
+            // A few centimetres: inside the 0.1 fat margin, so the leaf stays put
+            m.world[3].x += RandomSigned() * 0.04f;
+            m.world[3].z += RandomSigned() * 0.04f;
+            queue.SetTransform(id, m.world);
+        } else if (pick < 0.8f) {
+            m.world[3] = { RandomSigned() * kWorldHalf, Random01() * 20.0f, RandomSigned() * kWorldHalf, 1.0f };
+            queue.SetTransform(id, m.world);
+        } else if (pick < 0.88f) {
+            m.visible = !m.visible;
+            queue.SetVisible(id, m.visible);
+        } else if (pick < 0.94f) {
+            m.localBounds = { { RandomSigned() * 0.25f, 0.5f * Random01(), 0 }, { 0.25f + Random01(), 0.5f, 0.25f + Random01() } };
+            queue.SetBounds(id, m.localBounds);
+        } else {
+            queue.Destroy(id);
+            m.alive = false;
+            const RenderProxyDesc d = RandomProxy();
+            id = queue.Create(d);
+            Apply(mirror, id, d);
+            commands++;
+        }
+        commands++;
+        touched.push_back(id);
+    }
+    return commands;
+}
+
+bool SameBounds(const AABB_t& a, const AABB_t& b)
+{
+    return a.center.x == b.center.x && a.center.y == b.center.y && a.center.z == b.center.z &&
+           a.extents.x == b.extents.x && a.extents.y == b.extents.y && a.extents.z == b.extents.z;
+}
+
+std::vector<CullView> MakeViews()
+{
+    std::vector<CullView> views;
+    for (uint32_t v = 0; v < kViews; v++) {
+        const float yaw = 0.4f + 1.57f * float(v);
+        const float3 pos{ std::cos(yaw) * 150.0f * float(v), 4.0f, std::sin(yaw) * 150.0f * float(v) };
+        views.push_back(MakeCullView(camera_to_world(pos, { std::sin(yaw), -0.05f, std::cos(yaw) }, { 0, 1, 0 }),
+                                     1.0f, 16.0f / 9.0f, 0.1f, 150.0f));
+    }
+    return views;
+}
+
+// Brute force over the mirror: the visible live proxies of `kinds` whose exact world bounds pass `view`
+void CullMirror(const std::vector<Mirror>& mirror, const CullView& view, uint32_t kinds, std::vector<RenderProxyId>& out)
+{
+    out.clear();
+    for (RenderProxyId id = 0; id < (RenderProxyId)mirror.size(); id++) {
+        const Mirror& m = mirror[id];
+        if (m.alive && m.visible && (m.kind & kinds) && AabbVisible(view, aabb_transform_affine(m.localBounds, m.world)))
+            out.push_back(id);
+    }
+}
+
+// Everything the scene exposes must follow from the commands alone
+bool Check(const RenderScene& scene, const std::vector<Mirror>& mirror, const std::vector<CullView>& views, const char* when)
+{
+    uint32_t alive = 0, visible = 0, meshes = 0, boxes = 0, badBounds = 0;
+    for (RenderProxyId id = 0; id < (RenderProxyId)mirror.size(); id++) {
+        const Mirror& m = mirror[id];
+        if (!m.alive) continue;
+        alive++;
+        visible += m.visible;
+        meshes += m.kind == kProxyMesh;
+        boxes += m.kind == kProxyDebugBox;
+        badBounds += !SameBounds(scene.WorldBounds(id), aabb_transform_affine(m.localBounds, m.world));
+    }
+    bool ok = true;
+    if (badBounds) {
+        std::fprintf(stderr, "SceneBench: MISMATCH %s: %u proxies with stale world bounds\n", when, badBounds);
+        ok = false;
+    }
+    if (scene.ProxyCount() != alive || scene.ProxyCount(kProxyMesh) != meshes || scene.ProxyCount(kProxyDebugBox) != boxes ||
+        scene.Bvh().LeafCount() != visible) {
+        std::fprintf(stderr, "SceneBench: MISMATCH %s: %u/%u/%u proxies, %u leaves; expected %u/%u/%u, %u\n", when,
+                     scene.ProxyCount(), scene.ProxyCount(kProxyMesh), scene.ProxyCount(kProxyDebugBox),
+                     scene.Bvh().LeafCount(), alive, meshes, boxes, visible);
+        ok = false;
+    }
+
+    std::vector<RenderProxyId> got, want;
+    for (uint32_t v = 0; v < (uint32_t)views.size(); v++) {
+        for (const uint32_t kinds : { uint32_t(kProxyMesh), uint32_t(kProxyMesh | kProxyDebugBox) }) {
+            got.clear();
+            scene.Cull(views[v], kinds, [&](RenderProxyId id, bool) { got.push_back(id); });
+            std::sort(got.begin(), got.end());
+            CullMirror(mirror, views[v], kinds, want);
+            if (got != want) {
+                std::fprintf(stderr, "SceneBench: MISMATCH %s: view %u kinds %u culls %zu proxies, brute force %zu\n",
+                             when, v, kinds, got.size(), want.size());
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t proxies = 1'000'000, frames = 20, passes = 5;
+    std::string outPath = "scene_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--proxies") && more) proxies = uint32_t(std::max(1.0, std::atof(argv[++i])));
+        else if (!std::strcmp(argv[i], "--frames") && more) frames = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: SceneBench [--proxies N] [--frames N] [--passes N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    RenderScene scene;
+    RenderCommandQueue queue;
+    std::vector<Mirror> mirror;
+    mirror.reserve(proxies);
+    for (uint32_t i = 0; i < proxies; i++) {
+        const RenderProxyDesc d = RandomProxy();
+        Apply(mirror, queue.Create(d), d);
+    }
+    queue.Submit();
+    const Clock::time_point fill0 = Clock::now();
+    scene.ApplyUpdates(queue);
+    const double fill = Seconds(fill0, Clock::now());
+
+    const std::vector<CullView> views = MakeViews();
+    bool allOk = Check(scene, mirror, views, "after fill");
+
+    std::vector<Row> rows;
+    std::vector<RenderProxyId> touched;
+    for (const uint32_t changes : { 0u, 10u, 100u, 1000u, 10'000u, 100'000u }) {
+        if (changes > proxies) break;
+        Row row{};
+        row.changes = changes;
+        row.ok = true;
+        for (uint32_t f = 0; f < frames; f++) {
+            touched.clear();
+            const Clock::time_point t0 = Clock::now();
+            const uint32_t commands = Churn(queue, mirror, changes, touched);
+            queue.Submit();
+            const Clock::time_point t1 = Clock::now();
+            const RenderScene::UpdateStats stats = scene.ApplyUpdates(queue);
+            const Clock::time_point t2 = Clock::now();
+            row.record += Seconds(t0, t1);
+            row.apply += Seconds(t1, t2);
+            row.commands += stats.commands;
+            row.dirty += stats.dirty;
+            row.reinserted += stats.reinserted;
+
+            // Dirty work is one recompute per live proxy named this frame, however often it was named
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            const uint32_t expect = (uint32_t)std::count_if(touched.begin(), touched.end(), [&](RenderProxyId id) { return mirror[id].alive; });
+            if (stats.commands != commands || stats.dirty != expect || stats.reinserted > stats.dirty) {
+                std::fprintf(stderr, "SceneBench: MISMATCH %u changes: %u commands, %u dirty, %u reinserted; expected %u, %u\n",
+                             changes, stats.commands, stats.dirty, stats.reinserted, commands, expect);
+                row.ok = false;
+            }
+        }
+        row.record /= frames;
+        row.apply /= frames;
+        char when[64];
+        std::snprintf(when, sizeof(when), "after %u changes x %u frames", changes, frames);
+        row.ok &= Check(scene, mirror, views, when);
+        allOk &= row.ok;
+        rows.push_back(row);
+    }
+
+    // Culling the settled scene: the BVH walk against the loop a per-frame renderer would run
+    uint32_t visible = 0, bruteVisible = 0, nodes = 0;
+    std::vector<RenderProxyId> out;
+    const double cull = BestOf(passes, [&] {
+        visible = nodes = 0;
+        for (const CullView& view : views)
+            nodes += scene.Cull(view, kProxyMesh, [&](RenderProxyId, bool) { visible++; });
+    });
+    const double brute = BestOf(passes, [&] {
+        bruteVisible = 0;
+        for (const CullView& view : views) {
+            CullMirror(mirror, view, kProxyMesh, out);
+            bruteVisible += (uint32_t)out.size();
+        }
+    });
+    if (visible != bruteVisible) {
+        std::fprintf(stderr, "SceneBench: MISMATCH cull: %u visible, brute force %u\n", visible, bruteVisible);
+        allOk = false;
+    }
+
+    std::printf("SceneBench: %u proxies, fill %.1f ms, BVH height %u, %u frames per row\n", proxies, fill * 1e3,
+                scene.Bvh().Height(), frames);
+    std::printf("  %7s %9s %8s %10s  %10s %10s %9s  %s\n", "changes", "commands", "dirty", "reinserted", "record us",
+                "apply us", "ns/chg", "check");
+    std::string json;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf), "{\n  \"benchmark\": \"scene_bench\",\n  \"proxies\": %u,\n  \"frames\": %u,\n  \"verified\": %s,\n"
+                  "  \"fill_ms\": %.3f,\n  \"results\": [", proxies, frames, allOk ? "true" : "false", fill * 1e3);
+    json += buf;
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Row& r = rows[i];
+        const double perChange = r.changes ? r.apply * 1e9 / r.changes : 0.0;
+        std::printf("  %7u %9u %8u %10u  %10.2f %10.2f %9.1f  %s\n", r.changes, r.commands / frames, r.dirty / frames,
+                    r.reinserted / frames, r.record * 1e6, r.apply * 1e6, perChange, r.ok ? "ok" : "MISMATCH");
+        std::snprintf(buf, sizeof(buf), "%s\n    { \"changes\": %u, \"commands_per_frame\": %u, \"dirty_per_frame\": %u, "
+                      "\"reinserted_per_frame\": %u, \"record_us\": %.3f, \"apply_us\": %.3f, \"apply_ns_per_change\": %.1f, \"ok\": %s }",
+                      i ? "," : "", r.changes, r.commands / frames, r.dirty / frames, r.reinserted / frames, r.record * 1e6,
+                      r.apply * 1e6, perChange, r.ok ? "true" : "false");
+        json += buf;
+    }
+    std::printf("  cull %u views: BVH %.2f ms (%u nodes), brute force %.2f ms, %u visible\n", kViews, cull * 1e3, nodes,
+                brute * 1e3, visible);
+    std::snprintf(buf, sizeof(buf), "\n  ],\n  \"cull\": { \"views\": %u, \"visible\": %u, \"nodes\": %u, \"bvh_ms\": %.3f, "
+                  "\"brute_force_ms\": %.3f }\n}\n", kViews, visible, nodes, cull * 1e3, brute * 1e3);
+    json += buf;
+
+    if (!WriteFile(outPath, json, "SceneBench")) return 1;
+    return allOk ? 0 : 1;
+}
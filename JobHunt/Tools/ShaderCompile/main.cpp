@@ -0,0 +1,119 @@
+// ShaderCompile: every permutation of the engine's shader programs -> one archive (see Assets/ShaderPermutations.h)
+//   ShaderCompile <shaderDir> <output.gesa> [--threads N] [--cache file] [--debug] [--list] [--stub]
+// --cache keeps bytecode between runs so only edited permutations recompile. --stub writes placeholder
+// blobs instead of calling the compiler; it is the only back end off Windows and exists to exercise
+// keying, the archive format and lookup.
+#include "Assets/ShaderPermutations.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#if defined(_WIN32)
+#include "Assets/D3DShaderCompiler.h"
+#include <d3dcompiler.h>
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+    // Deterministic "bytecode": the key of what would have been compiled
+    class StubCompiler final : public ShaderCompiler {
+    public:
+        std::string Version() const override { return "stub_1"; }
+        bool Compile(const ShaderDesc& desc, const std::string& source, std::vector<uint8_t>& bytecode, std::string&) override
+        {
+            Hasher128 h;
+            h.Add(source);
+            h.Add(desc.entry);
+            for (const ShaderDefine& d : desc.defines) { h.Add(d.name); h.Add(d.value); }
+            const Hash128 k = h.Get();
+            bytecode.resize(64);
+            for (size_t i = 0; i < bytecode.size(); i++) bytecode[i] = uint8_t((i & 8 ? k.hi : k.lo) >> ((i & 7) * 8));
+            return true;
+        }
+    };
+
+    void ListPermutations(std::span<const ShaderProgramDesc> programs)
+    {
+        for (const ShaderProgramDesc& p : programs) {
+            std::printf("%s (%s): keywords [%s], %u permutations\n", p.name.c_str(), p.path.c_str(),
+                        ShaderKeywordString(p.keywords).c_str(), PermutationCount(p.keywords));
+            for (uint32_t m = p.keywords;; m = (m - 1) & p.keywords) {
+                std::printf("  %2u  [%s]\n", PermutationIndex(m, p.keywords), ShaderKeywordString(m).c_str());
+                if (!m) break;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: ShaderCompile <shaderDir> <output.gesa> [--threads N] [--cache file] [--debug] [--list] [--stub]\n");
+        return 1;
+    }
+    uint32_t threads = UINT32_MAX;
+    const char* cachePath = nullptr;
+    bool debug = false, list = false, stub = false;
+    for (int i = 3; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--cache") && i + 1 < argc) cachePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--debug")) debug = true;
+        else if (!std::strcmp(argv[i], "--list")) list = true;
+        else if (!std::strcmp(argv[i], "--stub")) stub = true;
+    }
+
+    // Archive and cache keys must match the ones the engine computes at run time
+    if (!VerifyHashBytes128()) {
+        std::fprintf(stderr, "ShaderCompile: HashBytes128 does not match the reference digests\n");
+        return 1;
+    }
+
+    const std::span<const ShaderProgramDesc> programs = EngineShaderPrograms();
+    if (list) ListPermutations(programs);
+
+    std::unique_ptr<ShaderCompiler> compiler;
+    uint32_t flags = 0;
+#if defined(_WIN32)
+    if (!stub) compiler = std::make_unique<D3DShaderCompiler>();
+    if (debug) flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;   // must match the runtime's flags to be used
+#else
+    (void)debug;
+    (void)stub;
+#endif
+    if (!compiler) compiler = std::make_unique<StubCompiler>();
+
+    // --threads 1 = single-threaded (no pool)
+    std::unique_ptr<JobSystem> jobs;
+    if (threads != 1) jobs = std::make_unique<JobSystem>(threads == UINT32_MAX ? UINT32_MAX : threads - 1);
+
+    ShaderCache cache;
+    if (cachePath) cache.Open(cachePath);
+
+    const auto t0 = Clock::now();
+    ShaderArchiveBuildStats stats;
+    std::string errors;
+    const bool ok = BuildShaderArchive(argv[2], programs, argv[1], flags, *compiler, jobs.get(),
+                                       cachePath ? &cache : nullptr, errors, &stats);
+    if (cachePath) cache.Save();
+    const auto t1 = Clock::now();
+    if (!ok) {
+        std::fprintf(stderr, "ShaderCompile: %u failed\n%s", stats.failed, errors.c_str());
+        return 1;
+    }
+
+    ShaderArchive archive;
+    if (!archive.Open(argv[2])) {
+        std::fprintf(stderr, "ShaderCompile: %s does not read back\n", argv[2]);
+        return 1;
+    }
+    std::printf("%s: %u programs, %u compiled, %u reused, %.1f KB | key %.3fs compile %.3fs write %.3fs total %.3fs (%u threads)\n",
+                argv[2], archive.GetProgramCount(), stats.compiled, stats.reused, double(stats.bytes) / 1024.0,
+                stats.keySeconds, stats.compileSeconds, stats.writeSeconds, Seconds(t0, t1), jobs ? jobs->GetThreadCount() : 1u);
+    return 0;
+}
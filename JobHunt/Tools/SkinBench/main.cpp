@@ -0,0 +1,183 @@
+// SkinBench: CPU skinning throughput per core. Builds a tube mesh around a bent, twisted joint chain
+// (every vertex weighted to up to four nearby joints), poses it through the animation module, then
+// skins it with linear blend and dual quaternions, scalar and AVX2, into two destinations: an
+// interleaved VertexPNC stream (as an upload-ring allocation would be) and a packed position array
+// (as a physics / hit-test buffer would be). AVX2 results are checked against the scalar paths.
+// Results go to JSON.
+//   SkinBench [--vertices N] [--joints N] [--passes N] [--out results.json]
+#include "Animation/Pose.h"
+#include "Animation/Skinning.h"
+#include "Common/Bench.h"
+#include "Geometry.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+constexpr float kBoneLength = 0.1f;
+
+struct Result {
+    std::string name;
+    double      seconds;     // best pass
+};
+
+template <typename Fn> Result Measure(std::string name, uint32_t passes, Fn&& fn)
+{
+    return { std::move(name), BestOf(passes, fn) };
+}
+
+float MaxDistance(const std::vector<VertexPNC>& a, const std::vector<VertexPNC>& b)
+{
+    float d = 0;
+    for (size_t i = 0; i < a.size(); i++) d = std::max({ d, length(a[i].pos - b[i].pos), length(a[i].normal - b[i].normal) });
+    return d;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t vertices = 200'000, joints = 60, passes = 20;
+    std::string outPath = "skin_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--vertices") && more) vertices = uint32_t(std::max(1.0, std::atof(argv[++i])));
+        else if (!std::strcmp(argv[i], "--joints") && more) joints = uint32_t(std::clamp(std::atoi(argv[++i]), 2, 65535));
+        else if (!std::strcmp(argv[i], "--passes") && more) passes = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: SkinBench [--vertices N] [--joints N] [--passes N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    // Chain along +Y, one joint per kBoneLength
+    Skeleton skeleton;
+    skeleton.parents.resize(joints);
+    skeleton.bindPose.resize(joints);
+    for (uint32_t j = 0; j < joints; j++) {
+        skeleton.parents[j] = int16_t(int(j) - 1);
+        skeleton.bindPose[j].translation = { 0, j ? kBoneLength : 0.0f, 0 };
+    }
+    Pose pose;
+    BindPose(skeleton, pose);
+    std::vector<float4x4> bindModel(joints), inverseBind(joints), model(joints), palette(joints);
+    LocalToModel(skeleton, pose, bindModel);
+    for (uint32_t j = 0; j < joints; j++) inverseBind[j] = m_inverse_affine(bindModel[j]);
+
+    // Posed: every joint bends a little and twists hard, which is where the two methods differ
+    for (uint32_t j = 1; j < joints; j++) {
+        const quat bend = q_from_axis_angle({ 1, 0, 0.3f }, 0.08f);
+        const quat twist = q_from_axis_angle({ 0, 1, 0 }, 0.15f);
+        pose.Set(j, q_mul(twist, bend), skeleton.bindPose[j].translation);
+    }
+    LocalToModel(skeleton, pose, model);
+    BuildSkinMatrices(model, inverseBind, palette);
+    std::vector<dualquat> dualQuats(joints);
+    BuildSkinDualQuats(palette, dualQuats);
+
+    // Tube around the chain; each vertex takes the (up to) four nearest joints, weights by distance
+    std::vector<VertexPNC> bind(vertices);
+    std::vector<SkinInfluence> influences(vertices);
+    const float height = kBoneLength * float(joints - 1);
+    uint32_t rigid = 0;
+    for (uint32_t v = 0; v < vertices; v++) {
+        const float y = height * Unit(Hash(v)), angle = 2.0f * kPi * Unit(Hash(v + vertices));
+        const float3 n{ std::cos(angle), 0, std::sin(angle) };
+        bind[v] = { n * 0.05f + float3{ 0, y, 0 }, n, { 1, 1, 1 } };
+
+        SkinInfluence& inf = influences[v];
+        const int nearest = std::clamp(int(y / kBoneLength + 0.5f), 0, int(joints) - 1);
+        float sum = 0;
+        for (int i = 0; i < 4; i++) {
+            const int j = std::clamp(nearest - 1 + i, 0, int(joints) - 1);
+            const float d = std::fabs(y - kBoneLength * float(j)) / kBoneLength;
+            inf.joints[i] = uint16_t(j);
+            inf.weights[i] = std::max(0.0f, 1.5f - d);
+            sum += inf.weights[i];
+        }
+        for (float& w : inf.weights) w /= sum;
+        // Every 16th vertex rigidly bound: LBS and DQS must agree exactly there
+        if (v % 16 == 0) {
+            inf.joints[0] = uint16_t(nearest);
+            inf.weights[0] = 1.0f;
+            inf.weights[1] = inf.weights[2] = inf.weights[3] = 0.0f;
+            rigid++;
+        }
+    }
+
+    SkinSource src;
+    src.positions = reinterpret_cast<const std::byte*>(&bind[0].pos);
+    src.positionStride = sizeof(VertexPNC);
+    src.normals = reinterpret_cast<const std::byte*>(&bind[0].normal);
+    src.normalStride = sizeof(VertexPNC);
+    src.influences = influences.data();
+    src.vertexCount = vertices;
+
+    // Interleaved destination (the renderer's vertex layout) and a packed physics position array
+    std::vector<VertexPNC> lbsScalar(bind), lbsAvx(bind), dqsScalar(bind), dqsAvx(bind);
+    std::vector<float3> physics(vertices);
+    auto target = [](std::vector<VertexPNC>& out) {
+        SkinTarget t;
+        t.positions = reinterpret_cast<std::byte*>(&out[0].pos);
+        t.positionStride = sizeof(VertexPNC);
+        t.normals = reinterpret_cast<std::byte*>(&out[0].normal);
+        t.normalStride = sizeof(VertexPNC);
+        return t;
+    };
+    SkinTarget physicsTarget;
+    physicsTarget.positions = reinterpret_cast<std::byte*>(physics.data());
+
+    const bool avx2 = BestSkinPath() == SkinPath::Avx2;
+    std::vector<Result> results;
+    results.push_back(Measure("linear blend (scalar)", passes, [&] { SkinLinear(src, palette, target(lbsScalar), 0, vertices, SkinPath::Scalar); }));
+    results.push_back(Measure("dual quat (scalar)", passes, [&] { SkinDualQuat(src, dualQuats, target(dqsScalar), 0, vertices, SkinPath::Scalar); }));
+    if (avx2) {
+        results.push_back(Measure("linear blend (avx2)", passes, [&] { SkinLinear(src, palette, target(lbsAvx), 0, vertices, SkinPath::Avx2); }));
+        results.push_back(Measure("dual quat (avx2)", passes, [&] { SkinDualQuat(src, dualQuats, target(dqsAvx), 0, vertices, SkinPath::Avx2); }));
+    }
+    results.push_back(Measure("linear blend positions -> physics", passes, [&] { SkinLinear(src, palette, physicsTarget, 0, vertices); }));
+
+    // AVX2 = scalar; LBS = DQS on rigidly bound vertices; physics positions = interleaved ones
+    const float avxLbsError = avx2 ? MaxDistance(lbsScalar, lbsAvx) : 0.0f;
+    const float avxDqsError = avx2 ? MaxDistance(dqsScalar, dqsAvx) : 0.0f;
+    float rigidError = 0, physicsError = 0, methodGap = 0;
+    for (uint32_t v = 0; v < vertices; v++) {
+        const float gap = length(lbsScalar[v].pos - dqsScalar[v].pos);
+        if (v % 16 == 0) rigidError = std::max(rigidError, gap);
+        methodGap = std::max(methodGap, gap);
+        physicsError = std::max(physicsError, length(physics[v] - lbsScalar[v].pos));
+    }
+    const bool ok = avxLbsError < 1e-4f && avxDqsError < 1e-4f && rigidError < 1e-4f && physicsError < 1e-4f;
+
+    std::printf("SkinBench: %u vertices, %u joints, %s, %s\n", vertices, joints, avx2 ? "AVX2" : "no AVX2 (scalar only)",
+                ok ? "verified" : "MISMATCH");
+    std::printf("  max |avx2 - scalar| lbs %.2g dqs %.2g, rigid lbs-dqs %.2g, largest lbs-dqs gap %.4f\n",
+                avxLbsError, avxDqsError, rigidError, methodGap);
+    std::string json;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf), "{\n  \"benchmark\": \"skin_bench\",\n  \"vertices\": %u,\n  \"joints\": %u,\n  \"avx2\": %s,\n"
+                  "  \"verified\": %s,\n  \"lbsDqsGap\": %.5f,\n  \"results\": [",
+                  vertices, joints, avx2 ? "true" : "false", ok ? "true" : "false", methodGap);
+    json += buf;
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        const double mvps = r.seconds > 0 ? double(vertices) / r.seconds * 1e-6 : 0.0;
+        std::printf("  %-34s %8.3f ms  %8.1f M verts/s/core\n", r.name.c_str(), r.seconds * 1e3, mvps);
+        std::snprintf(buf, sizeof(buf), "%s\n    { \"name\": \"%s\", \"ms\": %.4f, \"millionVertsPerSecPerCore\": %.3f }",
+                      i ? "," : "", r.name.c_str(), r.seconds * 1e3, mvps);
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+
+    if (!WriteFile(outPath, json, "SkinBench")) return 1;
+    return ok ? 0 : 1;
+}
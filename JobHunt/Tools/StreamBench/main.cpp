@@ -0,0 +1,255 @@
+// StreamBench: request -> resident latency and I/O throughput of the AssetStreamer. Writes a pack of
+// LZ4 block-compressed assets scattered over a plane, then flies a camera across it: every frame
+// re-prioritises what is still outstanding (StreamPriority: distance, ahead = visible), cancels
+// what has fallen far behind, and pumps uploads under a byte budget. Processing decodes on the job
+// system; every upload is checked against the generator, and the counts against the stats.
+// A second pass queues more than maxInFlightBytes and checks that WaitIdle returns without pumping,
+// and wakes again after pumps and after a cancel empties the queue.
+// Page cache is warm (the pack was just written). Results go to JSON.
+//   StreamBench [--assets N] [--budget MB] [--frame-ms N] [--threads N] [--dir path] [--out results.json]
+#include "Assets/AssetStreamer.h"
+#include "Assets/Compression.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float kExtent = 100.0f;        // assets spread over [-kExtent, kExtent]^2
+constexpr float kCameraStep = 1.0f;      // per frame, along +x
+constexpr float kDropBehind = 40.0f;     // outstanding requests this far behind the camera are cancelled
+constexpr uint32_t kMaxAssetBytes = 256 * 1024;
+
+struct Asset {
+    float    x = 0, z = 0;
+    uint64_t offset = 0;
+    uint32_t packed = 0, raw = 0;
+    StreamHandle handle = kInvalidStream;
+    bool     uploaded = false, dropped = false, corrupt = false;
+};
+
+// Word w of asset i; runs of 16 equal words so the blocks compress
+uint32_t Word(uint32_t asset, uint32_t w) { return Hash(asset * 0x10001u + w / 16); }
+
+bool Decode(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& out)
+{
+    BlockStreamReader reader;
+    if (!reader.Open(src, srcSize)) return false;
+    out.resize(size_t(reader.RawSize()));
+    return reader.DecodeAll(out.data());
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t assetCount = 2000, threads = UINT32_MAX;
+    double budgetMB = 8.0, frameMs = 2.0;
+    std::string dir = ".", outPath = "stream_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--assets") && more) assetCount = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--budget") && more) budgetMB = std::max(0.01, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--frame-ms") && more) frameMs = std::max(0.0, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && more) threads = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--dir") && more) dir = argv[++i];
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: StreamBench [--assets N] [--budget MB] [--frame-ms N] [--threads N] [--dir path] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    // --threads 1 = processing inline on the I/O thread
+    JobSystem jobs(threads == UINT32_MAX ? UINT32_MAX : (threads ? threads - 1 : 0));
+
+    // Pack: 16-256 KB assets, each its own block stream
+    std::vector<Asset> assets(assetCount);
+    std::vector<uint8_t> pack, raw;
+    uint64_t rawTotal = 0;
+    for (uint32_t i = 0; i < assetCount; i++) {
+        Asset& a = assets[i];
+        a.x = (Unit(Hash(i)) * 2.0f - 1.0f) * kExtent;
+        a.z = (Unit(Hash(i + assetCount)) * 2.0f - 1.0f) * kExtent;
+        a.raw = (16u + Hash(i * 3u) % 241u) * 1024u;   // up to kMaxAssetBytes
+        raw.resize(a.raw);
+        for (uint32_t w = 0; w < a.raw / 4; w++) {
+            const uint32_t v = Word(i, w);
+            std::memcpy(raw.data() + size_t(w) * 4, &v, 4);
+        }
+        a.offset = pack.size();
+        CompressBlocks(raw.data(), raw.size(), pack, &jobs, 64 * 1024);
+        a.packed = uint32_t(pack.size() - a.offset);
+        rawTotal += a.raw;
+    }
+    const std::string packPath = dir + "/stream_bench.pack";
+    if (!WriteFile(packPath, std::string(reinterpret_cast<const char*>(pack.data()), pack.size()), "StreamBench")) return 1;
+    const uint64_t packTotal = pack.size();
+    pack = {};
+
+    // Fly-over
+    const uint64_t budget = uint64_t(budgetMB * 1048576.0);
+    uint32_t frames = 0, uploads = 0, dropped = 0;
+    uint64_t uploadedBytes = 0, maxFrameBytes = 0;
+    StreamStats stats;
+    const Clock::time_point t0 = Clock::now();
+    {
+        AssetStreamer streamer(&jobs);
+        const uint32_t file = streamer.OpenFile(packPath);
+        if (!file) {
+            std::fprintf(stderr, "StreamBench: cannot open %s\n", packPath.c_str());
+            return 1;
+        }
+        float cameraX = -kExtent;
+        auto priority = [&](const Asset& a) {
+            return StreamPriority(std::hypot(a.x - cameraX, a.z), a.x >= cameraX);
+        };
+        for (uint32_t i = 0; i < assetCount; i++) {
+            Asset& a = assets[i];
+            StreamRequestDesc desc;
+            desc.file = file;
+            desc.offset = a.offset;
+            desc.size = a.packed;
+            desc.priority = priority(a);
+            desc.process = Decode;
+            desc.upload = [&a, i](const uint8_t* data, size_t size) {
+                bool same = size == a.raw && !a.uploaded;
+                for (uint32_t w = 0; same && w < a.raw / 4; w++) {
+                    uint32_t v;
+                    std::memcpy(&v, data + size_t(w) * 4, 4);
+                    same = v == Word(i, w);
+                }
+                a.corrupt |= !same;
+                a.uploaded = true;
+            };
+            a.handle = streamer.Request(std::move(desc));
+        }
+
+        while (uploads + dropped < assetCount) {
+            cameraX = std::min(cameraX + kCameraStep, kExtent);
+            for (Asset& a : assets) {
+                if (a.uploaded || a.dropped) continue;
+                if (a.x < cameraX - kDropBehind) {
+                    streamer.Cancel(a.handle);
+                    a.dropped = true;
+                    dropped++;
+                } else {
+                    streamer.SetPriority(a.handle, priority(a));
+                }
+            }
+            const uint64_t bytes = streamer.PumpUploads(budget);
+            uploadedBytes += bytes;
+            maxFrameBytes = std::max(maxFrameBytes, bytes);
+            uploads = 0;
+            for (const Asset& a : assets) uploads += a.uploaded ? 1 : 0;
+            frames++;
+            if (frameMs > 0) std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(frameMs));
+        }
+        streamer.WaitIdle();
+        stats = streamer.GetStats();
+    }
+    const double seconds = Seconds(t0, Clock::now());
+
+    // Every request ends exactly once: uploaded, or cancelled and never uploaded
+    uint32_t corrupt = 0;
+    bool countsOk = stats.requested == assetCount && stats.failed == 0 && stats.resident == uploads &&
+                    stats.cancelled == dropped && stats.resident + stats.cancelled == assetCount;
+    for (const Asset& a : assets) {
+        corrupt += a.corrupt ? 1 : 0;
+        countsOk &= !(a.dropped && a.uploaded);
+    }
+    // A frame goes over the budget only by uploading a single asset larger than it
+    const bool budgetOk = maxFrameBytes <= std::max<uint64_t>(budget, kMaxAssetBytes);
+
+    // WaitIdle with more queued than maxInFlightBytes and no pumping: it must return once the cap
+    // holds back the rest, leave that work pending, and then wake again after each pump and after a
+    // cancel empties the queue, until every request has ended.
+    bool idleOk = false;
+    uint32_t idleWaits = 0;
+    {
+        StreamerDesc desc;
+        desc.maxInFlightBytes = std::max<uint64_t>(1, packTotal / 4);
+        AssetStreamer streamer(nullptr, desc);
+        const uint32_t file = streamer.OpenFile(packPath);
+        std::vector<StreamHandle> handles;
+        uint32_t landed = 0;
+        for (uint32_t i = 0; i < assetCount; i++) {
+            StreamRequestDesc r;
+            r.file = file;
+            r.offset = assets[i].offset;
+            r.size = assets[i].packed;
+            r.upload = [&landed, &assets, i](const uint8_t*, size_t size) { landed += size == assets[i].packed ? 1 : 0; };
+            handles.push_back(streamer.Request(std::move(r)));
+        }
+        // A waiter that never returns is reported, then unstuck by pumping from here
+        auto wait = [&] {
+            std::future<void> waiter = std::async(std::launch::async, [&] { streamer.WaitIdle(); });
+            const bool woke = waiter.wait_for(std::chrono::seconds(2)) == std::future_status::ready;
+            while (waiter.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready) streamer.PumpUploads(UINT64_MAX);
+            idleWaits++;
+            return woke;
+        };
+        auto count = [&](StreamState state) {
+            uint32_t n = 0;
+            for (StreamHandle h : handles) n += streamer.GetState(h) == state ? 1 : 0;
+            return n;
+        };
+
+        idleOk = wait();
+        // Idle under the cap: nothing in flight, some work ready, the rest held back
+        idleOk &= count(StreamState::Reading) == 0 && count(StreamState::Ready) > 0 && count(StreamState::Pending) > 0;
+        streamer.PumpUploads(UINT64_MAX);
+        idleOk &= wait();
+
+        // The cap now holds back a later batch; cancelling it is the last change before idle
+        for (StreamHandle h : handles)
+            if (streamer.GetState(h) == StreamState::Pending) streamer.Cancel(h);
+        idleOk &= wait();
+        streamer.PumpUploads(UINT64_MAX);
+        idleOk &= wait();
+
+        const StreamStats s = streamer.GetStats();
+        idleOk &= count(StreamState::Ready) == 0 && count(StreamState::Pending) == 0 && landed == s.resident &&
+                  s.resident + s.cancelled == assetCount && s.failed == 0;
+    }
+    std::remove(packPath.c_str());
+
+    const bool ok = corrupt == 0 && countsOk && budgetOk && idleOk;
+    const double readsPerRequest = double(stats.readCalls) / double(std::max<uint64_t>(1, stats.resident + stats.cancelled));
+    std::printf("StreamBench: %u assets, %.1f MB packed (%.1f MB raw), %u threads, %.1f MB/frame budget, %.1f ms frames\n",
+                assetCount, double(packTotal) / 1048576.0, double(rawTotal) / 1048576.0, jobs.GetThreadCount(), budgetMB, frameMs);
+    std::printf("  %u frames in %.2f s: %u resident, %llu cancelled (%u dropped), %.1f MB uploaded, max %.2f MB in one frame\n",
+                frames, seconds, uploads, (unsigned long long)stats.cancelled, dropped, double(uploadedBytes) / 1048576.0,
+                double(maxFrameBytes) / 1048576.0);
+    std::printf("  latency request -> resident: avg %.2f ms, p95 %.2f ms, max %.2f ms\n", stats.latencyAvgMs, stats.latencyP95Ms, stats.latencyMaxMs);
+    std::printf("  I/O: %.1f MB in %llu reads (%.2f per request), %.0f MB/s while reading\n", double(stats.bytesRead) / 1048576.0,
+                (unsigned long long)stats.readCalls, readsPerRequest, stats.MBps());
+    std::printf("  payloads %s, counts %s, budget %s, idle under the cap %s (%u waits)\n", corrupt ? "CORRUPT" : "ok", countsOk ? "ok" : "MISMATCH",
+                budgetOk ? "ok" : "EXCEEDED", idleOk ? "ok" : "HUNG", idleWaits);
+
+    char buf[1024];
+    std::snprintf(buf, sizeof(buf),
+                  "{\n  \"benchmark\": \"stream_bench\",\n  \"assets\": %u,\n  \"packMB\": %.2f,\n  \"rawMB\": %.2f,\n  \"threads\": %u,\n"
+                  "  \"budgetMB\": %.2f,\n  \"frameMs\": %.2f,\n  \"verified\": %s,\n  \"frames\": %u,\n  \"seconds\": %.3f,\n"
+                  "  \"resident\": %u,\n  \"cancelled\": %llu,\n  \"latencyMs\": { \"avg\": %.3f, \"p95\": %.3f, \"max\": %.3f },\n"
+                  "  \"readMB\": %.2f,\n  \"readCalls\": %llu,\n  \"readMBps\": %.1f\n}\n",
+                  assetCount, double(packTotal) / 1048576.0, double(rawTotal) / 1048576.0, jobs.GetThreadCount(), budgetMB, frameMs,
+                  ok ? "true" : "false", frames, seconds, uploads, (unsigned long long)stats.cancelled, stats.latencyAvgMs,
+                  stats.latencyP95Ms, stats.latencyMaxMs, double(stats.bytesRead) / 1048576.0, (unsigned long long)stats.readCalls,
+                  stats.MBps());
+
+    if (!WriteFile(outPath, buf, "StreamBench")) return 1;
+    return ok ? 0 : 1;
+}
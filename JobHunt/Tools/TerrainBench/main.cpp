@@ -0,0 +1,264 @@
+// TerrainBench: CDLOD selection and tile streaming cost on a large heightmap. Builds a .getr from an
+// analytic source through BuildTerrainFile, opens it as the renderer does (centred, 16-quad
+// patches, 64-tile budget) and flies a camera across it, once reading tiles synchronously and once
+// through the AssetStreamer. Per frame: Select against the view frustum, StreamTiles, WriteVertices.
+// Checked: selected nodes never overlap; every few frames an unculled selection covers the map
+// exactly once with neighbouring levels at most one apart; the tile budget holds; and once the
+// camera stops and streaming settles, every vertex of the full-resolution nodes that morphing does
+// not move sits on the source height. Results go to JSON.
+//   TerrainBench [--size N] [--frames N] [--tiles N] [--loads N] [--dir path] [--out results.json]
+#include "Assets/AssetStreamer.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include "Culling.h"
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr uint32_t kGridDim = 16;
+constexpr uint32_t kCoverageEvery = 20;      // frames between full-map coverage checks
+constexpr uint32_t kSettleFrames = 200;      // camera held at the end until no tile is missing
+constexpr float    kFovY = 1.0f;
+constexpr float    kAspect = 16.0f / 9.0f;
+constexpr float    kFar = 4000.0f;
+constexpr float    kAltitude = 30.0f;        // above the ground under the camera
+constexpr uint64_t kUploadBudget = 8ull << 20;
+
+// Hills, ridges and per-sample noise, all recomputable for the check
+uint16_t Source(uint32_t x, uint32_t z)
+{
+    const float fx = float(x), fz = float(z);
+    const float h = 32768.0f + 14000.0f * std::sin(fx * 0.0021f) * std::cos(fz * 0.0017f) +
+                    6000.0f * std::sin((fx + fz) * 0.011f) + float(Hash(x * 73856093u ^ z * 19349663u) & 1023u);
+    return uint16_t(std::clamp(h, 0.0f, 65535.0f));
+}
+
+struct Run {
+    const char* name;
+    double   selectAvgUs = 0, selectMaxUs = 0, streamAvgUs = 0, verticesAvgMs = 0;
+    double   nodesAvg = 0, verticesAvg = 0;
+    uint64_t loads = 0;
+    uint32_t settleFrames = 0;
+    TerrainMemoryStats memory{};
+    uint64_t checkedVertices = 0;
+    bool     ok = true;
+};
+
+// Leaf-cell coverage of the current selection: no overlap (always); with `full`, every cell once
+// and levels of edge neighbours at most one apart
+bool CheckCoverage(const Terrain& terrain, std::vector<uint32_t>& cells, std::vector<uint8_t>& levels, uint32_t stamp, bool full)
+{
+    const TerrainFileHeader& h = terrain.GetHeader();
+    const uint32_t leaves = h.size / h.leafSize;
+    for (const TerrainNode& n : terrain.GetNodes()) {
+        const uint32_t span = n.quads * ((h.leafSize << n.level) / kGridDim) / h.leafSize;
+        const uint32_t cx = n.x / h.leafSize, cz = n.z / h.leafSize;
+        if (n.x % h.leafSize || n.z % h.leafSize || cx + span > leaves || cz + span > leaves) return false;
+        for (uint32_t z = cz; z < cz + span; z++)
+            for (uint32_t x = cx; x < cx + span; x++) {
+                uint32_t& c = cells[size_t(z) * leaves + x];
+                if (c == stamp) return false;
+                c = stamp;
+                levels[size_t(z) * leaves + x] = uint8_t(n.level);
+            }
+    }
+    if (!full) return true;
+    for (uint32_t z = 0; z < leaves; z++)
+        for (uint32_t x = 0; x < leaves; x++) {
+            const size_t i = size_t(z) * leaves + x;
+            if (cells[i] != stamp) return false;
+            if (x + 1 < leaves && std::abs(int(levels[i]) - int(levels[i + 1])) > 1) return false;
+            if (z + 1 < leaves && std::abs(int(levels[i]) - int(levels[i + leaves])) > 1) return false;
+        }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t size = 16384, frames = 200, tileBudget = 64, maxLoads = 8;
+    std::string dir = ".", outPath = "terrain_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--size") && more) size = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--frames") && more) frames = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--tiles") && more) tileBudget = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--loads") && more) maxLoads = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--dir") && more) dir = argv[++i];
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: TerrainBench [--size N] [--frames N] [--tiles N] [--loads N] [--dir path] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    TerrainBuildDesc desc;
+    desc.size = size;
+    desc.heightScale = 300.0f;
+    const std::string path = dir + "/terrain_bench.getr";
+    const Clock::time_point b0 = Clock::now();
+    const bool built = BuildTerrainFile(path, desc, [](uint32_t x0, uint32_t z0, uint32_t w, uint32_t h, uint16_t* out) {
+        for (uint32_t j = 0; j < h; j++)
+            for (uint32_t i = 0; i < w; i++) out[size_t(j) * w + i] = Source(x0 + i, z0 + j);
+    });
+    if (!built) {
+        std::fprintf(stderr, "TerrainBench: cannot build %s (size must be a power of two >= %u)\n", path.c_str(), desc.tileSize);
+        return 1;
+    }
+    const double buildSeconds = Seconds(b0, Clock::now());
+    const double fileMB = double(std::ifstream(path, std::ios::binary | std::ios::ate).tellg()) / 1048576.0;
+
+    JobSystem jobs;
+    std::vector<Run> runs;
+    for (const bool streamed : { false, true }) {
+        Run run{ streamed ? "streamed" : "sync" };
+        AssetStreamer streamer(&jobs);
+        Terrain terrain;
+        if (streamed) terrain.SetStreamer(&streamer);
+        if (!terrain.Open(path)) {
+            std::fprintf(stderr, "TerrainBench: cannot open %s\n", path.c_str());
+            return 1;
+        }
+        // As Renderer::LoadTerrain
+        const TerrainFileHeader& h = terrain.GetHeader();
+        const float half = float(h.size) * h.sampleSpacing * 0.5f;
+        terrain.SetOrigin({ -half, 0.0f, -half });
+        terrain.SetLod(kGridDim, float(h.leafSize) * h.sampleSpacing * 4.0f);
+        terrain.SetTileBudget(tileBudget);
+
+        const uint32_t leaves = h.size / h.leafSize;
+        std::vector<uint32_t> cells(size_t(leaves) * leaves, 0);
+        std::vector<uint8_t> levels(cells.size());
+        uint32_t stamp = 0;
+        std::vector<VertexPNC> vertices;
+
+        // Half the map along x with a slow sway in z, level with the ground
+        float3 eye{}, forward{};
+        auto place = [&](uint32_t frame) {
+            const float t = float(std::min(frame, frames - 1)) / float(std::max(frames - 1, 1u));
+            const float x = (-0.25f + 0.5f * t) * half * 2.0f, z = 0.15f * half * std::sin(t * 6.2831853f);
+            const float dz = 0.15f * half * 6.2831853f * std::cos(t * 6.2831853f) / (half * 2.0f * 0.5f);
+            eye = { x, terrain.GetHeightAt(x, z) + kAltitude, z };
+            forward = normalize_safe(float3{ 1.0f, -0.15f, dz });
+        };
+
+        double selectSeconds = 0, streamSeconds = 0, vertexSeconds = 0;
+        uint64_t nodes = 0, verts = 0;
+        uint32_t frame = 0;
+        for (; frame < frames + kSettleFrames; frame++) {
+            place(frame);
+            if (frame < frames && frame % kCoverageEvery == 0) {
+                terrain.Select(eye, nullptr);
+                run.ok &= CheckCoverage(terrain, cells, levels, ++stamp, true);
+            }
+
+            const CullView view = MakeCullView(camera_to_world(eye, forward, { 0, 1, 0 }), kFovY, kAspect, 0.1f, kFar);
+            const Clock::time_point t0 = Clock::now();
+            terrain.Select(eye, &view);
+            const Clock::time_point t1 = Clock::now();
+            const uint32_t loads = terrain.StreamTiles(eye, maxLoads);
+            if (streamed) streamer.PumpUploads(kUploadBudget);
+            const Clock::time_point t2 = Clock::now();
+            vertices.resize(terrain.GetVertexCount());
+            terrain.WriteVertices(vertices.data(), eye);
+            const Clock::time_point t3 = Clock::now();
+
+            run.ok &= CheckCoverage(terrain, cells, levels, ++stamp, false);
+            run.ok &= terrain.GetMemoryStats().residentTiles <= tileBudget;
+            run.loads += loads;
+            if (frame < frames) {
+                selectSeconds += Seconds(t0, t1);
+                streamSeconds += Seconds(t1, t2);
+                vertexSeconds += Seconds(t2, t3);
+                run.selectMaxUs = std::max(run.selectMaxUs, Seconds(t0, t1) * 1e6);
+                nodes += terrain.GetNodes().size();
+                verts += terrain.GetVertexCount();
+            } else if (loads == 0) {
+                // Nothing new requested: settled once the reads in flight have landed
+                if (!streamed) break;
+                streamer.WaitIdle();
+                if (streamer.PumpUploads(UINT64_MAX) == 0) break;
+            }
+        }
+        run.settleFrames = frame - frames;
+        run.ok &= frame < frames + kSettleFrames;
+
+        // Settled: even-even vertices of nodes finer than the base map are exact source samples
+        const float hs = h.heightScale / 65535.0f, hb = h.heightOffset;
+        const uint32_t baseStep = h.size / h.baseSize;
+        for (const TerrainNode& n : terrain.GetNodes()) {
+            const uint32_t step = (h.leafSize << n.level) / kGridDim;
+            if (step >= baseStep) continue;
+            const VertexPNC* v = vertices.data() + n.firstVertex;
+            for (uint32_t j = 0; j <= n.quads; j += 2)
+                for (uint32_t i = 0; i <= n.quads; i += 2) {
+                    const uint32_t x = std::min(n.x + i * step, h.size), z = std::min(n.z + j * step, h.size);
+                    const VertexPNC& p = v[j * (n.quads + 1) + i];
+                    const float expected = hb + float(Source(x, z)) * hs;
+                    run.ok &= std::fabs(p.pos.y - expected) <= 1e-3f * std::max(1.0f, std::fabs(expected)) &&
+                              std::fabs(p.pos.x - (float(x) * h.sampleSpacing - half)) < 1e-2f &&
+                              std::fabs(p.pos.z - (float(z) * h.sampleSpacing - half)) < 1e-2f;
+                    run.checkedVertices++;
+                }
+        }
+        run.ok &= run.checkedVertices > 0;
+
+        run.selectAvgUs = selectSeconds / double(frames) * 1e6;
+        run.streamAvgUs = streamSeconds / double(frames) * 1e6;
+        run.verticesAvgMs = vertexSeconds / double(frames) * 1e3;
+        run.nodesAvg = double(nodes) / double(frames);
+        run.verticesAvg = double(verts) / double(frames);
+        run.memory = terrain.GetMemoryStats();
+        runs.push_back(run);
+    }
+    std::remove(path.c_str());
+
+    bool allOk = true;
+    for (const Run& r : runs) allOk &= r.ok;
+    std::printf("TerrainBench: %u x %u map, %.1f MB file (built in %.1f s), %u frames, %u-tile budget, %u loads/frame\n",
+                size, size, fileMB, buildSeconds, frames, tileBudget, maxLoads);
+    std::printf("  %-9s %10s %10s %10s %10s %7s %8s %6s %7s  %s\n", "tiles", "select", "select max", "stream", "vertices",
+                "nodes", "verts", "loads", "settle", "check");
+    std::string json;
+    char buf[640];
+    std::snprintf(buf, sizeof(buf),
+                  "{\n  \"benchmark\": \"terrain_bench\",\n  \"size\": %u,\n  \"fileMB\": %.2f,\n  \"frames\": %u,\n"
+                  "  \"tileBudget\": %u,\n  \"verified\": %s,\n  \"results\": [",
+                  size, fileMB, frames, tileBudget, allOk ? "true" : "false");
+    json += buf;
+    for (size_t i = 0; i < runs.size(); i++) {
+        const Run& r = runs[i];
+        const TerrainMemoryStats& m = r.memory;
+        const double residentMB = double(m.pyramidBytes + m.baseBytes + m.tileBytes) / 1048576.0;
+        std::printf("  %-9s %8.1fus %8.1fus %8.1fus %8.2fms %7.0f %8.0f %6llu %7u  %s\n", r.name, r.selectAvgUs, r.selectMaxUs,
+                    r.streamAvgUs, r.verticesAvgMs, r.nodesAvg, r.verticesAvg, (unsigned long long)r.loads, r.settleFrames,
+                    r.ok ? "ok" : "MISMATCH");
+        std::printf("  %-9s resident %.2f MB: pyramid %.2f MB + base %.2f MB + %u/%u tiles %.2f MB, %llu vertices checked\n", "",
+                    residentMB, double(m.pyramidBytes) / 1048576.0, double(m.baseBytes) / 1048576.0, m.residentTiles, m.totalTiles,
+                    double(m.tileBytes) / 1048576.0, (unsigned long long)r.checkedVertices);
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    { \"name\": \"%s\", \"selectAvgUs\": %.2f, \"selectMaxUs\": %.2f, \"streamAvgUs\": %.2f,"
+                      " \"verticesAvgMs\": %.3f, \"nodesAvg\": %.1f, \"verticesAvg\": %.0f, \"loads\": %llu, \"settleFrames\": %u,"
+                      " \"residentMB\": %.3f, \"pyramidMB\": %.3f, \"baseMB\": %.3f, \"tileMB\": %.3f, \"residentTiles\": %u, \"ok\": %s }",
+                      i ? "," : "", r.name, r.selectAvgUs, r.selectMaxUs, r.streamAvgUs, r.verticesAvgMs, r.nodesAvg, r.verticesAvg,
+                      (unsigned long long)r.loads, r.settleFrames, residentMB, double(m.pyramidBytes) / 1048576.0,
+                      double(m.baseBytes) / 1048576.0, double(m.tileBytes) / 1048576.0, m.residentTiles, r.ok ? "true" : "false");
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+
+    if (!WriteFile(outPath, json, "TerrainBench")) return 1;
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// TerrainBuild: heightmap -> .getr (see Terrain.h). The source is either a raw 16-bit little-endian
+// heightmap of (size+1)^2 samples, row-major, or a procedural ridged fBm map (the default, which
+// the Game build generates as Assets/terrain.getr). Either way the map is fed to BuildTerrainFile
+// one tile at a time, so a 16k x 16k map never has to be resident.
+//   TerrainBuild <output.getr> [--size N] [--tile N] [--leaf N] [--base N] [--spacing m] [--height m]
+//                [--seed N] [--raw heights.r16] [--threads N]
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr uint32_t kOctaves = 8;
+constexpr float    kFeature = 1024.0f;    // samples per cell of the coarsest octave
+
+// Smoothed value noise on an integer lattice, in [0, 1]
+float ValueNoise(float x, float z, uint32_t seed)
+{
+    const float fx = std::floor(x), fz = std::floor(z);
+    const uint32_t ix = uint32_t(int32_t(fx)), iz = uint32_t(int32_t(fz));
+    auto corner = [&](uint32_t cx, uint32_t cz) { return Unit(Hash(cx * 0x8DA6B343u ^ cz * 0xD8163841u ^ seed)); };
+    float tx = x - fx, tz = z - fz;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    tz = tz * tz * (3.0f - 2.0f * tz);
+    const float a = corner(ix, iz), b = corner(ix + 1, iz), c = corner(ix, iz + 1), d = corner(ix + 1, iz + 1);
+    return (a + (b - a) * tx) + ((c + (d - c) * tx) - (a + (b - a) * tx)) * tz;
+}
+
+// Rolling hills with sharper ridges in the finer octaves, in [0, 1]
+float Height(uint32_t x, uint32_t z, uint32_t seed)
+{
+    float sum = 0.0f, amplitude = 1.0f, norm = 0.0f, frequency = 1.0f / kFeature;
+    for (uint32_t o = 0; o < kOctaves; o++) {
+        float n = ValueNoise(float(x) * frequency, float(z) * frequency, seed + o * 0x9E3779B9u);
+        if (o >= 2) n = 1.0f - std::fabs(n * 2.0f - 1.0f);
+        sum += n * amplitude;
+        norm += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+    return sum / norm;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argv[1][0] == '-') {
+        std::fprintf(stderr, "usage: TerrainBuild <output.getr> [--size N] [--tile N] [--leaf N] [--base N] [--spacing m] [--height m]\n"
+                             "                    [--seed N] [--raw heights.r16] [--threads N]\n");
+        return 1;
+    }
+    const std::string outPath = argv[1];
+    TerrainBuildDesc desc;
+    desc.size = 4096;
+    desc.heightScale = 300.0f;
+    uint32_t seed = 1, threads = UINT32_MAX;
+    std::string rawPath;
+    for (int i = 2; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--size") && more) desc.size = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--tile") && more) desc.tileSize = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--leaf") && more) desc.leafSize = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--base") && more) desc.baseSize = uint32_t(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--spacing") && more) desc.sampleSpacing = float(std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--height") && more) desc.heightScale = float(std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--seed") && more) seed = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--raw") && more) rawPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--threads") && more) threads = uint32_t(std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr, "TerrainBuild: unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    // Sea level a fifth of the way up, so the origin sits close to the ground
+    desc.heightOffset = -0.2f * desc.heightScale;
+
+    const uint64_t side = uint64_t(desc.size) + 1;
+    std::ifstream raw;
+    if (!rawPath.empty()) {
+        raw.open(rawPath, std::ios::binary | std::ios::ate);
+        if (!raw || uint64_t(raw.tellg()) != side * side * sizeof(uint16_t)) {
+            std::fprintf(stderr, "TerrainBuild: %s is not %llu x %llu 16-bit samples\n", rawPath.c_str(),
+                         (unsigned long long)side, (unsigned long long)side);
+            return 1;
+        }
+    }
+
+    // --threads 1 = procedural rows on the main thread
+    JobSystem jobs(threads == UINT32_MAX ? UINT32_MAX : (threads ? threads - 1 : 0));
+    const TerrainSampleFn source = [&](uint32_t x0, uint32_t z0, uint32_t w, uint32_t h, uint16_t* out) {
+        const uint32_t last = desc.size;
+        if (raw.is_open()) {
+            for (uint32_t j = 0; j < h; j++) {
+                const uint32_t z = std::min(z0 + j, last), x1 = std::min(x0 + w - 1, last), count = x1 - x0 + 1;
+                raw.seekg(std::streamoff((uint64_t(z) * side + x0) * sizeof(uint16_t)));
+                raw.read(reinterpret_cast<char*>(out + size_t(j) * w), std::streamsize(count * sizeof(uint16_t)));
+                for (uint32_t i = count; i < w; i++) out[size_t(j) * w + i] = out[size_t(j) * w + count - 1];
+            }
+            return;
+        }
+        jobs.ParallelFor(h, 8, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t j = begin; j < end; j++)
+                for (uint32_t i = 0; i < w; i++)
+                    out[size_t(j) * w + i] = uint16_t(std::lround(Height(std::min(x0 + i, last), std::min(z0 + j, last), seed) * 65535.0f));
+        });
+    };
+
+    const Clock::time_point t0 = Clock::now();
+    if (!BuildTerrainFile(outPath, desc, source) || (raw.is_open() && !raw)) {
+        std::fprintf(stderr, "TerrainBuild: cannot build %s (size, tile, leaf and base must be powers of two that divide the map)\n",
+                     outPath.c_str());
+        return 1;
+    }
+    const double seconds = Seconds(t0, Clock::now());
+    const double mb = double(std::ifstream(outPath, std::ios::binary | std::ios::ate).tellg()) / 1048576.0;
+    std::printf("TerrainBuild: %s, %u x %u quads (%s), %.1f MB in %.2f s\n", outPath.c_str(), desc.size, desc.size,
+                rawPath.empty() ? "procedural" : rawPath.c_str(), mb, seconds);
+    return 0;
+}
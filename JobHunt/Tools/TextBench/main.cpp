@@ -0,0 +1,287 @@
+// TextBench: CPU cost of overlay text per 10k glyphs, and a check of what it produces. A HUD-like
+// frame of 250 strings x ~30 glyphs (labels, numeric readouts, tabs, newlines, degree / plus-minus
+// / micro) goes through TextBatch with every string cached, with 20% of them changing every frame
+// (readouts), with all of them new every frame, and through ShapeText alone. Checked: UTF-8
+// decoding (round trip of every encoded length, malformed and overlong input), the baked atlas
+// (each glyph's texels inside its rect), a golden layout, the glyph rects and line / tab positions
+// of every string, TextBatch's instances against ShapeText output, its cache stats, eviction and
+// the cache cap. Results go to JSON.
+//   TextBench [--strings N] [--frames N] [--out results.json]
+#include "Common/Bench.h"
+#include "Text.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr uint32_t kCellW = 8, kCellH = 8;   // as Text.cpp bakes them
+constexpr float    kScale = 2.0f;
+
+void AppendUtf8(std::string& s, uint32_t cp)
+{
+    if (cp < 0x80) s += char(cp);
+    else if (cp < 0x800) { s += char(0xC0 | (cp >> 6)); s += char(0x80 | (cp & 0x3F)); }
+    else if (cp < 0x10000) { s += char(0xE0 | (cp >> 12)); s += char(0x80 | ((cp >> 6) & 0x3F)); s += char(0x80 | (cp & 0x3F)); }
+    else { s += char(0xF0 | (cp >> 18)); s += char(0x80 | ((cp >> 12) & 0x3F)); s += char(0x80 | ((cp >> 6) & 0x3F)); s += char(0x80 | (cp & 0x3F)); }
+}
+
+std::vector<uint32_t> DecodeAll(std::string_view s)
+{
+    std::vector<uint32_t> cps;
+    for (size_t pos = 0; pos < s.size();) cps.push_back(DecodeUtf8(s, pos));
+    return cps;
+}
+
+// String i of a frame: a label and a readout; `frame` only changes the readouts when `live`
+std::string HudString(uint32_t i, uint32_t frame, bool live)
+{
+    static const char* kLabels[] = { "POS", "VEL", "YAW", "LIGHT", "DRAW CALLS", "TRIS", "FRAME" };
+    const uint32_t h = Hash(i * 7919u + (live ? frame : 0));
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%s %u\t%+8.3f %+8.3f %+8.3f", kLabels[i % 7], i, (Unit(h) - 0.5f) * 2000.0f,
+                  (Unit(h >> 8) - 0.5f) * 200.0f, Unit(h >> 16) * 360.0f);
+    std::string s = buf;
+    if (i % 5 == 0) { s += " "; AppendUtf8(s, 0x00B0); }                       // degree
+    if (i % 9 == 0) { s += "\n"; AppendUtf8(s, 0x00B1); s += "0.5 "; AppendUtf8(s, 0x00B5); s += "s"; }
+    return s;
+}
+
+// ShapeText's contract, one string at a time: one glyph per printable code point with the atlas
+// rect of that code point, pens advancing left to right on lines kLineHeight apart, tabs on
+// four-cell stops, width / height of the block
+bool CheckShape(const GlyphAtlas& atlas, std::string_view s, const ShapedText& shaped)
+{
+    const std::vector<uint32_t> cps = DecodeAll(s);
+    const float line = float(atlas.LineHeight());
+    size_t g = 0;
+    float penX = 0.0f, penY = 0.0f, width = 0.0f;
+    for (const uint32_t cp : cps) {
+        if (cp == '\n') { width = std::max(width, penX); penX = 0.0f; penY += line; continue; }
+        const Glyph& ref = atlas.Find(cp == '\t' ? ' ' : cp);
+        if (cp == '\t') { const float tab = ref.advance * 4.0f; penX = std::floor(penX / tab) * tab + tab; continue; }
+        if (cp > ' ') {
+            if (g >= shaped.glyphs.size()) return false;
+            const ShapedGlyph& sg = shaped.glyphs[g++];
+            if (sg.x != penX + ref.xoff || sg.y != penY + ref.yoff || sg.u != ref.u || sg.v != ref.v || sg.w != ref.w || sg.h != ref.h)
+                return false;
+        }
+        penX += ref.advance;
+    }
+    return g == shaped.glyphs.size() && shaped.width == std::max(width, penX) && shaped.height == (s.empty() ? 0.0f : penY + line);
+}
+
+// Every glyph's set texels lie inside its rect, inside its cell; printable ones have some
+bool CheckAtlas(const GlyphAtlas& atlas)
+{
+    const std::vector<uint8_t>& px = atlas.Pixels();
+    std::vector<uint8_t> owned(px.size(), 0);
+    auto claim = [&](const Glyph& g, bool visible) {
+        if (g.u % kCellW || g.v % kCellH || g.w > kCellW || g.h > kCellH || g.u + g.w > atlas.Width() || g.v + g.h > atlas.Height())
+            return false;
+        uint32_t set = 0;
+        for (uint32_t y = 0; y < g.h; y++)
+            for (uint32_t x = 0; x < g.w; x++) {
+                const size_t i = size_t(g.v + y) * atlas.Width() + g.u + x;
+                owned[i] = 1;
+                set += px[i] ? 1 : 0;
+            }
+        return visible == (set > 0);
+    };
+    bool ok = true;
+    for (uint32_t cp = 0x20; cp < 0x7F; cp++) ok &= claim(atlas.Find(cp), cp != ' ');
+    for (const uint32_t cp : { 0x00B0u, 0x00B1u, 0x00B5u, 0xFFFDu }) ok &= claim(atlas.Find(cp), true);
+    for (size_t i = 0; i < px.size(); i++) ok &= !px[i] || owned[i];   // nothing outside a glyph rect
+    return ok;
+}
+
+bool CheckUtf8()
+{
+    bool ok = true;
+    // Round trip: code points of every encoded length, skipping surrogates
+    std::vector<uint32_t> cps;
+    for (uint32_t i = 0; i < 20000; i++) {
+        const uint32_t h = Hash(i), len = h % 4;
+        const uint32_t lo[4] = { 0x01, 0x80, 0x800, 0x10000 }, hi[4] = { 0x7F, 0x7FF, 0xFFFF, 0x10FFFF };
+        uint32_t cp = lo[len] + (h >> 2) % (hi[len] - lo[len] + 1);
+        if (cp >= 0xD800 && cp <= 0xDFFF) cp = 0xE000;
+        cps.push_back(cp);
+    }
+    std::string s;
+    for (const uint32_t cp : cps) AppendUtf8(s, cp);
+    ok &= DecodeAll(s) == cps;
+
+    // Malformed input: one U+FFFD per byte that cannot start a valid sequence, then resync
+    struct Case { const char* bytes; std::vector<uint32_t> expect; };
+    const Case cases[] = {
+        { "\xC0\xAF", { 0xFFFD, 0xFFFD } },                         // overlong '/'
+        { "\xE0\x80\xAF", { 0xFFFD, 0xFFFD, 0xFFFD } },             // overlong, 3 bytes
+        { "\xED\xA0\x80", { 0xFFFD, 0xFFFD, 0xFFFD } },             // surrogate
+        { "\xF4\x90\x80\x80", { 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD } }, // past U+10FFFF
+        { "A\xE2\x82", { 'A', 0xFFFD, 0xFFFD } },                    // truncated
+        { "\x80" "B", { 0xFFFD, 'B' } },                             // stray continuation
+        { "\xC3" "A", { 0xFFFD, 'A' } },                             // lead without continuation
+        { "\xF8\x88\x80\x80\x80", { 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD } },
+        { "\xC2\xB5", { 0x00B5 } },
+    };
+    for (const Case& c : cases) ok &= DecodeAll(c.bytes) == c.expect;
+    return ok;
+}
+
+bool CheckGolden(const GlyphAtlas& atlas)
+{
+    // "Ab\tc\nd": tab from pen 12 to the 24 stop, second line 9 down; block 30 x 18
+    ShapedText shaped;
+    ShapeText(atlas, "Ab\tc\nd", shaped);
+    const float xs[] = { 0, 6, 24, 0 }, ys[] = { 0, 0, 0, 9 };
+    const char chars[] = { 'A', 'b', 'c', 'd' };
+    bool ok = shaped.glyphs.size() == 4 && shaped.width == 30.0f && shaped.height == 18.0f;
+    for (size_t i = 0; ok && i < 4; i++)
+        ok = shaped.glyphs[i].x == xs[i] && shaped.glyphs[i].y == ys[i] && shaped.glyphs[i].u == atlas.Find(chars[i]).u;
+    return ok;
+}
+
+// One frame into `batch`; when `check`, its instances must be each string's ShapeText glyphs,
+// scaled and offset, in draw order
+bool DrawFrame(TextBatch& batch, const GlyphAtlas& atlas, const std::vector<std::string>& strings, bool check)
+{
+    batch.Begin();
+    float y = 0.0f;
+    for (size_t i = 0; i < strings.size(); i++) {
+        const float x = float(i % 4) * 320.0f;
+        const TextExtent e = batch.Draw(strings[i], x, y, kScale, 0xFF000000u | uint32_t(i));
+        if (i % 4 == 3) y += e.height;
+    }
+    if (!check) return true;
+
+    const std::span<const GlyphInstance> out = batch.Instances();
+    ShapedText shaped;
+    size_t k = 0;
+    y = 0.0f;
+    for (size_t i = 0; i < strings.size(); i++) {
+        const float x = float(i % 4) * 320.0f;
+        ShapeText(atlas, strings[i], shaped);
+        for (const ShapedGlyph& g : shaped.glyphs) {
+            if (k >= out.size()) return false;
+            const GlyphInstance& gi = out[k++];
+            if (gi.x != x + g.x * kScale || gi.y != y + g.y * kScale || gi.w != g.w * kScale || gi.h != g.h * kScale ||
+                gi.u != g.u || gi.v != g.v || gi.uw != g.w || gi.vh != g.h || gi.color != (0xFF000000u | uint32_t(i)))
+                return false;
+        }
+        if (i % 4 == 3) y += shaped.height * kScale;
+    }
+    return k == out.size() && batch.GetStats().glyphs == out.size() && batch.GetStats().strings == strings.size();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t stringCount = 250, frames = 200;
+    std::string outPath = "text_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--strings") && more) stringCount = uint32_t(std::max(4, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--frames") && more) frames = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: TextBench [--strings N] [--frames N] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    GlyphAtlas atlas;
+    atlas.BakeBuiltin();
+    bool ok = true;
+    auto check = [&](bool pass, const char* what) {
+        if (!pass) std::fprintf(stderr, "TextBench: MISMATCH %s\n", what);
+        ok &= pass;
+    };
+    check(CheckUtf8(), "UTF-8 decoding");
+    check(CheckAtlas(atlas), "atlas texels outside their glyph rects");
+    check(CheckGolden(atlas), "golden layout of \"Ab\\tc\\nd\"");
+
+    // Workloads: each frame's strings, built up front so the timings are layout only
+    std::vector<std::string> staticFrame(stringCount);
+    for (uint32_t i = 0; i < stringCount; i++) staticFrame[i] = HudString(i, 0, false);
+    auto frameStrings = [&](uint32_t f, uint32_t livePercent) {
+        std::vector<std::string> s(stringCount);
+        for (uint32_t i = 0; i < stringCount; i++) s[i] = HudString(i, f + 1, i % 100 < livePercent);
+        return s;
+    };
+    std::vector<std::vector<std::string>> mixed(frames), fresh(frames);
+    for (uint32_t f = 0; f < frames; f++) { mixed[f] = frameStrings(f, 20); fresh[f] = frameStrings(f, 100); }
+
+    uint64_t glyphsPerFrame = 0;
+    ShapedText shaped;
+    for (const std::vector<std::string>* work : { &staticFrame, &fresh[0] })
+        for (const std::string& s : *work) {
+            ShapeText(atlas, s, shaped);
+            if (work == &staticFrame) glyphsPerFrame += shaped.glyphs.size();
+            if (!CheckShape(atlas, s, shaped)) {
+                std::fprintf(stderr, "TextBench: MISMATCH layout of \"%s\"\n", s.c_str());
+                ok = false;
+            }
+        }
+
+    // TextBatch output, cache hits / misses, eviction after kEvictFrames, the cap
+    {
+        TextBatch batch(atlas);
+        check(DrawFrame(batch, atlas, staticFrame, true), "TextBatch instances (first frame)");
+        check(batch.GetStats().cacheMisses == stringCount && batch.GetStats().cacheHits == 0, "first frame cache misses");
+        check(DrawFrame(batch, atlas, staticFrame, true), "TextBatch instances (cached)");
+        check(batch.GetStats().cacheHits == stringCount && batch.GetStats().cacheMisses == 0, "cached frame cache hits");
+        for (uint32_t f = 0; f < TextBatch::kEvictFrames + 80; f++) DrawFrame(batch, atlas, { "FPS 60" }, false);
+        batch.Begin();
+        check(batch.GetStats().cached == 1, "strings not drawn for kEvictFrames frames are evicted");
+
+        std::vector<std::string> flood(TextBatch::kMaxCached + 100);
+        for (size_t i = 0; i < flood.size(); i++) flood[i] = "T " + std::to_string(i);
+        DrawFrame(batch, atlas, flood, true);
+        DrawFrame(batch, atlas, { "FPS 60", "X" }, true);
+        batch.Begin();
+        check(batch.GetStats().cached == 2, "a cache past kMaxCached keeps only last frame's strings");
+    }
+
+    // Timings: per frame, then scaled to 10k glyphs
+    const double perTenK = 10000.0 / double(glyphsPerFrame);
+    TextBatch cachedBatch(atlas);
+    DrawFrame(cachedBatch, atlas, staticFrame, false);
+    const double cached = BestOf(frames, [&] { DrawFrame(cachedBatch, atlas, staticFrame, false); });
+    const double shapeOnly = BestOf(frames, [&] { for (const std::string& s : staticFrame) ShapeText(atlas, s, shaped); });
+    auto perFrame = [&](const std::vector<std::vector<std::string>>& work) {
+        TextBatch batch(atlas);
+        const Clock::time_point t0 = Clock::now();
+        for (uint32_t f = 0; f < frames; f++) DrawFrame(batch, atlas, work[f], false);
+        return Seconds(t0, Clock::now()) / frames;
+    };
+    const double mixedFrame = perFrame(mixed), freshFrame = perFrame(fresh);
+
+    const double uploadKB = double(glyphsPerFrame * sizeof(GlyphInstance)) / 1024.0;
+    std::printf("TextBench: %u strings, %llu glyphs / frame (%.1f KB of instances), atlas %ux%u\n", stringCount,
+                (unsigned long long)glyphsPerFrame, uploadKB, atlas.Width(), atlas.Height());
+    std::printf("  %-28s %12s %12s\n", "pass", "us / 10k", "ns / glyph");
+    const struct { const char* name; double seconds; } rows[] = {
+        { "TextBatch, all cached", cached }, { "TextBatch, 20% readouts new", mixedFrame },
+        { "TextBatch, all new", freshFrame }, { "ShapeText only", shapeOnly },
+    };
+    for (const auto& r : rows)
+        std::printf("  %-28s %12.1f %12.2f\n", r.name, r.seconds * 1e6 * perTenK, r.seconds * 1e9 / double(glyphsPerFrame));
+    std::printf("  checks: %s\n", ok ? "ok" : "MISMATCH");
+
+    char json[1024];
+    std::snprintf(json, sizeof(json),
+        "{\n  \"strings\": %u,\n  \"glyphsPerFrame\": %llu,\n  \"instanceKB\": %.1f,\n  \"cachedUsPer10k\": %.2f,\n"
+        "  \"mixedUsPer10k\": %.2f,\n  \"freshUsPer10k\": %.2f,\n  \"shapeUsPer10k\": %.2f,\n  \"ok\": %s\n}\n",
+        stringCount, (unsigned long long)glyphsPerFrame, uploadKB, cached * 1e6 * perTenK, mixedFrame * 1e6 * perTenK,
+        freshFrame * 1e6 * perTenK, shapeOnly * 1e6 * perTenK, ok ? "true" : "false");
+    if (!WriteFile(outPath, json, "TextBench")) return 1;
+    return ok ? 0 : 1;
+}
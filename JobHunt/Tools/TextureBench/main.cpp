@@ -0,0 +1,259 @@
+// TextureBench: the TextureStreamer residency policy along a scripted camera path. Objects on a
+// plane each use one of a set of BC7 textures (256-4096 texels, full mip chains in one pack file);
+// the camera circles the plane and a 2D frustum test reports the visible ones with their projected
+// size, as the culling pass would. Every frame: ReportUsage, Update, PumpUploads under an upload
+// budget. The upload / evict callbacks keep a mirror of what the GPU would hold and check it:
+// contiguous mip ranges, payload bytes from the right offset, resident bytes = the mirror's, budget
+// never exceeded, tails never evicted, and with room to spare the desired mips are all reached.
+// Runs once per memory budget. Results go to JSON.
+//   TextureBench [--objects N] [--textures N] [--frames N] [--budget MB] [--upload MB] [--out results.json]
+#include "Assets/AssetStreamer.h"
+#include "Assets/TextureStreamer.h"
+#include "Common/Bench.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace GraphicsEngine;
+using namespace Bench;
+
+namespace {
+
+constexpr float    kPi = 3.14159265358979323846f;
+constexpr float    kExtent = 500.0f;         // objects spread over [-kExtent, kExtent]^2
+constexpr float    kOrbit = 300.0f;          // camera circles the origin at this radius
+constexpr float    kFar = 400.0f;
+constexpr float    kFovY = 60.0f * kPi / 180.0f;
+constexpr float    kAspect = 16.0f / 9.0f;
+constexpr float    kViewportHeight = 1080.0f;
+constexpr uint32_t kSizeClasses = 5;         // 256 << c texels
+constexpr uint32_t kSettleFrames = 600;      // camera held still at the end until requests drain
+
+struct Object {
+    float     x, z, radius;
+    TextureId texture;
+};
+
+struct Run {
+    double   budgetMB = 0;
+    double   peakMB = 0;
+    uint64_t evictions = 0, requests = 0, cancels = 0;
+    double   missingPerFrame = 0, visiblePerFrame = 0;
+    double   updateAvgUs = 0, updateMaxUs = 0;
+    double   latencyP95Ms = 0;
+    uint32_t finalMissing = 0;
+    bool     ok = true;
+};
+
+uint32_t SizeOf(uint32_t sizeClass) { return 256u << sizeClass; }
+uint32_t MipCountOf(uint32_t size)  { uint32_t n = 1; while (size >> n) n++; return n; }
+
+// BC7 bytes of mips [first, end) of a square texture
+uint64_t ChainBytes(uint32_t size, uint32_t first, uint32_t end)
+{
+    uint64_t bytes = 0;
+    for (uint32_t m = first; m < end; m++) {
+        const uint64_t blocks = (std::max(size >> m, 1u) + 3) / 4;
+        bytes += blocks * blocks * 16;
+    }
+    return bytes;
+}
+
+// Word w of the mip chain of a size class, so a read from the wrong offset shows up
+uint32_t Word(uint32_t sizeClass, uint64_t w) { return Hash(uint32_t(w) * 5u + sizeClass * 0x9E3779B9u); }
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t objectCount = 20'000, textureCount = 2000, frames = 1800;
+    double uploadMB = 16.0;
+    std::vector<double> budgets = { 4096.0, 1024.0, 256.0, 64.0 };
+    std::string outPath = "texture_bench.json";
+    for (int i = 1; i < argc; i++) {
+        const bool more = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--objects") && more) objectCount = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--textures") && more) textureCount = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--frames") && more) frames = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--budget") && more) budgets = { std::max(1.0, std::atof(argv[++i])) };
+        else if (!std::strcmp(argv[i], "--upload") && more) uploadMB = std::max(0.01, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--out") && more) outPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: TextureBench [--objects N] [--textures N] [--frames N] [--budget MB] [--upload MB] [--out results.json]\n");
+            return 1;
+        }
+    }
+
+    // Pack: one full mip chain per size class, shared by every texture of that size
+    uint64_t chainOffset[kSizeClasses];
+    std::string pack;
+    for (uint32_t c = 0; c < kSizeClasses; c++) {
+        const uint32_t size = SizeOf(c);
+        const uint64_t bytes = ChainBytes(size, 0, MipCountOf(size));
+        chainOffset[c] = pack.size();
+        pack.resize(pack.size() + size_t(bytes));
+        for (uint64_t w = 0; w < bytes / 4; w++) {
+            const uint32_t v = Word(c, w);
+            std::memcpy(&pack[size_t(chainOffset[c] + w * 4)], &v, 4);
+        }
+    }
+    const std::string packPath = "texture_bench.pack";
+    if (!WriteFile(packPath, pack, "TextureBench")) return 1;
+    const double packMB = double(pack.size()) / 1048576.0;
+    pack = {};
+
+    std::vector<uint32_t> textureClass(textureCount);
+    for (uint32_t t = 0; t < textureCount; t++) textureClass[t] = Hash(t * 7u + 1u) % kSizeClasses;
+    std::vector<Object> objects(objectCount);
+    for (uint32_t o = 0; o < objectCount; o++) {
+        objects[o] = { (Unit(Hash(o * 3u)) * 2.0f - 1.0f) * kExtent, (Unit(Hash(o * 3u + 1u)) * 2.0f - 1.0f) * kExtent,
+                       1.0f + 9.0f * Unit(Hash(o * 3u + 2u)), Hash(o) % textureCount };
+    }
+    const float halfFovX = std::atan(std::tan(kFovY * 0.5f) * kAspect);
+
+    JobSystem jobs;
+    std::vector<Run> runs;
+    for (double budgetMB : budgets) {
+        Run run;
+        run.budgetMB = budgetMB;
+        const uint64_t budget = uint64_t(budgetMB * 1048576.0);
+
+        AssetStreamer assets(&jobs);
+        const uint32_t file = assets.OpenFile(packPath);
+        if (!file) {
+            std::fprintf(stderr, "TextureBench: cannot open %s\n", packPath.c_str());
+            return 1;
+        }
+        TextureStreamerDesc desc;
+        desc.budgetBytes = budget;
+        TextureStreamer streamer(assets, desc);
+        std::vector<uint32_t> gpuMip(textureCount);   // finest mip the GPU side holds
+        for (uint32_t t = 0; t < textureCount; t++) {
+            StreamedTextureDesc td;
+            td.width = td.height = SizeOf(textureClass[t]);
+            td.mipCount = MipCountOf(td.width);
+            td.file = file;
+            td.dataOffset = chainOffset[textureClass[t]];
+            streamer.Register(td);
+            gpuMip[t] = td.mipCount;
+        }
+
+        auto mipCount = [&](TextureId id) { return MipCountOf(SizeOf(textureClass[id])); };
+        streamer.SetCallbacks(
+            [&](TextureId id, uint32_t firstMip, uint32_t count, const uint8_t* data, size_t size) {
+                const uint32_t c = textureClass[id], texels = SizeOf(c);
+                // Extends the resident chain by exactly the range it read
+                bool same = firstMip + count == gpuMip[id] && size == ChainBytes(texels, firstMip, firstMip + count);
+                const uint64_t base = ChainBytes(texels, 0, firstMip) / 4;
+                for (uint64_t w = 0; same && w < size / 4; w += 257) {
+                    uint32_t v;
+                    std::memcpy(&v, data + w * 4, 4);
+                    same = v == Word(c, base + w);
+                }
+                run.ok &= same;
+                gpuMip[id] = firstMip;
+            },
+            [&](TextureId id, uint32_t newResidentMip) {
+                // One finest mip at a time, never into the tail
+                const uint32_t texels = SizeOf(textureClass[id]);
+                uint32_t tail = 0;
+                while (std::max(texels >> tail, 1u) > desc.tailSize) tail++;
+                run.ok &= newResidentMip == gpuMip[id] + 1 && newResidentMip <= std::min(tail, mipCount(id) - 1);
+                gpuMip[id] = newResidentMip;
+            });
+
+        uint64_t missing = 0, visible = 0;
+        double updateSeconds = 0;
+        uint32_t frame = 0;
+        for (; frame < frames + kSettleFrames; frame++) {
+            const float angle = 2.0f * kPi * float(std::min(frame, frames - 1)) / float(frames);
+            const float camX = kOrbit * std::cos(angle), camZ = kOrbit * std::sin(angle);
+            const float dirX = -std::sin(angle), dirZ = std::cos(angle);   // along the orbit
+            for (const Object& o : objects) {
+                const float dx = o.x - camX, dz = o.z - camZ;
+                const float distance = std::sqrt(dx * dx + dz * dz);
+                if (distance - o.radius > kFar) continue;
+                const float forward = dx * dirX + dz * dirZ, side = std::fabs(dx * dirZ - dz * dirX);
+                if (distance > o.radius && (forward <= 0.0f || std::atan2(side, forward) - std::asin(std::min(1.0f, o.radius / distance)) > halfFovX))
+                    continue;
+                streamer.ReportUsage(o.texture, ProjectedScreenSize(o.radius, distance, kFovY, kViewportHeight), distance);
+            }
+
+            const Clock::time_point t0 = Clock::now();
+            streamer.Update();
+            const double us = Seconds(t0, Clock::now()) * 1e6;
+            updateSeconds += us * 1e-6;
+            run.updateMaxUs = std::max(run.updateMaxUs, us);
+
+            assets.PumpUploads(uint64_t(uploadMB * 1048576.0));
+
+            // Resident set: the streamer's accounting matches the GPU mirror and stays in budget
+            const TextureStreamerStats& s = streamer.GetStats();
+            uint64_t mirrored = 0;
+            for (uint32_t t = 0; t < textureCount; t++) {
+                run.ok &= streamer.GetResidentMip(t) == gpuMip[t];
+                mirrored += ChainBytes(SizeOf(textureClass[t]), gpuMip[t], mipCount(t));
+            }
+            run.ok &= mirrored == s.residentBytes && s.residentBytes + s.inFlightBytes <= budget;
+            if (frame < frames) {
+                missing += s.missingMips;
+                visible += s.visible;
+            } else if (s.inFlightBytes == 0 && s.missingMips == 0) {
+                break;   // settled
+            }
+        }
+
+        const TextureStreamerStats& s = streamer.GetStats();
+        run.peakMB = double(s.peakBytes) / 1048576.0;
+        run.evictions = s.evictions;
+        run.requests = s.requests;
+        run.cancels = s.cancels;
+        run.missingPerFrame = double(missing) / double(frames);
+        run.visiblePerFrame = double(visible) / double(frames);
+        run.updateAvgUs = updateSeconds / double(frame + 1) * 1e6;
+        run.latencyP95Ms = assets.GetStats().latencyP95Ms;
+        run.finalMissing = s.missingMips;
+        run.ok &= s.peakBytes <= budget;
+        // Nothing was ever evicted, so the budget had room: every desired mip must have arrived
+        if (run.evictions == 0) run.ok &= run.finalMissing == 0;
+        runs.push_back(run);
+    }
+    std::remove(packPath.c_str());
+
+    bool allOk = true;
+    for (const Run& r : runs) allOk &= r.ok;
+    std::printf("TextureBench: %u objects, %u BC7 textures (256-4096), %u frames + settle, %.1f MB/frame upload, pack %.1f MB\n",
+                objectCount, textureCount, frames, uploadMB, packMB);
+    std::printf("  %8s %9s %9s %9s %8s %9s %9s %10s %10s %9s  %s\n", "budget", "peak", "evictions", "requests", "cancels",
+                "missing", "visible", "update avg", "update max", "p95", "check");
+    std::string json;
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "{\n  \"benchmark\": \"texture_bench\",\n  \"objects\": %u,\n  \"textures\": %u,\n  \"frames\": %u,\n"
+                  "  \"uploadMBPerFrame\": %.2f,\n  \"verified\": %s,\n  \"results\": [",
+                  objectCount, textureCount, frames, uploadMB, allOk ? "true" : "false");
+    json += buf;
+    for (size_t i = 0; i < runs.size(); i++) {
+        const Run& r = runs[i];
+        std::printf("  %6.0fMB %7.1fMB %9llu %9llu %8llu %9.1f %9.1f %8.1fus %8.1fus %7.2fms  %s\n", r.budgetMB, r.peakMB,
+                    (unsigned long long)r.evictions, (unsigned long long)r.requests, (unsigned long long)r.cancels,
+                    r.missingPerFrame, r.visiblePerFrame, r.updateAvgUs, r.updateMaxUs, r.latencyP95Ms, r.ok ? "ok" : "MISMATCH");
+        std::snprintf(buf, sizeof(buf),
+                      "%s\n    { \"budgetMB\": %.1f, \"peakMB\": %.2f, \"evictions\": %llu, \"requests\": %llu, \"cancels\": %llu,"
+                      " \"missingMipsPerFrame\": %.2f, \"visiblePerFrame\": %.1f, \"updateAvgUs\": %.2f, \"updateMaxUs\": %.2f,"
+                      " \"latencyP95Ms\": %.3f, \"ok\": %s }",
+                      i ? "," : "", r.budgetMB, r.peakMB, (unsigned long long)r.evictions, (unsigned long long)r.requests,
+                      (unsigned long long)r.cancels, r.missingPerFrame, r.visiblePerFrame, r.updateAvgUs, r.updateMaxUs,
+                      r.latencyP95Ms, r.ok ? "true" : "false");
+        json += buf;
+    }
+    json += "\n  ]\n}\n";
+
+    if (!WriteFile(outPath, json, "TextureBench")) return 1;
+    return allOk ? 0 : 1;
+}